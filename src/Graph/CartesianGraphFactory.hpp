@@ -13,9 +13,13 @@
 #include "Grid/grid_sm.hpp"
 #include "Space/Shape/Box.hpp"
 #include "Space/Shape/HyperCube.hpp"
+#include "util/multi_thread_util.hpp"
 
 #define NO_VERTEX_ID -1
 
+//! Under this number of vertices the cartesian graph is constructed by one thread
+#define CARTESIAN_GRAPH_CPU_GRAIN 16384
+
 /*! \brief Operator to fill the property 'prp' with the linearization of indexes
  *
  *  \tparam dim Dimension of the space
@@ -264,6 +268,43 @@ struct fill_prop_by_type<dim, 0, p, Graph, pos...>
 
 };
 
+/*! \brief Set the edge property that store the contact size
+ *
+ * \tparam se property that store the contact size
+ *
+ */
+template<int se>
+struct cartesian_edge_prop
+{
+	/*! \brief Set the contact size of the edge between v and its adjacent vertex i
+	 *
+	 * \param gp graph
+	 * \param v vertex
+	 * \param i adjacent vertex id
+	 * \param ele_sz contact size
+	 *
+	 */
+	template<typename Graph, typename T>
+	static inline void set(Graph & gp, size_t v, size_t i, T ele_sz)
+	{
+		gp.getChildEdge(v,i).template get<se>() = ele_sz;
+	}
+};
+
+/*! \brief Set the edge property that store the contact size
+ *
+ * Case NO_EDGE, nothing to set
+ *
+ */
+template<>
+struct cartesian_edge_prop<NO_EDGE>
+{
+	template<typename Graph, typename T>
+	static inline void set(Graph & gp, size_t v, size_t i, T ele_sz)
+	{
+	}
+};
+
 /*! \brief Graph constructor function specialization
  *
  * On C++ partial function specialization is not allowed, so we need a class to do it
@@ -275,9 +316,32 @@ struct fill_prop_by_type<dim, 0, p, Graph, pos...>
 template<unsigned int dim, int lin_id, typename Graph, int se, typename T, unsigned int dim_c, int ... pos>
 class Graph_constructor_impl
 {
+	/*! \brief Return the id of the vertex in direction c or -1 if it does not exist
+	 *
+	 * \param g grid info
+	 * \param key vertex
+	 * \param c direction
+	 * \param bc boundary conditions
+	 *
+	 * \return the vertex id
+	 *
+	 */
+	static inline long int neighborhood(const grid_sm<dim, void> & g, const grid_key_dx<dim> & key, const comb<dim> & c, const size_t(& bc)[dim])
+	{
+		long int end_v = g.template LinId<CheckExistence>(key,c.getComb(),bc);
+
+		return (end_v < 0 || (size_t)end_v >= g.size())?-1:end_v;
+	}
+
 public:
 
 	/*! \brief Construct a cartesian graph
+	 *
+	 * The graph is generated directly in compact form with multiple threads. The number of edges of every
+	 * vertex is calculated from the stencil (the combinations of dimension dim_c or bigger) and the boundary
+	 * conditions, the adjacency lists are allocated at once and then every thread fill the vertex
+	 * properties and the edges of a range of vertices. The vertices, the edges and their ids are the same
+	 * that are produced adding the vertices and the edges one by one
 	 *
 	 * \param sz size of the partesian graph
 	 * \param dom domain where this cartesian graph is defined (used to fill the coordinates)
@@ -304,134 +368,47 @@ public:
 
 		grid_sm<dim, void> g(sz);
 
-		// Create a graph with the number of vertices equal to the number of
-		// grid point
-
-		//! Graph to construct
+		// the stencil, combinations from dimension dim-1 to dim_c, and the size of the element in contact
+		// (communication weight)
 
-		Graph gp(g.size());
+		std::vector<comb<dim>> c;
+		std::vector<T> ele_sz;
 
-		/******************
-		 *
-		 * Create the edges and fill spatial
-		 * information properties
-		 *
-		 ******************/
-
-		//! Construct a key iterator
-		grid_key_dx_iterator<dim> k_it(g);
-
-		//! Iterate through all the elements
-
-		while (k_it.isNext())
+		for (long int d = dim-1 ; d >= dim_c ; d--)
 		{
-			grid_key_dx<dim> key = k_it.get();
-
-			// Vertex object
-
-			auto obj = gp.vertex(g.LinId(key));
+			std::vector<comb<dim>> cd = hc.getCombinations_R(d);
 
-			typedef typename to_boost_vmpl<pos...>::type p;
-
-			// vertex spatial properties functor
-
-			fill_prop<dim, lin_id, T, decltype(gp.vertex(g.LinId(key))), typename to_boost_vmpl<pos...>::type, fill_prop_by_type<dim,sizeof...(pos), p, Graph, pos...>::value> flp(obj, szd, key, g, dom);
-
-			// fill properties
-
-			boost::mpl::for_each<boost::mpl::range_c<int, 0, sizeof...(pos)> >(flp);
-
-			// Get the combinations of dimension d
-
-			for (long int d = dim-1 ; d >= dim_c ; d--)
+			for (size_t j = 0; j < cd.size(); j++)
 			{
-				// create the edges for that dimension
-
-				std::vector<comb<dim>> c = hc.getCombinations_R(d);
-
-				// for each combination calculate a safe linearization and create an edge
-
-				for (size_t j = 0; j < c.size(); j++)
-				{
-					// Calculate the element size
-
-					T ele_sz = 0;
-
-					// for each dimension multiply and reduce
-
+				T sz_e = 0;
 
-					for (size_t s = 0 ; s < dim ; s++)
-						ele_sz += szd[s] * abs(c[j][s]);
+				for (size_t s = 0 ; s < dim ; s++)
+					sz_e += szd[s] * abs(cd[j][s]);
 
-					// Calculate the end point vertex id
-					// Calculate the start point id
-
-					size_t start_v = g.LinId(key);
-
-					size_t end_v = g.template LinId<CheckExistence>(key,c[j].getComb(),bc);
-
-					// Add an edge and set the the edge property to the size of the face (communication weight)
-					gp.template addEdge<CheckExistence>(start_v, end_v).template get<se>() = ele_sz;
-				}
+				c.push_back(cd[j]);
+				ele_sz.push_back(sz_e);
 			}
-
-			// Fill vertex properties
-
-			++k_it;
 		}
 
-		return gp;
-	}
-};
-
-/*! \brief Graph constructor function specialization
- *
- * On C++ partial function specialization is not allowed, so we need a class to do it
- * This specialization handle the case when we have NO_EDGE option active
- *
- * \see CartesianGraphFactory method construct
- *
- */
+		// Create a graph with the number of vertices equal to the number of
+		// grid point
 
-template<unsigned int dim, int lin_id, typename Graph, typename T, unsigned int dim_c, int ... pos>
-class Graph_constructor_impl<dim, lin_id, Graph, NO_EDGE, T, dim_c, pos...>
-{
-public:
+		//! Graph to construct
 
-	/*! \brief Construct a cartesian graph
-	 *
-	 * \param sz size of the partesian graph
-	 * \param dom domain where this cartesian graph is defined (used to fill the coordinates)
-	 * \param bc boundary conditions (torus or cube)
-	 *
-	 * \return the constructed graph
-	 *
-	 */
-	static Graph construct(const size_t ( & sz)[dim], Box<dim,T> & dom, const size_t(& bc)[dim])
-	{
-		// Calculate the size of the hyper-cubes on each dimension
+		Graph gp(g.size());
 
-		T szd[dim];
+		// number of edges of every vertex
 
-		for (size_t i = 0; i < dim; i++)
+		gp.allocateCompact([&](size_t v)
 		{
-			szd[i] = (dom.getHigh(i) - dom.getLow(i)) / sz[i];
-		}
+			grid_key_dx<dim> key = g.InvLinId(v);
 
-		//! Construct an hyper-cube of dimension dim
-
-		HyperCube<dim> hc;
+			size_t n_e = 0;
+			for (size_t j = 0 ; j < c.size() ; j++)
+			{n_e += (neighborhood(g,key,c[j],bc) != -1);}
 
-		// Construct a grid info
-
-		grid_sm<dim, void> g(sz);
-
-		// Create a graph with the number of vertices equal to the number of
-		// grid point
-
-		//! Graph to construct
-
-		Graph gp(g.size());
+			return n_e;
+		});
 
 		/******************
 		 *
@@ -440,55 +417,59 @@ public:
 		 *
 		 ******************/
 
-		//! Construct a key iterator
-		grid_key_dx_iterator<dim> k_it(g);
-
-		//! Iterate through all the elements
+		const size_t n = g.size();
+		const int nth = openfpm::ofp_n_threads(n,CARTESIAN_GRAPH_CPU_GRAIN);
 
-		while (k_it.isNext())
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
 		{
-			grid_key_dx<dim> key = k_it.get();
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n,t,nth,start,stop);
 
-			// Vertex object
-			auto obj = gp.vertex(g.LinId(key));
+			if (start == stop)	{continue;}
 
-			typedef typename to_boost_vmpl<pos...>::type p;
+			grid_key_dx<dim> key = g.InvLinId(start);
 
-			// vertex spatial properties functor
+			for (size_t start_v = start ; start_v < stop ; start_v++)
+			{
+				// Vertex object
 
-			fill_prop<dim, lin_id, T, decltype(gp.vertex(g.LinId(key))), typename to_boost_vmpl<pos...>::type, fill_prop_by_type<dim,sizeof...(pos), p, Graph, pos...>::value> flp(obj, szd, key, g, dom);
+				auto obj = gp.vertex(start_v);
 
-			// fill properties
+				typedef typename to_boost_vmpl<pos...>::type p;
 
-			boost::mpl::for_each_ref<boost::mpl::range_c<int, 0, sizeof...(pos)> >(flp);
+				// vertex spatial properties functor
 
-			// Get the combinations of dimension d
+				fill_prop<dim, lin_id, T, decltype(gp.vertex(start_v)), typename to_boost_vmpl<pos...>::type, fill_prop_by_type<dim,sizeof...(pos), p, Graph, pos...>::value> flp(obj, szd, key, g, dom);
 
-			for (long int d = dim-1 ; d >= dim_c ; d--)
-			{
-				// create the edges for that dimension
+				// fill properties
 
-				std::vector<comb<dim>> c = hc.getCombinations_R(d);
+				boost::mpl::for_each_ref<boost::mpl::range_c<int, 0, sizeof...(pos)> >(flp);
 
-				// for each combination calculate a safe linearization and create an edge
+				// create the edges and set the the edge property to the size of the face (communication weight)
 
+				size_t i = 0;
 				for (size_t j = 0; j < c.size(); j++)
 				{
-					// Calculate the end point vertex id
-					// Calculate the start point id
+					long int end_v = neighborhood(g,key,c[j],bc);
 
-					size_t start_v = g.LinId(key);
+					if (end_v == -1)	{continue;}
 
-					size_t end_v = g.template LinId<CheckExistence>(key,c[j].getComb(),bc);
-
-					// Add an edge and set the the edge property to the size of the face (communication weight)
-					gp.template addEdge<CheckExistence>(start_v, end_v);
+					gp.setChild(start_v,i,end_v);
+					cartesian_edge_prop<se>::set(gp,start_v,i,ele_sz[j]);
+					i++;
 				}
-			}
 
-			// Fill vertex properties
+				// next vertex
 
-			++k_it;
+				for (size_t s = 0 ; s < dim ; s++)
+				{
+					key.set_d(s,key.get(s) + 1);
+					if ((size_t)key.get(s) < sz[s])	{break;}
+					key.set_d(s,0);
+				}
+			}
 		}
 
 		return gp;
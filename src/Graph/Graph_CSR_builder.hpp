@@ -0,0 +1,252 @@
+/*
+ * Graph_CSR_builder.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef GRAPH_CSR_BUILDER_HPP_
+#define GRAPH_CSR_BUILDER_HPP_
+
+#include "map_graph.hpp"
+#include "util/radix_sort_cpu.hpp"
+
+/*! \brief Build the edges of a Graph_CSR in compact form
+ *
+ * The edges are collected in a coordinate list (source, target, properties), build() sort them by
+ * source and produce the adjacency lists of the graph in one pass, without slots and without the
+ * reallocations that Graph_CSR::addEdge does when a vertex exceed its slots. Edges with the same
+ * source keep the order in which they have been added.
+ *
+ * Edges can be added one by one with addEdge, or the list can be resized and filled in parallel
+ * with setEdge
+ *
+ * \tparam Graph Graph_CSR type
+ *
+ * ### Build a graph
+ * \snippet graph_unit_tests.hpp Build a compact graph
+ *
+ */
+template<typename Graph>
+class Graph_CSR_builder
+{
+	//! edge properties vector (same type of the graph)
+	typedef typename std::remove_reference<decltype(std::declval<Graph &>().e)>::type e_vector;
+
+	//! source vertex of each edge
+	openfpm::vector<size_t> src;
+
+	//! target vertex of each edge
+	openfpm::vector<size_t> dst;
+
+	//! edge properties
+	e_vector e;
+
+public:
+
+	/*! \brief Reserve space for n edges
+	 *
+	 * \param n number of edges
+	 *
+	 */
+	void reserve(size_t n)
+	{
+		src.reserve(n);
+		dst.reserve(n);
+		e.reserve(n);
+	}
+
+	/*! \brief Resize the list to n edges, the new edges must be set with setEdge
+	 *
+	 * \param n number of edges
+	 *
+	 */
+	void resize(size_t n)
+	{
+		src.resize(n);
+		dst.resize(n);
+		e.resize(n);
+	}
+
+	/*! \brief Number of edges
+	 *
+	 * \return the number of edges
+	 *
+	 */
+	size_t size() const
+	{
+		return src.size();
+	}
+
+	/*! \brief Set the edge id (it can be called concurrently for different ids)
+	 *
+	 * \param id edge id
+	 * \param v1 source vertex
+	 * \param v2 target vertex
+	 *
+	 */
+	inline void setEdge(size_t id, size_t v1, size_t v2)
+	{
+		src.template get<0>(id) = v1;
+		dst.template get<0>(id) = v2;
+	}
+
+	/*! \brief Add an edge
+	 *
+	 * \param v1 source vertex
+	 * \param v2 target vertex
+	 *
+	 * \return the edge id
+	 *
+	 */
+	inline size_t addEdge(size_t v1, size_t v2)
+	{
+		src.add(v1);
+		dst.add(v2);
+		e.add();
+
+		return e.size() - 1;
+	}
+
+	/*! \brief Add an edge with properties
+	 *
+	 * \param v1 source vertex
+	 * \param v2 target vertex
+	 * \param ed edge properties
+	 *
+	 * \return the edge id
+	 *
+	 */
+	inline size_t addEdge(size_t v1, size_t v2, const typename Graph::E_type & ed)
+	{
+		src.add(v1);
+		dst.add(v2);
+		e.add(ed);
+
+		return e.size() - 1;
+	}
+
+	/*! \brief Access the properties of an edge
+	 *
+	 * \param id edge id
+	 *
+	 * \return the edge object
+	 *
+	 */
+	inline auto edge(size_t id) -> decltype(e.get(id))
+	{
+		return e.get(id);
+	}
+
+	/*! \brief Replace the edges of g with the collected edges
+	 *
+	 * The vertices of g are untouched, g is left in compact form and the edge id of the edge i
+	 * added to the builder is i. The builder is empty after the call
+	 *
+	 * \param g graph
+	 *
+	 */
+	void build(Graph & g)
+	{
+		const size_t n_e = src.size();
+		const size_t n_v = g.getNVertex();
+
+#ifdef SE_CLASS1
+
+		for (size_t i = 0 ; i < n_e ; i++)
+		{
+			if (src.template get<0>(i) >= n_v || dst.template get<0>(i) >= n_v)
+			{
+				std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " edge " << i << " connect vertices that does not exist" << std::endl;
+				break;
+			}
+		}
+
+#endif
+
+		// sort the edges by source, perm is the edge id
+
+		openfpm::vector<size_t> perm;
+		perm.resize(n_e);
+
+		int nth = openfpm::ofp_n_threads(n_e,GRAPH_CSR_CPU_GRAIN);
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n_e,t,nth,start,stop);
+
+			for (size_t i = start ; i < stop ; i++)
+			{perm.template get<0>(i) = i;}
+		}
+
+		if (n_e != 0)
+		{openfpm::radix_sort_cpu(&src.template get<0>(0),&perm.template get<0>(0),n_e);}
+
+		// start of each vertex, every position where the source change is the start of the
+		// vertices between the previous source (excluded) and the new one (included)
+
+		g.v_s.resize(n_v + 1);
+		g.v_l.resize(n_v);
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n_e + 1,t,nth,start,stop);
+
+			for (size_t i = start ; i < stop ; i++)
+			{
+				size_t prev = (i == 0)?0:src.template get<0>(i-1) + 1;
+				size_t cur = (i == n_e)?n_v:src.template get<0>(i);
+
+				for (size_t k = prev ; k <= cur ; k++)
+				{g.v_s.template get<0>(k) = i;}
+			}
+		}
+
+		// adjacency lists and number of adjacent vertices
+
+		g.e_l.resize(n_e);
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n_e,t,nth,start,stop);
+
+			for (size_t i = start ; i < stop ; i++)
+			{
+				size_t id = perm.template get<0>(i);
+
+				g.e_l.template get<e_map::vid>(i) = dst.template get<0>(id);
+				g.e_l.template get<e_map::eid>(i) = id;
+			}
+		}
+
+		nth = openfpm::ofp_n_threads(n_v,GRAPH_CSR_CPU_GRAIN);
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n_v,t,nth,start,stop);
+
+			for (size_t i = start ; i < stop ; i++)
+			{g.v_l.template get<0>(i) = g.v_s.template get<0>(i+1) - g.v_s.template get<0>(i);}
+		}
+
+		g.e.swap(e);
+
+		src.clear();
+		dst.clear();
+		e.clear();
+	}
+};
+
+#endif /* GRAPH_CSR_BUILDER_HPP_ */
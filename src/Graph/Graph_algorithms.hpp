@@ -0,0 +1,456 @@
+/*
+ * Graph_algorithms.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef GRAPH_ALGORITHMS_HPP_
+#define GRAPH_ALGORITHMS_HPP_
+
+#include <vector>
+#include <atomic>
+#include <memory>
+#include "util/multi_thread_util.hpp"
+
+/*! \brief Multi-threaded graph algorithms on Graph_CSR
+ *
+ * * graph_bfs direction-optimizing breadth first search
+ * * graph_connected_components label propagation with pointer jumping
+ * * graph_coloring Jones-Plassmann greedy coloring
+ *
+ * The graph is assumed to be undirected (every edge has its reverse), the result is written in the
+ * vertex property prop
+ *
+ * ### Color a graph
+ * \snippet graph_unit_tests.hpp Color a graph
+ *
+ */
+
+//! Grain used to process the vertices with multiple threads
+#define GRAPH_ALGO_CPU_GRAIN 2048
+
+//! The bfs switch to bottom-up when the edges of the frontier are more than the unexplored edges / alpha
+#define GRAPH_BFS_ALPHA 14
+
+//! The bfs switch back to top-down when the frontier has less than n_vertex / beta vertices
+#define GRAPH_BFS_BETA 24
+
+/*! \brief Run a function on the range of elements [start,stop) assigned to each thread
+ *
+ * \param n number of elements
+ * \param f function f(t,start,stop)
+ *
+ * \return the number of threads used
+ *
+ */
+template<typename funct_type>
+int graph_parallel_ranges(size_t n, funct_type f)
+{
+	const int nth = openfpm::ofp_n_threads(n,GRAPH_ALGO_CPU_GRAIN);
+
+	#pragma omp parallel for num_threads(nth) schedule(static,1)
+	for (int t = 0 ; t < nth ; t++)
+	{
+		size_t start;
+		size_t stop;
+		openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+		f(t,start,stop);
+	}
+
+	return nth;
+}
+
+/*! \brief Concatenate the per-thread lists into out
+ *
+ * \param lists per thread lists
+ * \param nth number of lists to concatenate
+ * \param out output
+ *
+ */
+static inline void graph_concat_lists(std::vector<std::vector<size_t>> & lists, int nth, std::vector<size_t> & out)
+{
+	std::vector<size_t> off(nth + 1,0);
+
+	for (int t = 0 ; t < nth ; t++)
+	{off[t+1] = off[t] + lists[t].size();}
+
+	out.resize(off[nth]);
+
+	#pragma omp parallel for num_threads(nth) schedule(static,1)
+	for (int t = 0 ; t < nth ; t++)
+	{std::copy(lists[t].begin(),lists[t].end(),out.begin() + off[t]);}
+}
+
+/*! \brief Direction-optimizing breadth first search
+ *
+ * The frontier is expanded top-down (from the frontier vertices to their unvisited children) while it is
+ * small, and bottom-up (every unvisited vertex look for a parent in the frontier) when the frontier is big,
+ * following Beamer et al.
+ *
+ * \tparam prop vertex property where to write the distance from the root (-1 for unreachable vertices)
+ *
+ * \param g graph
+ * \param root root vertex
+ *
+ * \return the number of levels (the maximum distance + 1)
+ *
+ */
+template<unsigned int prop, typename Graph>
+size_t graph_bfs(Graph & g, size_t root)
+{
+	typedef typename std::remove_reference<decltype(g.vertex(0).template get<prop>())>::type d_type;
+
+	const size_t n = g.getNVertex();
+	if (n == 0)	{return 0;}
+
+	std::unique_ptr<std::atomic<long int>[]> dist(new std::atomic<long int>[n]);
+
+	size_t m_unexplored = 0;
+	int nth = openfpm::ofp_n_threads(n,GRAPH_ALGO_CPU_GRAIN);
+	std::vector<size_t> th_e(nth,0);
+
+	graph_parallel_ranges(n,[&](int t, size_t start, size_t stop)
+	{
+		for (size_t i = start ; i < stop ; i++)
+		{
+			dist[i].store(-1,std::memory_order_relaxed);
+			th_e[t] += g.getNChilds(i);
+		}
+	});
+
+	for (int t = 0 ; t < nth ; t++)	{m_unexplored += th_e[t];}
+
+	std::vector<size_t> frontier;
+	std::vector<std::vector<size_t>> next(openfpm::ofp_max_threads());
+
+	dist[root].store(0,std::memory_order_relaxed);
+	frontier.push_back(root);
+
+	size_t n_front = 1;
+	size_t m_front = g.getNChilds(root);
+	bool bottom_up = false;
+	long int level = 0;
+
+	while (n_front != 0)
+	{
+		m_unexplored -= std::min(m_unexplored,m_front);
+
+		// choose the direction
+
+		if (bottom_up == false && m_front > m_unexplored / GRAPH_BFS_ALPHA)
+		{bottom_up = true;}
+		else if (bottom_up == true && n_front < n / GRAPH_BFS_BETA)
+		{
+			bottom_up = false;
+
+			// the top-down step need the list of the frontier vertices
+
+			int nth_f = graph_parallel_ranges(n,[&](int t, size_t start, size_t stop)
+			{
+				next[t].clear();
+				for (size_t i = start ; i < stop ; i++)
+				{
+					if (dist[i].load(std::memory_order_relaxed) == level)
+					{next[t].push_back(i);}
+				}
+			});
+
+			graph_concat_lists(next,nth_f,frontier);
+		}
+
+		std::vector<size_t> th_n(openfpm::ofp_max_threads(),0);
+		std::vector<size_t> th_m(openfpm::ofp_max_threads(),0);
+		int nth_s;
+
+		if (bottom_up == false)
+		{
+			nth_s = graph_parallel_ranges(frontier.size(),[&](int t, size_t start, size_t stop)
+			{
+				next[t].clear();
+
+				for (size_t i = start ; i < stop ; i++)
+				{
+					size_t v = frontier[i];
+
+					for (size_t j = 0 ; j < g.getNChilds(v) ; j++)
+					{
+						size_t c = g.getChild(v,j);
+						long int unv = -1;
+
+						if (dist[c].load(std::memory_order_relaxed) == -1 &&
+						    dist[c].compare_exchange_strong(unv,level + 1,std::memory_order_relaxed))
+						{
+							next[t].push_back(c);
+							th_m[t] += g.getNChilds(c);
+						}
+					}
+				}
+
+				th_n[t] = next[t].size();
+			});
+
+			graph_concat_lists(next,nth_s,frontier);
+		}
+		else
+		{
+			// every vertex write only its own distance
+
+			nth_s = graph_parallel_ranges(n,[&](int t, size_t start, size_t stop)
+			{
+				for (size_t i = start ; i < stop ; i++)
+				{
+					if (dist[i].load(std::memory_order_relaxed) != -1)	{continue;}
+
+					for (size_t j = 0 ; j < g.getNChilds(i) ; j++)
+					{
+						if (dist[g.getChild(i,j)].load(std::memory_order_relaxed) == level)
+						{
+							dist[i].store(level + 1,std::memory_order_relaxed);
+							th_n[t]++;
+							th_m[t] += g.getNChilds(i);
+							break;
+						}
+					}
+				}
+			});
+		}
+
+		n_front = 0;
+		m_front = 0;
+		for (int t = 0 ; t < nth_s ; t++)
+		{
+			n_front += th_n[t];
+			m_front += th_m[t];
+		}
+
+		level++;
+	}
+
+	graph_parallel_ranges(n,[&](int t, size_t start, size_t stop)
+	{
+		for (size_t i = start ; i < stop ; i++)
+		{g.vertex(i).template get<prop>() = (d_type)dist[i].load(std::memory_order_relaxed);}
+	});
+
+	return level;
+}
+
+/*! \brief Connected components by label propagation
+ *
+ * Every vertex start with its own id as label and take the minimum label of its adjacent vertices until
+ * nothing change. Labels are shortcut with pointer jumping (the label of a vertex is itself a vertex of the
+ * same component) to reduce the number of iterations on graphs with large diameter. At the end the label
+ * of every vertex is the minimum vertex id of its component
+ *
+ * \tparam prop vertex property where to write the component label
+ *
+ * \param g graph
+ *
+ * \return the number of connected components
+ *
+ */
+template<unsigned int prop, typename Graph>
+size_t graph_connected_components(Graph & g)
+{
+	typedef typename std::remove_reference<decltype(g.vertex(0).template get<prop>())>::type l_type;
+
+	const size_t n = g.getNVertex();
+	if (n == 0)	{return 0;}
+
+	std::unique_ptr<std::atomic<size_t>[]> label(new std::atomic<size_t>[n]);
+
+	graph_parallel_ranges(n,[&](int t, size_t start, size_t stop)
+	{
+		for (size_t i = start ; i < stop ; i++)
+		{label[i].store(i,std::memory_order_relaxed);}
+	});
+
+	std::atomic<bool> changed(true);
+
+	while (changed.load() == true)
+	{
+		changed.store(false);
+
+		graph_parallel_ranges(n,[&](int t, size_t start, size_t stop)
+		{
+			bool ch = false;
+
+			for (size_t i = start ; i < stop ; i++)
+			{
+				size_t l = label[i].load(std::memory_order_relaxed);
+				size_t lm = l;
+
+				for (size_t j = 0 ; j < g.getNChilds(i) ; j++)
+				{lm = std::min(lm,label[g.getChild(i,j)].load(std::memory_order_relaxed));}
+
+				// pointer jumping
+
+				lm = std::min(lm,label[lm].load(std::memory_order_relaxed));
+
+				// labels only decrease, the minimum is written in i and in its old label
+
+				while (lm < l && label[i].compare_exchange_weak(l,lm,std::memory_order_relaxed) == false)	{}
+				if (lm < l)	{ch = true;}
+
+				size_t ll = label[l].load(std::memory_order_relaxed);
+				while (lm < ll && label[l].compare_exchange_weak(ll,lm,std::memory_order_relaxed) == false)	{}
+			}
+
+			if (ch == true)	{changed.store(true);}
+		});
+	}
+
+	std::vector<size_t> th_c(openfpm::ofp_max_threads(),0);
+
+	int nth = graph_parallel_ranges(n,[&](int t, size_t start, size_t stop)
+	{
+		for (size_t i = start ; i < stop ; i++)
+		{
+			size_t l = label[i].load(std::memory_order_relaxed);
+
+			g.vertex(i).template get<prop>() = (l_type)l;
+			if (l == i)	{th_c[t]++;}
+		}
+	});
+
+	size_t n_comp = 0;
+	for (int t = 0 ; t < nth ; t++)	{n_comp += th_c[t];}
+
+	return n_comp;
+}
+
+/*! \brief Random priority of a vertex used by the coloring
+ *
+ * \param v vertex
+ * \param seed seed
+ *
+ * \return the priority
+ *
+ */
+static inline size_t graph_vertex_priority(size_t v, size_t seed)
+{
+	size_t x = v + seed * 0x9e3779b97f4a7c15ull;
+
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+	return x ^ (x >> 31);
+}
+
+/*! \brief Greedy parallel coloring (Jones-Plassmann)
+ *
+ * Every vertex get a random priority. At each round the uncolored vertices whose priority is bigger than
+ * the one of all their uncolored adjacent vertices (an independent set) take the smallest color not used by
+ * their adjacent vertices. The number of colors is at most the maximum degree + 1
+ *
+ * \tparam prop vertex property where to write the color
+ *
+ * \param g graph
+ * \param seed seed of the priorities
+ *
+ * \return the number of colors
+ *
+ */
+template<unsigned int prop, typename Graph>
+size_t graph_coloring(Graph & g, size_t seed = 0)
+{
+	typedef typename std::remove_reference<decltype(g.vertex(0).template get<prop>())>::type c_type;
+
+	const size_t n = g.getNVertex();
+	if (n == 0)	{return 0;}
+
+	std::vector<long int> color(n,-1);
+	std::vector<unsigned char> sel(n,0);
+	std::vector<size_t> work(n);
+	std::vector<std::vector<size_t>> next(openfpm::ofp_max_threads());
+	std::vector<size_t> th_c(openfpm::ofp_max_threads(),0);
+
+	std::vector<size_t> prio(n);
+
+	graph_parallel_ranges(n,[&](int t, size_t start, size_t stop)
+	{
+		for (size_t i = start ; i < stop ; i++)
+		{
+			work[i] = i;
+			prio[i] = graph_vertex_priority(i,seed);
+		}
+	});
+
+	// compare the priorities, equal priorities are broken by the vertex id
+
+	auto greater = [&](size_t a, size_t b)
+	{
+		return (prio[a] > prio[b]) || (prio[a] == prio[b] && a > b);
+	};
+
+	while (work.size() != 0)
+	{
+		// select the independent set, color is not modified
+
+		graph_parallel_ranges(work.size(),[&](int t, size_t start, size_t stop)
+		{
+			for (size_t i = start ; i < stop ; i++)
+			{
+				size_t v = work[i];
+				bool max = true;
+
+				for (size_t j = 0 ; j < g.getNChilds(v) && max == true ; j++)
+				{
+					size_t c = g.getChild(v,j);
+					if (c != v && color[c] == -1 && greater(c,v) == true)	{max = false;}
+				}
+
+				sel[v] = max;
+			}
+		});
+
+		// color the independent set, the adjacent vertices of a selected vertex are not modified in this round
+
+		int nth = graph_parallel_ranges(work.size(),[&](int t, size_t start, size_t stop)
+		{
+			std::vector<bool> used;
+			next[t].clear();
+
+			for (size_t i = start ; i < stop ; i++)
+			{
+				size_t v = work[i];
+
+				if (sel[v] == 0)
+				{
+					next[t].push_back(v);
+					continue;
+				}
+
+				used.assign(g.getNChilds(v) + 1,false);
+
+				for (size_t j = 0 ; j < g.getNChilds(v) ; j++)
+				{
+					long int c = color[g.getChild(v,j)];
+					if (c != -1 && (size_t)c < used.size())	{used[c] = true;}
+				}
+
+				size_t k = 0;
+				while (used[k] == true)	{k++;}
+
+				color[v] = k;
+				th_c[t] = std::max(th_c[t],k + 1);
+			}
+		});
+
+		graph_concat_lists(next,nth,work);
+	}
+
+	size_t n_color = 0;
+	for (size_t t = 0 ; t < th_c.size() ; t++)	{n_color = std::max(n_color,th_c[t]);}
+
+	graph_parallel_ranges(n,[&](int t, size_t start, size_t stop)
+	{
+		for (size_t i = start ; i < stop ; i++)
+		{g.vertex(i).template get<prop>() = (c_type)color[i];}
+	});
+
+	return n_color;
+}
+
+#endif /* GRAPH_ALGORITHMS_HPP_ */
@@ -0,0 +1,335 @@
+/*
+ * Graph_reorder.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef GRAPH_REORDER_HPP_
+#define GRAPH_REORDER_HPP_
+
+#include <algorithm>
+#include "Vector/map_vector.hpp"
+#include "Grid/grid_sm.hpp"
+#include "Grid/grid_key_dx_iterator_hilbert.hpp"
+#include "util/zmorton.hpp"
+#include "util/radix_sort_cpu.hpp"
+#include "util/multi_thread_util.hpp"
+
+/*! \brief Vertex orderings that reduce the bandwidth of a graph
+ *
+ * Every function produce a permutation new_id (new_id[i] is the new id of the vertex i) to be
+ * passed to Graph_CSR::reorder. Neighbouring vertices get close ids so that the properties of the
+ * adjacent vertices are close in memory when the graph is traversed
+ *
+ * * reorder_rcm reverse Cuthill-McKee, it use only the connectivity of the graph
+ * * reorder_morton and reorder_hilbert, for graphs whose vertices are the points of a grid
+ *   (like the one produced by CartesianGraphFactory), order the vertices along a space filling curve
+ *
+ * ### Reorder a graph
+ * \snippet graph_unit_tests.hpp Reorder a graph
+ *
+ */
+
+//! Grain used to process the vertices with multiple threads
+#define GRAPH_REORDER_CPU_GRAIN 4096
+
+/*! \brief Breadth first search from the vertex r that produce the level structure of its connected component
+ *
+ * \param g graph
+ * \param r root vertex
+ * \param mark visited marker of each vertex (set to stamp for the visited vertices)
+ * \param stamp marker of this search
+ * \param queue vertices in the order they are visited
+ * \param last_level start in queue of the last level
+ *
+ * \return the number of levels (eccentricity of r + 1)
+ *
+ */
+template<typename Graph>
+size_t graph_level_structure(const Graph & g, size_t r, openfpm::vector<size_t> & mark, size_t stamp,
+		                     openfpm::vector<size_t> & queue, size_t & last_level)
+{
+	queue.clear();
+	queue.add(r);
+	mark.template get<0>(r) = stamp;
+
+	size_t n_level = 0;
+	size_t lv_start = 0;
+
+	while (lv_start < queue.size())
+	{
+		size_t lv_stop = queue.size();
+		last_level = lv_start;
+		n_level++;
+
+		for (size_t i = lv_start ; i < lv_stop ; i++)
+		{
+			size_t v = queue.template get<0>(i);
+
+			for (size_t j = 0 ; j < g.getNChilds(v) ; j++)
+			{
+				size_t c = g.getChild(v,j);
+
+				if (mark.template get<0>(c) != stamp)
+				{
+					mark.template get<0>(c) = stamp;
+					queue.add(c);
+				}
+			}
+		}
+
+		lv_start = lv_stop;
+	}
+
+	return n_level;
+}
+
+/*! \brief Reverse Cuthill-McKee ordering
+ *
+ * Every connected component is visited breadth first starting from a pseudo-peripheral vertex
+ * (George-Liu), the adjacent vertices are visited in order of increasing degree. The final
+ * order is reversed. The graph is assumed to be undirected (every edge has its reverse)
+ *
+ * \param g graph
+ * \param new_id output permutation, new_id[i] is the new id of the vertex i
+ *
+ */
+template<typename Graph>
+void reorder_rcm(const Graph & g, openfpm::vector<size_t> & new_id)
+{
+	const size_t n = g.getNVertex();
+
+	new_id.resize(n);
+	if (n == 0)	{return;}
+
+	// vertices sorted by degree, the components start from the vertex with minimum degree
+
+	openfpm::vector<size_t> deg;
+	openfpm::vector<size_t> by_deg;
+	deg.resize(n);
+	by_deg.resize(n);
+
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		deg.template get<0>(i) = g.getNChilds(i);
+		by_deg.template get<0>(i) = i;
+	}
+
+	openfpm::vector<size_t> deg_sort;
+	deg_sort.resize(n);
+	for (size_t i = 0 ; i < n ; i++)
+	{deg_sort.template get<0>(i) = deg.template get<0>(i);}
+
+	openfpm::radix_sort_cpu(&deg_sort.template get<0>(0),&by_deg.template get<0>(0),n);
+
+	// mark is used by the searches for the pseudo-peripheral vertex, a vertex is numbered when
+	// visited[v] != 0
+
+	openfpm::vector<size_t> mark;
+	openfpm::vector<unsigned char> visited;
+	mark.resize(n);
+	visited.resize(n);
+
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		mark.template get<0>(i) = 0;
+		visited.template get<0>(i) = 0;
+	}
+
+	openfpm::vector<size_t> queue;
+	openfpm::vector<size_t> order;
+	order.reserve(n);
+
+	std::vector<size_t> childs;
+	size_t stamp = 0;
+
+	for (size_t k = 0 ; k < n ; k++)
+	{
+		size_t r = by_deg.template get<0>(k);
+		if (visited.template get<0>(r) != 0)	{continue;}
+
+		// pseudo-peripheral vertex, the vertex of minimum degree of the last level is tried as
+		// root until the eccentricity stop to grow
+
+		size_t last_level;
+		size_t n_level = graph_level_structure(g,r,mark,++stamp,queue,last_level);
+
+		while (true)
+		{
+			size_t x = queue.template get<0>(last_level);
+			for (size_t i = last_level + 1 ; i < queue.size() ; i++)
+			{
+				size_t c = queue.template get<0>(i);
+				if (deg.template get<0>(c) < deg.template get<0>(x))	{x = c;}
+			}
+
+			size_t x_last_level;
+			size_t x_n_level = graph_level_structure(g,x,mark,++stamp,queue,x_last_level);
+
+			if (x_n_level <= n_level)	{break;}
+
+			r = x;
+			n_level = x_n_level;
+			last_level = x_last_level;
+		}
+
+		// Cuthill-McKee numbering of the component
+
+		size_t head = order.size();
+		order.add(r);
+		visited.template get<0>(r) = 1;
+
+		while (head < order.size())
+		{
+			size_t v = order.template get<0>(head);
+			head++;
+
+			childs.clear();
+			for (size_t j = 0 ; j < g.getNChilds(v) ; j++)
+			{
+				size_t c = g.getChild(v,j);
+
+				if (visited.template get<0>(c) == 0)
+				{
+					visited.template get<0>(c) = 1;
+					childs.push_back(c);
+				}
+			}
+
+			std::stable_sort(childs.begin(),childs.end(),[&](size_t a, size_t b){return deg.template get<0>(a) < deg.template get<0>(b);});
+
+			for (size_t j = 0 ; j < childs.size() ; j++)
+			{order.add(childs[j]);}
+		}
+	}
+
+	for (size_t i = 0 ; i < n ; i++)
+	{new_id.template get<0>(order.template get<0>(i)) = n - 1 - i;}
+}
+
+/*! \brief Morton (z-curve) ordering of a graph whose vertex i is the point gs.InvLinId(i) of a grid
+ *
+ * \tparam dim dimensionality of the grid (up to 3)
+ *
+ * \param g graph
+ * \param gs grid
+ * \param new_id output permutation, new_id[i] is the new id of the vertex i
+ *
+ */
+template<unsigned int dim, typename Graph>
+void reorder_morton(const Graph & g, const grid_sm<dim,void> & gs, openfpm::vector<size_t> & new_id)
+{
+	const size_t n = g.getNVertex();
+
+	new_id.resize(n);
+	if (n == 0)	{return;}
+
+	openfpm::vector<size_t> z;
+	openfpm::vector<size_t> perm;
+	z.resize(n);
+	perm.resize(n);
+
+	const int nth = openfpm::ofp_n_threads(n,GRAPH_REORDER_CPU_GRAIN);
+
+	#pragma omp parallel for num_threads(nth) schedule(static,1)
+	for (int t = 0 ; t < nth ; t++)
+	{
+		size_t start;
+		size_t stop;
+		openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+		for (size_t i = start ; i < stop ; i++)
+		{
+			z.template get<0>(i) = lin_zid(gs.InvLinId(i));
+			perm.template get<0>(i) = i;
+		}
+	}
+
+	openfpm::radix_sort_cpu(&z.template get<0>(0),&perm.template get<0>(0),n);
+
+	#pragma omp parallel for num_threads(nth) schedule(static,1)
+	for (int t = 0 ; t < nth ; t++)
+	{
+		size_t start;
+		size_t stop;
+		openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+		for (size_t i = start ; i < stop ; i++)
+		{new_id.template get<0>(perm.template get<0>(i)) = i;}
+	}
+}
+
+/*! \brief Hilbert ordering of a graph whose vertex i is the point gs.InvLinId(i) of a grid
+ *
+ * The Hilbert curve cover the smallest 2^m cube that contain the grid, the points outside
+ * the grid are skipped
+ *
+ * \param g graph
+ * \param gs grid
+ * \param new_id output permutation, new_id[i] is the new id of the vertex i
+ *
+ */
+template<unsigned int dim, typename Graph>
+void reorder_hilbert(const Graph & g, const grid_sm<dim,void> & gs, openfpm::vector<size_t> & new_id)
+{
+	const size_t n = g.getNVertex();
+
+	new_id.resize(n);
+	if (n == 0)	{return;}
+
+	size_t m = 0;
+	for (size_t i = 0 ; i < dim ; i++)
+	{
+		while (((size_t)1 << m) < gs.size(i))
+		{m++;}
+	}
+
+	grid_key_dx_iterator_hilbert<dim> it(m);
+
+	size_t id = 0;
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		bool inside = true;
+		for (size_t i = 0 ; i < dim ; i++)
+		{inside &= ((size_t)key.get(i) < gs.size(i));}
+
+		if (inside == true)
+		{
+			new_id.template get<0>(gs.LinId(key)) = id;
+			id++;
+		}
+
+		++it;
+	}
+}
+
+/*! \brief Bandwidth of a graph
+ *
+ * \param g graph
+ *
+ * \return the maximum distance between the id of a vertex and the id of one of its adjacent vertices
+ *
+ */
+template<typename Graph>
+size_t graph_bandwidth(const Graph & g)
+{
+	size_t bw = 0;
+
+	for (size_t i = 0 ; i < g.getNVertex() ; i++)
+	{
+		for (size_t j = 0 ; j < g.getNChilds(i) ; j++)
+		{
+			size_t c = g.getChild(i,j);
+			size_t d = (c > i)?c - i:i - c;
+
+			bw = std::max(bw,d);
+		}
+	}
+
+	return bw;
+}
+
+#endif /* GRAPH_REORDER_HPP_ */
@@ -10,6 +10,13 @@
 
 #include "config.h"
 #include "map_graph.hpp"
+#include "Graph_CSR_builder.hpp"
+#include "CartesianGraphFactory.hpp"
+#include "Graph_reorder.hpp"
+#include "Graph_algorithms.hpp"
+#include "graph_util_test.hpp"
+#include "timer.hpp"
+#include <random>
 #include "Point_test.hpp"
 
 BOOST_AUTO_TEST_SUITE( graph_test )
@@ -194,6 +201,549 @@ BOOST_AUTO_TEST_CASE( graph_use)
 	std::cout << "Graph unit test end" << "\n";
 }
 
+/*! \brief Check that two graphs have the same adjacency lists and edge properties
+ *
+ * \param g1 first graph
+ * \param g2 second graph
+ *
+ * \return true if they match
+ *
+ */
+template<typename Graph1, typename Graph2>
+bool graph_same_edges(Graph1 & g1, Graph2 & g2)
+{
+	bool match = (g1.getNVertex() == g2.getNVertex()) && (g1.getNEdge() == g2.getNEdge());
+
+	for (size_t i = 0 ; i < g1.getNVertex() && match == true ; i++)
+	{
+		match &= (g1.getNChilds(i) == g2.getNChilds(i));
+
+		for (size_t j = 0 ; j < g1.getNChilds(i) && match == true ; j++)
+		{
+			match &= (g1.getChild(i,j) == g2.getChild(i,j));
+			match &= (g1.getChildEdge(i,j).template get<0>() == g2.getChildEdge(i,j).template get<0>());
+		}
+	}
+
+	return match;
+}
+
+BOOST_AUTO_TEST_CASE( graph_csr_builder_and_finalize )
+{
+	typedef aggregate<float> V;
+	typedef aggregate<size_t> E;
+
+	const size_t n_v = 2000;
+
+	// graph with skewed degree, the vertex 0 is connected to all the others
+
+	openfpm::vector<size_t> src;
+	openfpm::vector<size_t> dst;
+
+	size_t seed = 1;
+	for (size_t i = 1 ; i < n_v ; i++)
+	{
+		src.add(0);
+		dst.add(i);
+
+		seed = seed * 6364136223846793005ul + 1442695040888963407ul;
+		size_t n_e = (seed >> 33) % 5;
+
+		for (size_t j = 0 ; j < n_e ; j++)
+		{
+			seed = seed * 6364136223846793005ul + 1442695040888963407ul;
+
+			src.add(i);
+			dst.add((seed >> 33) % n_v);
+		}
+	}
+
+	// slotted graph, vertex 0 overflow its slots several times
+
+	Graph_CSR<V,E> g_slot(n_v,4);
+
+	for (size_t i = 0 ; i < src.size() ; i++)
+	{g_slot.addEdge(src.get(i),dst.get(i)).template get<0>() = i;}
+
+	//! [Build a compact graph]
+
+	Graph_CSR<V,E> g(n_v);
+
+	Graph_CSR_builder<Graph_CSR<V,E>> gb;
+	gb.resize(src.size());
+
+	#pragma omp parallel for
+	for (size_t i = 0 ; i < src.size() ; i++)
+	{
+		gb.setEdge(i,src.get(i),dst.get(i));
+		gb.edge(i).template get<0>() = i;
+	}
+
+	gb.build(g);
+
+	//! [Build a compact graph]
+
+	BOOST_REQUIRE_EQUAL(g.isCompact(),true);
+	BOOST_REQUIRE_EQUAL(g.getNChilds(0),n_v - 1);
+	BOOST_REQUIRE_EQUAL(graph_same_edges(g,g_slot),true);
+
+	// finalize the slotted graph
+
+	g_slot.finalize();
+
+	BOOST_REQUIRE_EQUAL(g_slot.isCompact(),true);
+	BOOST_REQUIRE_EQUAL(graph_same_edges(g,g_slot),true);
+
+	// a compact graph can still be modified
+
+	g.addEdge(5,7).template get<0>() = src.size();
+	g.addVertex();
+	g.addEdge(n_v,0).template get<0>() = src.size() + 1;
+
+	BOOST_REQUIRE_EQUAL(g.isCompact(),false);
+	BOOST_REQUIRE_EQUAL(g.getChild(5,g.getNChilds(5)-1),7ul);
+	BOOST_REQUIRE_EQUAL(g.getChild(n_v,0),0ul);
+	BOOST_REQUIRE_EQUAL(g.getChildEdge(n_v,0).template get<0>(),src.size() + 1);
+	BOOST_REQUIRE_EQUAL(g.getNChilds(0),n_v - 1);
+
+	g.finalize();
+
+	Graph_CSR<V,E> g_dup = g.duplicate();
+	BOOST_REQUIRE_EQUAL(graph_same_edges(g,g_dup),true);
+	BOOST_REQUIRE_EQUAL(g_dup.getNEdge(),src.size() + 2);
+}
+
+/*! \brief Construct a cartesian graph adding vertices and edges one by one
+ *
+ * \param sz size of the grid
+ * \param bc boundary conditions
+ * \param dim_c connectivity dimension
+ *
+ * \return the graph
+ *
+ */
+template<typename Graph>
+Graph cartesian_graph_by_edges(const size_t (& sz)[3], const size_t (& bc)[3], size_t dim_c)
+{
+	grid_sm<3,void> g(sz);
+	HyperCube<3> hc;
+
+	Graph gp(g.size());
+
+	grid_key_dx_iterator<3> k_it(g);
+
+	while (k_it.isNext())
+	{
+		auto key = k_it.get();
+
+		for (long int d = 2 ; d >= (long int)dim_c ; d--)
+		{
+			std::vector<comb<3>> c = hc.getCombinations_R(d);
+
+			for (size_t j = 0 ; j < c.size() ; j++)
+			{
+				float ele_sz = 0;
+				for (size_t s = 0 ; s < 3 ; s++)
+					ele_sz += 1.0f / sz[s] * abs(c[j][s]);
+
+				size_t end_v = g.template LinId<CheckExistence>(key,c[j].getComb(),bc);
+				gp.template addEdge<CheckExistence>(g.LinId(key),end_v).template get<0>() = ele_sz;
+			}
+		}
+
+		++k_it;
+	}
+
+	return gp;
+}
+
+BOOST_AUTO_TEST_CASE( cartesian_graph_factory_parallel )
+{
+	typedef aggregate<float[3],size_t> V;
+	typedef aggregate<float> E;
+
+	size_t sz[3] = {50,40,35};
+	Box<3,float> dom({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	size_t bc_np[3] = {NON_PERIODIC,NON_PERIODIC,NON_PERIODIC};
+	size_t bc_p[3] = {PERIODIC,NON_PERIODIC,PERIODIC};
+
+	grid_sm<3,void> g(sz);
+
+	// faces only non periodic, and all the neighborhood with mixed boundary conditions
+
+	for (size_t k = 0 ; k < 2 ; k++)
+	{
+		const size_t (& bc)[3] = (k == 0)?bc_np:bc_p;
+		const size_t dim_c = (k == 0)?2:0;
+
+		Graph_CSR<V,E> gp = (k == 0)?CartesianGraphFactory<3,Graph_CSR<V,E>>::construct<0,1,float,2,0>(sz,dom,bc):
+		                             CartesianGraphFactory<3,Graph_CSR<V,E>>::construct<0,1,float,0,0>(sz,dom,bc);
+
+		Graph_CSR<V,E> gr = cartesian_graph_by_edges<Graph_CSR<V,E>>(sz,bc,dim_c);
+
+		BOOST_REQUIRE_EQUAL(gp.isCompact(),true);
+		BOOST_REQUIRE_EQUAL(graph_same_edges(gp,gr),true);
+
+		bool match = true;
+
+		grid_key_dx_iterator<3> k_it(g);
+
+		while (k_it.isNext())
+		{
+			auto key = k_it.get();
+			size_t id = g.LinId(key);
+
+			match &= (gp.vertex(id).template get<1>() == id);
+
+			for (size_t s = 0 ; s < 3 ; s++)
+			{match &= (gp.vertex(id).template get<0>()[s] == key.get(s) * (1.0f / sz[s]));}
+
+			++k_it;
+		}
+
+		BOOST_REQUIRE_EQUAL(match,true);
+	}
+
+	// no edge properties
+
+	Graph_CSR<V,no_edge> gn = CartesianGraphFactory<3,Graph_CSR<V,no_edge>>::construct<NO_EDGE,NO_VERTEX_ID,float,2>(sz,dom,bc_np);
+
+	BOOST_REQUIRE_EQUAL(gn.getNVertex(),g.size());
+	BOOST_REQUIRE_EQUAL(gn.getNChilds(0),3ul);
+	BOOST_REQUIRE_EQUAL(gn.getNChilds(g.LinId(grid_key_dx<3>(1,1,1))),6ul);
+}
+
+/*! \brief Check that g is the graph g_ref renumbered, vertex property 1 store the original id
+ *
+ * \param g graph
+ * \param g_ref original graph
+ *
+ * \return true if every vertex has the same adjacent vertices and edges of the original one
+ *
+ */
+template<typename Graph>
+bool graph_renumbered(Graph & g, Graph & g_ref)
+{
+	if (g.getNVertex() != g_ref.getNVertex() || g.getNEdge() != g_ref.getNEdge())	{return false;}
+
+	for (size_t i = 0 ; i < g.getNVertex() ; i++)
+	{
+		size_t o = g.vertex(i).template get<1>();
+
+		if (g.getNChilds(i) != g_ref.getNChilds(o))	{return false;}
+
+		for (size_t j = 0 ; j < g.getNChilds(i) ; j++)
+		{
+			if (g.vertex(g.getChild(i,j)).template get<1>() != g_ref.getChild(o,j))	{return false;}
+			if (g.getChildEdge(i,j).template get<0>() != g_ref.getChildEdge(o,j).template get<0>())	{return false;}
+		}
+	}
+
+	return true;
+}
+
+BOOST_AUTO_TEST_CASE( graph_reorder_bandwidth )
+{
+	typedef aggregate<float[3],size_t> V;
+	typedef aggregate<float> E;
+
+	size_t sz[3] = {40,40,40};
+	size_t bc[3] = {NON_PERIODIC,NON_PERIODIC,NON_PERIODIC};
+	Box<3,float> dom({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	grid_sm<3,void> gs(sz);
+
+	Graph_CSR<V,E> g_ref = CartesianGraphFactory<3,Graph_CSR<V,E>>::construct<NO_EDGE,1,float,2,0>(sz,dom,bc);
+
+	// every edge get a different property
+
+	for (size_t i = 0 ; i < g_ref.getNVertex() ; i++)
+	{
+		for (size_t j = 0 ; j < g_ref.getNChilds(i) ; j++)
+		{g_ref.getChildEdge(i,j).template get<0>() = (float)(i % 1000) + 0.001f * (g_ref.getChild(i,j) % 1000);}
+	}
+
+	// Shuffle the vertices
+
+	std::vector<size_t> rnd(gs.size());
+	for (size_t i = 0 ; i < rnd.size() ; i++)	{rnd[i] = i;}
+
+	std::mt19937 gen(17);
+	std::shuffle(rnd.begin(),rnd.end(),gen);
+
+	openfpm::vector<size_t> new_id;
+	new_id.resize(gs.size());
+	for (size_t i = 0 ; i < rnd.size() ; i++)	{new_id.template get<0>(i) = rnd[i];}
+
+	Graph_CSR<V,E> g_sh = g_ref.duplicate();
+	g_sh.reorder(new_id);
+
+	BOOST_REQUIRE_EQUAL(g_sh.isCompact(),true);
+	BOOST_REQUIRE_EQUAL(graph_renumbered(g_sh,g_ref),true);
+
+	size_t bw_sh = graph_bandwidth(g_sh);
+
+	openfpm::vector<float> out_sh;
+	graph_traverse(g_sh,out_sh);
+
+	//! [Reorder a graph]
+
+	Graph_CSR<V,E> g_rcm = g_sh.duplicate();
+
+	// calculate the permutation and renumber the vertices
+	openfpm::vector<size_t> rcm_id;
+	reorder_rcm(g_rcm,rcm_id);
+	g_rcm.reorder(rcm_id);
+
+	//! [Reorder a graph]
+
+	// Morton and Hilbert are calculated on the original numbering of the vertices (grid points)
+
+	openfpm::vector<size_t> mrt_id;
+	openfpm::vector<size_t> hlb_id;
+	reorder_morton(g_ref,gs,mrt_id);
+	reorder_hilbert(g_ref,gs,hlb_id);
+
+	Graph_CSR<V,E> g_mrt = g_ref.duplicate();
+	Graph_CSR<V,E> g_hlb = g_ref.duplicate();
+	g_mrt.reorder(mrt_id);
+	g_hlb.reorder(hlb_id);
+
+	Graph_CSR<V,E> * gr[3] = {&g_rcm,&g_mrt,&g_hlb};
+	openfpm::vector<size_t> * ids[3] = {&rcm_id,&mrt_id,&hlb_id};
+
+	for (size_t k = 0 ; k < 3 ; k++)
+	{
+		// it must be a permutation
+
+		std::vector<bool> used(gs.size(),false);
+		bool perm = true;
+		for (size_t i = 0 ; i < ids[k]->size() ; i++)
+		{
+			size_t id = ids[k]->template get<0>(i);
+			perm &= (id < gs.size() && used[id] == false);
+			if (id < gs.size())	{used[id] = true;}
+		}
+
+		BOOST_REQUIRE_EQUAL(perm,true);
+		BOOST_REQUIRE_EQUAL(graph_renumbered(*gr[k],g_ref),true);
+		BOOST_REQUIRE(graph_bandwidth(*gr[k]) < bw_sh);
+	}
+
+	// the first vertices of a space filling curve are neighbours on the grid
+
+	size_t o0 = g_hlb.vertex(0).template get<1>();
+	size_t o1 = g_hlb.vertex(1).template get<1>();
+	size_t dist = 0;
+	for (size_t s = 0 ; s < 3 ; s++)
+	{dist += abs((long int)gs.InvLinId(o0).get(s) - (long int)gs.InvLinId(o1).get(s));}
+	BOOST_REQUIRE_EQUAL(dist,1ul);
+
+	// The traversal give the same result per vertex
+
+	openfpm::vector<float> out_rcm;
+	graph_traverse(g_rcm,out_rcm);
+
+	bool match = true;
+	for (size_t i = 0 ; i < gs.size() ; i++)
+	{match &= (out_rcm.template get<0>(rcm_id.template get<0>(i)) == out_sh.template get<0>(i));}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE( graph_parallel_bfs )
+{
+	typedef aggregate<float[3],size_t,long int> V;
+
+	size_t sz[3] = {30,25,20};
+	size_t bc[3] = {NON_PERIODIC,NON_PERIODIC,NON_PERIODIC};
+	Box<3,float> dom({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	grid_sm<3,void> gs(sz);
+
+	// faces connectivity, the distance from the corner is the Manhattan distance, with the full
+	// neighborhood the distance from the center is the Chebyshev distance
+
+	Graph_CSR<V,no_edge> gf = CartesianGraphFactory<3,Graph_CSR<V,no_edge>>::construct<NO_EDGE,1,float,2,0>(sz,dom,bc);
+	Graph_CSR<V,no_edge> gc = CartesianGraphFactory<3,Graph_CSR<V,no_edge>>::construct<NO_EDGE,1,float,0,0>(sz,dom,bc);
+
+	grid_key_dx<3> center;
+	center.set_d(0,15);
+	center.set_d(1,12);
+	center.set_d(2,10);
+
+	size_t n_lf = graph_bfs<2>(gf,0);
+	size_t n_lc = graph_bfs<2>(gc,gs.LinId(center));
+
+	BOOST_REQUIRE_EQUAL(n_lf,29ul + 24ul + 19ul + 1ul);
+	BOOST_REQUIRE_EQUAL(n_lc,16ul);
+
+	bool match = true;
+
+	grid_key_dx_iterator<3> it(gs);
+	while (it.isNext())
+	{
+		auto key = it.get();
+		size_t id = gs.LinId(key);
+
+		long int d_f = key.get(0) + key.get(1) + key.get(2);
+		long int d_c = 0;
+		for (size_t s = 0 ; s < 3 ; s++)
+		{d_c = std::max(d_c,(long int)abs(key.get(s) - center.get(s)));}
+
+		match &= (gf.vertex(id).template get<2>() == d_f);
+		match &= (gc.vertex(id).template get<2>() == d_c);
+
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// unreachable vertices
+
+	Graph_CSR<V,no_edge> gu(10);
+	Graph_CSR_builder<Graph_CSR<V,no_edge>> b;
+
+	for (size_t i = 0 ; i < 4 ; i++)
+	{
+		b.addEdge(i,i+1);
+		b.addEdge(i+1,i);
+	}
+	b.build(gu);
+
+	BOOST_REQUIRE_EQUAL(graph_bfs<2>(gu,2),3ul);
+	BOOST_REQUIRE_EQUAL(gu.vertex(0).template get<2>(),2);
+	BOOST_REQUIRE_EQUAL(gu.vertex(4).template get<2>(),2);
+	BOOST_REQUIRE_EQUAL(gu.vertex(5).template get<2>(),-1);
+}
+
+/*! \brief Find the root of a vertex in a union-find structure
+ *
+ * \param p parent of each vertex
+ * \param v vertex
+ *
+ * \return the root
+ *
+ */
+static inline size_t uf_find(std::vector<size_t> & p, size_t v)
+{
+	while (p[v] != v)
+	{
+		p[v] = p[p[v]];
+		v = p[v];
+	}
+
+	return v;
+}
+
+BOOST_AUTO_TEST_CASE( graph_parallel_connected_components )
+{
+	typedef aggregate<float[3],size_t,size_t> V;
+
+	size_t sz[3] = {40,30,20};
+	grid_sm<3,void> gs(sz);
+
+	// face connected grid cut by the plane x = 10 (between 9 and 10), and holes where
+	// (x + 2*y + 3*z) % 7 == 0 that split it further
+
+	auto hole = [&](const grid_key_dx<3> & k)
+	{return (k.get(0) + 2*k.get(1) + 3*k.get(2)) % 7 == 0;};
+
+	Graph_CSR<V,no_edge> g(gs.size());
+	Graph_CSR_builder<Graph_CSR<V,no_edge>> b;
+
+	std::vector<size_t> p(gs.size());
+	for (size_t i = 0 ; i < p.size() ; i++)	{p[i] = i;}
+
+	grid_key_dx_iterator<3> it(gs);
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		for (size_t s = 0 ; s < 3 ; s++)
+		{
+			grid_key_dx<3> nk = key;
+			nk.set_d(s,key.get(s) + 1);
+
+			if ((size_t)nk.get(s) >= sz[s])	{continue;}
+			if (s == 0 && key.get(0) == 9)	{continue;}
+			if (hole(key) || hole(nk))	{continue;}
+
+			size_t a = gs.LinId(key);
+			size_t c = gs.LinId(nk);
+
+			b.addEdge(a,c);
+			b.addEdge(c,a);
+
+			p[uf_find(p,a)] = uf_find(p,c);
+		}
+
+		++it;
+	}
+
+	b.build(g);
+
+	size_t n_ref = 0;
+	for (size_t i = 0 ; i < p.size() ; i++)
+	{n_ref += (uf_find(p,i) == i);}
+
+	size_t n_comp = graph_connected_components<2>(g);
+
+	BOOST_REQUIRE_EQUAL(n_comp,n_ref);
+
+	// same component if and only if same label, the label is the minimum id of the component
+
+	std::vector<size_t> min_id(gs.size(),(size_t)-1);
+	for (size_t i = 0 ; i < gs.size() ; i++)
+	{min_id[uf_find(p,i)] = std::min(min_id[uf_find(p,i)],i);}
+
+	bool match = true;
+	for (size_t i = 0 ; i < gs.size() ; i++)
+	{match &= (g.vertex(i).template get<2>() == min_id[uf_find(p,i)]);}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE( graph_parallel_coloring )
+{
+	typedef aggregate<float[3],size_t,int> V;
+
+	size_t sz[3] = {30,30,30};
+	size_t bc[3] = {PERIODIC,NON_PERIODIC,NON_PERIODIC};
+	Box<3,float> dom({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	for (size_t dim_c = 0 ; dim_c <= 2 ; dim_c += 2)
+	{
+		//! [Color a graph]
+
+		Graph_CSR<V,no_edge> g = (dim_c == 0)?CartesianGraphFactory<3,Graph_CSR<V,no_edge>>::construct<NO_EDGE,1,float,0,0>(sz,dom,bc):
+		                                      CartesianGraphFactory<3,Graph_CSR<V,no_edge>>::construct<NO_EDGE,1,float,2,0>(sz,dom,bc);
+
+		// the color of each vertex is written in the property 2
+		size_t n_color = graph_coloring<2>(g);
+
+		//! [Color a graph]
+
+		size_t max_deg = 0;
+		bool valid = true;
+
+		for (size_t i = 0 ; i < g.getNVertex() ; i++)
+		{
+			max_deg = std::max(max_deg,g.getNChilds(i));
+
+			int c = g.vertex(i).template get<2>();
+			valid &= (c >= 0 && (size_t)c < n_color);
+
+			for (size_t j = 0 ; j < g.getNChilds(i) ; j++)
+			{valid &= (g.vertex(g.getChild(i,j)).template get<2>() != c);}
+		}
+
+		BOOST_REQUIRE_EQUAL(valid,true);
+		BOOST_REQUIRE(n_color <= max_deg + 1);
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
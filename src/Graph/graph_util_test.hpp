@@ -0,0 +1,57 @@
+/*
+ * graph_util_test.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef SRC_GRAPH_GRAPH_UTIL_TEST_HPP_
+#define SRC_GRAPH_GRAPH_UTIL_TEST_HPP_
+
+#include "map_graph.hpp"
+#include "CartesianGraphFactory.hpp"
+
+/*! \brief Graph of a cartesian grid n x n x n in the unit cube (non periodic)
+ *
+ * \tparam se edge property that store the contact surface (NO_EDGE for none)
+ * \tparam dim_c connectivity dimension
+ *
+ * \param n points on each direction
+ *
+ * \return the graph, vertex property 0 is the position, property 1 the vertex id
+ *
+ */
+template<int se, unsigned int dim_c, typename V, typename E>
+Graph_CSR<V,E> graph_cartesian_cube(size_t n)
+{
+	size_t sz[3] = {n,n,n};
+	size_t bc[3] = {NON_PERIODIC,NON_PERIODIC,NON_PERIODIC};
+	Box<3,float> dom({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	return CartesianGraphFactory<3,Graph_CSR<V,E>>::template construct<se,1,float,dim_c,0>(sz,dom,bc);
+}
+
+/*! \brief Traverse the graph summing for each vertex the property of the adjacent vertices
+ *  weighted by the edge property
+ *
+ * \param g graph
+ * \param out result for each vertex
+ *
+ */
+template<typename Graph>
+void graph_traverse(Graph & g, openfpm::vector<float> & out)
+{
+	out.resize(g.getNVertex());
+
+	for (size_t i = 0 ; i < g.getNVertex() ; i++)
+	{
+		float sum = 0.0;
+
+		for (size_t j = 0 ; j < g.getNChilds(i) ; j++)
+		{sum += g.getChildEdge(i,j).template get<0>() * g.vertex(g.getChild(i,j)).template get<0>()[0];}
+
+		out.template get<0>(i) = sum;
+	}
+}
+
+#endif /* SRC_GRAPH_GRAPH_UTIL_TEST_HPP_ */
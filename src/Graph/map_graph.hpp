@@ -38,12 +38,23 @@
  *
  *  Vertex properties and edge properties are stored in a separate structure
  *
+ *  Compact form
+ *
+ *  After finalize() (or when the graph is created by Graph_CSR_builder) the slots are removed, the
+ *  neighborhood of the vertex i start at a position stored for each vertex, for the example above
+ *
+ *  Vertex start 0 3 4 6 8
+ *  Edge list    2 3 4 1 4 1 1 3
+ *
+ *  Adding vertex or edges to a compact graph convert it back to the slotted form
+ *
  */
 
 #ifndef MAP_GRAPH_HPP_
 #define MAP_GRAPH_HPP_
 
 #include "Vector/map_vector.hpp"
+#include "util/multi_thread_util.hpp"
 #include <unordered_map>
 #ifdef METIS_GP
 #include "metis_util.hpp"
@@ -51,6 +62,9 @@
 
 #define NO_EDGE -1
 
+//! Under this number of vertices the conversions between slotted and compact form run on one thread
+#define GRAPH_CSR_CPU_GRAIN 4096
+
 /*! \brief class with no edge
  *
  */
@@ -80,6 +94,9 @@ template<typename V, typename E,
 		 typename grow_p>
 class Graph_CSR;
 
+template<typename Graph>
+class Graph_CSR_builder;
+
 /*! \brief Structure used inside GraphCSR an edge
  *
  * For each vertex the first number "vid" store the target node, the second number store
@@ -321,6 +338,146 @@ class Graph_CSR
 	//! invalid edge element, when a function try to create an in valid edge this object is returned
 	openfpm::vector<E, Memory, layout_e_base, grow_p, openfpm::vect_isel<E>::value> e_invalid;
 
+	//! In compact form, for each vertex the start of its adjacency list in e_l (plus the total number of edges at the end), empty in slotted form
+	openfpm::vector<size_t, Memory, layout_v_base,grow_p, openfpm::vect_isel<size_t>::value> v_s;
+
+	template<typename Graph> friend class Graph_CSR_builder;
+
+	/*! \brief Return the position in e_l of the adjacent vertex i of the vertex v1
+	 *
+	 * \param v1 vertex
+	 * \param i adjacent vertex id
+	 *
+	 * \return the position in e_l
+	 *
+	 */
+	inline size_t adj_id(size_t v1, size_t i) const
+	{
+		return (v_s.size() != 0)?v_s.template get<0>(v1) + i:v1 * v_slot + i;
+	}
+
+	/*! \brief Increase the number of slots of a slotted graph
+	 *
+	 * The adjacency lists are moved in place starting from the last vertex
+	 *
+	 * \param n_slot new number of slots (bigger than v_slot)
+	 *
+	 */
+	void reslot(size_t n_slot)
+	{
+		e_l.resize(v.size() * n_slot);
+
+		for (long int i = (long int)v.size() - 1 ; i >= 0 ; i--)
+		{
+			for (long int j = (long int)v_l.template get<0>(i) - 1 ; j >= 0 ; j--)
+			{
+				e_l.template get<e_map::vid>(i * n_slot + j) = e_l.template get<e_map::vid>(i * v_slot + j);
+				e_l.template get<e_map::eid>(i * n_slot + j) = e_l.template get<e_map::eid>(i * v_slot + j);
+			}
+		}
+
+		v_slot = n_slot;
+	}
+
+	/*! \brief Convert a compact graph back to the slotted form
+	 *
+	 * The number of slots is the maximum between v_slot and the maximum number of adjacent vertices
+	 *
+	 */
+	void to_slotted()
+	{
+		size_t n_slot = v_slot;
+
+		for (size_t i = 0 ; i < v.size() ; i++)
+		{n_slot = std::max(n_slot,(size_t)v_l.template get<0>(i));}
+
+		if (n_slot == 0)	{n_slot = 1;}
+
+		decltype(e_l) e_l_new;
+		e_l_new.resize(v.size() * n_slot);
+
+		const size_t n = v.size();
+		const int nth = openfpm::ofp_n_threads(n,GRAPH_CSR_CPU_GRAIN);
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+			for (size_t i = start ; i < stop ; i++)
+			{
+				size_t s = v_s.template get<0>(i);
+
+				for (size_t j = 0 ; j < v_l.template get<0>(i) ; j++)
+				{
+					e_l_new.template get<e_map::vid>(i * n_slot + j) = e_l.template get<e_map::vid>(s + j);
+					e_l_new.template get<e_map::eid>(i * n_slot + j) = e_l.template get<e_map::eid>(s + j);
+				}
+			}
+		}
+
+		e_l.swap(e_l_new);
+		v_s.clear();
+		v_slot = n_slot;
+	}
+
+	/*! \brief Calculate v_s (compact form) from the number of adjacent vertices of each vertex (v_l)
+	 *
+	 * \return the total number of edges
+	 *
+	 */
+	size_t scan_v_s()
+	{
+		const size_t n = v.size();
+		const int nth = openfpm::ofp_n_threads(n,GRAPH_CSR_CPU_GRAIN);
+
+		v_s.resize(n + 1);
+
+		std::vector<size_t> th_off(nth + 1,0);
+
+		// number of edges of each thread range
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+			size_t tot = 0;
+			for (size_t i = start ; i < stop ; i++)
+			{tot += v_l.template get<0>(i);}
+
+			th_off[t+1] = tot;
+		}
+
+		for (int t = 0 ; t < nth ; t++)
+		{th_off[t+1] += th_off[t];}
+
+		// start of each vertex
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+			size_t off = th_off[t];
+			for (size_t i = start ; i < stop ; i++)
+			{
+				v_s.template get<0>(i) = off;
+				off += v_l.template get<0>(i);
+			}
+		}
+
+		v_s.template get<0>(n) = th_off[nth];
+
+		return th_off[nth];
+	}
+
 	/*! \brief add edge on the graph
 	 *
 	 * add edge on the graph
@@ -340,6 +497,10 @@ class Graph_CSR
 		if (CheckPolicy::valid(v2, v.size()) == false)
 			return (size_t)NO_EDGE;
 
+		// a compact graph has no free slots
+		if (isCompact() == true)
+			to_slotted();
+
 		// get the number of adjacent vertex
 		size_t id_x_end = v_l.template get<0>(v1);
 
@@ -355,7 +516,7 @@ class Graph_CSR
 
 		for (size_t s = 0; s < id_x_end; s++)
 		{
-			if (e_l.template get<e_map::vid>(v1 * v_slot + s) == v2)
+			if (e_l.template get<e_map::vid>(adj_id(v1,s)) == v2)
 			{
 				std::cerr << "Error graph: the edge already exist" << std::endl;
 			}
@@ -369,22 +530,7 @@ class Graph_CSR
 			// Unfortunately there is not space we need to reallocate memory
 			// Reallocate with double slot
 
-			// Create an new Graph
-
-			Graph_CSR<V, E> g_new(2 * v_slot, v.size());
-
-			// Copy the graph
-
-			for (size_t i = 0; i < v.size(); i++)
-			{
-				// copy the property from the old graph
-
-				g_new.v.set(i, v, 2 * i);
-			}
-
-			// swap the new graph with the old one
-
-			swap(g_new);
+			reslot((v_slot == 0)?1:2 * v_slot);
 		}
 
 		// Here we are sure than v and e has enough slots to store a new edge
@@ -446,6 +592,7 @@ public:
 		ret &= (v_l == g.v_l);
 		ret &= (e == g.e);
 		ret &= (e_l == g.e_l);
+		ret &= (v_s == g.v_s);
 
 		return ret;
 	}
@@ -469,6 +616,7 @@ public:
 		dup.e.swap(e.duplicate());
 		dup.e_l.swap(e_l.duplicate());
 		dup.e_invalid.swap(e_invalid.duplicate());
+		dup.v_s.swap(v_s.duplicate());
 
 		return dup;
 	}
@@ -672,6 +820,7 @@ public:
 		v_l.clear();
 		e_l.clear();
 		e_invalid.clear();
+		v_s.clear();
 	}
 
 
@@ -692,6 +841,8 @@ public:
 		e_l.shrink_to_fit();
 		e_invalid.clear();
 		e_invalid.shrink_to_fit();
+		v_s.clear();
+		v_s.shrink_to_fit();
 	}
 
 	/*! \brief Access the edge
@@ -730,7 +881,7 @@ public:
 	 */
 	auto edge(edge_key ek) const -> const decltype ( e.get(0) )
 	{
-		return e.get(e_l.template get<e_map::eid>(ek.pos * v_slot + ek.pos_e));
+		return e.get(e_l.template get<e_map::eid>(adj_id(ek.pos,ek.pos_e)));
 	}
 
 	/*! \brief operator to access the edge
@@ -797,7 +948,7 @@ public:
 	inline auto getChildEdge(size_t v, size_t v_e) -> decltype(e.get(0))
 	{
 		// Get the edge id
-		return e.get(e_l.template get<e_map::eid>(v * v_slot + v_e));
+		return e.get(e_l.template get<e_map::eid>(adj_id(v,v_e)));
 	}
 
 	/*! \brief Get the child vertex id
@@ -823,7 +974,7 @@ public:
 		}
 #endif
 		// Get the target vertex id
-		return e_l.template get<e_map::vid>(v * v_slot + i);
+		return e_l.template get<e_map::vid>(adj_id(v,i));
 	}
 
 	/*! \brief Get the child edge
@@ -842,14 +993,14 @@ public:
 			std::cerr << "Error " << __FILE__ << " line: " << __LINE__ << "    vertex " << v.get() << " does not have edge " << i << std::endl;
 		}
 
-		if (e.size() <= e_l.template get<e_map::eid>(v.get() * v_slot + i))
+		if (e.size() <= e_l.template get<e_map::eid>(adj_id(v.get(),i)))
 		{
 			std::cerr << "Error " << __FILE__ << " " << __LINE__ << " vertex " << v.get() << " does not have edge "<< i << std::endl;
 		}
 #endif
 
 		// Get the edge id
-		return e_l.template get<e_map::vid>(v.get() * v_slot + i);
+		return e_l.template get<e_map::vid>(adj_id(v.get(),i));
 	}
 
 	/*! \brief add vertex
@@ -859,6 +1010,8 @@ public:
 	 */
 	inline void addVertex(const V & vrt)
 	{
+		if (isCompact() == true)
+			to_slotted();
 
 		v.add(vrt);
 
@@ -876,6 +1029,8 @@ public:
 	 */
 	inline void addVertex()
 	{
+		if (isCompact() == true)
+			to_slotted();
 
 		v.add();
 
@@ -982,6 +1137,7 @@ public:
 		v_l.swap(g.v_l);
 		e_l.swap(g.e_l);
 		e_invalid.swap(g.e_invalid);
+		v_s.swap(g.v_s);
 
 		size_t v_slot_tmp = g.v_slot;
 		g.v_slot = v_slot;
@@ -1004,6 +1160,7 @@ public:
 		v_l.swap(g.v_l);
 		e_l.swap(g.e_l);
 		e_invalid.swap(g.e_invalid);
+		v_s.swap(g.v_s);
 
 		size_t v_slot_tmp = g.v_slot;
 		g.v_slot = v_slot;
@@ -1057,6 +1214,230 @@ public:
 	{
 		return e.size();
 	}
+
+	/*! \brief Return the memory allocated and used by the graph
+	 *
+	 * In slotted form the empty slots of the adjacency lists are wasted memory
+	 *
+	 * \return the memory usage
+	 *
+	 */
+	mem_usage getMemoryUsage() const
+	{
+		mem_usage m_el = e_l.getMemoryUsage();
+		m_el.used = std::min(m_el.used,e.size()*sizeof(e_map));
+
+		mem_usage m_inv = e_invalid.getMemoryUsage();
+		m_inv.used = 0;
+
+		return v.getMemoryUsage() + v_l.getMemoryUsage() + e.getMemoryUsage() + m_el + m_inv + v_s.getMemoryUsage();
+	}
+
+	/*! \brief Allocate the adjacency lists in compact form
+	 *
+	 * All the existing edges are removed. The vertex v will have n_child(v) adjacent vertices, that
+	 * must be set with setChild, and the edge properties are allocated (default constructed). It is used by
+	 * the generators that know the number of edges of every vertex in advance
+	 *
+	 * \param n_child functor that return the number of adjacent vertices of a vertex (called concurrently)
+	 *
+	 */
+	template<typename n_child_type>
+	void allocateCompact(n_child_type n_child)
+	{
+		const size_t n = v.size();
+		const int nth = openfpm::ofp_n_threads(n,GRAPH_CSR_CPU_GRAIN);
+
+		v_l.resize(n);
+
+		// number of edges of each vertex
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+			for (size_t i = start ; i < stop ; i++)
+			{v_l.template get<0>(i) = n_child(i);}
+		}
+
+		size_t tot = scan_v_s();
+
+		e_l.resize(tot);
+		e.clear();
+		e.resize(tot);
+	}
+
+	/*! \brief Set the adjacent vertex i of the vertex v1 of a graph allocated with allocateCompact
+	 *
+	 * The edge id is the position of the adjacent vertex in the adjacency lists. Different
+	 * vertices can be set concurrently
+	 *
+	 * \param v1 vertex
+	 * \param i adjacent vertex id
+	 * \param v2 adjacent vertex
+	 *
+	 */
+	inline void setChild(size_t v1, size_t i, size_t v2)
+	{
+		size_t id = adj_id(v1,i);
+
+		e_l.template get<e_map::vid>(id) = v2;
+		e_l.template get<e_map::eid>(id) = id;
+	}
+
+	/*! \brief Return true if the graph is in compact form
+	 *
+	 * \return true if the graph is compact
+	 *
+	 */
+	inline bool isCompact() const
+	{
+		return v_s.size() != 0;
+	}
+
+	/*! \brief Convert the graph in compact form
+	 *
+	 * The free slots of every vertex are removed, the adjacency list of each vertex start where the one of
+	 * the previous vertex end. The graph can still be modified, adding a vertex or an edge convert it back
+	 * to the slotted form
+	 *
+	 */
+	void finalize()
+	{
+		if (isCompact() == true)	{return;}
+
+		const size_t n = v.size();
+
+		size_t tot = scan_v_s();
+
+		decltype(e_l) e_l_new;
+		e_l_new.resize(tot);
+
+		const int nth = openfpm::ofp_n_threads(n,GRAPH_CSR_CPU_GRAIN);
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+			for (size_t i = start ; i < stop ; i++)
+			{
+				size_t s = v_s.template get<0>(i);
+
+				for (size_t j = 0 ; j < v_l.template get<0>(i) ; j++)
+				{
+					e_l_new.template get<e_map::vid>(s + j) = e_l.template get<e_map::vid>(i * v_slot + j);
+					e_l_new.template get<e_map::eid>(s + j) = e_l.template get<e_map::eid>(i * v_slot + j);
+				}
+			}
+		}
+
+		e_l.swap(e_l_new);
+	}
+
+	/*! \brief Renumber the vertices of the graph
+	 *
+	 * The vertex i become the vertex new_id[i], vertex properties and adjacency lists are
+	 * moved accordingly and the edge properties are stored in the order of the new adjacency lists,
+	 * so that a traversal of the reordered graph access both sequentially. The order of the adjacent
+	 * vertices of each vertex is preserved. The graph is left in compact form.
+	 *
+	 * Properties that store vertex ids are not touched
+	 *
+	 * \see Graph_reorder.hpp to calculate new_id
+	 *
+	 * \param new_id permutation of the vertices (new_id[i] is the new id of the vertex i)
+	 *
+	 */
+	void reorder(const openfpm::vector<size_t> & new_id)
+	{
+		const size_t n = v.size();
+
+#ifdef SE_CLASS1
+
+		if (new_id.size() != n)
+		{
+			std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the permutation has " << new_id.size() << " elements but the graph has " << n << " vertices" << std::endl;
+			return;
+		}
+
+#endif
+
+		const int nth = openfpm::ofp_n_threads(n,GRAPH_CSR_CPU_GRAIN);
+
+		openfpm::vector<size_t> old_id;
+		old_id.resize(n);
+
+		decltype(v_l) v_l_old;
+		v_l_old.swap(v_l);
+		v_l.resize(n);
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+			for (size_t i = start ; i < stop ; i++)
+			{
+				size_t ni = new_id.template get<0>(i);
+
+				old_id.template get<0>(ni) = i;
+				v_l.template get<0>(ni) = v_l_old.template get<0>(i);
+			}
+		}
+
+		// adjacency lists of the old graph
+
+		decltype(v_s) v_s_old;
+		v_s_old.swap(v_s);
+		size_t slot_old = v_slot;
+
+		size_t tot = scan_v_s();
+
+		decltype(v) v_new;
+		decltype(e) e_new;
+		decltype(e_l) e_l_new;
+
+		v_new.resize(n);
+		e_new.resize(tot);
+		e_l_new.resize(tot);
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+			for (size_t i = start ; i < stop ; i++)
+			{
+				size_t oi = old_id.template get<0>(i);
+				size_t s_old = (v_s_old.size() != 0)?v_s_old.template get<0>(oi):oi * slot_old;
+				size_t s = v_s.template get<0>(i);
+
+				v_new.set(i,v,oi);
+
+				for (size_t j = 0 ; j < v_l.template get<0>(i) ; j++)
+				{
+					e_l_new.template get<e_map::vid>(s + j) = new_id.template get<0>(e_l.template get<e_map::vid>(s_old + j));
+					e_l_new.template get<e_map::eid>(s + j) = s + j;
+
+					e_new.set(s + j,e,e_l.template get<e_map::eid>(s_old + j));
+				}
+			}
+		}
+
+		v.swap(v_new);
+		e.swap(e_new);
+		e_l.swap(e_l_new);
+	}
 };
 
 /*! \brief Simplified implementation of Graph_CSR
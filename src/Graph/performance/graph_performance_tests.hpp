@@ -0,0 +1,181 @@
+/*
+ * graph_performance_tests.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef OPENFPM_DATA_SRC_GRAPH_PERFORMANCE_GRAPH_PERFORMANCE_TESTS_HPP_
+#define OPENFPM_DATA_SRC_GRAPH_PERFORMANCE_GRAPH_PERFORMANCE_TESTS_HPP_
+
+#include <random>
+#include "Graph/Graph_reorder.hpp"
+#include "Graph/Graph_algorithms.hpp"
+#include "util/multi_thread_util.hpp"
+#include "Graph/graph_util_test.hpp"
+#include "util/performance/benchmark_store.hpp"
+
+/*! \brief CPU performance of the graph algorithms on the graph of a cartesian grid
+ *
+ * * graph_reorder: RCM and Hilbert renumbering of the vertices
+ * * graph_traverse: traversal of the adjacency of all the vertices with different vertex orderings
+ * * graph_bandwidth: bandwidth of the adjacency matrix for each ordering
+ * * graph_bfs, graph_cc, graph_coloring: parallel BFS, connected components and coloring from one thread
+ *   up to the maximum number of threads
+ *
+ * The measures are appended to graph_performance_funcs.jsonl and checked for regressions against
+ * $OPENFPM_PERFORMANCE_TEST_DIR/openfpm_data/graph_performance_funcs_ref.jsonl
+ *
+ */
+
+//! Number of repetitions for each measure
+constexpr int N_STAT_GRAPH = 5;
+
+//! All the samples of the measures
+benchmark_store graph_perf_store;
+
+BOOST_AUTO_TEST_SUITE( graph_performance )
+
+BOOST_AUTO_TEST_CASE(graph_performance_reorder_traversal)
+{
+	typedef aggregate<float[3],size_t> V;
+	typedef aggregate<float> E;
+
+	const size_t n = 80;
+	size_t sz[3] = {n,n,n};
+	grid_sm<3,void> gs(sz);
+
+	Graph_CSR<V,E> g = graph_cartesian_cube<0,0,V,E>(n);
+
+	std::vector<size_t> rnd(gs.size());
+	for (size_t i = 0 ; i < rnd.size() ; i++)	{rnd[i] = i;}
+
+	std::mt19937 gen(17);
+	std::shuffle(rnd.begin(),rnd.end(),gen);
+
+	openfpm::vector<size_t> sh_id;
+	sh_id.resize(gs.size());
+	for (size_t i = 0 ; i < rnd.size() ; i++)	{sh_id.template get<0>(i) = rnd[i];}
+
+	Graph_CSR<V,E> g_sh = g.duplicate();
+	g_sh.reorder(sh_id);
+
+	Graph_CSR<V,E> g_rcm;
+	Graph_CSR<V,E> g_hlb;
+
+	std::vector<double> t_rcm;
+	std::vector<double> t_hlb;
+
+	for (size_t k = 0 ; k < N_STAT_GRAPH ; k++)
+	{
+		g_rcm = g_sh.duplicate();
+		g_hlb = g.duplicate();
+
+		timer t;
+		t.start();
+		openfpm::vector<size_t> rcm_id;
+		reorder_rcm(g_rcm,rcm_id);
+		g_rcm.reorder(rcm_id);
+		t.stop();
+		t_rcm.push_back(t.getwct());
+
+		t.start();
+		openfpm::vector<size_t> hlb_id;
+		reorder_hilbert(g_hlb,gs,hlb_id);
+		g_hlb.reorder(hlb_id);
+		t.stop();
+		t_hlb.push_back(t.getwct());
+	}
+
+	graph_perf_store.add("graph_reorder",{{"order","RCM"},{"n_vertex",std::to_string(gs.size())}},t_rcm);
+	graph_perf_store.add("graph_reorder",{{"order","Hilbert"},{"n_vertex",std::to_string(gs.size())}},t_hlb);
+
+	const char * name[4] = {"lexicographic","shuffled","RCM","Hilbert"};
+	Graph_CSR<V,E> * gr[4] = {&g,&g_sh,&g_rcm,&g_hlb};
+	openfpm::vector<float> out;
+
+	for (size_t k = 0 ; k < 4 ; k++)
+	{
+		// warm up
+
+		graph_traverse(*gr[k],out);
+
+		std::vector<double> times;
+
+		for (size_t r = 0 ; r < N_STAT_GRAPH ; r++)
+		{
+			timer t;
+			t.start();
+			graph_traverse(*gr[k],out);
+			t.stop();
+
+			times.push_back(t.getwct());
+		}
+
+		graph_perf_store.add("graph_traverse",{{"order",name[k]},{"n_vertex",std::to_string(gs.size())}},times);
+		graph_perf_store.add("graph_bandwidth",{{"order",name[k]},{"n_vertex",std::to_string(gs.size())}},std::vector<double>({(double)graph_bandwidth(*gr[k])}),"vertices");
+	}
+}
+
+BOOST_AUTO_TEST_CASE(graph_performance_parallel_algorithms)
+{
+	typedef aggregate<float[3],size_t,long int> V;
+
+	const size_t n = 100;
+	Graph_CSR<V,no_edge> g = graph_cartesian_cube<NO_EDGE,2,V,no_edge>(n);
+
+	const int max_th = openfpm::ofp_max_threads();
+
+	for (int nt = 1 ; nt <= max_th ; nt = (nt == max_th)?max_th + 1:std::min(2*nt,max_th))
+	{
+#ifdef HAVE_OPENMP
+		omp_set_num_threads(nt);
+#endif
+
+		std::vector<double> t_bfs;
+		std::vector<double> t_cc;
+		std::vector<double> t_col;
+
+		for (size_t k = 0 ; k < N_STAT_GRAPH ; k++)
+		{
+			timer t;
+			t.start();
+			graph_bfs<2>(g,0);
+			t.stop();
+			t_bfs.push_back(t.getwct());
+
+			t.start();
+			graph_connected_components<2>(g);
+			t.stop();
+			t_cc.push_back(t.getwct());
+
+			t.start();
+			graph_coloring<2>(g);
+			t.stop();
+			t_col.push_back(t.getwct());
+		}
+
+		std::map<std::string,std::string> prm = {{"n_vertex",std::to_string(g.getNVertex())},{"threads",std::to_string(nt)}};
+
+		graph_perf_store.add("graph_bfs",prm,t_bfs);
+		graph_perf_store.add("graph_cc",prm,t_cc);
+		graph_perf_store.add("graph_coloring",prm,t_col);
+	}
+
+#ifdef HAVE_OPENMP
+	omp_set_num_threads(max_th);
+#endif
+}
+
+/////// THIS IS NOT A TEST IT WRITE THE PERFORMANCE RESULT ///////
+
+BOOST_AUTO_TEST_CASE(graph_performance_write_report)
+{
+	size_t n_reg = benchmark_write_and_check(graph_perf_store,"graph_performance_funcs",std::string(test_dir) + "/openfpm_data");
+
+	BOOST_REQUIRE_EQUAL(n_reg,0ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif /* OPENFPM_DATA_SRC_GRAPH_PERFORMANCE_GRAPH_PERFORMANCE_TESTS_HPP_ */
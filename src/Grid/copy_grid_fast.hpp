@@ -9,6 +9,10 @@
 #define OPENFPM_DATA_SRC_GRID_COPY_GRID_FAST_HPP_
 
 #include "Grid/iterators/grid_key_dx_iterator.hpp"
+#include "util/multi_thread_util.hpp"
+
+//! Under this number of elements packing and unpacking a sub-grid run on a single thread
+#define GRID_PACK_CPU_GRAIN 32768
 
 template<unsigned int dim>
 struct striding
@@ -747,34 +751,37 @@ struct pack_with_iterator<true,3,grid,encap_src,encap_dst,boost_vct,it,dtype,prp
 	 */
 	static void pack(grid & gr, it & sub_it, dtype & dest)
 	{
-		size_t id = 0;
-
-		size_t lin_src = 0;
-
 		auto & gs_src = gr.getGrid();
 		grid_key_dx<3> start = sub_it.getStart();
 		grid_key_dx<3> stop = sub_it.getStop();
 
-		lin_src += start.get(2) * gs_src.size_s(1);
+		if (stop.get(0) < start.get(0) || stop.get(1) < start.get(1) || stop.get(2) < start.get(2))
+		{return;}
+
+		const size_t nx = stop.get(0) - start.get(0) + 1;
+		const size_t ny = stop.get(1) - start.get(1) + 1;
+		const size_t nz = stop.get(2) - start.get(2) + 1;
+
+		const int nth = openfpm::ofp_n_threads(nx*ny*nz,GRID_PACK_CPU_GRAIN);
+
+		// every z slice is packed at the offset (i - start(2))*nx*ny
+		#pragma omp parallel for num_threads(nth) schedule(static)
 		for (long int i = start.get(2) ; i <= stop.get(2) ; i++)
 		{
-			lin_src += start.get(1) * gs_src.size_s(0);
+			size_t id = (i - start.get(2))*nx*ny;
+			size_t lin_src = i * gs_src.size_s(1) + start.get(1) * gs_src.size_s(0) + start.get(0);
+
 			for (long int j = start.get(1) ; j <= stop.get(1) ; j++)
 			{
-				lin_src += start.get(0);
-				for (long int k = start.get(0) ; k <= stop.get(0) ; k++)
+				for (size_t k = 0 ; k < nx ; k++)
 				{
 					// Copy only the selected properties
-					object_si_d<encap_src,encap_dst,OBJ_ENCAP,prp...>(gr.get_o(lin_src),dest.get(id));
+					object_si_d<encap_src,encap_dst,OBJ_ENCAP,prp...>(gr.get_o(lin_src + k),dest.get(id));
 
 					++id;
-					++lin_src;
 				}
-				lin_src -= stop.get(0) + 1;
 				lin_src += gs_src.size_s(0);
 			}
-			lin_src -= (stop.get(1) + 1)*gs_src.size_s(0);
-			lin_src += gs_src.size_s(1);
 		}
 	}
 };
@@ -805,30 +812,33 @@ struct pack_with_iterator<true,2,grid,encap_src,encap_dst,boost_vct,it,dtype,prp
 	 */
 	static void pack(grid & gr, it & sub_it, dtype & dest)
 	{
-		size_t id = 0;
-
-		size_t lin_src = 0;
-
 		auto & gs_src = gr.getGrid();
 		grid_key_dx<2> start = sub_it.getStart();
 		grid_key_dx<2> stop = sub_it.getStop();
 
-		lin_src += start.get(1) * gs_src.size_s(0);
+		if (stop.get(0) < start.get(0) || stop.get(1) < start.get(1))
+		{return;}
+
+		const size_t nx = stop.get(0) - start.get(0) + 1;
+		const size_t ny = stop.get(1) - start.get(1) + 1;
+
+		const int nth = openfpm::ofp_n_threads(nx*ny,GRID_PACK_CPU_GRAIN);
+
+		// every row is packed at the offset (j - start(1))*nx
+		#pragma omp parallel for num_threads(nth) schedule(static)
 		for (long int j = start.get(1) ; j <= stop.get(1) ; j++)
 		{
-			lin_src += start.get(0);
-			for (long int k = start.get(0) ; k <= stop.get(0) ; k++)
+			size_t id = (j - start.get(1))*nx;
+			size_t lin_src = j * gs_src.size_s(0) + start.get(0);
+
+			for (size_t k = 0 ; k < nx ; k++)
 			{
 				// Copy only the selected properties
-				object_si_d<encap_src,encap_dst,OBJ_ENCAP,prp...>(gr.get_o(lin_src),dest.get(id));
+				object_si_d<encap_src,encap_dst,OBJ_ENCAP,prp...>(gr.get_o(lin_src + k),dest.get(id));
 
 				++id;
-				++lin_src;
 			}
-			lin_src -= stop.get(0) + 1;
-			lin_src += gs_src.size_s(0);
 		}
-
 	}
 };
 
@@ -860,12 +870,12 @@ struct pack_with_iterator_longx<2,obj_byte,git,grid>
 	{
 		size_t tot_y = sub_it.getStop().get(1) - sub_it.getStart().get(1) + 1;
 
+		const int nth = openfpm::ofp_n_threads(tot_y*n_cpy,GRID_PACK_CPU_GRAIN);
+
+		#pragma omp parallel for num_threads(nth) schedule(static)
 		for (size_t i = 0 ; i < tot_y ; i++)
 		{
-			memcpy(ptr_dest,ptr,n_cpy * obj_byte);
-
-			ptr += stride_x;
-			ptr_dest += n_cpy * obj_byte;
+			memcpy(ptr_dest + i*n_cpy*obj_byte,ptr + i*stride_x,n_cpy * obj_byte);
 		}
 	}
 };
@@ -893,16 +903,22 @@ struct pack_with_iterator_longx<3,obj_byte,git,grid>
 
 		size_t stride_y = ptr_final - ptr_start;
 
+		const int nth = openfpm::ofp_n_threads(tot_z*tot_y*n_cpy,GRID_PACK_CPU_GRAIN);
+
+		// every z slice is copied at the offset i*tot_y*n_cpy
+		#pragma omp parallel for num_threads(nth) schedule(static)
 		for (size_t i = 0 ; i < tot_z ; i++)
 		{
-			for (size_t i = 0 ; i < tot_y ; i++)
+			unsigned char * ptr_s = ptr + i*stride_y;
+			unsigned char * ptr_dest_s = ptr_dest + i*tot_y*n_cpy*obj_byte;
+
+			for (size_t j = 0 ; j < tot_y ; j++)
 			{
-				memcpy(ptr_dest,ptr,n_cpy * obj_byte);
+				memcpy(ptr_dest_s,ptr_s,n_cpy * obj_byte);
 
-				ptr += stride_x;
-				ptr_dest += n_cpy * obj_byte;
+				ptr_s += stride_x;
+				ptr_dest_s += n_cpy * obj_byte;
 			}
-			ptr += stride_y - tot_y*stride_x;
 		}
 	}
 };
@@ -935,12 +951,12 @@ struct pack_with_iterator_shortx<2,n_cpy,obj_byte,git,grid>
 	{
 		size_t tot_y = sub_it.getStop().get(1) - sub_it.getStart().get(1) + 1;
 
+		const int nth = openfpm::ofp_n_threads(tot_y*n_cpy,GRID_PACK_CPU_GRAIN);
+
+		#pragma omp parallel for num_threads(nth) schedule(static)
 		for (size_t i = 0 ; i < tot_y ; i++)
 		{
-			__builtin_memcpy(ptr_dest,ptr,n_cpy * obj_byte);
-
-			ptr += stride_x;
-			ptr_dest += n_cpy * obj_byte;
+			__builtin_memcpy(ptr_dest + i*n_cpy*obj_byte,ptr + i*stride_x,n_cpy * obj_byte);
 		}
 	}
 };
@@ -967,16 +983,22 @@ struct pack_with_iterator_shortx<3,n_cpy,obj_byte,git,grid>
 
 		size_t stride_y = ptr_final - ptr_start;
 
+		const int nth = openfpm::ofp_n_threads(tot_z*tot_y*n_cpy,GRID_PACK_CPU_GRAIN);
+
+		// every z slice is copied at the offset i*tot_y*n_cpy
+		#pragma omp parallel for num_threads(nth) schedule(static)
 		for (size_t i = 0 ; i < tot_z ; i++)
 		{
-			for (size_t i = 0 ; i < tot_y ; i++)
+			unsigned char * ptr_s = ptr + i*stride_y;
+			unsigned char * ptr_dest_s = ptr_dest + i*tot_y*n_cpy*obj_byte;
+
+			for (size_t j = 0 ; j < tot_y ; j++)
 			{
-				__builtin_memcpy(ptr_dest,ptr,n_cpy * obj_byte);
+				__builtin_memcpy(ptr_dest_s,ptr_s,n_cpy * obj_byte);
 
-				ptr += stride_x;
-				ptr_dest += n_cpy * obj_byte;
+				ptr_s += stride_x;
+				ptr_dest_s += n_cpy * obj_byte;
 			}
-			ptr += stride_y - tot_y*stride_x;
 		}
 	}
 };
@@ -1242,36 +1264,100 @@ struct unpack_with_iterator<3,grid,
 	 */
 	static void unpack(grid & gr, it & sub_it, stype & src)
 	{
-		size_t id = 0;
-
-		size_t lin_dst = 0;
-
 		auto & gs_dst = gr.getGrid();
 		grid_key_dx<3> start = sub_it.getStart();
 		grid_key_dx<3> stop = sub_it.getStop();
 
-		// unpacking the information
+		if (stop.get(0) < start.get(0) || stop.get(1) < start.get(1) || stop.get(2) < start.get(2))
+		{return;}
+
+		const size_t nx = stop.get(0) - start.get(0) + 1;
+		const size_t ny = stop.get(1) - start.get(1) + 1;
+		const size_t nz = stop.get(2) - start.get(2) + 1;
+
+		const int nth = openfpm::ofp_n_threads(nx*ny*nz,GRID_PACK_CPU_GRAIN);
+
+		// unpacking the information, every z slice is read from the offset (i - start(2))*nx*ny
 
-		lin_dst += start.get(2) * gs_dst.size_s(1);
+		#pragma omp parallel for num_threads(nth) schedule(static)
 		for (long int i = start.get(2) ; i <= stop.get(2) ; i++)
 		{
-			lin_dst += start.get(1) * gs_dst.size_s(0);
+			size_t id = (i - start.get(2))*nx*ny;
+			size_t lin_dst = i * gs_dst.size_s(1) + start.get(1) * gs_dst.size_s(0) + start.get(0);
+
 			for (long int j = start.get(1) ; j <= stop.get(1) ; j++)
 			{
-				lin_dst += start.get(0);
-				for (long int k = start.get(0) ; k <= stop.get(0) ; k++)
+				for (size_t k = 0 ; k < nx ; k++)
 				{
 					// Copy only the selected properties
-					object_s_di<encap_src,encap_dst,OBJ_ENCAP,prp...>(src.get(id),gr.get_o(lin_dst));
+					object_s_di<encap_src,encap_dst,OBJ_ENCAP,prp...>(src.get(id),gr.get_o(lin_dst + k));
 
 					++id;
-					++lin_dst;
 				}
-				lin_dst -= stop.get(0) + 1;
 				lin_dst += gs_dst.size_s(0);
 			}
-			lin_dst -= (stop.get(1) + 1)*gs_dst.size_s(0);
-			lin_dst += gs_dst.size_s(1);
+		}
+	}
+};
+
+/*! \brief Unpack a vector like structure B into a 2D grid given an iterator of the grid
+ *
+ * \tparam it type of iterator of the grid-structure
+ * \tparam stype type of the structure B
+ * \tparam properties to unpack
+ *
+ */
+template <typename grid,
+          typename encap_src,
+		  typename encap_dst,
+		  typename boost_vct,
+		  typename it,
+		  typename stype,
+		  int ... prp>
+struct unpack_with_iterator<2,grid,
+							encap_src,
+							encap_dst,
+							boost_vct,
+							it,
+							stype,
+							prp ...>
+{
+	/*! \brief Unpack a vector like structure B into a 2D grid given an iterator of the grid
+	 *
+	 * \param gr grid where to unpack
+	 * \param sub_it Grid iterator
+	 * \param src from where to unpack
+	 *
+	 */
+	static void unpack(grid & gr, it & sub_it, stype & src)
+	{
+		auto & gs_dst = gr.getGrid();
+		grid_key_dx<2> start = sub_it.getStart();
+		grid_key_dx<2> stop = sub_it.getStop();
+
+		if (stop.get(0) < start.get(0) || stop.get(1) < start.get(1))
+		{return;}
+
+		const size_t nx = stop.get(0) - start.get(0) + 1;
+		const size_t ny = stop.get(1) - start.get(1) + 1;
+
+		const int nth = openfpm::ofp_n_threads(nx*ny,GRID_PACK_CPU_GRAIN);
+
+		// unpacking the information, every row is read from the offset (j - start(1))*nx
+
+		#pragma omp parallel for num_threads(nth) schedule(static)
+		for (long int j = start.get(1) ; j <= stop.get(1) ; j++)
+		{
+			size_t id = (j - start.get(1))*nx;
+			size_t lin_dst = j * gs_dst.size_s(0) + start.get(0);
+
+			for (size_t k = 0 ; k < nx ; k++)
+			{
+				// Copy only the selected properties
+				object_s_di<encap_src,encap_dst,OBJ_ENCAP,prp...>(src.get(id),gr.get_o(lin_dst + k));
+
+				++id;
+			}
 		}
 	}
 };
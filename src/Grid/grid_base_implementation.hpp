@@ -13,6 +13,8 @@
 #include "cuda/cuda_grid_gpu_funcs.cuh"
 #include "util/create_vmpl_sequence.hpp"
 #include "util/object_si_di.hpp"
+#include "util/performance/perf_counters.hpp"
+#include "util/mem_usage.hpp"
 
 constexpr int DATA_ON_HOST = 32;
 constexpr int DATA_ON_DEVICE = 64;
@@ -341,6 +343,8 @@ struct copy_grid_fast_caller<index_tuple_sq<prp ...>>
 	template<typename grid_type>
 	static void call(grid_type & gd, const grid_type & gs, const Box<grid_type::dims,size_t> & box_src, const Box<grid_type::dims,size_t> & box_dst)
 	{
+        OFP_PERF_REGION("copy_grid_fast");
+
         grid_key_dx<grid_type::dims> cnt[1];
         cnt[0].zero();
 
@@ -1332,6 +1336,8 @@ public:
 			     const Box<dim,size_t> & box_src,
 				 const Box<dim,size_t> & box_dst)
 	{
+        OFP_PERF_REGION("copy_grid_fast");
+
         typedef typename std::remove_reference<decltype(grid_src)>::type grid_cp;
         typedef typename std::remove_reference<decltype(grid_src.getGrid())>::type grid_info_cp;
 
@@ -1719,6 +1725,22 @@ public:
 		return g1.size();
 	}
 
+	/*! \brief Return the memory allocated and used by the grid
+	 *
+	 * A grid use all the memory it allocate, memory set externally (setMemory with
+	 * a user memory) is not counted because it is owned by the caller
+	 *
+	 * \return the memory usage
+	 *
+	 */
+	mem_usage getMemoryUsage() const
+	{
+		if (is_mem_init == false || isExternal == true)
+		{return mem_usage();}
+
+		return mem_usage(g1.size()*sizeof(T),g1.size()*sizeof(T));
+	}
+
 	/*! \brief Return a sub-grid iterator
 	 *
 	 * Return a sub-grid iterator, to iterate through the grid
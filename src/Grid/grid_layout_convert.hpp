@@ -0,0 +1,816 @@
+/*
+ * grid_layout_convert.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef GRID_LAYOUT_CONVERT_HPP_
+#define GRID_LAYOUT_CONVERT_HPP_
+
+#include <type_traits>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <boost/mpl/range_c.hpp>
+#include <boost/mpl/at.hpp>
+#include "util/for_each_ref.hpp"
+#include "util/multi_thread_util.hpp"
+#include "util/copy_compare/copy_general.hpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//! Number of elements converted together, the source and destination block stay in cache while all the properties are copied
+#define LAYOUT_CONVERT_BLOCK 256
+
+//! Minimum number of elements for a thread
+#define LAYOUT_CONVERT_GRAIN 32768
+
+//! Number of elements of a tile of the in-place transposition (layout_transpose_inplace)
+#define LAYOUT_CONVERT_TILE 64
+
+/*! \brief Map the property k of the source in the property of the destination (identity if prp is empty)
+ *
+ */
+template<unsigned int k, unsigned int ... prp>
+struct layout_convert_map
+{
+	static const unsigned int value = k;
+};
+
+template<unsigned int k, unsigned int p1, unsigned int ... prp>
+struct layout_convert_map<k,p1,prp...>
+{
+	static const unsigned int value = boost::mpl::at<boost::mpl::vector_c<unsigned int,p1,prp...>,boost::mpl::int_<k>>::type::value;
+};
+
+/*! \brief A property can be converted by blocks if it is an arithmetic type or an array (up to two dimensions) of it
+ *
+ */
+template<typename prop>
+struct layout_convert_block_ok
+{
+	static const bool value = std::rank<prop>::value <= 2 && std::is_arithmetic<typename std::remove_all_extents<prop>::type>::value;
+};
+
+/*! \brief Check that all the selected properties can be converted by blocks (same type in source and destination)
+ *
+ * \tparam T_dst type of the destination element
+ * \tparam T_src type of the source element
+ * \tparam prp destination property for each source property (empty means identity)
+ *
+ */
+template<typename T_dst, typename T_src, unsigned int ... prp>
+struct layout_convert_ok
+{
+	template<unsigned int k, bool is_last = (k == 0)>
+	struct check
+	{
+		typedef typename boost::mpl::at<typename T_src::type,boost::mpl::int_<k-1>>::type prop_src;
+		typedef typename boost::mpl::at<typename T_dst::type,boost::mpl::int_<layout_convert_map<k-1,prp...>::value>>::type prop_dst;
+
+		static const bool value = layout_convert_block_ok<prop_src>::value && std::is_same<prop_src,prop_dst>::value && check<k-1>::value;
+	};
+
+	template<unsigned int k>
+	struct check<k,true>
+	{
+		static const bool value = true;
+	};
+
+	static const unsigned int n_prp = (sizeof...(prp) == 0)?T_src::max_prop:sizeof...(prp);
+
+	static const bool value = check<n_prp>::value;
+};
+
+/*! \brief Address of the component c of the property p of an element (scalar property)
+ *
+ */
+template<unsigned int rank>
+struct layout_convert_addr
+{
+	template<unsigned int p, typename prop, typename grid_type, typename key_type>
+	static inline auto get(grid_type & g, const key_type & key, size_t c) -> decltype(&g.template get<p>(key))
+	{
+		return &g.template get<p>(key);
+	}
+};
+
+/*! \brief Address of the component c of the property p of an element (one dimensional array property)
+ *
+ */
+template<>
+struct layout_convert_addr<1>
+{
+	template<unsigned int p, typename prop, typename grid_type, typename key_type>
+	static inline auto get(grid_type & g, const key_type & key, size_t c) -> decltype(&g.template get<p>(key)[c])
+	{
+		return &g.template get<p>(key)[c];
+	}
+};
+
+/*! \brief Address of the component c of the property p of an element (two dimensional array property)
+ *
+ */
+template<>
+struct layout_convert_addr<2>
+{
+	template<unsigned int p, typename prop, typename grid_type, typename key_type>
+	static inline auto get(grid_type & g, const key_type & key, size_t c) -> decltype(&g.template get<p>(key)[0][0])
+	{
+		return &g.template get<p>(key)[c / std::extent<prop,1>::value][c % std::extent<prop,1>::value];
+	}
+};
+
+/*! \brief One component of a property seen as a strided array of scalars
+ *
+ * In a linear (AoS) layout the stride is the size of the element, in an interleaved (SoA) layout the
+ * size of the scalar. The stride is measured on the first two elements so it does not depend on the layout
+ *
+ */
+template<typename S>
+struct layout_convert_stream
+{
+	//! first element
+	char * base;
+
+	//! stride in byte
+	size_t stride;
+
+	/*! \brief Get the component of the element i
+	 *
+	 * \param i element
+	 *
+	 * \return the scalar
+	 *
+	 */
+	inline S & get(size_t i) const
+	{
+		return *(S *)(base + i*stride);
+	}
+};
+
+/*! \brief Create the stream of the component c of the property p
+ *
+ * \param g grid
+ * \param c component
+ *
+ * \return the stream
+ *
+ */
+template<unsigned int p, typename prop, typename S, typename grid_type>
+layout_convert_stream<S> layout_convert_get_stream(grid_type & g, size_t c)
+{
+	layout_convert_stream<S> st;
+
+	auto key0 = g.getGrid().InvLinId(0);
+	st.base = (char *)layout_convert_addr<std::rank<prop>::value>::template get<p,prop>(g,key0,c);
+	st.stride = 0;
+
+	if (g.getGrid().size() >= 2)
+	{
+		auto key1 = g.getGrid().InvLinId(1);
+		st.stride = (char *)layout_convert_addr<std::rank<prop>::value>::template get<p,prop>(g,key1,c) - st.base;
+	}
+
+	return st;
+}
+
+/*! \brief Convert the selected properties of a block of elements with the operation op (used for the
+ *         operations different from replace_)
+ *
+ * \tparam op operation (replace_ for a copy, add_ ...)
+ * \tparam grid_dst destination grid
+ * \tparam grid_src source grid
+ * \tparam prp destination property for each source property (empty means identity)
+ *
+ */
+template<template<typename,typename> class op, typename grid_dst, typename grid_src, unsigned int ... prp>
+struct layout_convert_block
+{
+	//! destination
+	grid_dst & dst;
+
+	//! source
+	const grid_src & src;
+
+	//! element of the destination that receive the first element of the source
+	size_t dst_start;
+
+	//! first source element
+	size_t src_start;
+
+	//! first element of the block (from the first source element)
+	size_t start;
+
+	//! one past the last element of the block
+	size_t stop;
+
+	/*! \brief Constructor
+	 *
+	 */
+	layout_convert_block(grid_dst & dst, const grid_src & src, size_t dst_start, size_t src_start, size_t start, size_t stop)
+	:dst(dst),src(src),dst_start(dst_start),src_start(src_start),start(start),stop(stop)
+	{}
+
+	//! Convert the property T::value
+	template<typename T>
+	inline void operator()(T& t) const
+	{
+		typedef typename boost::mpl::at<typename grid_src::value_type::type,boost::mpl::int_<T::value>>::type prop;
+		typedef typename std::remove_all_extents<prop>::type S;
+
+		const unsigned int pd = layout_convert_map<T::value,prp...>::value;
+		const size_t n_cmp = sizeof(prop) / sizeof(S);
+
+		for (size_t c = 0 ; c < n_cmp ; c++)
+		{
+			layout_convert_stream<S> sd = layout_convert_get_stream<pd,prop,S>(dst,c);
+			layout_convert_stream<S> ss = layout_convert_get_stream<T::value,prop,S>(const_cast<grid_src &>(src),c);
+
+			// the interleaved side is contiguous, it let the compiler vectorize the loop
+			if (sd.stride == sizeof(S))
+			{
+				S * d = &sd.get(dst_start);
+				for (size_t i = start ; i < stop ; i++)
+				{op<S,S>::operation(d[i],ss.get(src_start + i));}
+			}
+			else if (ss.stride == sizeof(S))
+			{
+				const S * s = &ss.get(src_start);
+				for (size_t i = start ; i < stop ; i++)
+				{op<S,S>::operation(sd.get(dst_start + i),s[i]);}
+			}
+			else
+			{
+				for (size_t i = start ; i < stop ; i++)
+				{op<S,S>::operation(sd.get(dst_start + i),ss.get(src_start + i));}
+			}
+		}
+	}
+};
+
+/*! \brief One scalar component of a property in the destination and in the source, the copy is done on the bits
+ *
+ */
+struct layout_convert_word
+{
+	//! component of the destination element 0
+	char * d;
+
+	//! destination stride in byte
+	size_t d_stride;
+
+	//! component of the source element 0
+	const char * s;
+
+	//! source stride in byte
+	size_t s_stride;
+
+	//! size of the scalar
+	unsigned int size;
+};
+
+//! How a group of words is copied
+enum layout_convert_kind
+{
+	//! one word, strided copy
+	LC_WORD = 0,
+
+	//! 4 consecutive words of 4 byte of a linear element into 4 interleaved arrays (4x4 transposition)
+	LC_LIN_INTE_4 = 1,
+
+	//! 4 interleaved arrays of 4 byte words into 4 consecutive words of a linear element (4x4 transposition)
+	LC_INTE_LIN_4 = 2,
+
+	//! 2 consecutive words of 8 byte of a linear element into 2 interleaved arrays (2x2 transposition)
+	LC_LIN_INTE_8 = 3,
+
+	//! 2 interleaved arrays of 8 byte words into 2 consecutive words of a linear element (2x2 transposition)
+	LC_INTE_LIN_8 = 4
+};
+
+/*! \brief Group of words copied together
+ *
+ */
+struct layout_convert_group
+{
+	//! kind of copy
+	layout_convert_kind kind;
+
+	//! first word of the group
+	size_t w;
+};
+
+/*! \brief Collect the words of the selected properties
+ *
+ * \tparam prp destination property for each source property (empty means identity)
+ *
+ */
+template<typename grid_dst, typename grid_src, unsigned int ... prp>
+struct layout_convert_collect
+{
+	//! destination
+	grid_dst & dst;
+
+	//! source
+	const grid_src & src;
+
+	//! collected words
+	std::vector<layout_convert_word> & words;
+
+	/*! \brief Constructor
+	 *
+	 */
+	layout_convert_collect(grid_dst & dst, const grid_src & src, std::vector<layout_convert_word> & words)
+	:dst(dst),src(src),words(words)
+	{}
+
+	//! Collect the components of the property T::value
+	template<typename T>
+	inline void operator()(T& t) const
+	{
+		typedef typename boost::mpl::at<typename grid_src::value_type::type,boost::mpl::int_<T::value>>::type prop;
+		typedef typename std::remove_all_extents<prop>::type S;
+
+		const unsigned int pd = layout_convert_map<T::value,prp...>::value;
+		const size_t n_cmp = sizeof(prop) / sizeof(S);
+
+		for (size_t c = 0 ; c < n_cmp ; c++)
+		{
+			layout_convert_stream<S> sd = layout_convert_get_stream<pd,prop,S>(dst,c);
+			layout_convert_stream<S> ss = layout_convert_get_stream<T::value,prop,S>(const_cast<grid_src &>(src),c);
+
+			layout_convert_word w;
+			w.d = sd.base;
+			w.d_stride = sd.stride;
+			w.s = ss.base;
+			w.s_stride = ss.stride;
+			w.size = sizeof(S);
+
+			words.push_back(w);
+		}
+	}
+};
+
+/*! \brief Check if the words [w,w+k) are k consecutive words of a linear element on one side, and k interleaved
+ *         arrays on the other side
+ *
+ * \param words words
+ * \param w first word
+ * \param k number of words
+ * \param size size of the words
+ * \param lin_src true if the linear side is the source
+ *
+ * \return true if the words can be transposed together
+ *
+ */
+static inline bool layout_convert_is_tile(const std::vector<layout_convert_word> & words, size_t w, size_t k, unsigned int size, bool lin_src)
+{
+	if (w + k > words.size())	{return false;}
+
+	for (size_t q = 0 ; q < k ; q++)
+	{
+		const layout_convert_word & wq = words[w+q];
+		const layout_convert_word & w0 = words[w];
+
+		if (wq.size != size)	{return false;}
+
+		if (lin_src == true)
+		{
+			if (wq.s != w0.s + q*size || wq.s_stride != w0.s_stride || wq.s_stride == size || wq.d_stride != size)
+			{return false;}
+		}
+		else
+		{
+			if (wq.d != w0.d + q*size || wq.d_stride != w0.d_stride || wq.d_stride == size || wq.s_stride != size)
+			{return false;}
+		}
+	}
+
+	return true;
+}
+
+/*! \brief Group the words in transpositions where possible
+ *
+ * \param words words
+ * \param groups groups
+ *
+ */
+static inline void layout_convert_make_groups(const std::vector<layout_convert_word> & words, std::vector<layout_convert_group> & groups)
+{
+	size_t w = 0;
+	while (w < words.size())
+	{
+		layout_convert_group g;
+		g.w = w;
+
+		if (layout_convert_is_tile(words,w,4,4,true) == true)
+		{g.kind = LC_LIN_INTE_4; w += 4;}
+		else if (layout_convert_is_tile(words,w,4,4,false) == true)
+		{g.kind = LC_INTE_LIN_4; w += 4;}
+		else if (layout_convert_is_tile(words,w,2,8,true) == true)
+		{g.kind = LC_LIN_INTE_8; w += 2;}
+		else if (layout_convert_is_tile(words,w,2,8,false) == true)
+		{g.kind = LC_INTE_LIN_8; w += 2;}
+		else
+		{g.kind = LC_WORD; w += 1;}
+
+		groups.push_back(g);
+	}
+}
+
+/*! \brief Strided copy of a word for the elements [start,stop)
+ *
+ */
+template<typename U>
+static inline void layout_convert_copy_word(const layout_convert_word & w, size_t d0, size_t s0, size_t start, size_t stop)
+{
+	char * d = w.d + (d0 + start)*w.d_stride;
+	const char * s = w.s + (s0 + start)*w.s_stride;
+
+	// both contiguous
+	if (w.d_stride == sizeof(U) && w.s_stride == sizeof(U))
+	{
+		memcpy(d,s,(stop - start)*sizeof(U));
+		return;
+	}
+
+	for (size_t i = start ; i < stop ; i++)
+	{
+		U tmp;
+		memcpy(&tmp,s,sizeof(U));
+		memcpy(d,&tmp,sizeof(U));
+
+		d += w.d_stride;
+		s += w.s_stride;
+	}
+}
+
+/*! \brief 4x4 transpositions of 4 byte words for the elements [start,stop)
+ *
+ * \param w the 4 words
+ * \param lin_src true if the source is the linear side
+ *
+ */
+static inline void layout_convert_transpose_4(const layout_convert_word * w, bool lin_src, size_t d0, size_t s0, size_t start, size_t stop)
+{
+	size_t i = start;
+
+#ifdef __SSE2__
+
+	if (lin_src == true)
+	{
+		const size_t ss = w[0].s_stride;
+
+		for ( ; i + 4 <= stop ; i += 4)
+		{
+			// row q = the 4 words of the element i+q
+			__m128 r0 = _mm_loadu_ps((const float *)(w[0].s + (s0+i)*ss));
+			__m128 r1 = _mm_loadu_ps((const float *)(w[0].s + (s0+i+1)*ss));
+			__m128 r2 = _mm_loadu_ps((const float *)(w[0].s + (s0+i+2)*ss));
+			__m128 r3 = _mm_loadu_ps((const float *)(w[0].s + (s0+i+3)*ss));
+
+			_MM_TRANSPOSE4_PS(r0,r1,r2,r3);
+
+			_mm_storeu_ps((float *)(w[0].d + (d0+i)*4),r0);
+			_mm_storeu_ps((float *)(w[1].d + (d0+i)*4),r1);
+			_mm_storeu_ps((float *)(w[2].d + (d0+i)*4),r2);
+			_mm_storeu_ps((float *)(w[3].d + (d0+i)*4),r3);
+		}
+	}
+	else
+	{
+		const size_t ds = w[0].d_stride;
+
+		for ( ; i + 4 <= stop ; i += 4)
+		{
+			// row q = the word q of the elements i..i+3
+			__m128 r0 = _mm_loadu_ps((const float *)(w[0].s + (s0+i)*4));
+			__m128 r1 = _mm_loadu_ps((const float *)(w[1].s + (s0+i)*4));
+			__m128 r2 = _mm_loadu_ps((const float *)(w[2].s + (s0+i)*4));
+			__m128 r3 = _mm_loadu_ps((const float *)(w[3].s + (s0+i)*4));
+
+			_MM_TRANSPOSE4_PS(r0,r1,r2,r3);
+
+			_mm_storeu_ps((float *)(w[0].d + (d0+i)*ds),r0);
+			_mm_storeu_ps((float *)(w[0].d + (d0+i+1)*ds),r1);
+			_mm_storeu_ps((float *)(w[0].d + (d0+i+2)*ds),r2);
+			_mm_storeu_ps((float *)(w[0].d + (d0+i+3)*ds),r3);
+		}
+	}
+
+#endif
+
+	// remaining elements
+	for (size_t q = 0 ; q < 4 ; q++)
+	{layout_convert_copy_word<uint32_t>(w[q],d0,s0,i,stop);}
+}
+
+/*! \brief 2x2 transpositions of 8 byte words for the elements [start,stop)
+ *
+ * \param w the 2 words
+ * \param lin_src true if the source is the linear side
+ *
+ */
+static inline void layout_convert_transpose_8(const layout_convert_word * w, bool lin_src, size_t d0, size_t s0, size_t start, size_t stop)
+{
+	size_t i = start;
+
+#ifdef __SSE2__
+
+	if (lin_src == true)
+	{
+		const size_t ss = w[0].s_stride;
+
+		for ( ; i + 2 <= stop ; i += 2)
+		{
+			__m128d r0 = _mm_loadu_pd((const double *)(w[0].s + (s0+i)*ss));
+			__m128d r1 = _mm_loadu_pd((const double *)(w[0].s + (s0+i+1)*ss));
+
+			_mm_storeu_pd((double *)(w[0].d + (d0+i)*8),_mm_unpacklo_pd(r0,r1));
+			_mm_storeu_pd((double *)(w[1].d + (d0+i)*8),_mm_unpackhi_pd(r0,r1));
+		}
+	}
+	else
+	{
+		const size_t ds = w[0].d_stride;
+
+		for ( ; i + 2 <= stop ; i += 2)
+		{
+			__m128d r0 = _mm_loadu_pd((const double *)(w[0].s + (s0+i)*8));
+			__m128d r1 = _mm_loadu_pd((const double *)(w[1].s + (s0+i)*8));
+
+			_mm_storeu_pd((double *)(w[0].d + (d0+i)*ds),_mm_unpacklo_pd(r0,r1));
+			_mm_storeu_pd((double *)(w[0].d + (d0+i+1)*ds),_mm_unpackhi_pd(r0,r1));
+		}
+	}
+
+#endif
+
+	// remaining elements
+	for (size_t q = 0 ; q < 2 ; q++)
+	{layout_convert_copy_word<uint64_t>(w[q],d0,s0,i,stop);}
+}
+
+/*! \brief Copy a group of words for the elements [start,stop)
+ *
+ */
+static inline void layout_convert_copy_group(const std::vector<layout_convert_word> & words, const layout_convert_group & g,
+		                                     size_t d0, size_t s0, size_t start, size_t stop)
+{
+	const layout_convert_word & w = words[g.w];
+
+	switch (g.kind)
+	{
+	case LC_LIN_INTE_4:
+		layout_convert_transpose_4(&w,true,d0,s0,start,stop);
+		break;
+	case LC_INTE_LIN_4:
+		layout_convert_transpose_4(&w,false,d0,s0,start,stop);
+		break;
+	case LC_LIN_INTE_8:
+		layout_convert_transpose_8(&w,true,d0,s0,start,stop);
+		break;
+	case LC_INTE_LIN_8:
+		layout_convert_transpose_8(&w,false,d0,s0,start,stop);
+		break;
+	default:
+		if (w.size == 1)	{layout_convert_copy_word<uint8_t>(w,d0,s0,start,stop);}
+		else if (w.size == 2)	{layout_convert_copy_word<uint16_t>(w,d0,s0,start,stop);}
+		else if (w.size == 4)	{layout_convert_copy_word<uint32_t>(w,d0,s0,start,stop);}
+		else if (w.size == 8)	{layout_convert_copy_word<uint64_t>(w,d0,s0,start,stop);}
+		else
+		{
+			for (size_t i = start ; i < stop ; i++)
+			{memcpy(w.d + (d0+i)*w.d_stride,w.s + (s0+i)*w.s_stride,w.size);}
+		}
+		break;
+	}
+}
+
+/*! \brief Copy (or merge with op) the elements [src_start,src_start+n) of src into [dst_start,dst_start+n) of dst,
+ *         whatever are the layouts of the two grids
+ *
+ * The elements are processed in blocks of LAYOUT_CONVERT_BLOCK, every block is converted for all the properties
+ * while it is in cache and the blocks are distributed across the threads. Inside a parallel region the conversion
+ * run on the calling thread (ofp_n_threads). The indexes are the linearized indexes of the grids. The properties
+ * must satisfy layout_convert_ok
+ *
+ * A copy (replace_) work on the bits of the scalar components: 4 consecutive 4 byte components of a linear (AoS)
+ * element and 4 interleaved (SoA) arrays are transposed 4x4 with SSE (2x2 for 8 byte components), in both
+ * directions. The other components, and the other operations, are copied with a strided loop
+ *
+ * \tparam op operation (replace_ for a copy)
+ * \tparam prp destination property for each source property (empty means identity)
+ *
+ * \param dst destination grid
+ * \param dst_start first destination element
+ * \param src source grid
+ * \param src_start first source element
+ * \param n number of elements
+ *
+ */
+template<template<typename,typename> class op, unsigned int ... prp, typename grid_dst, typename grid_src>
+void layout_convert_prp(grid_dst & dst, size_t dst_start, const grid_src & src, size_t src_start, size_t n)
+{
+	static_assert(layout_convert_ok<typename grid_dst::value_type,typename grid_src::value_type,prp...>::value,
+			      "layout_convert support arithmetic properties (or arrays up to 2 dimensions of them) with the same type in source and destination");
+
+	if (n == 0)	{return;}
+
+	const size_t n_prp = layout_convert_ok<typename grid_dst::value_type,typename grid_src::value_type,prp...>::n_prp;
+	const long int n_block = (n + LAYOUT_CONVERT_BLOCK - 1) / LAYOUT_CONVERT_BLOCK;
+	const int nth = openfpm::ofp_n_threads(n,LAYOUT_CONVERT_GRAIN);
+
+	if (std::is_same<op<int,int>,replace_<int,int>>::value == true)
+	{
+		std::vector<layout_convert_word> words;
+		std::vector<layout_convert_group> groups;
+
+		layout_convert_collect<grid_dst,grid_src,prp...> col(dst,src,words);
+		boost::mpl::for_each_ref<boost::mpl::range_c<int,0,n_prp>>(col);
+		layout_convert_make_groups(words,groups);
+
+		#pragma omp parallel for num_threads(nth) schedule(static)
+		for (long int b = 0 ; b < n_block ; b++)
+		{
+			size_t start = b*LAYOUT_CONVERT_BLOCK;
+			size_t stop = std::min(start + LAYOUT_CONVERT_BLOCK,n);
+
+			for (size_t k = 0 ; k < groups.size() ; k++)
+			{layout_convert_copy_group(words,groups[k],dst_start,src_start,start,stop);}
+		}
+
+		return;
+	}
+
+	#pragma omp parallel for num_threads(nth) schedule(static)
+	for (long int b = 0 ; b < n_block ; b++)
+	{
+		size_t start = b*LAYOUT_CONVERT_BLOCK;
+		size_t stop = std::min(start + LAYOUT_CONVERT_BLOCK,n);
+
+		layout_convert_block<op,grid_dst,grid_src,prp...> cb(dst,src,dst_start,src_start,start,stop);
+		boost::mpl::for_each_ref<boost::mpl::range_c<int,0,n_prp>>(cb);
+	}
+}
+
+/*! \brief Convert a grid into a grid of the same size with a different layout (for example memory_traits_lin
+ *         into memory_traits_inte)
+ *
+ * ### Convert a vector and a grid from AoS to SoA
+ * \snippet vector_unit_tests.hpp Layout conversion
+ *
+ * \param dst destination grid (already allocated)
+ * \param src source grid
+ *
+ * \return true if the grids have the same size and the conversion is done
+ *
+ */
+template<typename grid_dst, typename grid_src>
+bool layout_convert(grid_dst & dst, const grid_src & src)
+{
+	if (dst.getGrid().size() != src.getGrid().size())
+	{
+		std::cerr << __FILE__ << ":" << __LINE__ << " error layout_convert: the grids must have the same size " << dst.getGrid().size() << " != " << src.getGrid().size() << std::endl;
+		return false;
+	}
+
+	layout_convert_prp<replace_>(dst,0,src,0,src.getGrid().size());
+
+	return true;
+}
+
+/*! \brief Transpose every tile of LAYOUT_CONVERT_TILE elements of k scalars (B x k into k x B, or back)
+ *
+ * \param buf buffer
+ * \param m number of tiles
+ * \param k number of scalars of an element
+ * \param to_inte true B x k into k x B
+ *
+ */
+template<typename S>
+void layout_transpose_tiles(S * buf, size_t m, size_t k, bool to_inte)
+{
+	const size_t B = LAYOUT_CONVERT_TILE;
+	const int nth = openfpm::ofp_n_threads(m*B,LAYOUT_CONVERT_GRAIN);
+
+	#pragma omp parallel num_threads(nth)
+	{
+		std::vector<S> tmp(B*k);
+
+		#pragma omp for schedule(static)
+		for (long int t = 0 ; t < (long int)m ; t++)
+		{
+			S * tile = buf + t*B*k;
+			memcpy(tmp.data(),tile,B*k*sizeof(S));
+
+			if (to_inte == true)
+			{
+				for (size_t j = 0 ; j < k ; j++)
+				{
+					for (size_t i = 0 ; i < B ; i++)
+					{tile[j*B + i] = tmp[i*k + j];}
+				}
+			}
+			else
+			{
+				for (size_t i = 0 ; i < B ; i++)
+				{
+					for (size_t j = 0 ; j < k ; j++)
+					{tile[i*k + j] = tmp[j*B + i];}
+				}
+			}
+		}
+	}
+}
+
+/*! \brief Transpose in place a R x C matrix of blocks of B scalars into a C x R matrix, following the cycles
+ *         of the permutation
+ *
+ * \param buf buffer
+ * \param R rows
+ * \param C columns
+ * \param B scalars of a block
+ *
+ */
+template<typename S>
+void layout_transpose_blocks(S * buf, size_t R, size_t C, size_t B)
+{
+	if (R <= 1 || C <= 1)	{return;}
+
+	const size_t N = R*C;
+	std::vector<bool> done(N,false);
+	std::vector<S> tmp(B);
+
+	// the first and the last block do not move
+	for (size_t st = 1 ; st < N - 1 ; st++)
+	{
+		if (done[st] == true)	{continue;}
+
+		memcpy(tmp.data(),buf + st*B,B*sizeof(S));
+
+		size_t p = st;
+		while (true)
+		{
+			done[p] = true;
+
+			// the block in the row r column c go in the row c column r
+			size_t q = (p*C) % (N - 1);
+
+			if (q == st)
+			{
+				memcpy(buf + p*B,tmp.data(),B*sizeof(S));
+				break;
+			}
+
+			memcpy(buf + p*B,buf + q*B,B*sizeof(S));
+			p = q;
+		}
+	}
+}
+
+/*! \brief Convert in place a buffer of n elements of k scalars of type S from the linear (AoS) image into the
+ *         interleaved (SoA) image (k arrays of n scalars), or back
+ *
+ * The buffer can be the memory of a memory_traits_lin vector or grid whose properties are all of type S (or
+ * arrays of S) without padding. No second buffer is allocated: every tile of LAYOUT_CONVERT_TILE elements is
+ * transposed in a small temporary (the tiles are distributed across the threads), then the tiles of every scalar
+ * are moved in their final position following the cycles of the permutation. The sizes allow the in-place
+ * conversion when n is a multiple of LAYOUT_CONVERT_TILE, otherwise use layout_convert into a second grid
+ *
+ * \param buf buffer
+ * \param n number of elements
+ * \param k number of scalars of an element
+ * \param to_inte true from linear to interleaved, false from interleaved to linear
+ *
+ * \return false if n is not a multiple of LAYOUT_CONVERT_TILE (the buffer is not modified)
+ *
+ */
+template<typename S>
+bool layout_transpose_inplace(S * buf, size_t n, size_t k, bool to_inte = true)
+{
+	if (n % LAYOUT_CONVERT_TILE != 0)	{return false;}
+
+	const size_t m = n / LAYOUT_CONVERT_TILE;
+
+	if (m == 0 || k <= 1)	{return true;}
+
+	if (to_inte == true)
+	{
+		layout_transpose_tiles(buf,m,k,true);
+		layout_transpose_blocks(buf,m,k,LAYOUT_CONVERT_TILE);
+	}
+	else
+	{
+		layout_transpose_blocks(buf,k,m,LAYOUT_CONVERT_TILE);
+		layout_transpose_tiles(buf,m,k,false);
+	}
+
+	return true;
+}
+
+#endif /* GRID_LAYOUT_CONVERT_HPP_ */
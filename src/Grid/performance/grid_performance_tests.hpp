@@ -221,7 +221,6 @@ BOOST_AUTO_TEST_CASE(grid_performance_write_report)
 	StandardXMLPerformanceGraph("grid_performance_funcs.xml",file_xml_ref,cg);
 
 	addUpdateTime(cg,1,"data","grid_performance_funcs");
-	createCommitFile("data");
 
 	cg.write("grid_performance_funcs.html");
 }
@@ -13,6 +13,12 @@
 #include "util/copy_compare/meta_compare.hpp"
 #include "Grid/grid_sm.hpp"
 
+// Nvcc does not like VC ... for some reason
+#if !defined(__NVCC__) || defined(CUDA_ON_CPU) || defined(__HIP__)
+#include "Space/Shape/Box_batch.hpp"
+#define CELL_DECOMPOSER_BATCH
+#endif
+
 #define CELL_DECOMPOSER 8001lu
 
 
@@ -504,6 +510,85 @@ public:
 	}
 };
 
+#ifdef CELL_DECOMPOSER_BATCH
+
+/*! \brief Apply the point transformation to Vc::Vector<T>::Size consecutive points (used by getCellBatch)
+ *
+ * The generic implementation transform every point with the scalar transform, shift and
+ * no_transform are specialized to work directly on the vectors
+ *
+ */
+template<typename transform_type>
+struct cell_batch_transform
+{
+	/*! \brief Transformed coordinate s of the points [i,i+Vc::Vector<T>::Size)
+	 *
+	 * \param tr transformation
+	 * \param pos points
+	 * \param i first point
+	 * \param s coordinate
+	 *
+	 * \return the transformed coordinates
+	 *
+	 */
+	template<unsigned int dim, typename T>
+	static inline Vc::Vector<T> transform(const transform_type & tr, const Point_soa<dim,T> & pos, size_t i, size_t s)
+	{
+		T x[Vc::Vector<T>::Size];
+
+		for (size_t l = 0 ; l < Vc::Vector<T>::Size ; l++)
+		{x[l] = tr.transform(pos.get(i+l),s);}
+
+		return Vc::Vector<T>(x,Vc::Unaligned);
+	}
+};
+
+//! no_transform, the coordinates are loaded as they are
+template<unsigned int dim_t, typename T_t>
+struct cell_batch_transform<no_transform<dim_t,T_t>>
+{
+	template<unsigned int dim, typename T>
+	static inline Vc::Vector<T> transform(const no_transform<dim_t,T_t> & tr, const Point_soa<dim,T> & pos, size_t i, size_t s)
+	{
+		return Vc::Vector<T>(pos.x[s] + i,Vc::Unaligned);
+	}
+};
+
+//! no_transform_only, the coordinates are loaded as they are
+template<unsigned int dim_t, typename T_t>
+struct cell_batch_transform<no_transform_only<dim_t,T_t>>
+{
+	template<unsigned int dim, typename T>
+	static inline Vc::Vector<T> transform(const no_transform_only<dim_t,T_t> & tr, const Point_soa<dim,T> & pos, size_t i, size_t s)
+	{
+		return Vc::Vector<T>(pos.x[s] + i,Vc::Unaligned);
+	}
+};
+
+//! shift, the origin is subtracted
+template<unsigned int dim_t, typename T_t>
+struct cell_batch_transform<shift<dim_t,T_t>>
+{
+	template<unsigned int dim, typename T>
+	static inline Vc::Vector<T> transform(const shift<dim_t,T_t> & tr, const Point_soa<dim,T> & pos, size_t i, size_t s)
+	{
+		return Vc::Vector<T>(pos.x[s] + i,Vc::Unaligned) - Vc::Vector<T>(tr.getOrig().get(s));
+	}
+};
+
+//! shift_only, the origin is subtracted
+template<unsigned int dim_t, typename T_t>
+struct cell_batch_transform<shift_only<dim_t,T_t>>
+{
+	template<unsigned int dim, typename T>
+	static inline Vc::Vector<T> transform(const shift_only<dim_t,T_t> & tr, const Point_soa<dim,T> & pos, size_t i, size_t s)
+	{
+		return Vc::Vector<T>(pos.x[s] + i,Vc::Unaligned) - Vc::Vector<T>(tr.getOrig().get(s));
+	}
+};
+
+#endif
+
 /*! \brief Decompose a space into cells
  *
  * It is a convenient class for cell decomposition of an N dimensional space into cells
@@ -1235,6 +1320,76 @@ public:
 		return cell_id;
 	}
 
+#ifdef CELL_DECOMPOSER_BATCH
+
+	/*! \brief Get the cell-id of many points
+	 *
+	 * Same result of getCell for each point, transformation, floor, clamp and linearization are
+	 * done with Vc vectors on blocks of points and big batches are split across threads
+	 *
+	 * \param pos points (structure of arrays)
+	 * \param ids output cell-ids (pos.n elements)
+	 *
+	 */
+	void getCellBatch(const Point_soa<dim,T> & pos, size_t * ids) const
+	{
+		box_batch_run<T>(pos.n,[&](int t, size_t i)
+		{
+			const size_t vs = Vc::Vector<T>::Size;
+			size_t id[vs];
+			T c[vs];
+
+			for (size_t l = 0 ; l < vs ; l++)	{id[l] = 0;}
+
+			for (size_t s = 0 ; s < dim ; s++)
+			{
+				Vc::Vector<T> x = cell_batch_transform<transform_type>::transform(pointTransform,pos,i,s);
+
+				// floor like size_t_floor, that move an exact negative integer one cell down
+				Vc::Vector<T> q = x / Vc::Vector<T>(unitCellSpaceBox.getHigh(s));
+				Vc::Vector<T> fl = Vc::floor(q);
+				fl = Vc::iif(q < Vc::Vector<T>::Zero() && fl == q,fl - Vc::Vector<T>((T)1),fl);
+
+				// outside the cell space (negative included) go to the last cell like in ConvertToID
+				Vc::Vector<T> cv = fl + Vc::Vector<T>((T)off[s]);
+				cv = Vc::iif(cv >= Vc::Vector<T>((T)cellListGrid.size(s)) || cv < Vc::Vector<T>::Zero(),Vc::Vector<T>((T)(cellListGrid.size(s)-1)),cv);
+				cv.store(c,Vc::Unaligned);
+
+				size_t stride = (s == 0)?1:gr_cell2.size_s(s-1);
+
+				for (size_t l = 0 ; l < vs ; l++)
+				{id[l] += stride * ((size_t)c[l] - cellShift.get(s));}
+			}
+
+			for (size_t l = 0 ; l < vs ; l++)
+			{ids[i+l] = id[l];}
+		},
+		[&](int t, size_t i)
+		{
+			ids[i] = getCell(pos.get(i));
+		});
+	}
+
+	/*! \brief Get the cell-id of all the points of a vector
+	 *
+	 * \see getCellBatch
+	 *
+	 * \param pos vector of points with layout memory_traits_inte
+	 * \param ids output cell-ids
+	 *
+	 */
+	template<typename vector_pos>
+	void getCellBatch(const vector_pos & pos, openfpm::vector<aggregate<size_t>> & ids) const
+	{
+		ids.resize(pos.size());
+
+		if (pos.size() == 0)	{return;}
+
+		getCellBatch(Point_soa<dim,T>(pos),&ids.template get<0>(0));
+	}
+
+#endif
+
 	/*! \brief Get the cell-id
 	 *
 	 * Convert the point coordinates into the cell id
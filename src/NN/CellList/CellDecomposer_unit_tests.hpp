@@ -8,6 +8,7 @@
 #ifndef OPENFPM_DATA_SRC_NN_CELLLIST_CELLDECOMPOSER_UNIT_TESTS_HPP_
 #define OPENFPM_DATA_SRC_NN_CELLLIST_CELLDECOMPOSER_UNIT_TESTS_HPP_
 
+
 BOOST_AUTO_TEST_SUITE( CellDecomposer_test )
 
 BOOST_AUTO_TEST_CASE( CellDecomposer_get_grid_points )
@@ -288,6 +289,113 @@ BOOST_AUTO_TEST_CASE( CellDecomposer_swap_use )
 	BOOST_REQUIRE(cd1 == cd2_old);
 }
 
+#ifdef CELL_DECOMPOSER_BATCH
+
+/*! \brief Check getCellBatch against getCell on random points that cover the padding and the outside of the domain
+ *
+ * \param cd cell decomposer
+ * \param box domain
+ * \param n number of points
+ *
+ * \return true if all the cell-ids match
+ *
+ */
+template<typename CellD, typename T>
+bool check_cell_batch(const CellD & cd, const Box<3,T> & box, size_t n)
+{
+	openfpm::vector<Point<3,T>,HeapMemory,memory_traits_inte> pos;
+	pos.resize(n);
+
+	std::default_random_engine g;
+	std::uniform_real_distribution<T> d(-0.5,1.5);
+
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		for (size_t j = 0 ; j < 3 ; j++)
+		{pos.template get<0>(i)[j] = box.getLow(j) + d(g) * (box.getHigh(j) - box.getLow(j));}
+	}
+
+	openfpm::vector<aggregate<size_t>> ids;
+	cd.getCellBatch(pos,ids);
+
+	bool match = (ids.size() == n);
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		Point<3,T> p;
+		for (size_t j = 0 ; j < 3 ; j++)	{p.get(j) = pos.template get<0>(i)[j];}
+
+		match &= (ids.template get<0>(i) == cd.getCell(p));
+	}
+
+	return match;
+}
+
+BOOST_AUTO_TEST_CASE( CellDecomposer_cell_batch )
+{
+	size_t div[3] = {16,15,14};
+
+	// no_transform
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	//! [Cell decomposer batch cell-id]
+
+	CellDecomposer_sm<3,float> cd(box,div,1);
+
+	openfpm::vector<Point<3,float>,HeapMemory,memory_traits_inte> pos;
+	pos.add(Point<3,float>({0.5,0.5,0.5}));
+	pos.add(Point<3,float>({0.01,0.99,0.3}));
+
+	openfpm::vector<aggregate<size_t>> ids;
+	cd.getCellBatch(pos,ids);
+
+	//! [Cell decomposer batch cell-id]
+
+	BOOST_REQUIRE_EQUAL(ids.size(),2ul);
+	BOOST_REQUIRE_EQUAL(ids.template get<0>(0),cd.getCell(Point<3,float>({0.5,0.5,0.5})));
+	BOOST_REQUIRE_EQUAL(ids.template get<0>(1),cd.getCell(Point<3,float>({0.01,0.99,0.3})));
+
+	BOOST_REQUIRE_EQUAL(check_cell_batch(cd,box,10007),true);
+
+	// shift
+
+	Box<3,double> box2({-1.1,0.3,2.0},{0.7,1.3,2.5});
+	CellDecomposer_sm<3,double,shift<3,double>> cd2(box2,div,2);
+
+	BOOST_REQUIRE_EQUAL(check_cell_batch(cd2,box2,10007),true);
+
+	// consistent with an extended cell decomposer (cellShift != 0)
+
+	Box<3,size_t> ext({1,2,3},{1,1,1});
+	CellDecomposer_sm<3,double,shift<3,double>> cd3(cd2,ext);
+
+	BOOST_REQUIRE_EQUAL(check_cell_batch(cd3,box2,10007),true);
+
+	// coordinates that are exactly a negative number of cells (in the padding and outside)
+
+	openfpm::vector<Point<3,float>,HeapMemory,memory_traits_inte> pos_n;
+	for (size_t i = 0 ; i < 64 ; i++)
+	{
+		float x = -(float)(i % 4) / div[0];
+		pos_n.add(Point<3,float>({x,0.5f - (float)(i % 3) / div[1],(i % 2 == 0)?x:0.5f}));
+	}
+
+	cd.getCellBatch(pos_n,ids);
+
+	bool match = true;
+	for (size_t i = 0 ; i < pos_n.size() ; i++)
+	{match &= (ids.template get<0>(i) == cd.getCell(Point<3,float>(pos_n.get(i))));}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// empty
+	openfpm::vector<Point<3,float>,HeapMemory,memory_traits_inte> pos_e;
+	cd.getCellBatch(pos_e,ids);
+	BOOST_REQUIRE_EQUAL(ids.size(),0ul);
+}
+
+#endif
+
 BOOST_AUTO_TEST_SUITE_END()
 
 #endif /* OPENFPM_DATA_SRC_NN_CELLLIST_CELLDECOMPOSER_UNIT_TESTS_HPP_ */
@@ -924,6 +924,16 @@ public:
 		return Mem_type::size();
 	}
 
+	/*! \brief Return the memory allocated and used by the cell-list
+	 *
+	 * \return the memory usage
+	 *
+	 */
+	mem_usage getMemoryUsage() const
+	{
+		return Mem_type::getMemoryUsage() + nnc_rad.getMemoryUsage();
+	}
+
 	/*! \brief Return the number of elements in the cell
 	 *
 	 * \param cell_id id of the cell
@@ -18,6 +18,7 @@ enum cl_construct_opt
 };
 
 #include "util/ofp_context.hpp"
+#include "util/performance/perf_counters.hpp"
 
 
 /*! \brief populate the Cell-list with particles non symmetric case on GPU
@@ -194,6 +195,8 @@ void populate_cell_list(openfpm::vector<Point<dim,T>,Memory,layout_base> & vPos,
 						size_t opt,
 						cl_construct_opt optc)
 {
+	OFP_PERF_REGION("CellList::construct");
+
 	if (opt == CL_NON_SYMMETRIC)
 	{populate_cell_list_no_sym<dim,T,prop,Memory,layout_base,CellList,prp ...>(vPos,vPosOut,vPrp,vPrpOut,cli,gpuContext,g_m,optc);}
 	else
@@ -57,6 +57,16 @@ public:
 	//! expose the type of the local index
 	typedef local_index local_index_type;
 
+	/*! \brief Return the memory allocated and used (the vectors of all the cells included)
+	 *
+	 * \return the memory usage
+	 *
+	 */
+	mem_usage getMemoryUsage() const
+	{
+		return cl_base.getMemoryUsage();
+	}
+
 	/*! \brief Initialize all to zero
 	 *
 	 * \param slot number of slot (unused)
@@ -141,6 +141,26 @@ public:
 		return cl_n.size();
 	}
 
+	/*! \brief Return the memory allocated and used
+	 *
+	 * The empty slots of the cells are wasted memory
+	 *
+	 * \return the memory usage
+	 *
+	 */
+	mem_usage getMemoryUsage() const
+	{
+		size_t n_ele = 0;
+		for (size_t i = 0 ; i < cl_n.size() ; i++)
+		{n_ele += cl_n.template get<0>(i);}
+
+		mem_usage m = cl_n.getMemoryUsage();
+		m.allocated += cl_base.getMemoryUsage().allocated;
+		m.used += n_ele*sizeof(local_index);
+
+		return m;
+	}
+
 	/*! \brief Destroy the internal memory including the retained one
 	 *
 	 */
@@ -50,6 +50,26 @@ public:
 	//! expose the type of the local index
 	typedef local_index local_index_type;
 
+	/*! \brief Return the memory allocated and used
+	 *
+	 * The nodes of the map are counted as used, the empty buckets as wasted
+	 *
+	 * \return the memory usage
+	 *
+	 */
+	mem_usage getMemoryUsage() const
+	{
+		// every node store the pair and the pointer to the next node
+		size_t node = sizeof(std::pair<const local_index,base>) + sizeof(void *);
+
+		mem_usage m(cl_base.bucket_count()*sizeof(void *) + cl_base.size()*node,cl_base.size()*node);
+
+		for (auto & c : cl_base)
+		{m += c.second.getMemoryUsage();}
+
+		return m;
+	}
+
 	/*! \brief Initialize the data structure to zeros
 	 *
 	 * In this case it does nothing
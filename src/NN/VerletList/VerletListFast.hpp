@@ -13,6 +13,7 @@
 #include "NN/Mem_type/MemFast.hpp"
 #include "NN/Mem_type/MemBalanced.hpp"
 #include "NN/Mem_type/MemMemoryWise.hpp"
+#include "util/performance/perf_counters.hpp"
 
 #define VERLET_STARTING_NSLOT 128
 
@@ -373,6 +374,8 @@ private:
 	 */
 	template<typename NN_type, int type> inline void create_(const vector_pos_type & pos, const vector_pos_type & pos2 , const openfpm::vector<size_t> & dom, const openfpm::vector<subsub_lin<dim>> & anom, T r_cut, size_t g_m, CellListImpl & cli, size_t opt)
 	{
+		OFP_PERF_REGION("VerletList::create_");
+
 		size_t end;
 
 		auto it = PartItNN<type,dim,vector_pos_type,CellListImpl>::get(pos,dom,anom,cli,g_m,end);
@@ -472,6 +475,16 @@ public:
 		return Mem_type::size();
 	}
 
+	/*! \brief Return the memory allocated and used by the verlet list (internal cell-list included)
+	 *
+	 * \return the memory usage
+	 *
+	 */
+	mem_usage getMemoryUsage() const
+	{
+		return Mem_type::getMemoryUsage() + dp.getMemoryUsage() + mem_usage_nested<CellListImpl>::get(cli);
+	}
+
 	/*! \brief Add a neighborhood particle to a particle
 	 *
 	 * \param part_id part id where to add
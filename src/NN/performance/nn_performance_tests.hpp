@@ -0,0 +1,545 @@
+/*
+ * nn_performance_tests.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef OPENFPM_DATA_SRC_NN_PERFORMANCE_NN_PERFORMANCE_TESTS_HPP_
+#define OPENFPM_DATA_SRC_NN_PERFORMANCE_NN_PERFORMANCE_TESTS_HPP_
+
+#include <random>
+#include "NN/CellList/CellList.hpp"
+#include "NN/CellList/CellListM.hpp"
+#include "NN/Mem_type/MemBalanced.hpp"
+#include "NN/Mem_type/MemMemoryWise.hpp"
+#include "NN/VerletList/VerletList.hpp"
+#include "Vector/vector_simd_view.hpp"
+#include "util/stat/common_statistics.hpp"
+#include "util/performance/benchmark_store.hpp"
+#include "util/performance/perf_counters.hpp"
+
+/*! \brief CPU performance of the neighborhood structures
+ *
+ * For every dimensionality, number of particles, particles per cell and Mem_type
+ * we measure
+ *
+ * * nn_cl_build: construction of the cell-list
+ * * nn_cl_iterate: iteration over the neighborhood (cell-list) of all the particles
+ * * nn_vl_build: construction of the Verlet-list
+ * * nn_vl_force: force calculation iterating the Verlet-list
+ * * nn_sph_density: SPH density summation on the Verlet-list, scalar (get<p>(i)) and SIMD (vector_simd_view)
+ * * nn_cell_id: cell-id of the particles with CellDecomposer_sm getCell (one at the time) and getCellBatch
+ *
+ * All the samples of every measure, with the configuration of the run, the commit, the host and the
+ * compiler, are appended to nn_performance_funcs.jsonl (and exported to nn_performance_funcs.csv). The
+ * test fail if a measure is significantly slower than the reference of the same machine stored in
+ * $OPENFPM_PERFORMANCE_TEST_DIR/openfpm_data/nn_performance_funcs_ref.jsonl
+ *
+ */
+
+//! Number of repetitions for each measure
+constexpr int N_STAT_NN = 5;
+
+//! Number of particles used in the tests
+const size_t nn_perf_n_part[] = {10000,100000,1000000};
+
+//! Average number of particles in a cell of side r_cut
+const size_t nn_perf_ppc[] = {2,8};
+
+//! All the samples of the measures
+benchmark_store nn_perf_store;
+
+/*! \brief Add particles and get the particle id from the neighborhood iterator
+ *
+ * The multi-phase cell-list (CellListM) is used with a single phase
+ *
+ */
+template<typename CellS>
+struct nn_perf_cl
+{
+	template<unsigned int dim, typename T>
+	static inline void add(CellS & cl, const Point<dim,T> & p, size_t id)
+	{
+		cl.add(p,id);
+	}
+
+	template<typename NN_type>
+	static inline size_t get(NN_type & NN)
+	{
+		return NN.get();
+	}
+};
+
+template<unsigned int dim, typename T, unsigned int sh_byte, typename CellBase>
+struct nn_perf_cl<CellListM<dim,T,sh_byte,CellBase>>
+{
+	static inline void add(CellListM<dim,T,sh_byte,CellBase> & cl, const Point<dim,T> & p, size_t id)
+	{
+		cl.add(p,id,0);
+	}
+
+	template<typename NN_type>
+	static inline size_t get(NN_type & NN)
+	{
+		return NN.getP();
+	}
+};
+
+/*! \brief Create n random particles in the unit box and calculate the cell-list divisions for ppc particles per cell
+ *
+ * \param pos particles
+ * \param n number of particles
+ * \param ppc particles per cell
+ * \param div divisions
+ *
+ * \return the cut-off radius (side of the cell)
+ *
+ */
+template<unsigned int dim, typename T>
+T nn_perf_particles(openfpm::vector<Point<dim,T>> & pos, size_t n, size_t ppc, size_t (& div)[dim])
+{
+	std::mt19937 gen(n + ppc);
+	std::uniform_real_distribution<T> ud(0.0,1.0);
+
+	pos.resize(n);
+
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		for (size_t j = 0 ; j < dim ; j++)
+		{pos.template get<0>(i)[j] = ud(gen);}
+	}
+
+	size_t d = std::max((size_t)1,(size_t)std::pow((double)n / ppc,1.0 / dim));
+
+	for (size_t j = 0 ; j < dim ; j++)
+	{div[j] = d;}
+
+	return 1.0 / d;
+}
+
+/*! \brief Store a measure in the report
+ *
+ * \param measure name of the measure
+ * \param name name of the configuration
+ * \param times measures
+ * \param n number of particles
+ * \param ppc particles per cell
+ *
+ */
+template<unsigned int dim>
+void nn_perf_report(const std::string & measure, const std::string & name, std::vector<double> & times, size_t n, size_t ppc)
+{
+	nn_perf_store.add("nn_" + measure,{{"name",name},{"dim",std::to_string(dim)},{"n_part",std::to_string(n)},{"ppc",std::to_string(ppc)}},times);
+}
+
+/*! \brief Measure construction and neighborhood iteration of a cell-list
+ *
+ * \tparam CellS cell-list
+ *
+ * \param name name of the cell-list
+ * \param n number of particles
+ * \param ppc particles per cell
+ *
+ */
+template<unsigned int dim, typename T, typename CellS>
+void nn_perf_cell_list(const std::string & name, size_t n, size_t ppc)
+{
+	openfpm::vector<Point<dim,T>> pos;
+	size_t div[dim];
+	T r_cut = nn_perf_particles(pos,n,ppc,div);
+	T r_cut2 = r_cut*r_cut;
+
+	Box<dim,T> box;
+	for (size_t j = 0 ; j < dim ; j++)
+	{
+		box.setLow(j,0.0);
+		box.setHigh(j,1.0);
+	}
+
+	std::vector<double> times_b;
+	std::vector<double> times_i;
+	size_t n_pair = 0;
+
+	// the first run is a warm-up
+
+	for (size_t k = 0 ; k < N_STAT_NN + 1 ; k++)
+	{
+		timer t_b;
+		t_b.start();
+
+		CellS cl(box,div);
+
+		for (size_t i = 0 ; i < n ; i++)
+		{nn_perf_cl<CellS>::add(cl,Point<dim,T>(pos.get(i)),i);}
+
+		t_b.stop();
+
+		timer t_i;
+		t_i.start();
+
+		n_pair = 0;
+		for (size_t i = 0 ; i < n ; i++)
+		{
+			Point<dim,T> xp = pos.get(i);
+			auto NN = cl.getNNIterator(cl.getCell(xp));
+
+			while (NN.isNext())
+			{
+				size_t q = nn_perf_cl<CellS>::get(NN);
+
+				n_pair += (xp.distance2(pos.get(q)) < r_cut2);
+
+				++NN;
+			}
+		}
+
+		t_i.stop();
+
+		if (k == 0)	{continue;}
+
+		times_b.push_back(t_b.getwct());
+		times_i.push_back(t_i.getwct());
+	}
+
+	BOOST_REQUIRE(n_pair >= n);
+
+	nn_perf_report<dim>("cl_build",name,times_b,n,ppc);
+	nn_perf_report<dim>("cl_iterate",name,times_i,n,ppc);
+}
+
+/*! \brief Measure construction of a Verlet-list and a force calculation on it
+ *
+ * \tparam VerS Verlet-list
+ *
+ * \param name name of the Verlet-list
+ * \param n number of particles
+ * \param ppc particles per cell
+ *
+ */
+template<unsigned int dim, typename T, typename VerS>
+void nn_perf_verlet(const std::string & name, size_t n, size_t ppc)
+{
+	openfpm::vector<Point<dim,T>> pos;
+	openfpm::vector<Point<dim,T>> force;
+	size_t div[dim];
+	T r_cut = nn_perf_particles(pos,n,ppc,div);
+
+	force.resize(n);
+
+	Box<dim,T> box;
+	for (size_t j = 0 ; j < dim ; j++)
+	{
+		box.setLow(j,0.0);
+		box.setHigh(j,1.0);
+	}
+
+	std::vector<double> times_b;
+	std::vector<double> times_f;
+
+	for (size_t k = 0 ; k < N_STAT_NN + 1 ; k++)
+	{
+		timer t_b;
+		t_b.start();
+
+		VerS vl;
+		vl.Initialize(box,box,r_cut,pos,pos.size());
+
+		t_b.stop();
+
+		timer t_f;
+		t_f.start();
+
+		for (size_t i = 0 ; i < n ; i++)
+		{
+			Point<dim,T> xp = pos.get(i);
+			Point<dim,T> f;
+			f.zero();
+
+			for (size_t j = 0 ; j < vl.getNNPart(i) ; j++)
+			{
+				size_t q = vl.get(i,j);
+				if (q == i)	{continue;}
+
+				Point<dim,T> dr = xp - Point<dim,T>(pos.get(q));
+				T r2 = xp.distance2(pos.get(q));
+
+				f += dr / (r2*r2);
+			}
+
+			force.get(i) = f;
+		}
+
+		t_f.stop();
+
+		if (k == 0)	{continue;}
+
+		times_b.push_back(t_b.getwct());
+		times_f.push_back(t_f.getwct());
+	}
+
+	nn_perf_report<dim>("vl_build",name,times_b,n,ppc);
+	nn_perf_report<dim>("vl_force",name,times_f,n,ppc);
+}
+
+/*! \brief Measure the SPH density summation on a Verlet-list, with scalar access and with the SIMD view
+ *
+ * rho_i = m sum_j W(r_ij) with the poly6 kernel W = (h^2 - r^2)^3 for r < h. The scalar version use get<p>(i),
+ * the SIMD version gather the positions of Vc::Vector<T>::Size neighborhood particles at time (the last block
+ * is masked) and store the density with the SIMD view
+ *
+ * \param n number of particles
+ * \param ppc particles per cell
+ *
+ */
+template<unsigned int dim, typename T>
+void nn_perf_sph_density(size_t n, size_t ppc)
+{
+	typedef Vc::Vector<T> vT;
+
+	openfpm::vector<Point<dim,T>> pos;
+	size_t div[dim];
+	T h = nn_perf_particles(pos,n,ppc,div);
+	T h2 = h*h;
+	T mass = 1.0 / n;
+
+	// positions and density in interleaved layout
+	openfpm::vector<Point<dim,T>,HeapMemory,memory_traits_inte> pos_soa;
+	openfpm::vector_soa<aggregate<T>> rho_s;
+	openfpm::vector_soa<aggregate<T>> rho_v;
+
+	pos_soa.resize(n);
+	rho_s.resize(n);
+	rho_v.resize(n);
+
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		for (size_t s = 0 ; s < dim ; s++)
+		{pos_soa.template get<0>(i)[s] = pos.template get<0>(i)[s];}
+	}
+
+	Box<dim,T> box;
+	for (size_t j = 0 ; j < dim ; j++)
+	{
+		box.setLow(j,0.0);
+		box.setHigh(j,1.0);
+	}
+
+	VerletList<dim,T,Mem_fast<>> vl;
+	vl.Initialize(box,box,h,pos,pos.size());
+
+	auto pw = simd_view(pos_soa);
+	auto rw = simd_view(rho_v);
+
+	std::vector<double> times_s;
+	std::vector<double> times_v;
+
+	for (size_t k = 0 ; k < N_STAT_NN + 1 ; k++)
+	{
+		timer t_s;
+		t_s.start();
+
+		for (size_t i = 0 ; i < n ; i++)
+		{
+			T rho = 0.0;
+
+			for (size_t j = 0 ; j < vl.getNNPart(i) ; j++)
+			{
+				size_t q = vl.get(i,j);
+
+				T r2 = 0.0;
+				for (size_t s = 0 ; s < dim ; s++)
+				{
+					T dx = pos_soa.template get<0>(i)[s] - pos_soa.template get<0>(q)[s];
+					r2 += dx*dx;
+				}
+
+				if (r2 < h2)
+				{
+					T w = h2 - r2;
+					rho += w*w*w;
+				}
+			}
+
+			rho_s.template get<0>(i) = mass * rho;
+		}
+
+		t_s.stop();
+
+		timer t_v;
+		t_v.start();
+
+		vector_simd_lane<T> x[dim];
+		for (size_t s = 0 ; s < dim ; s++)
+		{x[s] = pw.template lane<0>(s);}
+
+		auto rho_l = rw.template lane<0>();
+
+		for (size_t i = 0 ; i < n ; i += vT::Size)
+		{
+			// one particle for each lane
+			T rho_i[vT::Size] = {};
+
+			for (size_t l = 0 ; l < vT::Size && i + l < n ; l++)
+			{
+				size_t p = i + l;
+				vT rho = vT::Zero();
+
+				size_t ids[vT::Size];
+				size_t nn = vl.getNNPart(p);
+
+				for (size_t j = 0 ; j < nn ; j += vT::Size)
+				{
+					size_t kb = std::min((size_t)vT::Size,nn - j);
+					for (size_t b = 0 ; b < kb ; b++)
+					{ids[b] = vl.get(p,j+b);}
+
+					vT r2 = vT::Zero();
+					for (size_t s = 0 ; s < dim ; s++)
+					{
+						vT dx = vT(x[s].getPointer()[p]) - x[s].gather(ids,kb);
+						r2 += dx*dx;
+					}
+
+					auto m = (r2 < vT(h2)) && (vT::IndexesFromZero() < vT((T)kb));
+					vT w = vT(h2) - r2;
+					rho += Vc::iif(m,w*w*w,vT::Zero());
+				}
+
+				rho_i[l] = mass * rho.sum();
+			}
+
+			rho_l.store(i,vT(rho_i,Vc::Unaligned));
+		}
+
+		t_v.stop();
+
+		if (k == 0)	{continue;}
+
+		times_s.push_back(t_s.getwct());
+		times_v.push_back(t_v.getwct());
+	}
+
+	for (size_t i = 0 ; i < n ; i++)
+	{BOOST_REQUIRE_CLOSE(rho_s.template get<0>(i),rho_v.template get<0>(i),0.01);}
+
+	nn_perf_report<dim>("sph_density","scalar",times_s,n,ppc);
+	nn_perf_report<dim>("sph_density","simd",times_v,n,ppc);
+}
+
+/*! \brief Run all the measures for a dimensionality
+ *
+ */
+template<unsigned int dim, typename T>
+void nn_perf_dim()
+{
+	for (size_t n : nn_perf_n_part)
+	{
+		for (size_t ppc : nn_perf_ppc)
+		{
+			nn_perf_cell_list<dim,T,CellList<dim,T,Mem_fast<>>>("fast",n,ppc);
+			nn_perf_cell_list<dim,T,CellList<dim,T,Mem_bal<>>>("bal",n,ppc);
+			nn_perf_cell_list<dim,T,CellList<dim,T,Mem_mw<>>>("mw",n,ppc);
+			nn_perf_cell_list<dim,T,CellListM<dim,T,8>>("multi",n,ppc);
+
+			nn_perf_verlet<dim,T,VerletList<dim,T,Mem_fast<>>>("fast",n,ppc);
+			nn_perf_verlet<dim,T,VerletList<dim,T,Mem_bal<>>>("bal",n,ppc);
+			nn_perf_verlet<dim,T,VerletList<dim,T,Mem_mw<>>>("mw",n,ppc);
+
+			nn_perf_sph_density<dim,T>(n,ppc);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE( nn_performance )
+
+BOOST_AUTO_TEST_CASE(nn_performance_2d)
+{
+	nn_perf_dim<2,float>();
+}
+
+BOOST_AUTO_TEST_CASE(nn_performance_3d)
+{
+	nn_perf_dim<3,float>();
+}
+
+#ifdef CELL_DECOMPOSER_BATCH
+
+BOOST_AUTO_TEST_CASE(nn_performance_cell_id)
+{
+	const size_t n = 4000000;
+	size_t div[3] = {64,64,64};
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+	CellDecomposer_sm<3,float,shift<3,float>> cd(box,div,1);
+
+	openfpm::vector<Point<3,float>> pos_aos;
+	size_t div_p[3];
+	nn_perf_particles(pos_aos,n,1,div_p);
+
+	openfpm::vector<Point<3,float>,HeapMemory,memory_traits_inte> pos;
+	pos.resize(n);
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		for (size_t j = 0 ; j < 3 ; j++)
+		{pos.template get<0>(i)[j] = pos_aos.template get<0>(i)[j];}
+	}
+
+	openfpm::vector<aggregate<size_t>> ids_sc;
+	openfpm::vector<aggregate<size_t>> ids;
+	ids_sc.resize(n);
+
+	std::vector<double> t_sc;
+	std::vector<double> t_b;
+
+	// the first run is a warm-up
+
+	for (size_t k = 0 ; k < N_STAT_NN + 1 ; k++)
+	{
+		timer t;
+		t.start();
+		for (size_t i = 0 ; i < n ; i++)
+		{ids_sc.template get<0>(i) = cd.getCell(pos_aos.get(i));}
+		t.stop();
+		double tsc = t.getwct();
+
+		t.start();
+		cd.getCellBatch(pos,ids);
+		t.stop();
+		double tb = t.getwct();
+
+		bool match = true;
+		for (size_t i = 0 ; i < n ; i++)
+		{match &= (ids.template get<0>(i) == ids_sc.template get<0>(i));}
+
+		BOOST_REQUIRE_EQUAL(match,true);
+
+		if (k == 0)	{continue;}
+
+		t_sc.push_back(tsc);
+		t_b.push_back(tb);
+	}
+
+	nn_perf_store.add("nn_cell_id",{{"name","getCell"},{"dim","3"},{"n_part",std::to_string(n)}},t_sc);
+	nn_perf_store.add("nn_cell_id",{{"name","getCellBatch"},{"dim","3"},{"n_part",std::to_string(n)}},t_b);
+}
+
+#endif
+
+/////// THIS IS NOT A TEST IT WRITE THE PERFORMANCE RESULT ///////
+
+BOOST_AUTO_TEST_CASE(nn_performance_write_report)
+{
+	// Machine readable history and regression check, with the hardware counters of the
+	// instrumented regions when compiled with OPENFPM_PERF_COUNTERS
+
+	perf_registry::to_store(nn_perf_store);
+
+	size_t n_reg = benchmark_write_and_check(nn_perf_store,"nn_performance_funcs",std::string(test_dir) + "/openfpm_data");
+
+	BOOST_REQUIRE_EQUAL(n_reg,0ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif /* OPENFPM_DATA_SRC_NN_PERFORMANCE_NN_PERFORMANCE_TESTS_HPP_ */
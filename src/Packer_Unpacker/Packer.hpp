@@ -19,9 +19,11 @@
 
 #include "Grid/grid_sm.hpp"
 #include "util/Pack_stat.hpp"
+#include "util/Pack_iovec.hpp"
 #include "Pack_selector.hpp"
 #include "has_pack_encap.hpp"
 #include "Packer_util.hpp"
+#include "util/performance/perf_counters.hpp"
 
 
 template <typename> struct Debug;
@@ -99,6 +101,23 @@ public:
 		sts.incReq();
 	}
 
+	/*! \brief It pack any C++ primitives as a segment
+	 *
+	 * The primitive is copied into a segment owned by iov
+	 *
+	 * \param iov list of segments
+	 * \param obj object to pack
+	 * \param sts pack-stat info
+	 *
+	 */
+	inline static void packSegments(Pack_iovec & iov, const T & obj, Pack_stat & sts)
+	{
+		*(typename std::remove_const<T>::type *)iov.stage(sizeof(T)) = obj;
+
+		// update statistic
+		sts.incReq();
+	}
+
 	/*! \brief It add a request to pack a C++ primitive
 	 *
 	 * \param req requests vector
@@ -364,8 +383,22 @@ public:
 
 	template<int ... prp> static void pack(ExtPreAlloc<Mem> & mem, const T & obj, Pack_stat & sts)
 	{
+		OFP_PERF_REGION("Packer::pack");
+
 		obj.template pack<prp...>(mem, sts);
 	}
+
+	/*! \brief Pack the object as a list of segments referring to its memory (zero-copy)
+	 *
+	 * \param iov list of segments
+	 * \param obj object to pack
+	 * \param sts pack-stat info
+	 *
+	 */
+	template<int ... prp> static void packSegments(Pack_iovec & iov, const T & obj, Pack_stat & sts)
+	{
+		obj.template packSegments<prp...>(iov, sts);
+	}
 };
 
 /*! \brief Packer for grids and sub-grids
@@ -391,11 +424,15 @@ public:
 
 	template<int ... prp> static void pack(ExtPreAlloc<Mem> & mem, const T & obj, Pack_stat & sts)
 	{
+		OFP_PERF_REGION("Packer::pack");
+
 		obj.template pack<prp...>(mem, sts);
 	}
 
 	template<typename grid_sub_it_type, int ... prp> static void pack(ExtPreAlloc<Mem> & mem, T & obj, grid_sub_it_type & sub_it, Pack_stat & sts)
 	{
+		OFP_PERF_REGION("Packer::pack");
+
 		obj.template pack<prp...>(mem, sub_it, sts);
 	}
 };
@@ -157,6 +157,113 @@ BOOST_AUTO_TEST_CASE ( vector_std_packer_unpacker )
 	delete &mem;
 }
 
+BOOST_AUTO_TEST_CASE ( vector_std_packer_unpacker_mt )
+{
+	// enough nested vectors to be packed with multiple threads
+	openfpm::vector<openfpm::vector<openfpm::vector<float>>> v2;
+	for (size_t i = 0; i < 5000; i++) {
+		openfpm::vector<openfpm::vector<float>> v6;
+		for (size_t j = 0; j < i % 4; j++) {
+			openfpm::vector<float> v7;
+			for (size_t k = 0; k < (i+j) % 7; k++) {
+				v7.add(i*100 + j*10 + k);
+			}
+			v6.add(v7);
+		}
+		v2.add(v6);
+	}
+
+	openfpm::vector<aggregate<float,openfpm::vector<float>>> va;
+	for (size_t i = 0; i < 3000; i++)
+	{
+		va.add();
+		va.last().template get<0>() = i;
+		for (size_t k = 0; k < i % 5; k++)
+		{va.last().template get<1>().add(i + k);}
+	}
+
+	size_t req = 0;
+
+	Packer<decltype(v2),HeapMemory>::packRequest<>(v2,req);
+	Packer<decltype(va),HeapMemory>::packRequest<0,1>(va,req);
+
+	HeapMemory pmem;
+	ExtPreAlloc<HeapMemory> & mem = *(new ExtPreAlloc<HeapMemory>(req,pmem));
+	mem.incRef();
+
+	Pack_stat sts;
+
+	Packer<decltype(v2),HeapMemory>::pack<>(mem,v2,sts);
+	Packer<decltype(va),HeapMemory>::pack<0,1>(mem,va,sts);
+
+	BOOST_REQUIRE_EQUAL(mem.size(),req);
+
+	// the buffer and the state of the memory are the same of a serial packing
+
+	int max_th = openfpm::ofp_max_threads();
+#ifdef HAVE_OPENMP
+	omp_set_num_threads(1);
+#endif
+
+	HeapMemory pmem_s;
+	ExtPreAlloc<HeapMemory> & mem_s = *(new ExtPreAlloc<HeapMemory>(req,pmem_s));
+	mem_s.incRef();
+
+	Pack_stat sts_s;
+
+	Packer<decltype(v2),HeapMemory>::pack<>(mem_s,v2,sts_s);
+	Packer<decltype(va),HeapMemory>::pack<0,1>(mem_s,va,sts_s);
+
+#ifdef HAVE_OPENMP
+	omp_set_num_threads(max_th);
+#endif
+
+	BOOST_REQUIRE_EQUAL(mem_s.getOffset(),mem.getOffset());
+	BOOST_REQUIRE_EQUAL(mem_s.getOffsetEnd(),mem.getOffsetEnd());
+	BOOST_REQUIRE_EQUAL(sts_s.reqPack(),sts.reqPack());
+	BOOST_REQUIRE_EQUAL(memcmp(mem_s.getPointerBase(),mem.getPointerBase(),req),0);
+
+	mem_s.decRef();
+	delete &mem_s;
+
+	Unpack_stat ps;
+
+	openfpm::vector<openfpm::vector<openfpm::vector<float>>> v2_unp;
+	openfpm::vector<aggregate<float,openfpm::vector<float>>> va_unp;
+
+	Unpacker<decltype(v2_unp),HeapMemory>::unpack<>(mem,v2_unp,ps);
+	Unpacker<decltype(va_unp),HeapMemory>::unpack<0,1>(mem,va_unp,ps);
+
+	BOOST_REQUIRE_EQUAL(ps.getOffset(),req);
+	BOOST_REQUIRE_EQUAL(v2_unp.size(),v2.size());
+	BOOST_REQUIRE_EQUAL(va_unp.size(),va.size());
+
+	bool match = true;
+	for (size_t k = 0; k < v2_unp.size(); k++)
+	{
+		match &= v2_unp.get(k).size() == v2.get(k).size();
+		for (size_t i = 0; i < v2_unp.get(k).size(); i++)
+		{
+			match &= v2_unp.get(k).get(i).size() == v2.get(k).get(i).size();
+			for (size_t j = 0; j < v2_unp.get(k).get(i).size(); j++)
+			{match &= v2_unp.get(k).get(i).get(j) == v2.get(k).get(i).get(j);}
+		}
+	}
+
+	for (size_t i = 0; i < va_unp.size(); i++)
+	{
+		match &= va_unp.template get<0>(i) == va.template get<0>(i);
+		match &= va_unp.template get<1>(i).size() == va.template get<1>(i).size();
+		for (size_t k = 0; k < va_unp.template get<1>(i).size(); k++)
+		{match &= va_unp.template get<1>(i).get(k) == va.template get<1>(i).get(k);}
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	mem.decRef();
+	delete &mem;
+}
+
 BOOST_AUTO_TEST_CASE ( vector_zerosize_packer_unpacker )
 {
 	openfpm::vector<openfpm::vector<openfpm::vector<Point_test<float>>>> v5;
@@ -304,6 +304,89 @@ BOOST_AUTO_TEST_CASE ( packer_unpacker_test )
 	}
 }
 
+template<unsigned int dim, int ... prp>
+void test_packer_sub_grid_mt(size_t (& sz)[dim], grid_key_dx<dim> start, grid_key_dx<dim> stop)
+{
+	typedef Point_test<float> pt;
+
+	grid_cpu<dim,Point_test<float>> g(sz);
+	g.setMemory();
+	fill_grid<dim>(g);
+
+	grid_key_dx_iterator_sub<dim> sub(g.getGrid(),start,stop);
+
+	size_t req = 0;
+	Packer<grid_cpu<dim,Point_test<float>>,HeapMemory>::template packRequest<decltype(sub),prp...>(g,sub,req);
+
+	HeapMemory pmem;
+	ExtPreAlloc<HeapMemory> & mem = *(new ExtPreAlloc<HeapMemory>(req,pmem));
+	mem.incRef();
+
+	Pack_stat sts;
+	Packer<grid_cpu<dim,Point_test<float>>,HeapMemory>::template pack<decltype(sub),prp...>(mem,g,sub,sts);
+
+	// the first property of every packed element is x, they must follow the order of the iterator
+
+	typedef object<typename object_creator<typename Point_test<float>::type,prp...>::type> prp_object;
+
+	bool match = true;
+	size_t id = 0;
+	sub.reset();
+	while (sub.isNext())
+	{
+		float * ptr = (float *)((unsigned char *)mem.getPointerBase() + id*sizeof(prp_object));
+		match &= *ptr == g.template get<pt::x>(sub.get());
+
+		++id;
+		++sub;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+	BOOST_REQUIRE_EQUAL(id*sizeof(prp_object),req);
+
+	// Unpack and check
+
+	grid_cpu<dim,Point_test<float>> g_test(sz);
+	g_test.setMemory();
+
+	grid_key_dx_iterator_sub<dim> sub2(g_test.getGrid(),start,stop);
+
+	Unpack_stat ps;
+	int gpuContext;
+	Unpacker<grid_cpu<dim,Point_test<float>>,HeapMemory>::template unpack<decltype(sub2),int,prp...>(mem,sub2,g_test,ps,gpuContext,rem_copy_opt::NONE_OPT);
+
+	sub2.reset();
+	while (sub2.isNext())
+	{
+		match &= g_test.template get<pt::x>(sub2.get()) == g.template get<pt::x>(sub2.get());
+		match &= g_test.template get<pt::v>(sub2.get())[0] == g.template get<pt::v>(sub2.get())[0];
+		match &= g_test.template get<pt::v>(sub2.get())[2] == g.template get<pt::v>(sub2.get())[2];
+
+		++sub2;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	mem.decRef();
+	delete &mem;
+}
+
+BOOST_AUTO_TEST_CASE ( packer_unpacker_sub_grid_mt )
+{
+	typedef Point_test<float> pt;
+
+	// sub-grids big enough to be packed with multiple threads
+
+	size_t sz[3] = {72,70,68};
+	test_packer_sub_grid_mt<3,pt::x,pt::v>(sz,grid_key_dx<3>({1,2,3}),grid_key_dx<3>({69,66,63}));
+	test_packer_sub_grid_mt<3,pt::x,pt::y,pt::z,pt::s,pt::v,pt::t>(sz,grid_key_dx<3>({1,2,3}),grid_key_dx<3>({69,66,63}));
+	test_packer_sub_grid_mt<3,pt::x,pt::y,pt::z,pt::s,pt::v,pt::t>(sz,grid_key_dx<3>({5,2,3}),grid_key_dx<3>({7,66,63}));
+
+	size_t sz2[2] = {600,500};
+	test_packer_sub_grid_mt<2,pt::x,pt::v>(sz2,grid_key_dx<2>({3,1}),grid_key_dx<2>({590,480}));
+	test_packer_sub_grid_mt<2,pt::x,pt::y,pt::z,pt::s,pt::v,pt::t>(sz2,grid_key_dx<2>({3,1}),grid_key_dx<2>({590,480}));
+}
+
 BOOST_AUTO_TEST_CASE ( packer_selector_test )
 {
 	BOOST_REQUIRE_EQUAL(Pack_selector<int>::value,PACKER_PRIMITIVE);
@@ -361,6 +444,152 @@ BOOST_AUTO_TEST_CASE ( packer_memory_traits_inte )
 
 }
 
+template<typename vector_type, unsigned int ... prp>
+void test_packer_segments(vector_type & v, size_t & n_seg, size_t & staged)
+{
+	Pack_iovec iov;
+	Pack_stat sts;
+
+	Packer<size_t,HeapMemory>::packSegments(iov,v.size(),sts);
+	Packer<vector_type,HeapMemory>::template packSegments<prp...>(iov,v,sts);
+
+	BOOST_REQUIRE_EQUAL(sts.reqPack(),3ul);
+
+	n_seg = iov.size();
+	staged = iov.stagedSize();
+
+	// unpack from the segments
+
+	Unpack_stat ps;
+
+	size_t sz = 0;
+	vector_type v2;
+
+	Unpacker<size_t,HeapMemory>::unpackSegments(iov,sz,ps);
+	Unpacker<vector_type,HeapMemory>::template unpackSegments<prp...>(iov,v2,ps);
+
+	BOOST_REQUIRE_EQUAL(ps.getOffset(),iov.totalSize());
+	BOOST_REQUIRE_EQUAL(sz,v.size());
+	BOOST_REQUIRE_EQUAL(v2.size(),v.size());
+
+	bool match = true;
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{
+		match &= v2.template get<0>(i) == v.template get<0>(i);
+		match &= v2.template get<1>(i)[0] == v.template get<1>(i)[0];
+		match &= v2.template get<1>(i)[1] == v.template get<1>(i)[1];
+		match &= v2.template get<1>(i)[2] == v.template get<1>(i)[2];
+
+		if (sizeof...(prp) == 0)
+		{match &= v2.template get<2>(i) == v.template get<2>(i);}
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// unpack from a single gathered segment
+
+	openfpm::vector<unsigned char> buf;
+	buf.resize(iov.totalSize());
+	iov.gather(buf.getPointer());
+
+	Pack_iovec iov2;
+	iov2.add(buf.getPointer(),buf.size());
+
+	Unpack_stat ps2;
+	vector_type v3;
+
+	Unpacker<size_t,HeapMemory>::unpackSegments(iov2,sz,ps2);
+	Unpacker<vector_type,HeapMemory>::template unpackSegments<prp...>(iov2,v3,ps2);
+
+	BOOST_REQUIRE_EQUAL(v3.size(),v.size());
+
+	match = true;
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{
+		match &= v3.template get<0>(i) == v.template get<0>(i);
+		match &= v3.template get<1>(i)[2] == v.template get<1>(i)[2];
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE ( packer_unpacker_segments )
+{
+	typedef aggregate<float,float[3],size_t> prop;
+
+	openfpm::vector<prop> v;
+	openfpm::vector<prop,HeapMemory,memory_traits_inte> v_inte;
+
+	for (size_t i = 0 ; i < 1000 ; i++)
+	{
+		v.add();
+		v.last().template get<0>() = i;
+		v.last().template get<1>()[0] = i + 1;
+		v.last().template get<1>()[1] = i + 2;
+		v.last().template get<1>()[2] = i + 3;
+		v.last().template get<2>() = 7*i;
+
+		v_inte.add();
+		v_inte.last().template get<0>() = i;
+		v_inte.last().template get<1>()[0] = i + 1;
+		v_inte.last().template get<1>()[1] = i + 2;
+		v_inte.last().template get<1>()[2] = i + 3;
+		v_inte.last().template get<2>() = 7*i;
+	}
+
+	size_t n_seg;
+	size_t staged;
+
+	// memory_traits_lin all properties: the data are referenced
+
+	test_packer_segments<decltype(v)>(v,n_seg,staged);
+	BOOST_REQUIRE_EQUAL(n_seg,3ul);
+	BOOST_REQUIRE_EQUAL(staged,2*sizeof(size_t));
+
+	// memory_traits_lin some properties: the data are copied
+
+	test_packer_segments<decltype(v),0,1>(v,n_seg,staged);
+	BOOST_REQUIRE_EQUAL(n_seg,3ul);
+	BOOST_REQUIRE_EQUAL(staged,2*sizeof(size_t) + v.size()*4*sizeof(float));
+
+	// memory_traits_inte: one segment for each component
+
+	test_packer_segments<decltype(v_inte)>(v_inte,n_seg,staged);
+	BOOST_REQUIRE_EQUAL(n_seg,7ul);
+	BOOST_REQUIRE_EQUAL(staged,2*sizeof(size_t));
+
+	test_packer_segments<decltype(v_inte),0,1>(v_inte,n_seg,staged);
+	BOOST_REQUIRE_EQUAL(n_seg,6ul);
+	BOOST_REQUIRE_EQUAL(staged,2*sizeof(size_t));
+
+	// memory_traits_lin all properties has the same format of pack()
+
+	size_t req = 0;
+	Packer<decltype(v),HeapMemory>::packRequest(v,req);
+
+	HeapMemory pmem;
+	ExtPreAlloc<HeapMemory> & mem = *(new ExtPreAlloc<HeapMemory>(req,pmem));
+	mem.incRef();
+
+	Pack_stat sts;
+	Packer<decltype(v),HeapMemory>::pack(mem,v,sts);
+
+	Pack_iovec iov;
+	Pack_stat sts2;
+	Packer<decltype(v),HeapMemory>::packSegments(iov,v,sts2);
+
+	BOOST_REQUIRE_EQUAL(iov.totalSize(),req);
+
+	openfpm::vector<unsigned char> buf;
+	buf.resize(iov.totalSize());
+	iov.gather(buf.getPointer());
+
+	BOOST_REQUIRE_EQUAL(memcmp(buf.getPointer(),mem.getPointerBase(),req),0);
+
+	mem.decRef();
+	delete &mem;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
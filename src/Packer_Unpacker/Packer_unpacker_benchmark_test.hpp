@@ -180,6 +180,73 @@ BOOST_AUTO_TEST_CASE( bm_test )
 
 }
 
+BOOST_AUTO_TEST_CASE( bm_test_segments )
+{
+	typedef aggregate<float,float[3],size_t> prop;
+
+	openfpm::vector<prop> v;
+	v.resize(1000000);
+
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{
+		v.template get<0>(i) = i;
+		v.template get<1>(i)[0] = i;
+		v.template get<1>(i)[1] = i;
+		v.template get<1>(i)[2] = i;
+		v.template get<2>(i) = i;
+	}
+
+	size_t num1 = 5;
+	double t_copy = 0;
+	double t_seg = 0;
+
+	openfpm::vector<prop> v_unp;
+
+	for (size_t n = 0; n < num1; n++)
+	{
+		// Copy into a preallocated buffer
+
+		timer t;
+		t.start();
+
+		size_t req = 0;
+		Packer<decltype(v),HeapMemory>::packRequest(v,req);
+
+		HeapMemory pmem;
+		ExtPreAlloc<HeapMemory> & mem = *(new ExtPreAlloc<HeapMemory>(req,pmem));
+		mem.incRef();
+
+		Pack_stat sts;
+		Packer<decltype(v),HeapMemory>::pack(mem,v,sts);
+
+		Unpack_stat ps;
+		Unpacker<decltype(v_unp),HeapMemory>::unpack(mem,v_unp,ps);
+
+		mem.decRef();
+		delete &mem;
+
+		t.stop();
+		t_copy += t.getwct();
+
+		// Scatter/gather segments
+
+		timer t2;
+		t2.start();
+
+		Pack_iovec iov;
+		Pack_stat sts2;
+		Packer<decltype(v),HeapMemory>::packSegments(iov,v,sts2);
+
+		Unpack_stat ps2;
+		Unpacker<decltype(v_unp),HeapMemory>::unpackSegments(iov,v_unp,ps2);
+
+		t2.stop();
+		t_seg += t2.getwct();
+	}
+
+	std::cout << "Pack/Unpack " << v.size() << " elements, copy: " << t_copy / num1 << " s segments: " << t_seg / num1 << " s" << std::endl;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 #endif /* OPENFPM_DATA_SRC_PACKER_UNPACKER_PACKER_UNPACKER_BENCHMARK_TEST_HPP_ */
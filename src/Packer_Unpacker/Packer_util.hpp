@@ -15,6 +15,10 @@
 #include "Vector/vect_isel.hpp"
 #include "memory_ly/memory_conf.hpp"
 #include "util/Pack_stat.hpp"
+#include "util/multi_thread_util.hpp"
+#include "memory/ExtPreAlloc.hpp"
+#include <vector>
+#include <cstring>
 
 template<typename T, typename Mem, int pack_type=Pack_selector<T>::value > class Packer;
 template<typename T, typename Mem, int pack_type=Pack_selector<T>::value > class Unpacker;
@@ -545,4 +549,139 @@ struct call_aggregateUnpack
 	}
 };
 
+//! Under this number of objects the nested packing run on a single thread
+#define PACK_NESTED_CPU_GRAIN 1024
+
+/*! \brief Move the allocation pointer of an ExtPreAlloc at the offset off, the next allocate start there
+ *
+ * \param mem ExtPreAlloc
+ * \param off offset from the beginning of the buffer
+ *
+ */
+template<typename Mem>
+inline void ext_prealloc_seek(ExtPreAlloc<Mem> & mem, size_t off)
+{
+	if (off >= mem.getOffset())
+	{mem.shift_forward(off - mem.getOffset());}
+	else
+	{mem.shift_backward(mem.getOffset() - off);}
+}
+
+/*! \brief Pack n nested objects one after the other using multiple threads
+ *
+ * The byte offset of each object is calculated with a prefix sum of the pack requests, then the objects
+ * are split into ranges, one for each thread, and every thread pack its range directly at its offset in mem.
+ * The produced buffer, and the state of mem at the end, are identical to the ones produced packing the
+ * objects serially. Inside a parallel region the objects are packed serially
+ *
+ * ExtPreAlloc has no sub-view, every thread pack through its own ExtPreAlloc that share the buffer of mem
+ * (a copy without the references of mem) positioned at the offset of every object
+ *
+ * \param mem preallocated memory where to pack the objects
+ * \param n number of objects
+ * \param sts pack-stat info
+ * \param request functor request(i,req) that add to req the bytes required to pack the object i
+ * \param pack functor pack(i,mem,sts) that pack the object i
+ *
+ */
+template<typename Mem, typename request_type, typename pack_type>
+void pack_nested_mt(ExtPreAlloc<Mem> & mem, size_t n, Pack_stat & sts, request_type request, pack_type pack)
+{
+	const int nth = openfpm::ofp_n_threads(n,PACK_NESTED_CPU_GRAIN);
+
+	if (nth == 1)
+	{
+		for (size_t i = 0 ; i < n ; i++)
+		{pack(i,mem,sts);}
+
+		return;
+	}
+
+	// off[i+1] is the offset of the end of the object i from the start of its range
+
+	std::vector<size_t> off(n+1,0);
+	std::vector<size_t> off_th(nth+1,0);
+	std::vector<size_t> n_req(nth,0);
+
+	#pragma omp parallel for num_threads(nth) schedule(static,1)
+	for (int t = 0 ; t < nth ; t++)
+	{
+		size_t start;
+		size_t stop;
+		openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+		size_t sum = 0;
+		for (size_t i = start ; i < stop ; i++)
+		{
+			size_t req = 0;
+			request(i,req);
+			sum += req;
+			off[i+1] = sum;
+		}
+
+		off_th[t+1] = sum;
+	}
+
+	for (int t = 0 ; t < nth ; t++)
+	{off_th[t+1] += off_th[t];}
+
+	// nothing to pack, the serial packing does not move mem
+
+	if (off_th[nth] == 0)
+	{
+		for (size_t i = 0 ; i < n ; i++)
+		{pack(i,mem,sts);}
+
+		return;
+	}
+
+	const size_t base = mem.getOffsetEnd();
+
+	// offset of the last allocation and end of the packed data in the range of every thread
+
+	std::vector<size_t> last_a(nth,0);
+	std::vector<size_t> last_e(nth,0);
+
+	#pragma omp parallel for num_threads(nth) schedule(static,1)
+	for (int t = 0 ; t < nth ; t++)
+	{
+		size_t start;
+		size_t stop;
+		openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+		ExtPreAlloc<Mem> mem_t(mem);
+		for (long int r = mem_t.ref() ; r > 0 ; r--)
+		{mem_t.decRef();}
+
+		Pack_stat sts_t;
+
+		for (size_t i = start ; i < stop ; i++)
+		{
+			size_t off_i = (i == start)?0:off[i];
+
+			ext_prealloc_seek(mem_t,base + off_th[t] + off_i);
+			pack(i,mem_t,sts_t);
+
+			if (off[i+1] != off_i)
+			{
+				last_a[t] = mem_t.getOffset();
+				last_e[t] = mem_t.getOffsetEnd();
+			}
+		}
+
+		n_req[t] = sts_t.reqPack();
+	}
+
+	for (int t = 0 ; t < nth ; t++)
+	{sts.addReq(n_req[t]);}
+
+	// as after a serial packing the last allocation of mem is the last allocation of the last object
+
+	int t_last = nth - 1;
+	while (off_th[t_last+1] == off_th[t_last])	{t_last--;}
+
+	ext_prealloc_seek(mem,last_a[t_last]);
+	mem.allocate(last_e[t_last] - last_a[t_last]);
+}
+
 #endif /* PACKER_UTIL_HPP_ */
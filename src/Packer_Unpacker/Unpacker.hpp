@@ -15,8 +15,10 @@
 #include "util/util_debug.hpp"
 #include "Pack_selector.hpp"
 #include "util/Pack_stat.hpp"
+#include "util/Pack_iovec.hpp"
 #include "memory/PtrMemory.hpp"
 #include "Packer_util.hpp"
+#include "util/performance/perf_counters.hpp"
 #include "util/multi_array_openfpm/multi_array_ref_openfpm.hpp"
 #include "has_pack_encap.hpp"
 #include "util/object_creator.hpp"
@@ -70,6 +72,20 @@ public:
 
 		ps.addOffset(sizeof(T));
 	}
+
+	/*! \brief It unpack C++ primitives from a list of segments
+	 *
+	 * \param iov list of segments from where to unpack the object
+	 * \param obj object where to unpack
+	 * \param ps unpack-stat info
+	 *
+	 */
+	static void unpackSegments(const Pack_iovec & iov, T & obj, Unpack_stat & ps)
+	{
+		iov.read(ps.getOffset(),&obj,sizeof(T));
+
+		ps.addOffset(sizeof(T));
+	}
 };
 
 template<typename T, typename Mem>
@@ -232,6 +248,8 @@ public:
 
 	template<unsigned int ... prp> void static unpack(ExtPreAlloc<Mem> & mem, T & obj, Unpack_stat & ps)
 	{
+		OFP_PERF_REGION("Unpacker::unpack");
+
 		obj.template unpack<prp...>(mem, ps);
 	}
 
@@ -242,6 +260,18 @@ public:
 
 		obj.template unpack<prp...>(mem, ps);
 	}
+
+	/*! \brief Unpack the object from a list of segments
+	 *
+	 * \param iov list of segments
+	 * \param obj object where to unpack
+	 * \param ps unpack-stat info
+	 *
+	 */
+	template<unsigned int ... prp> void static unpackSegments(const Pack_iovec & iov, T & obj, Unpack_stat & ps)
+	{
+		obj.template unpackSegments<prp...>(iov, ps);
+	}
 };
 
 /*! \brief Unpacker for grids
@@ -257,6 +287,8 @@ public:
 
 	template<unsigned int ... prp> static void unpack(ExtPreAlloc<Mem> & mem, T & obj, Unpack_stat & ps)
 	{
+		OFP_PERF_REGION("Unpacker::unpack");
+
 		obj.template unpack<prp...>(mem, ps);
 	}
 
@@ -264,6 +296,8 @@ public:
 			 typename context_type,
 			 unsigned int ... prp> static void unpack(ExtPreAlloc<Mem> & mem, grid_sub_it_type & sub_it, T & obj, Unpack_stat & ps, context_type& gpuContext, rem_copy_opt opt)
 	{
+		OFP_PERF_REGION("Unpacker::unpack");
+
 		obj.template unpack<prp...>(mem, sub_it, ps, gpuContext, opt);
 	}
 
@@ -0,0 +1,615 @@
+/*
+ * BoxBVH.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef BOXBVH_HPP_
+#define BOXBVH_HPP_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include "Space/Shape/Box.hpp"
+#include "Vector/map_vector.hpp"
+#include "util/multi_thread_util.hpp"
+#include "util/radix_sort_cpu.hpp"
+
+//! Size of the traversal stack (the depth of the tree is at most 64 + 32 levels)
+#define BOX_BVH_STACK 128
+
+//! Grain used to build the tree and process the batched queries with multiple threads
+#define BOX_BVH_CPU_GRAIN 1024
+
+/*! \brief Node predicate of a point location query
+ *
+ * \tparam dim dimensionality
+ * \tparam T type of space
+ *
+ */
+template<unsigned int dim, typename T>
+struct bvh_point_pred
+{
+	//! point to locate
+	Point<dim,T> p;
+
+	/*! \brief Return true if the bounding box of the node contain the point
+	 *
+	 * \param nb node bounding boxes
+	 * \param nd node
+	 *
+	 */
+	template<typename vbox_type>
+	__device__ __host__ inline bool operator()(const vbox_type & nb, unsigned int nd) const
+	{
+		bool in = true;
+		for (unsigned int i = 0 ; i < dim ; i++)
+		{in &= (p.get(i) >= nb.template get<0>(nd)[i]) & (p.get(i) <= nb.template get<1>(nd)[i]);}
+
+		return in;
+	}
+};
+
+/*! \brief Node predicate of a box overlap query (the boxes are closed, like in Box::Intersect)
+ *
+ * \tparam dim dimensionality
+ * \tparam T type of space
+ *
+ */
+template<unsigned int dim, typename T>
+struct bvh_box_pred
+{
+	//! box to intersect
+	Box<dim,T> b;
+
+	/*! \brief Return true if the bounding box of the node overlap the box
+	 *
+	 * \param nb node bounding boxes
+	 * \param nd node
+	 *
+	 */
+	template<typename vbox_type>
+	__device__ __host__ inline bool operator()(const vbox_type & nb, unsigned int nd) const
+	{
+		bool in = true;
+		for (unsigned int i = 0 ; i < dim ; i++)
+		{in &= (b.getLow(i) <= nb.template get<1>(nd)[i]) & (b.getHigh(i) >= nb.template get<0>(nd)[i]);}
+
+		return in;
+	}
+};
+
+/*! \brief Traverse the tree calling f(box_id) for every leaf whose box satisfy the predicate
+ *
+ * Nodes [0,n_leaf-1) are internal nodes, nodes [n_leaf-1,2*n_leaf-1) are leaves, the root is the node 0
+ *
+ * \param nb node bounding boxes
+ * \param nc children of the internal nodes
+ * \param nl box id of the leaves
+ * \param n_leaf number of leaves
+ * \param pred node predicate
+ * \param f function called for each box
+ *
+ */
+template<typename vbox_type, typename vchild_type, typename vleaf_type, typename pred_type, typename funct_type>
+__device__ __host__ inline void bvh_query_impl(const vbox_type & nb, const vchild_type & nc, const vleaf_type & nl,
+		                                        unsigned int n_leaf, const pred_type & pred, funct_type & f)
+{
+	if (n_leaf == 0)	{return;}
+
+	unsigned int stack[BOX_BVH_STACK];
+	int sp = 0;
+	stack[sp++] = 0;
+
+	while (sp != 0)
+	{
+		unsigned int nd = stack[--sp];
+
+		if (pred(nb,nd) == false)	{continue;}
+
+		if (nd >= n_leaf - 1)
+		{
+			f(nl.template get<0>(nd - (n_leaf - 1)));
+			continue;
+		}
+
+		stack[sp++] = nc.template get<1>(nd);
+		stack[sp++] = nc.template get<0>(nd);
+	}
+}
+
+/*! \brief Kernel view of a BoxBVH
+ *
+ * It is a reference to the flat arrays of the tree, usable in a kernel or on host
+ *
+ * \see BoxBVH::toKernel
+ *
+ */
+template<unsigned int dim, typename T, typename vbox_type, typename vchild_type, typename vleaf_type>
+class BoxBVH_ker
+{
+	//! node bounding boxes
+	vbox_type nb;
+
+	//! children of the internal nodes
+	vchild_type nc;
+
+	//! box id of the leaves
+	vleaf_type nl;
+
+	//! number of boxes
+	unsigned int n_leaf;
+
+public:
+
+	//! Constructor
+	BoxBVH_ker(const vbox_type & nb, const vchild_type & nc, const vleaf_type & nl, unsigned int n_leaf)
+	:nb(nb),nc(nc),nl(nl),n_leaf(n_leaf)
+	{}
+
+	/*! \brief Call f(box_id) for every box that contain the point p
+	 *
+	 * \param p point
+	 * \param f function
+	 *
+	 */
+	template<typename funct_type>
+	__device__ __host__ inline void queryPoint(const Point<dim,T> & p, funct_type & f) const
+	{
+		bvh_point_pred<dim,T> pred;
+		pred.p = p;
+
+		bvh_query_impl(nb,nc,nl,n_leaf,pred,f);
+	}
+
+	/*! \brief Call f(box_id) for every box that overlap the box b
+	 *
+	 * \param b box
+	 * \param f function
+	 *
+	 */
+	template<typename funct_type>
+	__device__ __host__ inline void queryBox(const Box<dim,T> & b, funct_type & f) const
+	{
+		bvh_box_pred<dim,T> pred;
+		pred.b = b;
+
+		bvh_query_impl(nb,nc,nl,n_leaf,pred,f);
+	}
+
+	/*! \brief Return the number of boxes
+	 *
+	 * \return the number of boxes
+	 *
+	 */
+	__device__ __host__ inline unsigned int size() const
+	{
+		return n_leaf;
+	}
+};
+
+/*! \brief Bounding volume hierarchy over a set of boxes
+ *
+ * Linear BVH (Karras 2012): the boxes are sorted by the Morton code of their center and every internal
+ * node is built independently from the sorted codes, so the construction is parallel. The tree is stored
+ * in flat arrays (node bounding boxes, children, box id of the leaves), the same arrays are used by the host
+ * queries and by the kernel view returned by toKernel.
+ *
+ * It replace the O(N x M) loops of Box::Intersect / Box::isInside between lists of boxes
+ *
+ * \tparam dim dimensionality
+ * \tparam T type of space
+ *
+ * ### Build and query
+ * \snippet BoxBVH_unit_tests.cpp Build a BVH and query
+ *
+ */
+template<unsigned int dim, typename T, typename Memory = HeapMemory, template<typename> class layout_base = memory_traits_lin>
+class BoxBVH
+{
+	//! bounding box of each node (internal nodes first, then leaves)
+	openfpm::vector<Box<dim,T>,Memory,layout_base> nb;
+
+	//! left and right child of each internal node
+	openfpm::vector<aggregate<unsigned int,unsigned int>,Memory,layout_base> nc;
+
+	//! box id of each leaf
+	openfpm::vector<aggregate<unsigned int>,Memory,layout_base> nl;
+
+	//! number of boxes
+	unsigned int n_leaf = 0;
+
+	/*! \brief Length of the common prefix of the codes i and j, equal codes are distinguished by their position
+	 *
+	 * \param code sorted codes
+	 * \param n number of codes
+	 * \param i first code
+	 * \param j second code
+	 *
+	 * \return the common prefix, -1 if j is out of range
+	 *
+	 */
+	static inline int delta(const uint64_t * code, long int n, long int i, long int j)
+	{
+		if (j < 0 || j >= n)	{return -1;}
+
+		uint64_t a = code[i];
+		uint64_t b = code[j];
+
+		if (a == b)	{return 64 + __builtin_clzll((uint64_t)(i ^ j));}
+
+		return __builtin_clzll(a ^ b);
+	}
+
+	/*! \brief Morton code of the point q (already quantized to bits bits per coordinate)
+	 *
+	 * \param q quantized coordinates
+	 * \param bits bits per coordinate
+	 *
+	 * \return the code
+	 *
+	 */
+	static inline uint64_t morton(const uint64_t (& q)[dim], unsigned int bits)
+	{
+		uint64_t code = 0;
+
+		for (long int b = bits - 1 ; b >= 0 ; b--)
+		{
+			for (unsigned int i = 0 ; i < dim ; i++)
+			{code = (code << 1) | ((q[i] >> b) & 1);}
+		}
+
+		return code;
+	}
+
+	/*! \brief Run a batch of queries in parallel and collect the pairs (query, box)
+	 *
+	 * \param n number of queries
+	 * \param make_pred functor that return the predicate of the query i
+	 * \param res pairs (query id, box id) ordered by query
+	 *
+	 */
+	template<typename pred_maker>
+	void batch(size_t n, pred_maker make_pred, openfpm::vector<aggregate<unsigned int,unsigned int>> & res) const
+	{
+		const int nth = openfpm::ofp_n_threads(n,BOX_BVH_CPU_GRAIN);
+		std::vector<std::vector<std::pair<unsigned int,unsigned int>>> th_res(nth);
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+			for (size_t i = start ; i < stop ; i++)
+			{
+				auto f = [&](unsigned int id){th_res[t].push_back(std::make_pair((unsigned int)i,id));};
+				bvh_query_impl(nb,nc,nl,n_leaf,make_pred(i),f);
+			}
+		}
+
+		std::vector<size_t> off(nth + 1,0);
+		for (int t = 0 ; t < nth ; t++)
+		{off[t+1] = off[t] + th_res[t].size();}
+
+		res.resize(off[nth]);
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			for (size_t i = 0 ; i < th_res[t].size() ; i++)
+			{
+				res.template get<0>(off[t] + i) = th_res[t][i].first;
+				res.template get<1>(off[t] + i) = th_res[t][i].second;
+			}
+		}
+	}
+
+public:
+
+	/*! \brief Build the tree
+	 *
+	 * \tparam vector_box any openfpm::vector of Box or SpaceBox
+	 *
+	 * \param boxes boxes to index
+	 *
+	 */
+	template<typename vector_box>
+	void build(const vector_box & boxes)
+	{
+		const size_t n = boxes.size();
+		n_leaf = n;
+
+		nl.resize(n);
+		nb.resize((n == 0)?0:2*n - 1);
+		nc.resize((n == 0)?0:n - 1);
+
+		if (n == 0)	{return;}
+
+		const int nth = openfpm::ofp_n_threads(n,BOX_BVH_CPU_GRAIN);
+
+		// bounding box of the centers
+
+		std::vector<Box<dim,T>> th_bb(nth);
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+			Box<dim,T> & bb = th_bb[t];
+			for (unsigned int j = 0 ; j < dim ; j++)
+			{
+				bb.setLow(j,std::numeric_limits<T>::max());
+				bb.setHigh(j,std::numeric_limits<T>::lowest());
+			}
+
+			for (size_t i = start ; i < stop ; i++)
+			{
+				Box<dim,T> b = typename vector_box::value_type(boxes.get(i));
+
+				for (unsigned int j = 0 ; j < dim ; j++)
+				{
+					T c = (b.getLow(j) + b.getHigh(j)) / 2;
+					bb.setLow(j,std::min(bb.getLow(j),c));
+					bb.setHigh(j,std::max(bb.getHigh(j),c));
+				}
+			}
+		}
+
+		Box<dim,T> bb = th_bb[0];
+		for (int t = 1 ; t < nth ; t++)
+		{
+			for (unsigned int j = 0 ; j < dim ; j++)
+			{
+				bb.setLow(j,std::min(bb.getLow(j),th_bb[t].getLow(j)));
+				bb.setHigh(j,std::max(bb.getHigh(j),th_bb[t].getHigh(j)));
+			}
+		}
+
+		// Morton code of the centers, sorted
+
+		const unsigned int bits = std::min(32u,63u / dim);
+		const double q_max = (double)(((uint64_t)1 << bits) - 1);
+
+		std::vector<uint64_t> code(n);
+		std::vector<unsigned int> id(n);
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+			for (size_t i = start ; i < stop ; i++)
+			{
+				Box<dim,T> b = typename vector_box::value_type(boxes.get(i));
+				uint64_t q[dim];
+
+				for (unsigned int j = 0 ; j < dim ; j++)
+				{
+					double ext = (double)bb.getHigh(j) - (double)bb.getLow(j);
+					double c = ((double)b.getLow(j) + (double)b.getHigh(j)) / 2.0;
+
+					q[j] = (ext > 0.0)?(uint64_t)((c - bb.getLow(j)) / ext * q_max):0;
+				}
+
+				code[i] = morton(q,bits);
+				id[i] = i;
+			}
+		}
+
+		openfpm::radix_sort_cpu(code.data(),id.data(),n);
+
+		// leaves and internal nodes (every internal node is calculated independently)
+
+		std::vector<unsigned int> parent(2*n - 1,0);
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+			for (size_t i = start ; i < stop ; i++)
+			{
+				nl.template get<0>(i) = id[i];
+				nb.set(n - 1 + i,Box<dim,T>(typename vector_box::value_type(boxes.get(id[i]))));
+
+				if (i == n - 1)	{continue;}
+
+				const long int ln = n;
+				const long int li = i;
+
+				// direction of the range
+
+				int d = (delta(code.data(),ln,li,li+1) - delta(code.data(),ln,li,li-1) >= 0)?1:-1;
+				int d_min = delta(code.data(),ln,li,li-d);
+
+				// other end of the range
+
+				long int l_max = 2;
+				while (delta(code.data(),ln,li,li + l_max*d) > d_min)	{l_max *= 2;}
+
+				long int l = 0;
+				for (long int s = l_max / 2 ; s >= 1 ; s /= 2)
+				{
+					if (delta(code.data(),ln,li,li + (l + s)*d) > d_min)	{l += s;}
+				}
+
+				long int j = li + l*d;
+				int d_node = delta(code.data(),ln,li,j);
+
+				// split position
+
+				long int s = 0;
+				long int st = l;
+				do
+				{
+					st = (st + 1) / 2;
+					if (delta(code.data(),ln,li,li + (s + st)*d) > d_node)	{s += st;}
+				}
+				while (st > 1);
+
+				long int gamma = li + s*d + std::min(d,0);
+
+				unsigned int left = (std::min(li,j) == gamma)?n - 1 + gamma:gamma;
+				unsigned int right = (std::max(li,j) == gamma + 1)?n - 1 + gamma + 1:gamma + 1;
+
+				nc.template get<0>(i) = left;
+				nc.template get<1>(i) = right;
+
+				parent[left] = i;
+				parent[right] = i;
+			}
+		}
+
+		// bounding boxes from the leaves to the root, the second child that reach a node calculate its box
+
+		std::unique_ptr<std::atomic<int>[]> visit(new std::atomic<int>[n]);
+		for (size_t i = 0 ; i < n ; i++)	{visit[i].store(0,std::memory_order_relaxed);}
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+			for (size_t i = start ; i < stop ; i++)
+			{
+				unsigned int nd = n - 1 + i;
+
+				while (nd != 0)
+				{
+					nd = parent[nd];
+
+					if (visit[nd].fetch_add(1,std::memory_order_acq_rel) == 0)	{break;}
+
+					unsigned int l = nc.template get<0>(nd);
+					unsigned int r = nc.template get<1>(nd);
+
+					for (unsigned int j = 0 ; j < dim ; j++)
+					{
+						nb.template get<0>(nd)[j] = std::min(nb.template get<0>(l)[j],nb.template get<0>(r)[j]);
+						nb.template get<1>(nd)[j] = std::max(nb.template get<1>(l)[j],nb.template get<1>(r)[j]);
+					}
+				}
+			}
+		}
+	}
+
+	/*! \brief Return the number of boxes
+	 *
+	 * \return the number of boxes
+	 *
+	 */
+	size_t size() const
+	{
+		return n_leaf;
+	}
+
+	/*! \brief Return the bounding box of all the boxes
+	 *
+	 * \return the bounding box (the box of the root node)
+	 *
+	 */
+	Box<dim,T> getBoundingBox() const
+	{
+		return nb.get(0);
+	}
+
+	/*! \brief Call f(box_id) for every box that contain the point p
+	 *
+	 * \param p point
+	 * \param f function
+	 *
+	 */
+	template<typename funct_type>
+	void queryPoint(const Point<dim,T> & p, funct_type f) const
+	{
+		bvh_point_pred<dim,T> pred;
+		pred.p = p;
+
+		bvh_query_impl(nb,nc,nl,n_leaf,pred,f);
+	}
+
+	/*! \brief Call f(box_id) for every box that overlap the box b
+	 *
+	 * \param b box
+	 * \param f function
+	 *
+	 */
+	template<typename funct_type>
+	void queryBox(const Box<dim,T> & b, funct_type f) const
+	{
+		bvh_box_pred<dim,T> pred;
+		pred.b = b;
+
+		bvh_query_impl(nb,nc,nl,n_leaf,pred,f);
+	}
+
+	/*! \brief Locate a batch of points (in parallel)
+	 *
+	 * \param pts points
+	 * \param res pairs (point id, box id) for every box that contain a point, ordered by point
+	 *
+	 */
+	template<typename vector_point>
+	void findPoints(const vector_point & pts, openfpm::vector<aggregate<unsigned int,unsigned int>> & res) const
+	{
+		batch(pts.size(),[&](size_t i)
+		{
+			bvh_point_pred<dim,T> pred;
+			pred.p = typename vector_point::value_type(pts.get(i));
+			return pred;
+		},res);
+	}
+
+	/*! \brief Find the overlaps of a batch of boxes (in parallel)
+	 *
+	 * \param qb query boxes (any openfpm::vector of Box or SpaceBox)
+	 * \param res pairs (query id, box id) for every box that overlap a query box, ordered by query
+	 *
+	 */
+	template<typename vector_box>
+	void findOverlaps(const vector_box & qb, openfpm::vector<aggregate<unsigned int,unsigned int>> & res) const
+	{
+		batch(qb.size(),[&](size_t i)
+		{
+			bvh_box_pred<dim,T> pred;
+			pred.b = typename vector_box::value_type(qb.get(i));
+			return pred;
+		},res);
+	}
+
+	/*! \brief Return a view of the tree usable in a kernel
+	 *
+	 * \return the kernel view
+	 *
+	 */
+	BoxBVH_ker<dim,T,decltype(nb.toKernel()),decltype(nc.toKernel()),decltype(nl.toKernel())> toKernel()
+	{
+		return BoxBVH_ker<dim,T,decltype(nb.toKernel()),decltype(nc.toKernel()),decltype(nl.toKernel())>(nb.toKernel(),nc.toKernel(),nl.toKernel(),n_leaf);
+	}
+
+	/*! \brief Copy the tree on device
+	 *
+	 */
+	void hostToDevice()
+	{
+		nb.template hostToDevice<0,1>();
+		nc.template hostToDevice<0,1>();
+		nl.template hostToDevice<0>();
+	}
+};
+
+#endif /* BOXBVH_HPP_ */
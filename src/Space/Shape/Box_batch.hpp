@@ -0,0 +1,348 @@
+/*
+ * Box_batch.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef BOX_BATCH_HPP_
+#define BOX_BATCH_HPP_
+
+#include <Vc/Vc>
+#include <vector>
+#include "Space/Shape/Box.hpp"
+#include "Vector/map_vector.hpp"
+#include "util/multi_thread_util.hpp"
+
+/*! \brief Batched (SIMD) geometric predicates on points stored as structure of arrays
+ *
+ * Box::isInside, Box::isInsideNP, Point::distance2 and the cell id of a regular grid evaluated with Vc
+ * vectors on many points. The coordinates are read from a Point_soa view, that can be created from an
+ * openfpm::vector<Point<dim,T>> with layout memory_traits_inte (one array per coordinate). Big batches are
+ * split across threads
+ *
+ * ### Batched predicates
+ * \snippet Box_unit_tests.hpp Batched predicates
+ *
+ */
+
+//! Under this number of points the batch functions run on a single thread
+#define BOX_BATCH_CPU_GRAIN 16384
+
+/*! \brief View of n points stored as structure of arrays (one array for each coordinate)
+ *
+ * \tparam dim dimensionality
+ * \tparam T type of space
+ *
+ */
+template<unsigned int dim, typename T>
+struct Point_soa
+{
+	//! array of each coordinate
+	const T * x[dim];
+
+	//! number of points
+	size_t n;
+
+	/*! \brief Constructor from raw arrays
+	 *
+	 * \param xs pointer to the array of each coordinate
+	 * \param n number of points
+	 *
+	 */
+	Point_soa(const T * (& xs)[dim], size_t n)
+	:n(n)
+	{
+		for (size_t i = 0 ; i < dim ; i++)
+		{x[i] = xs[i];}
+	}
+
+	/*! \brief Constructor from a vector of points with interleaved (SoA) layout
+	 *
+	 * \param v vector of points
+	 *
+	 */
+	template<typename Memory, typename grow_p, unsigned int impl>
+	Point_soa(const openfpm::vector<Point<dim,T>,Memory,memory_traits_inte,grow_p,impl> & v)
+	:n(v.size())
+	{
+		for (size_t i = 0 ; i < dim ; i++)
+		{x[i] = (n == 0)?nullptr:&v.template get<0>(0)[i];}
+	}
+
+	/*! \brief Return the point i
+	 *
+	 * \param i point id
+	 *
+	 * \return the point
+	 *
+	 */
+	inline Point<dim,T> get(size_t i) const
+	{
+		Point<dim,T> p;
+		for (size_t j = 0 ; j < dim ; j++)
+		{p.get(j) = x[j][i];}
+
+		return p;
+	}
+};
+
+/*! \brief Process the points [0,n) in blocks of Vc::Vector<T>::Size, the remainder one by one
+ *
+ * Every thread process a contiguous range of points
+ *
+ * \param n number of points
+ * \param f_simd function called with the first point of a block f_simd(t,i)
+ * \param f_sc function called for a single point f_sc(t,i)
+ *
+ * \return the number of threads used
+ *
+ */
+template<typename T, typename simd_type, typename sc_type>
+int box_batch_run(size_t n, simd_type f_simd, sc_type f_sc)
+{
+	const size_t vs = Vc::Vector<T>::Size;
+	const int nth = openfpm::ofp_n_threads(n,BOX_BATCH_CPU_GRAIN);
+
+	#pragma omp parallel for num_threads(nth) schedule(static,1)
+	for (int t = 0 ; t < nth ; t++)
+	{
+		size_t start;
+		size_t stop;
+		openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+		size_t i = start;
+		for ( ; i + vs <= stop ; i += vs)
+		{f_simd(t,i);}
+
+		for ( ; i < stop ; i++)
+		{f_sc(t,i);}
+	}
+
+	return nth;
+}
+
+/*! \brief Mask of the points inside the box, like Box::isInside (np = false) or Box::isInsideNP (np = true)
+ *
+ * \tparam np exclude the positive border
+ *
+ * \param b box
+ * \param i first point
+ * \param p points
+ *
+ * \return the mask
+ *
+ */
+template<bool np, unsigned int dim, typename T>
+inline typename Vc::Vector<T>::MaskType box_inside_simd(const Box<dim,T> & b, size_t i, const Point_soa<dim,T> & p)
+{
+	Vc::Vector<T> xv(p.x[0] + i,Vc::Unaligned);
+	typename Vc::Vector<T>::MaskType m = (xv >= Vc::Vector<T>(b.getLow(0)));
+	m &= (np == true)?(xv < Vc::Vector<T>(b.getHigh(0))):(xv <= Vc::Vector<T>(b.getHigh(0)));
+
+	for (size_t j = 1 ; j < dim ; j++)
+	{
+		xv.load(p.x[j] + i,Vc::Unaligned);
+		m &= (xv >= Vc::Vector<T>(b.getLow(j)));
+		m &= (np == true)?(xv < Vc::Vector<T>(b.getHigh(j))):(xv <= Vc::Vector<T>(b.getHigh(j)));
+	}
+
+	return m;
+}
+
+/*! \brief Check if the point i is inside the box
+ *
+ * \tparam np exclude the positive border
+ *
+ * \param b box
+ * \param i point
+ * \param p points
+ *
+ * \return true if inside
+ *
+ */
+template<bool np, unsigned int dim, typename T>
+inline bool box_inside_sc(const Box<dim,T> & b, size_t i, const Point_soa<dim,T> & p)
+{
+	bool in = true;
+	for (size_t j = 0 ; j < dim ; j++)
+	{
+		in &= (p.x[j][i] >= b.getLow(j));
+		in &= (np == true)?(p.x[j][i] < b.getHigh(j)):(p.x[j][i] <= b.getHigh(j));
+	}
+
+	return in;
+}
+
+/*! \brief For each point set mask[i] to 1 if it is inside the box (border included, like Box::isInside)
+ *
+ * \param b box
+ * \param p points
+ * \param mask output (p.n elements)
+ *
+ */
+template<bool np = false, unsigned int dim, typename T>
+void batch_isInside(const Box<dim,T> & b, const Point_soa<dim,T> & p, unsigned char * mask)
+{
+	box_batch_run<T>(p.n,[&](int t, size_t i)
+	{
+		auto m = box_inside_simd<np>(b,i,p);
+
+		for (size_t l = 0 ; l < Vc::Vector<T>::Size ; l++)
+		{mask[i+l] = m[l];}
+	},
+	[&](int t, size_t i)
+	{
+		mask[i] = box_inside_sc<np>(b,i,p);
+	});
+}
+
+/*! \brief For each point set mask[i] to 1 if it is inside the box excluding the positive border (like Box::isInsideNP)
+ *
+ * \param b box
+ * \param p points
+ * \param mask output (p.n elements)
+ *
+ */
+template<unsigned int dim, typename T>
+void batch_isInsideNP(const Box<dim,T> & b, const Point_soa<dim,T> & p, unsigned char * mask)
+{
+	batch_isInside<true>(b,p,mask);
+}
+
+/*! \brief Compacted list of the points inside the box
+ *
+ * \tparam np exclude the positive border (like Box::isInsideNP)
+ *
+ * \param b box
+ * \param p points
+ * \param ids output, the ids of the points inside in increasing order
+ *
+ */
+template<bool np = false, unsigned int dim, typename T>
+void batch_isInside_ids(const Box<dim,T> & b, const Point_soa<dim,T> & p, openfpm::vector<aggregate<unsigned int>> & ids)
+{
+	std::vector<std::vector<unsigned int>> th_ids(openfpm::ofp_n_threads(p.n,BOX_BATCH_CPU_GRAIN));
+
+	int nth = box_batch_run<T>(p.n,[&](int t, size_t i)
+	{
+		unsigned int bits = box_inside_simd<np>(b,i,p).toInt();
+
+		while (bits != 0)
+		{
+			th_ids[t].push_back(i + __builtin_ctz(bits));
+			bits &= bits - 1;
+		}
+	},
+	[&](int t, size_t i)
+	{
+		if (box_inside_sc<np>(b,i,p) == true)
+		{th_ids[t].push_back(i);}
+	});
+
+	std::vector<size_t> off(nth + 1,0);
+	for (int t = 0 ; t < nth ; t++)
+	{off[t+1] = off[t] + th_ids[t].size();}
+
+	ids.resize(off[nth]);
+
+	#pragma omp parallel for num_threads(nth) schedule(static,1)
+	for (int t = 0 ; t < nth ; t++)
+	{
+		for (size_t i = 0 ; i < th_ids[t].size() ; i++)
+		{ids.template get<0>(off[t] + i) = th_ids[t][i];}
+	}
+}
+
+/*! \brief Square distance of every point from c (like Point::distance2)
+ *
+ * \param c point
+ * \param p points
+ * \param d2 output (p.n elements)
+ *
+ */
+template<unsigned int dim, typename T>
+void batch_distance2(const Point<dim,T> & c, const Point_soa<dim,T> & p, T * d2)
+{
+	box_batch_run<T>(p.n,[&](int t, size_t i)
+	{
+		Vc::Vector<T> d(Vc::Vector<T>::Zero());
+
+		for (size_t j = 0 ; j < dim ; j++)
+		{
+			Vc::Vector<T> dx = Vc::Vector<T>(p.x[j] + i,Vc::Unaligned) - Vc::Vector<T>(c.get(j));
+			d += dx*dx;
+		}
+
+		d.store(d2 + i,Vc::Unaligned);
+	},
+	[&](int t, size_t i)
+	{
+		T d = 0;
+		for (size_t j = 0 ; j < dim ; j++)
+		{d += (p.x[j][i] - c.get(j)) * (p.x[j][i] - c.get(j));}
+
+		d2[i] = d;
+	});
+}
+
+/*! \brief Linearized cell id of every point in a regular grid of div cells over the box dom
+ *
+ * Points outside the box are assigned to the nearest border cell
+ *
+ * \param dom box covered by the grid
+ * \param div number of cells in each direction
+ * \param p points
+ * \param ids output (p.n elements)
+ *
+ */
+template<unsigned int dim, typename T>
+void batch_cell_id(const Box<dim,T> & dom, const size_t (& div)[dim], const Point_soa<dim,T> & p, size_t * ids)
+{
+	T inv_sp[dim];
+	size_t stride[dim];
+
+	for (size_t j = 0 ; j < dim ; j++)
+	{
+		inv_sp[j] = div[j] / (dom.getHigh(j) - dom.getLow(j));
+		stride[j] = (j == 0)?1:stride[j-1] * div[j-1];
+	}
+
+	box_batch_run<T>(p.n,[&](int t, size_t i)
+	{
+		const size_t vs = Vc::Vector<T>::Size;
+		size_t id[vs];
+		T c[vs];
+
+		for (size_t l = 0 ; l < vs ; l++)	{id[l] = 0;}
+
+		for (size_t j = 0 ; j < dim ; j++)
+		{
+			Vc::Vector<T> cv = Vc::floor((Vc::Vector<T>(p.x[j] + i,Vc::Unaligned) - Vc::Vector<T>(dom.getLow(j))) * Vc::Vector<T>(inv_sp[j]));
+			cv = Vc::max(Vc::min(cv,Vc::Vector<T>((T)(div[j] - 1))),Vc::Vector<T>::Zero());
+			cv.store(c,Vc::Unaligned);
+
+			for (size_t l = 0 ; l < vs ; l++)
+			{id[l] += (size_t)c[l] * stride[j];}
+		}
+
+		for (size_t l = 0 ; l < vs ; l++)
+		{ids[i+l] = id[l];}
+	},
+	[&](int t, size_t i)
+	{
+		size_t id = 0;
+
+		for (size_t j = 0 ; j < dim ; j++)
+		{
+			T c = std::floor((p.x[j][i] - dom.getLow(j)) * inv_sp[j]);
+			c = std::max(std::min(c,(T)(div[j] - 1)),(T)0);
+
+			id += (size_t)c * stride[j];
+		}
+
+		ids[i] = id;
+	});
+}
+
+#endif /* BOX_BATCH_HPP_ */
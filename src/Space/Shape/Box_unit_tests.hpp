@@ -8,6 +8,8 @@
 #ifndef BOX_UNIT_TESTS_HPP_
 #define BOX_UNIT_TESTS_HPP_
 
+#include "Space/Shape/Box_batch.hpp"
+
 BOOST_AUTO_TEST_SUITE( box_test )
 
 BOOST_AUTO_TEST_CASE( box_use)
@@ -486,6 +488,82 @@ BOOST_AUTO_TEST_CASE( box_is_inside_with_border )
 	BOOST_REQUIRE_EQUAL(result,false);
 }
 
+BOOST_AUTO_TEST_CASE( box_batch_predicates )
+{
+	typedef openfpm::vector<Point<3,float>,HeapMemory,memory_traits_inte> vector_soa;
+
+	// 1003 points (not a multiple of the SIMD width) on a lattice, some of them on the border of the box
+
+	vector_soa pos;
+	pos.resize(1003);
+
+	for (size_t i = 0 ; i < pos.size() ; i++)
+	{
+		pos.template get<0>(i)[0] = (i % 11) * 0.1;
+		pos.template get<0>(i)[1] = ((i / 11) % 13) * 0.1;
+		pos.template get<0>(i)[2] = (i / 143) * 0.1 - 0.05;
+	}
+
+	Box<3,float> b({0.2,0.3,0.0},{0.5,0.8,0.45});
+	size_t div[3] = {4,5,6};
+
+	//! [Batched predicates]
+
+	Point_soa<3,float> p(pos);
+
+	// mask of the points inside
+	std::vector<unsigned char> in(p.n);
+	batch_isInside(b,p,in.data());
+
+	// ids of the points inside excluding the positive border
+	openfpm::vector<aggregate<unsigned int>> ids_np;
+	batch_isInside_ids<true>(b,p,ids_np);
+
+	// square distance from the center of the box
+	std::vector<float> d2(p.n);
+	batch_distance2(b.middle(),p,d2.data());
+
+	// cell id of each point in a 4x5x6 grid covering the box
+	std::vector<size_t> cid(p.n);
+	batch_cell_id(b,div,p,cid.data());
+
+	//! [Batched predicates]
+
+	grid_sm<3,void> gs(div);
+	Point<3,float> c = b.middle();
+
+	bool match = true;
+	size_t k = 0;
+
+	for (size_t i = 0 ; i < p.n ; i++)
+	{
+		Point<3,float> x = p.get(i);
+
+		match &= ((bool)in[i] == b.isInside(x));
+
+		if (b.isInsideNP(x) == true)
+		{
+			match &= (k < ids_np.size() && ids_np.template get<0>(k) == i);
+			k++;
+		}
+
+		match &= (fabs(d2[i] - c.distance2(x)) < 1e-6);
+
+		grid_key_dx<3> key;
+		for (size_t j = 0 ; j < 3 ; j++)
+		{
+			long int cj = floor((x.get(j) - b.getLow(j)) * (float)div[j] / (b.getHigh(j) - b.getLow(j)));
+			cj = std::max(std::min(cj,(long int)div[j] - 1),0l);
+			key.set_d(j,cj);
+		}
+
+		match &= (cid[i] == gs.LinId(key));
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+	BOOST_REQUIRE_EQUAL(k,ids_np.size());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -0,0 +1,190 @@
+/*
+ * space_performance_tests.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef OPENFPM_DATA_SRC_SPACE_PERFORMANCE_SPACE_PERFORMANCE_TESTS_HPP_
+#define OPENFPM_DATA_SRC_SPACE_PERFORMANCE_SPACE_PERFORMANCE_TESTS_HPP_
+
+#include <random>
+#include "Space/BoxBVH.hpp"
+#include "Space/tests/BoxBVH_util_test.hpp"
+#include "Space/Shape/Box_batch.hpp"
+#include "util/performance/benchmark_store.hpp"
+
+/*! \brief CPU performance of the spatial queries on boxes
+ *
+ * * box_bvh_build, box_bvh_overlap: construction of a BoxBVH and overlap query of as many boxes as in the tree
+ * * box_bvh_overlap_bf: brute force overlap query of a subset of the boxes, for comparison
+ * * box_is_inside: point in box one point at the time (AoS) and with batch_isInside (SoA)
+ * * box_cell_id: cell of the points with batch_cell_id
+ *
+ * The measures are appended to space_performance_funcs.jsonl and checked for regressions against
+ * $OPENFPM_PERFORMANCE_TEST_DIR/openfpm_data/space_performance_funcs_ref.jsonl
+ *
+ */
+
+//! Number of repetitions for each measure
+constexpr int N_STAT_SPACE = 5;
+
+//! All the samples of the measures
+benchmark_store space_perf_store;
+
+BOOST_AUTO_TEST_SUITE( space_performance )
+
+BOOST_AUTO_TEST_CASE(space_performance_box_bvh)
+{
+	std::mt19937 gen(7);
+
+	const size_t n = 100000;
+	const size_t n_bf = 100;
+
+	openfpm::vector<Box<3,float>> boxes;
+	openfpm::vector<Box<3,float>> qb;
+
+	bvh_random_boxes<3>(boxes,n,0.02,gen);
+	bvh_random_boxes<3>(qb,n,0.02,gen);
+
+	std::vector<double> t_b;
+	std::vector<double> t_q;
+	std::vector<double> t_bf;
+
+	// the first run is a warm-up
+
+	for (size_t k = 0 ; k < N_STAT_SPACE + 1 ; k++)
+	{
+		timer t;
+		t.start();
+		BoxBVH<3,float> bvh;
+		bvh.build(boxes);
+		t.stop();
+		double tb = t.getwct();
+
+		t.start();
+		openfpm::vector<aggregate<unsigned int,unsigned int>> res;
+		bvh.findOverlaps(qb,res);
+		t.stop();
+		double tq = t.getwct();
+
+		t.start();
+		size_t cnt_bf = 0;
+		for (size_t i = 0 ; i < n_bf ; i++)
+		{
+			Box<3,float> bq = qb.get(i);
+			for (size_t j = 0 ; j < n ; j++)
+			{
+				Box<3,float> b_out;
+				Box<3,float> b = boxes.get(j);
+				cnt_bf += bq.Intersect(b,b_out);
+			}
+		}
+		t.stop();
+		double tbf = t.getwct();
+
+		size_t cnt = 0;
+		for (size_t i = 0 ; i < res.size() && res.template get<0>(i) < n_bf ; i++)	{cnt++;}
+		BOOST_REQUIRE_EQUAL(cnt,cnt_bf);
+
+		if (k == 0)	{continue;}
+
+		t_b.push_back(tb);
+		t_q.push_back(tq);
+		t_bf.push_back(tbf);
+	}
+
+	space_perf_store.add("box_bvh_build",{{"n_box",std::to_string(n)}},t_b);
+	space_perf_store.add("box_bvh_overlap",{{"n_box",std::to_string(n)},{"n_query",std::to_string(n)}},t_q);
+	space_perf_store.add("box_bvh_overlap_bf",{{"n_box",std::to_string(n)},{"n_query",std::to_string(n_bf)}},t_bf);
+}
+
+BOOST_AUTO_TEST_CASE(space_performance_box_batch)
+{
+	typedef openfpm::vector<Point<3,float>,HeapMemory,memory_traits_inte> vector_soa;
+
+	const size_t n = 4000000;
+
+	vector_soa pos;
+	openfpm::vector<Point<3,float>> pos_aos;
+	pos.resize(n);
+	pos_aos.resize(n);
+
+	std::mt19937 gen(11);
+	std::uniform_real_distribution<float> ud(0.0,1.0);
+
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		for (size_t j = 0 ; j < 3 ; j++)
+		{
+			pos.template get<0>(i)[j] = ud(gen);
+			pos_aos.template get<0>(i)[j] = pos.template get<0>(i)[j];
+		}
+	}
+
+	Box<3,float> b({0.1,0.2,0.3},{0.6,0.7,0.8});
+	Box<3,float> dom({0.0,0.0,0.0},{1.0,1.0,1.0});
+	size_t div[3] = {64,64,64};
+
+	Point_soa<3,float> p(pos);
+	std::vector<unsigned char> in(n);
+	std::vector<size_t> cid(n);
+
+	std::vector<double> t_sc;
+	std::vector<double> t_b;
+	std::vector<double> t_c;
+
+	// the first run is a warm-up
+
+	for (size_t k = 0 ; k < N_STAT_SPACE + 1 ; k++)
+	{
+		timer t;
+		t.start();
+		size_t cnt_sc = 0;
+		for (size_t i = 0 ; i < n ; i++)
+		{
+			Point<3,float> x = pos_aos.get(i);
+			in[i] = b.isInside(x);
+			cnt_sc += in[i];
+		}
+		t.stop();
+		double tsc = t.getwct();
+
+		t.start();
+		batch_isInside(b,p,in.data());
+		t.stop();
+		double tb = t.getwct();
+
+		size_t cnt = 0;
+		for (size_t i = 0 ; i < n ; i++)	{cnt += in[i];}
+		BOOST_REQUIRE_EQUAL(cnt,cnt_sc);
+
+		t.start();
+		batch_cell_id(dom,div,p,cid.data());
+		t.stop();
+		double tc = t.getwct();
+
+		if (k == 0)	{continue;}
+
+		t_sc.push_back(tsc);
+		t_b.push_back(tb);
+		t_c.push_back(tc);
+	}
+
+	space_perf_store.add("box_is_inside",{{"method","one_by_one"},{"n_point",std::to_string(n)}},t_sc);
+	space_perf_store.add("box_is_inside",{{"method","batch"},{"n_point",std::to_string(n)}},t_b);
+	space_perf_store.add("box_cell_id",{{"method","batch"},{"n_point",std::to_string(n)}},t_c);
+}
+
+/////// THIS IS NOT A TEST IT WRITE THE PERFORMANCE RESULT ///////
+
+BOOST_AUTO_TEST_CASE(space_performance_write_report)
+{
+	size_t n_reg = benchmark_write_and_check(space_perf_store,"space_performance_funcs",std::string(test_dir) + "/openfpm_data");
+
+	BOOST_REQUIRE_EQUAL(n_reg,0ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif /* OPENFPM_DATA_SRC_SPACE_PERFORMANCE_SPACE_PERFORMANCE_TESTS_HPP_ */
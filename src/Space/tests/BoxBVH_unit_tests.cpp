@@ -0,0 +1,254 @@
+/*
+ * BoxBVH_unit_tests.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <algorithm>
+#include "Space/SpaceBox.hpp"
+#include "Space/BoxBVH.hpp"
+#include "Space/tests/BoxBVH_util_test.hpp"
+
+/*! \brief Check the result of a batched query against the brute force result
+ *
+ * \param res pairs (query,box) returned by the BVH
+ * \param n_q number of queries
+ * \param bf brute force, return the sorted list of boxes of the query i
+ *
+ * \return true if they match
+ *
+ */
+template<typename bf_type>
+bool bvh_check_batch(openfpm::vector<aggregate<unsigned int,unsigned int>> & res, size_t n_q, bf_type bf)
+{
+	size_t k = 0;
+
+	for (size_t i = 0 ; i < n_q ; i++)
+	{
+		std::vector<unsigned int> ids;
+		while (k < res.size() && res.template get<0>(k) == i)
+		{
+			ids.push_back(res.template get<1>(k));
+			k++;
+		}
+
+		std::sort(ids.begin(),ids.end());
+
+		if (ids != bf(i))	{return false;}
+	}
+
+	return k == res.size();
+}
+
+BOOST_AUTO_TEST_SUITE( box_bvh_test )
+
+BOOST_AUTO_TEST_CASE( box_bvh_point_and_overlap )
+{
+	std::mt19937 gen(5);
+
+	openfpm::vector<Box<3,float>> boxes;
+	openfpm::vector<Box<3,float>> qb;
+	openfpm::vector<Point<3,float>> pts;
+
+	bvh_random_boxes<3>(boxes,3000,0.1,gen);
+	bvh_random_boxes<3>(qb,1000,0.05,gen);
+
+	std::uniform_real_distribution<float> ud(0.0,1.0);
+	pts.resize(2000);
+	for (size_t i = 0 ; i < pts.size() ; i++)
+	{
+		for (size_t j = 0 ; j < 3 ; j++)
+		{pts.template get<0>(i)[j] = ud(gen);}
+	}
+
+	//! [Build a BVH and query]
+
+	BoxBVH<3,float> bvh;
+	bvh.build(boxes);
+
+	// all the pairs (point,box) with the point inside the box
+	openfpm::vector<aggregate<unsigned int,unsigned int>> res_p;
+	bvh.findPoints(pts,res_p);
+
+	// all the pairs (query box,box) that overlap
+	openfpm::vector<aggregate<unsigned int,unsigned int>> res_b;
+	bvh.findOverlaps(qb,res_b);
+
+	// single query
+	size_t cnt = 0;
+	bvh.queryPoint(Point<3,float>(pts.get(0)),[&](unsigned int id){cnt++;});
+
+	//! [Build a BVH and query]
+
+	BOOST_REQUIRE_EQUAL(bvh.size(),boxes.size());
+
+	bool match = bvh_check_batch(res_p,pts.size(),[&](size_t i)
+	{
+		std::vector<unsigned int> ids;
+		for (size_t j = 0 ; j < boxes.size() ; j++)
+		{
+			Box<3,float> b = boxes.get(j);
+			if (b.isInside(Point<3,float>(pts.get(i))))	{ids.push_back(j);}
+		}
+		return ids;
+	});
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	match = bvh_check_batch(res_b,qb.size(),[&](size_t i)
+	{
+		std::vector<unsigned int> ids;
+		Box<3,float> bq = qb.get(i);
+		for (size_t j = 0 ; j < boxes.size() ; j++)
+		{
+			Box<3,float> b_out;
+			Box<3,float> b = boxes.get(j);
+			if (bq.Intersect(b,b_out))	{ids.push_back(j);}
+		}
+		return ids;
+	});
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	size_t cnt_bf = 0;
+	for (size_t i = 0 ; i < res_p.size() ; i++)	{cnt_bf += (res_p.template get<0>(i) == 0);}
+	BOOST_REQUIRE_EQUAL(cnt,cnt_bf);
+
+	// the kernel view give the same results
+
+	auto bvh_k = bvh.toKernel();
+
+	size_t cnt_k = 0;
+	auto f = [&](unsigned int id){cnt_k++;};
+	for (size_t i = 0 ; i < qb.size() ; i++)
+	{bvh_k.queryBox(Box<3,float>(qb.get(i)),f);}
+
+	BOOST_REQUIRE_EQUAL(cnt_k,res_b.size());
+}
+
+BOOST_AUTO_TEST_CASE( box_bvh_subdomains )
+{
+	// 2D decomposition of the unit square in 16x16 sub-domains, the sub-domains touch
+	// their neighbours (Box::Intersect consider closed boxes)
+
+	const size_t n_d = 16;
+	openfpm::vector<SpaceBox<2,double>> sub;
+
+	for (size_t i = 0 ; i < n_d ; i++)
+	{
+		for (size_t j = 0 ; j < n_d ; j++)
+		{
+			SpaceBox<2,double> b({i / (double)n_d, j / (double)n_d},{(i + 1) / (double)n_d, (j + 1) / (double)n_d});
+			sub.add(b);
+		}
+	}
+
+	BoxBVH<2,double> bvh;
+	bvh.build(sub);
+
+	openfpm::vector<aggregate<unsigned int,unsigned int>> res;
+	bvh.findOverlaps(sub,res);
+
+	size_t n_inner = (n_d - 2) * (n_d - 2);
+	size_t n_border = 4 * (n_d - 2);
+	BOOST_REQUIRE_EQUAL(res.size(),n_inner * 9 + n_border * 6 + 4 * 4);
+
+	// point location of the centers
+
+	openfpm::vector<Point<2,double>> pts;
+	for (size_t i = 0 ; i < sub.size() ; i++)
+	{pts.add(SpaceBox<2,double>(sub.get(i)).middle());}
+
+	bvh.findPoints(pts,res);
+
+	BOOST_REQUIRE_EQUAL(res.size(),sub.size());
+
+	bool match = true;
+	for (size_t i = 0 ; i < res.size() ; i++)
+	{match &= (res.template get<0>(i) == i && res.template get<1>(i) == i);}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE( box_bvh_degenerate )
+{
+	BoxBVH<3,float> bvh;
+	openfpm::vector<Box<3,float>> boxes;
+
+	// empty
+
+	bvh.build(boxes);
+
+	size_t cnt = 0;
+	bvh.queryBox(Box<3,float>({0.0,0.0,0.0},{1.0,1.0,1.0}),[&](unsigned int id){cnt++;});
+	BOOST_REQUIRE_EQUAL(cnt,0ul);
+
+	// one box
+
+	boxes.add(Box<3,float>({0.0,0.0,0.0},{0.5,0.5,0.5}));
+	bvh.build(boxes);
+
+	bvh.queryPoint(Point<3,float>({0.25,0.25,0.25}),[&](unsigned int id){cnt += id + 1;});
+	BOOST_REQUIRE_EQUAL(cnt,1ul);
+
+	// many equal boxes (equal Morton codes)
+
+	Box<3,float> b0 = boxes.get(0);
+	for (size_t i = 0 ; i < 999 ; i++)	{boxes.add(b0);}
+	bvh.build(boxes);
+
+	std::vector<unsigned int> ids;
+	bvh.queryPoint(Point<3,float>({0.5,0.5,0.5}),[&](unsigned int id){ids.push_back(id);});
+	std::sort(ids.begin(),ids.end());
+
+	BOOST_REQUIRE_EQUAL(ids.size(),1000ul);
+	for (size_t i = 0 ; i < ids.size() ; i++)	{BOOST_REQUIRE_EQUAL(ids[i],i);}
+
+	cnt = 0;
+	bvh.queryPoint(Point<3,float>({0.6,0.5,0.5}),[&](unsigned int id){cnt++;});
+	BOOST_REQUIRE_EQUAL(cnt,0ul);
+}
+
+BOOST_AUTO_TEST_CASE( box_bvh_overlap_brute_force )
+{
+	std::mt19937 gen(7);
+
+	// enough boxes to build the tree with multiple threads
+
+	const size_t n = 20000;
+	const size_t n_q = 200;
+
+	openfpm::vector<Box<3,float>> boxes;
+	openfpm::vector<Box<3,float>> qb;
+
+	bvh_random_boxes<3>(boxes,n,0.02,gen);
+	bvh_random_boxes<3>(qb,n_q,0.02,gen);
+
+	BoxBVH<3,float> bvh;
+	bvh.build(boxes);
+
+	openfpm::vector<aggregate<unsigned int,unsigned int>> res;
+	bvh.findOverlaps(qb,res);
+
+	bool match = bvh_check_batch(res,qb.size(),[&](size_t i)
+	{
+		std::vector<unsigned int> ids;
+		Box<3,float> bq = qb.get(i);
+		for (size_t j = 0 ; j < boxes.size() ; j++)
+		{
+			Box<3,float> b_out;
+			Box<3,float> b = boxes.get(j);
+			if (bq.Intersect(b,b_out))	{ids.push_back(j);}
+		}
+		return ids;
+	});
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
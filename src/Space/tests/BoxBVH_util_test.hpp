@@ -0,0 +1,39 @@
+/*
+ * BoxBVH_util_test.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef SRC_SPACE_TESTS_BOXBVH_UTIL_TEST_HPP_
+#define SRC_SPACE_TESTS_BOXBVH_UTIL_TEST_HPP_
+
+#include <random>
+
+/*! \brief Create n random boxes inside the unit cube
+ *
+ * \param boxes output
+ * \param n number of boxes
+ * \param max_sz maximum side of the boxes
+ * \param gen random generator
+ *
+ */
+template<unsigned int dim, typename vector_box>
+void bvh_random_boxes(vector_box & boxes, size_t n, float max_sz, std::mt19937 & gen)
+{
+	std::uniform_real_distribution<float> ud(0.0,1.0);
+
+	boxes.resize(n);
+
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		for (size_t j = 0 ; j < dim ; j++)
+		{
+			float l = ud(gen);
+			boxes.template get<0>(i)[j] = l;
+			boxes.template get<1>(i)[j] = l + max_sz * ud(gen);
+		}
+	}
+}
+
+#endif /* SRC_SPACE_TESTS_BOXBVH_UTIL_TEST_HPP_ */
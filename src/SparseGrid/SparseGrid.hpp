@@ -13,6 +13,8 @@
 #include "memory_ly/memory_conf.hpp"
 #include "hash_map/hopscotch_map.h"
 #include "hash_map/hopscotch_set.h"
+#include "hash_map/hopscotch_concurrent_map.h"
+#include "hash_map/flat_int_map.h"
 #include "Vector/map_vector.hpp"
 #include "util/variadic_to_vmpl.hpp"
 #include "data_type/aggregate.hpp"
@@ -20,6 +22,7 @@
 #include "SparseGrid_iterator.hpp"
 #include "SparseGrid_iterator_block.hpp"
 #include "SparseGrid_conv_opt.hpp"
+#include "util/performance/perf_counters.hpp"
 //#include "util/debug.hpp"
 // We do not want parallel writer
 
@@ -414,7 +417,8 @@ template<unsigned int dim,
 		 typename grid_lin,
 		 typename layout,
 		 template<typename> class layout_base,
-		 typename chunking>
+		 typename chunking,
+		 typename map_type>
 class sgrid_cpu
 {
 	//! cache pointer
@@ -426,8 +430,8 @@ class sgrid_cpu
 	//! cached id
 	mutable long int cached_id[SGRID_CACHE];
 
-	//! Map to convert from grid coordinates to chunk
-	tsl::hopscotch_map<size_t, size_t> map;
+	//! Map to convert from grid coordinates to chunk (tsl::hopscotch_map, openfpm::hopscotch_concurrent_map or openfpm::flat_int_map)
+	map_type map;
 
 	//! indicate which element in the chunk are really filled
 	openfpm::vector<cheader<dim>,S> header_inf;
@@ -440,7 +444,7 @@ class sgrid_cpu
 	//! background values
 	//aggregate_bfv<chunk_def> background;
 
-	typedef sgrid_cpu<dim,T,S,grid_lin,layout,layout_base,chunking> self;
+	typedef sgrid_cpu<dim,T,S,grid_lin,layout,layout_base,chunking,map_type> self;
 
 	//! vector of chunks
 	openfpm::vector<aggregate_bfv<chunk_def>,S,layout_base > chunks;
@@ -1875,6 +1879,26 @@ public:
 		return tot;
 	}
 
+	/*! \brief Return the memory allocated and used by the sparse grid
+	 *
+	 * The used memory of the chunks is the one of the existing points, the empty points of
+	 * the chunks, the background chunk and the empty slots of the map are wasted
+	 *
+	 * \return the memory usage
+	 *
+	 */
+	mem_usage getMemoryUsage() const
+	{
+		mem_usage m_cnk = chunks.getMemoryUsage();
+		m_cnk.used = size() * (sizeof(aggregate_bfv<chunk_def>) / chunking::size::value);
+
+		typedef std::pair<typename map_type::key_type,typename map_type::mapped_type> map_entry;
+		mem_usage m_map(map.bucket_count()*sizeof(map_entry),map.size()*sizeof(map_entry));
+
+		return m_cnk + m_map + header_inf.getMemoryUsage() + header_mask.getMemoryUsage()
+				+ NNlist.getMemoryUsage() + empty_v.getMemoryUsage();
+	}
+
 	/*! \number of element inserted
 	 *
 	 * \warning this function is not as fast as the size in other structures
@@ -2064,6 +2088,8 @@ public:
 	template<unsigned int prop_src, unsigned int prop_dst, unsigned int stencil_size, unsigned int N, typename lambda_f, typename ... ArgsT >
 	void conv(int (& stencil)[N][dim], grid_key_dx<3> start, grid_key_dx<3> stop , lambda_f func, ArgsT ... args)
 	{
+		OFP_PERF_REGION("sgrid_cpu::conv");
+
 		NNlist.resize(NNStar_c<dim>::nNN * chunks.size());
 
 		if (findNN == false)
@@ -2085,6 +2111,8 @@ public:
 	template<unsigned int prop_src, unsigned int prop_dst, unsigned int stencil_size, typename lambda_f, typename ... ArgsT >
 	void conv_cross(grid_key_dx<3> start, grid_key_dx<3> stop , lambda_f func, ArgsT ... args)
 	{
+		OFP_PERF_REGION("sgrid_cpu::conv_cross");
+
 		NNlist.resize(2*dim * chunks.size());
 
 		if (findNN == false)
@@ -2106,6 +2134,8 @@ public:
 	template<unsigned int stencil_size, typename prop_type, typename lambda_f, typename ... ArgsT >
 	void conv_cross_ids(grid_key_dx<3> start, grid_key_dx<3> stop , lambda_f func, ArgsT ... args)
 	{
+		OFP_PERF_REGION("sgrid_cpu::conv_cross_ids");
+
 		if (layout_base<aggregate<int>>::type_value::value != SOA_layout_IA)
 		{
 			std::cout << __FILE__ << ":" << __LINE__ << " Error this function can be only used with the SOA version of the data-structure" << std::endl;
@@ -2128,6 +2158,8 @@ public:
 	template<unsigned int prop_src1, unsigned int prop_src2 ,unsigned int prop_dst1, unsigned int prop_dst2 ,unsigned int stencil_size, unsigned int N, typename lambda_f, typename ... ArgsT >
 	void conv2(int (& stencil)[N][dim], grid_key_dx<3> start, grid_key_dx<3> stop , lambda_f func, ArgsT ... args)
 	{
+		OFP_PERF_REGION("sgrid_cpu::conv2");
+
 		NNlist.resize(NNStar_c<dim>::nNN * chunks.size());
 
 		if (findNN == false)
@@ -2145,6 +2177,8 @@ public:
 	template<unsigned int prop_src1, unsigned int prop_src2 ,unsigned int prop_dst1, unsigned int prop_dst2 ,unsigned int stencil_size, typename lambda_f, typename ... ArgsT >
 	void conv_cross2(grid_key_dx<3> start, grid_key_dx<3> stop , lambda_f func, ArgsT ... args)
 	{
+		OFP_PERF_REGION("sgrid_cpu::conv_cross2");
+
 		NNlist.resize(NNStar_c<dim>::nNN * chunks.size());
 
 		if (findNN == false)
@@ -2738,8 +2772,9 @@ template<unsigned int dim,
 		 typename grid_lin = grid_zm<dim,void>,
 		 typename layout = typename memory_traits_inte<T>::type,
 		 template<typename> class layout_base = memory_traits_inte,
-		 typename chunking = default_chunking<dim>>
-using sgrid_soa = sgrid_cpu<dim,T,S,grid_lin,layout,layout_base,chunking>;
+		 typename chunking = default_chunking<dim>,
+		 typename map_type = tsl::hopscotch_map<size_t, size_t>>
+using sgrid_soa = sgrid_cpu<dim,T,S,grid_lin,layout,layout_base,chunking,map_type>;
 
 
 #endif /* OPENFPM_DATA_SRC_SPARSEGRID_SPARSEGRID_HPP_ */
@@ -13,6 +13,7 @@ const static int cnk_nele = 1;
 const static int cnk_mask = 2;
 
 #include "util/sparsegrid_util_common.hpp"
+#include "hash_map/hopscotch_map.h"
 
 //! sizeof the cache
 #define SGRID_CACHE 2
@@ -284,7 +285,8 @@ template<unsigned int dim,
 		 typename grid_lin = grid_sm<dim,void>,
 		 typename layout=typename memory_traits_lin<T>::type,
 		 template<typename> class layout_base = memory_traits_lin,
-		 typename chunking = default_chunking<dim>>
+		 typename chunking = default_chunking<dim>,
+		 typename map_type = tsl::hopscotch_map<size_t, size_t>>
 class sgrid_cpu;
 
 
@@ -12,6 +12,10 @@
 #include "SparseGrid/SparseGrid.hpp"
 #include "NN/CellList/CellDecomposer.hpp"
 #include <math.h>
+#include <atomic>
+#include <unordered_map>
+#include "util/multi_thread_util.hpp"
+#include "util/SimpleRNG.hpp"
 //#include "util/debug.hpp"
 
 BOOST_AUTO_TEST_SUITE( sparse_grid_test )
@@ -2434,5 +2438,239 @@ BOOST_AUTO_TEST_CASE( sparse_testing_clear )
 	BOOST_REQUIRE_EQUAL(grid.template get<0>(keyzero),555.0);
 }
 
-BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_CASE( sparse_grid_concurrent_map_test )
+{
+	typedef openfpm::hopscotch_concurrent_map<size_t,size_t> cmap_type;
+
+	cmap_type map(100000);
+
+	const size_t n = 100000;
+
+	// insert from multiple threads
+
+	#pragma omp parallel for num_threads(openfpm::ofp_max_threads())
+	for (size_t i = 0 ; i < n ; i++)
+	{map.insert(i*7,i);}
+
+	BOOST_REQUIRE_EQUAL(map.size(),n);
+
+	// duplicated keys must not be inserted twice and return the first value
+
+	std::atomic<size_t> cnt(n);
+
+	#pragma omp parallel for num_threads(openfpm::ofp_max_threads())
+	for (size_t i = 0 ; i < 2*n ; i++)
+	{map.get_or_insert_with(i*7,[&cnt](){return cnt++;});}
+
+	BOOST_REQUIRE_EQUAL(map.size(),2*n);
+	BOOST_REQUIRE_EQUAL(cnt.load(),2*n);
+
+	bool match = true;
+
+	#pragma omp parallel for num_threads(openfpm::ofp_max_threads()) reduction(&&:match)
+	for (size_t i = 0 ; i < 2*n ; i++)
+	{
+		size_t v;
+		bool found = map.find_value(i*7,v);
+		match = match && found;
+		match = match && ((i < n)?(v == i):(v >= n && v < 2*n));
+
+		match = match && (map.find_value(i*7+1,v) == false);
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// erase half of the keys
+
+	#pragma omp parallel for num_threads(openfpm::ofp_max_threads())
+	for (size_t i = 0 ; i < 2*n ; i += 2)
+	{map.erase(i*7);}
+
+	BOOST_REQUIRE_EQUAL(map.size(),n);
+
+	// the serial interface
+
+	size_t count = 0;
+	for (auto it = map.begin() ; it != map.end() ; ++it)
+	{
+		match &= (it->first % 14) == 7;
+		count++;
+	}
+
+	BOOST_REQUIRE_EQUAL(count,n);
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	const cmap_type & cmap = map;
+	BOOST_REQUIRE(cmap.find(7) != cmap.end());
+	BOOST_REQUIRE(cmap.find(14) == cmap.end());
+	BOOST_REQUIRE_EQUAL(cmap.find(21)->second,3ul);
+
+	map[14] = 5;
+	BOOST_REQUIRE_EQUAL(map.count(14),1ul);
+
+	map.clear();
+	BOOST_REQUIRE_EQUAL(map.size(),0ul);
+}
+
+template<typename map_type>
+void test_sparse_grid_fill_all_map()
+{
+	size_t sz[3] = {71,71,71};
+
+	sgrid_cpu<3,aggregate<float>,HeapMemory,grid_sm<3,void>,typename memory_traits_lin<aggregate<float>>::type,memory_traits_lin,default_chunking<3>,map_type> grid(sz);
+
+	grid.getBackgroundValue().template get<0>() = 0.0;
+
+	grid_sm<3,void> g_sm(sz);
+
+	grid_key_dx_iterator<3> kit(g_sm);
+
+	while (kit.isNext())
+	{
+		auto key = kit.get();
+
+		grid.template insert<0>(key) = g_sm.LinId(key);
+
+		++kit;
+	}
+
+	auto it = grid.getIterator();
+
+	size_t count = 0;
+	bool match = true;
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+		auto key_pos = it.getKeyF();
+
+		match &= (grid.template get<0>(key_pos) == g_sm.LinId(key));
+
+		count++;
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(count,(size_t)71*71*71);
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// remove half of the points, it reconstruct the map
+
+	grid_key_dx_iterator<3> kit2(g_sm);
+
+	while (kit2.isNext())
+	{
+		auto key = kit2.get();
+
+		if (key.get(2) < 35)
+		{grid.remove(key);}
+
+		++kit2;
+	}
+
+	BOOST_REQUIRE_EQUAL(grid.size(),(size_t)71*71*36);
+
+	grid_key_dx<3> k1({10,10,10});
+	grid_key_dx<3> k2({10,10,50});
+
+	BOOST_REQUIRE_EQUAL(grid.template get<0>(k1),0.0);
+	BOOST_REQUIRE_EQUAL(grid.template get<0>(k2),g_sm.LinId(k2));
+}
+
+BOOST_AUTO_TEST_CASE( sparse_grid_fill_all_concurrent_map_test )
+{
+	test_sparse_grid_fill_all_map<openfpm::hopscotch_concurrent_map<size_t,size_t>>();
+}
+
+BOOST_AUTO_TEST_CASE( sparse_grid_flat_int_map_test )
+{
+	typedef openfpm::flat_int_map<size_t,size_t> fmap_type;
+
+	fmap_type map;
+	std::unordered_map<size_t,size_t> ref;
+
+	BOOST_REQUIRE(map.find(0) == map.end());
+	BOOST_REQUIRE_EQUAL(map.erase(0),0ul);
+
+	// random insert/erase, keys in a small range produce many tombstones
+
+	SimpleRNG rng;
+	bool match = true;
+
+	for (size_t i = 0 ; i < 200000 ; i++)
+	{
+		size_t key = (size_t)(rng.GetUniform() * 20000);
+		size_t op = (size_t)(rng.GetUniform() * 4);
+
+		if (op == 0)
+		{match &= (map.erase(key) == ref.erase(key));}
+		else if (op == 1)
+		{
+			map[key] = i;
+			ref[key] = i;
+		}
+		else if (op == 2)
+		{match &= (map.insert(std::make_pair(key,i)).second == ref.insert(std::make_pair(key,i)).second);}
+		else
+		{
+			auto it = map.find(key);
+			auto itr = ref.find(key);
+
+			match &= ((it == map.end()) == (itr == ref.end()));
+			if (itr != ref.end())	{match &= (it->second == itr->second);}
+		}
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+	BOOST_REQUIRE_EQUAL(map.size(),ref.size());
+	BOOST_REQUIRE(map.load_factor() <= 7.0 / 8.0);
+
+	// iterate, copy and swap
+
+	fmap_type map2(map);
+	fmap_type map3;
+	map3.swap(map2);
+
+	size_t count = 0;
+	for (auto it = map3.begin() ; it != map3.end() ; ++it)
+	{
+		auto itr = ref.find(it->first);
+		match &= (itr != ref.end() && itr->second == it->second);
+		count++;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+	BOOST_REQUIRE_EQUAL(count,ref.size());
+	BOOST_REQUIRE_EQUAL(map2.size(),0ul);
 
+	// batched find
+
+	openfpm::vector<size_t> keys;
+	openfpm::vector<size_t> vals;
+
+	for (size_t i = 0 ; i < 30000 ; i++)
+	{keys.add(i);}
+	vals.resize(keys.size());
+
+	size_t found = map3.find_many(&keys.get(0),keys.size(),&vals.get(0),(size_t)-1);
+
+	BOOST_REQUIRE_EQUAL(found,ref.size());
+
+	for (size_t i = 0 ; i < keys.size() ; i++)
+	{
+		auto itr = ref.find(i);
+		match &= (itr == ref.end())?(vals.get(i) == (size_t)-1):(vals.get(i) == itr->second);
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	map3.clear();
+	BOOST_REQUIRE_EQUAL(map3.size(),0ul);
+	BOOST_REQUIRE(map3.find(keys.get(0)) == map3.end());
+}
+
+BOOST_AUTO_TEST_CASE( sparse_grid_fill_all_flat_int_map_test )
+{
+	test_sparse_grid_fill_all_map<openfpm::flat_int_map<size_t,size_t>>();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
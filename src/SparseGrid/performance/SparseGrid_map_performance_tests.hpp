@@ -0,0 +1,220 @@
+/*
+ * SparseGrid_map_performance_tests.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef OPENFPM_DATA_SRC_SPARSEGRID_PERFORMANCE_SPARSEGRID_MAP_PERFORMANCE_TESTS_HPP_
+#define OPENFPM_DATA_SRC_SPARSEGRID_PERFORMANCE_SPARSEGRID_MAP_PERFORMANCE_TESTS_HPP_
+
+#include "hash_map/hopscotch_map.h"
+#include "hash_map/hopscotch_concurrent_map.h"
+#include "hash_map/flat_int_map.h"
+#include "util/multi_thread_util.hpp"
+#include "util/SimpleRNG.hpp"
+#include "util/performance/benchmark_store.hpp"
+
+/*! \brief CPU performance of the hash maps used by the sparse grid to map the chunks
+ *
+ * * sgrid_map_insert, sgrid_map_find: tsl::hopscotch_map on one thread, hopscotch_concurrent_map on all the threads
+ * * sgrid_map_find_rnd: look-up in random order of tsl::hopscotch_map, flat_int_map (find and find_many)
+ *
+ * The measures are appended to sgrid_map_performance_funcs.jsonl and checked for regressions against
+ * $OPENFPM_PERFORMANCE_TEST_DIR/openfpm_data/sgrid_map_performance_funcs_ref.jsonl
+ *
+ */
+
+//! Number of repetitions for each measure
+constexpr int N_STAT_SGRID_MAP = 5;
+
+//! Number of keys
+const size_t sgrid_map_perf_n = 4000000;
+
+//! All the samples of the measures
+benchmark_store sgrid_map_perf_store;
+
+/*! \brief Create n random 64 bit keys
+ *
+ * \param keys keys
+ * \param n number of keys
+ *
+ */
+static void sgrid_map_perf_keys(openfpm::vector<size_t> & keys, size_t n)
+{
+	keys.resize(n);
+
+	SimpleRNG rng;
+	for (size_t i = 0 ; i < n ; i++)
+	{keys.get(i) = (size_t)(rng.GetUniform() * 4294967296.0) * 4294967296ul + (size_t)(rng.GetUniform() * 4294967296.0);}
+}
+
+BOOST_AUTO_TEST_SUITE( sgrid_map_performance )
+
+BOOST_AUTO_TEST_CASE(sgrid_map_performance_concurrent)
+{
+	const size_t n = sgrid_map_perf_n;
+	const int nth = openfpm::ofp_max_threads();
+
+	openfpm::vector<size_t> keys;
+	sgrid_map_perf_keys(keys,n);
+
+	std::vector<double> t_ins;
+	std::vector<double> t_fnd;
+	std::vector<double> t_cins;
+	std::vector<double> t_cfnd;
+
+	// the first run is a warm-up
+
+	for (size_t k = 0 ; k < N_STAT_SGRID_MAP + 1 ; k++)
+	{
+		tsl::hopscotch_map<size_t,size_t> smap;
+		smap.reserve(n);
+
+		timer t;
+		t.start();
+
+		for (size_t i = 0 ; i < n ; i++)
+		{smap.insert(std::make_pair(keys.get(i),i));}
+
+		t.stop();
+		double ti = t.getwct();
+
+		size_t found = 0;
+
+		t.start();
+
+		for (size_t i = 0 ; i < n ; i++)
+		{found += smap.count(keys.get(i));}
+
+		t.stop();
+		double tf = t.getwct();
+
+		openfpm::hopscotch_concurrent_map<size_t,size_t> cmap;
+		cmap.reserve(n);
+
+		t.start();
+
+		#pragma omp parallel for num_threads(nth) schedule(static)
+		for (size_t i = 0 ; i < n ; i++)
+		{cmap.insert(keys.get(i),i);}
+
+		t.stop();
+		double tci = t.getwct();
+
+		size_t cfound = 0;
+
+		t.start();
+
+		#pragma omp parallel for num_threads(nth) schedule(static) reduction(+:cfound)
+		for (size_t i = 0 ; i < n ; i++)
+		{cfound += cmap.count(keys.get(i));}
+
+		t.stop();
+		double tcf = t.getwct();
+
+		BOOST_REQUIRE_EQUAL(found,n);
+		BOOST_REQUIRE_EQUAL(cfound,n);
+
+		if (k == 0)	{continue;}
+
+		t_ins.push_back(ti);
+		t_fnd.push_back(tf);
+		t_cins.push_back(tci);
+		t_cfnd.push_back(tcf);
+	}
+
+	sgrid_map_perf_store.add("sgrid_map_insert",{{"map","hopscotch_map"},{"n",std::to_string(n)},{"threads","1"}},t_ins);
+	sgrid_map_perf_store.add("sgrid_map_find",{{"map","hopscotch_map"},{"n",std::to_string(n)},{"threads","1"}},t_fnd);
+	sgrid_map_perf_store.add("sgrid_map_insert",{{"map","hopscotch_concurrent_map"},{"n",std::to_string(n)},{"threads",std::to_string(nth)}},t_cins);
+	sgrid_map_perf_store.add("sgrid_map_find",{{"map","hopscotch_concurrent_map"},{"n",std::to_string(n)},{"threads",std::to_string(nth)}},t_cfnd);
+}
+
+BOOST_AUTO_TEST_CASE(sgrid_map_performance_flat_int)
+{
+	const size_t n = sgrid_map_perf_n;
+
+	openfpm::vector<size_t> keys;
+	openfpm::vector<size_t> vals;
+	sgrid_map_perf_keys(keys,n);
+	vals.resize(n);
+
+	tsl::hopscotch_map<size_t,size_t> hmap;
+	openfpm::flat_int_map<size_t,size_t> fmap;
+	hmap.reserve(n);
+	fmap.reserve(n);
+
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		hmap[keys.get(i)] = i;
+		fmap[keys.get(i)] = i;
+	}
+
+	// shuffle the look-up order
+
+	SimpleRNG rng;
+	for (size_t i = n - 1 ; i > 0 ; i--)
+	{std::swap(keys.get(i),keys.get((size_t)(rng.GetUniform() * i)));}
+
+	std::vector<double> t_h;
+	std::vector<double> t_f;
+	std::vector<double> t_fm;
+
+	// the first run is a warm-up
+
+	for (size_t k = 0 ; k < N_STAT_SGRID_MAP + 1 ; k++)
+	{
+		size_t sum_h = 0;
+		timer t;
+		t.start();
+
+		for (size_t i = 0 ; i < n ; i++)
+		{sum_h += hmap.find(keys.get(i))->second;}
+
+		t.stop();
+		double th = t.getwct();
+
+		size_t sum_f = 0;
+		t.start();
+
+		for (size_t i = 0 ; i < n ; i++)
+		{sum_f += fmap.find(keys.get(i))->second;}
+
+		t.stop();
+		double tf = t.getwct();
+
+		t.start();
+
+		size_t found = fmap.find_many(&keys.get(0),n,&vals.get(0),(size_t)0);
+
+		t.stop();
+		double tfm = t.getwct();
+
+		BOOST_REQUIRE_EQUAL(found,n);
+		BOOST_REQUIRE_EQUAL(sum_h,(n-1)*n/2);
+		BOOST_REQUIRE_EQUAL(sum_f,sum_h);
+
+		if (k == 0)	{continue;}
+
+		t_h.push_back(th);
+		t_f.push_back(tf);
+		t_fm.push_back(tfm);
+	}
+
+	sgrid_map_perf_store.add("sgrid_map_find_rnd",{{"map","hopscotch_map"},{"n",std::to_string(n)}},t_h);
+	sgrid_map_perf_store.add("sgrid_map_find_rnd",{{"map","flat_int_map"},{"n",std::to_string(n)}},t_f);
+	sgrid_map_perf_store.add("sgrid_map_find_rnd",{{"map","flat_int_map_find_many"},{"n",std::to_string(n)}},t_fm);
+}
+
+/////// THIS IS NOT A TEST IT WRITE THE PERFORMANCE RESULT ///////
+
+BOOST_AUTO_TEST_CASE(sgrid_map_performance_write_report)
+{
+	size_t n_reg = benchmark_write_and_check(sgrid_map_perf_store,"sgrid_map_performance_funcs",std::string(test_dir) + "/openfpm_data");
+
+	BOOST_REQUIRE_EQUAL(n_reg,0ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif /* OPENFPM_DATA_SRC_SPARSEGRID_PERFORMANCE_SPARSEGRID_MAP_PERFORMANCE_TESTS_HPP_ */
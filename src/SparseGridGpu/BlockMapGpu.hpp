@@ -83,6 +83,28 @@ public:
         blockMap.swap(bm.blockMap);
     }
 
+	/*! \brief Return the memory allocated and used by the block map
+	 *
+	 * The buffers are mirrored on device, the memory reported is the one of a single copy
+	 *
+	 * \return the memory usage
+	 *
+	 */
+	mem_usage getMemoryUsage() const
+	{
+		return blockMap.getMemoryUsage();
+	}
+
+	/*! \brief Borrow the temporaries of the flush from an arena shared with other grids and vectors
+	 *
+	 * \param arena arena (NULL to keep the temporaries in the block map), it must live longer than the block map
+	 *
+	 */
+	void setScratchArena(scratch_arena * arena)
+	{
+		blockMap.setScratchArena(arena);
+	}
+
 	/*! \brief Get the background value
 	 *
 	 * \return background value
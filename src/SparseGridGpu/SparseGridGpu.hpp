@@ -10,6 +10,7 @@ constexpr int BLOCK_SIZE_STENCIL = 128;
 #include "config.h"
 #include "util/cuda_util.hpp"
 #include <cstdlib>
+#include <tuple>
 #include <SparseGridGpu/BlockMapGpu.hpp>
 #include <Grid/iterators/grid_skin_iterator.hpp>
 #include <Grid/Geometry/grid_smb.hpp>
@@ -2446,6 +2447,30 @@ public:
         return numExistingElements;
     }
 
+    /*! \brief Return the memory allocated and used by the sparse grid
+     *
+     * The used memory is counted at the granularity of the blocks (counting the existing points
+     * would require the masks on host, see countExistingElements). The neighborhood and the
+     * pack/unpack buffers are counted as allocated but not used
+     *
+     * \return the memory usage
+     *
+     */
+    mem_usage getMemoryUsage() const
+    {
+        mem_usage m = BlockMapGpu<AggregateInternalT, threadBlockSize, indexT, layout_base>::getMemoryUsage();
+
+        m += nn_blocks.getMemoryUsage() + ghostLayerToThreadsMapping.getMemoryUsage();
+
+        mem_usage tmp_b = tmp.getMemoryUsage() + rem_sects.getMemoryUsage() + e_points.getMemoryUsage();
+        tmp_b += e_points_swp.getMemoryUsage() + e_points_swp_r.getMemoryUsage();
+        tmp_b += pack_output.getMemoryUsage() + pack_output_swp.getMemoryUsage() + pack_output_swp_r.getMemoryUsage();
+
+        m.allocated += tmp_b.allocated + mem.size();
+
+        return m;
+    }
+
     size_t countBoundaryElements()
     {
         // Here it is crucial to use "auto &" as the type, as we need to be sure to pass the reference to the actual buffers!
@@ -2729,6 +2754,222 @@ public:
         applyStencils<stencil2, otherStencils ...>(box,mode, args...);
     }
 
+    /*! \brief Apply a sequence of stencils in place with a single launch (fused sweep)
+     *
+     * Instead of one launch (and one full pass over the blocks) for every stencil, every block apply
+     * all the stencils one after the other. The block index, mask, coordinates and neighbourhood are
+     * computed only once, every stencil still load and store its properties
+     *
+     * The result is the same of applyStencils<stencil1,stencil2,...> only if a stencil does not read the
+     * neighbourhood of a property written by a previous stencil of the sequence (blocks are not synchronized
+     * between two stencils). Stencils on independent properties, or point-wise stages, can be always fused.
+     * All the stencils must have the same stencil_type and take the same arguments
+     *
+     * Every stencil read and write the grid directly. Stages that need the result of a previous stage on the
+     * neighbours (multi-stage Runge-Kutta for example) must be applied with applyStagesFused
+     *
+     * \param box the stencils are applied only on the points inside this box
+     * \param mode stencil mode, only STENCIL_MODE_INPLACE is supported (any other mode is an error)
+     * \param args arguments passed to the stencils
+     *
+     */
+    template<typename stencil1, typename ... otherStencils, typename... Args>
+    void applyStencilsFused(const Box<dim,int> & box, StencilMode mode, Args... args)
+    {
+        typedef typename stencil1::stencil_type stencil_type;
+
+        // a sequence is equal to its rotation only if all the elements are equal
+        static_assert(std::is_same<std::tuple<stencil_type,typename otherStencils::stencil_type...>,
+                                   std::tuple<typename otherStencils::stencil_type...,stencil_type>>::value,
+                      "applyStencilsFused: all the stencils must have the same stencil_type");
+
+        if (mode != STENCIL_MODE_INPLACE)
+        {
+            std::cerr << __FILE__ << ":" << __LINE__ << " error applyStencilsFused support only STENCIL_MODE_INPLACE" << std::endl;
+            return;
+        }
+
+        if (findNN == false)
+        {
+        	findNeighbours<stencil_type>();
+        	findNN = true;
+        }
+
+        auto & indexBuffer_ = BlockMapGpu<AggregateInternalT, threadBlockSize, indexT, layout_base>::blockMap.getIndexBuffer();
+        auto & dataBuffer_ = BlockMapGpu<AggregateInternalT, threadBlockSize, indexT, layout_base>::blockMap.getDataBuffer();
+
+        const unsigned int dataChunkSize = BlockTypeOf<AggregateBlockT, 0>::size;
+        unsigned int numScalars = indexBuffer_.size() * dataChunkSize;
+
+        if (numScalars == 0) return;
+
+        constexpr unsigned int chunksPerBlock = 1;
+        const unsigned int localThreadBlockSize = dataChunkSize * chunksPerBlock;
+        const unsigned int threadGridSize = numScalars % localThreadBlockSize == 0
+                                            ? numScalars / localThreadBlockSize
+                                            : 1 + numScalars / localThreadBlockSize;
+
+        constexpr unsigned int nLoop = UIntDivCeil<(IntPow<blockEdgeSize + 2, dim>::value - IntPow<blockEdgeSize, dim>::value), (blockSize * chunksPerBlock)>::value; // todo: This works only for stencilSupportSize==1
+
+        typedef SparseGridGpuKernels::stencil_fused_call<stencil1,otherStencils...> stencilSeq;
+
+#ifdef CUDIFY_USE_CUDA
+
+        CUDA_LAUNCH_DIM3((SparseGridGpuKernels::applyStencilsFusedInPlace
+                <dim,
+                BlockMapGpu<AggregateInternalT, threadBlockSize, indexT, layout_base>::pMask,
+                stencilSeq>),
+                threadGridSize, localThreadBlockSize,
+                        box,
+                        indexBuffer_.toKernel(),
+                        dataBuffer_.toKernel(),
+                        this->template toKernelNN<stencil_type::nNN, nLoop>(),
+                        args...);
+
+#else
+
+		auto bx = box;
+		auto indexBuffer = indexBuffer_.toKernel();
+		auto dataBuffer = dataBuffer_.toKernel();
+		auto sparseGrid = this->template toKernelNN<stencil_type::nNN, nLoop>();
+
+		constexpr int pMask = BlockMapGpu<AggregateInternalT, threadBlockSize, indexT, layout_base>::pMask;
+
+		auto lamb = [=] __device__ () mutable
+		{
+			constexpr unsigned int pIndex = 0;
+
+			typedef typename decltype(dataBuffer)::value_type AggregateT_;
+			typedef BlockTypeOf<AggregateT_, pMask> MaskBlockT;
+			constexpr unsigned int blockSize = MaskBlockT::size;
+
+			const unsigned int dataBlockPos = blockIdx.x;
+			const unsigned int offset = threadIdx.x;
+
+			if (dataBlockPos >= indexBuffer.size())
+			{
+				return;
+			}
+
+			auto dataBlock = dataBuffer.get(dataBlockPos);
+
+			const unsigned int dataBlockId = indexBuffer.template get<pIndex>(dataBlockPos);
+			grid_key_dx<dim, int> pointCoord = sparseGrid.getCoord(dataBlockId * blockSize + offset);
+
+			unsigned char curMask;
+
+			if (offset < blockSize)
+			{
+				curMask = dataBlock.template get<pMask>()[offset];
+				for (int i = 0 ; i < dim ; i++)
+				{curMask &= (pointCoord.get(i) < bx.getLow(i) || pointCoord.get(i) > bx.getHigh(i))?0:0xFF;}
+			}
+
+			openfpm::sparse_index<unsigned int> sdataBlockPos;
+			sdataBlockPos.id = dataBlockPos;
+
+			stencilSeq::call(sparseGrid, dataBlockId, sdataBlockPos, offset, pointCoord, dataBlock, curMask, args...);
+		};
+
+		CUDA_LAUNCH_LAMBDA_DIM3_TLS(threadGridSize, localThreadBlockSize,lamb);
+
+#endif
+    }
+
+    /*! \brief Apply a sequence of dependent stages with a single launch, without storing the intermediate results
+     *
+     * Every block load p_src, plus an halo equal to the sum of the support radius of the stages, into a
+     * block-local scratch in shared memory. The stages are then applied one after the other on the scratch:
+     * every stage is computed on the block and on the part of the halo that the next stages still need, so a
+     * stage can read the result of the previous one on the neighbours (this is the overlapped tiling of temporal
+     * blocking, the halo points are recomputed by every block that need them). Only the result of the last stage
+     * is stored in p_dst, the intermediate stages never reach global memory
+     *
+     * The result is the same of applying the stages one after the other with applyStencils, writing every stage
+     * in a temporary property. A stage is a structure with a static supportRadius and the device function
+     *
+     * \code
+     * template<unsigned int edge, typename ScalarT, typename ... Args>
+     * static inline __device__ ScalarT stage(const ScalarT * u0, const ScalarT * u, const unsigned int linId, Args... args)
+     * \endcode
+     *
+     * that return the new value of the point linId of the scratch (a dim-dimensional array of edge points per side,
+     * a move of one point in direction d is a move of edge^d). u is the output of the previous stage, u0 the value
+     * of p_src (for example the solution at the beginning of a Runge-Kutta step). The stage is called only on the
+     * points that exist, are not padding and are inside the box, the other points keep the value of p_src.
+     * Points that do not exist read the background value
+     *
+     * \note The halo is loaded from the full neighbourhood of the block (NNFull), the neighbour blocks are computed
+     *       at every call
+     *
+     * \tparam p_src property read by the first stage, it must be different from p_dst (the neighbour blocks read it
+     *         while the block write p_dst)
+     * \tparam p_dst property where the result of the last stage is stored
+     *
+     * \param box the stages are applied only on the points inside this box
+     * \param args arguments passed to the stages
+     *
+     */
+    template<unsigned int p_src, unsigned int p_dst, typename stage1, typename ... otherStages, typename... Args>
+    void applyStagesFused(const Box<dim,int> & box, Args... args)
+    {
+        typedef SparseGridGpuKernels::stages_fused<stage1,otherStages...> stageSeq;
+
+        static_assert(p_src != p_dst, "applyStagesFused: p_src and p_dst must be different properties");
+        static_assert(stageSeq::halo <= blockEdgeSize, "applyStagesFused: the sum of the support radius of the stages cannot be bigger than the block edge");
+
+        auto & indexBuffer_ = BlockMapGpu<AggregateInternalT, threadBlockSize, indexT, layout_base>::blockMap.getIndexBuffer();
+        auto & dataBuffer_ = BlockMapGpu<AggregateInternalT, threadBlockSize, indexT, layout_base>::blockMap.getDataBuffer();
+
+        const unsigned int dataChunkSize = BlockTypeOf<AggregateBlockT, 0>::size;
+        unsigned int numScalars = indexBuffer_.size() * dataChunkSize;
+
+        if (numScalars == 0) return;
+
+        // The halo can be bigger than the stencil support radius (and reach the diagonal blocks), the next
+        // applyStencils recompute the neighbourhood of its stencil_type
+        findNeighbours<NNFull<dim>>();
+        findNN = false;
+
+        // one block of threads for every data block
+        const unsigned int localThreadBlockSize = dataChunkSize;
+        const unsigned int threadGridSize = indexBuffer_.size();
+
+        constexpr int pMask = BlockMapGpu<AggregateInternalT, threadBlockSize, indexT, layout_base>::pMask;
+
+#ifdef CUDIFY_USE_CUDA
+
+        CUDA_LAUNCH_DIM3((SparseGridGpuKernels::applyStagesFusedKernel
+                <dim,
+                pMask,
+                p_src,
+                p_dst,
+                NNFull<dim>,
+                stageSeq>),
+                threadGridSize, localThreadBlockSize,
+                        box,
+                        indexBuffer_.toKernel(),
+                        dataBuffer_.toKernel(),
+                        this->template toKernelNN<NNFull<dim>::nNN, 0>(),
+                        args...);
+
+#else
+
+		auto bx = box;
+		auto indexBuffer = indexBuffer_.toKernel();
+		auto dataBuffer = dataBuffer_.toKernel();
+		auto sparseGrid = this->template toKernelNN<NNFull<dim>::nNN, 0>();
+
+		auto lamb = [=] __device__ () mutable
+		{
+			stageSeq::template apply<dim,pMask,p_src,p_dst,NNFull<dim>>(bx,indexBuffer,dataBuffer,sparseGrid,args...);
+		};
+
+		CUDA_LAUNCH_LAMBDA_DIM3_TLS(threadGridSize, localThreadBlockSize,lamb);
+
+#endif
+    }
+
     template<typename BitMaskT>
     inline static bool isPadding(BitMaskT &bitMask)
     {
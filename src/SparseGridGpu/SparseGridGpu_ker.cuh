@@ -8,6 +8,7 @@
 #include <Grid/Geometry/grid_smb.hpp>
 #include "BlockMapGpu.hpp"
 #include "SparseGridGpu_ker_util.hpp"
+#include "TemplateUtils/mathUtils.hpp"
 
 template<typename indexT>
 struct block_offset
@@ -570,6 +571,53 @@ public:
         __loadGhostBlock<p>(dataBlockLoad,blockLinId, sharedRegion,mask);
     }
 
+    /*! \brief Load a data block with an halo of arbitrary size around it into a shared memory region
+     *
+     * Unlike loadGhostBlock the halo is not limited to the stencil support radius of the grid. The region is
+     * shaped as a dim-dimensional array of edge blockEdgeSize + 2*halo, all the threads of the block cooperate
+     * to load it. Points that do not exist are loaded with the background value
+     *
+     * \warning nn_blocks must have been computed for NN_type (NNFull), and halo must not be bigger than blockEdgeSize
+     *
+     * \tparam p property to load
+     * \tparam halo size of the halo
+     * \tparam NN_type neighborhood type used to compute nn_blocks
+     *
+     * \param blockIdPos position of the data block
+     * \param sharedRegion shared region where to load the property
+     * \param maskRegion shared region where to load the mask
+     *
+     */
+    template<unsigned int p, unsigned int halo, typename NN_type, typename ScalarT>
+    inline __device__ void
+    loadBlockWithHalo(const openfpm::sparse_index<unsigned int> blockIdPos, ScalarT * sharedRegion, unsigned char * maskRegion)
+    {
+    	constexpr int pM = BlockMapGpu_ker<AggregateBlockT, indexT, layout_base>::pMask;
+    	constexpr unsigned int edge = blockEdgeSize + 2*halo;
+
+    	for (unsigned int e = threadIdx.x ; e < IntPow<edge,dim>::value ; e += blockDim.x)
+    	{
+    		grid_key_dx<dim,int> mov;
+
+    		unsigned int ctr = e;
+    		for (int i = 0 ; i < dim ; i++)
+    		{
+    			mov.set_d(i,(int)(ctr % edge) - (int)halo);
+    			ctr /= edge;
+    		}
+
+    		auto bof = getNNPoint<NN_type>(blockIdPos,0,mov);
+
+    		ScalarT data = this->blockMap.template get_ele<p>(bof.pos)[bof.off];
+    		unsigned char mask = this->blockMap.template get_ele<pM>(bof.pos)[bof.off];
+
+    		if (mask == 0)	{set_compile_condition<pM != p>::template set<p>(data,background);}
+
+    		sharedRegion[e] = data;
+    		maskRegion[e] = mask;
+    	}
+    }
+
     /**
      * Load the ghost layer of a data block into the boundary part of a shared memory region.
      * The given shared memory region should be shaped as a dim-dimensional array and sized so that it
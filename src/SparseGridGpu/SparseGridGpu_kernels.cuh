@@ -1093,6 +1093,291 @@ namespace SparseGridGpuKernels
                 curMask, args...);
     }
 
+    /*! \brief Call a sequence of stencils on the same data block, one after the other
+     *
+     * Between two stencils the threads of the block are synchronized, so a stencil see the points
+     * of the block written by the previous ones
+     *
+     */
+    template<typename ... stencils>
+    struct stencil_fused_call
+    {
+        template<typename SparseGridT, typename DataBlockWrapperT, typename PointCoordT, typename... Args>
+        static inline __device__ void call(SparseGridT & sparseGrid,
+                                           const unsigned int dataBlockId,
+                                           const openfpm::sparse_index<unsigned int> dataBlockIdPos,
+                                           const unsigned int offset,
+                                           const PointCoordT & pointCoord,
+                                           DataBlockWrapperT & dataBlock,
+                                           unsigned char curMask,
+                                           Args... args)
+        {}
+    };
+
+    template<typename stencil, typename ... stencils>
+    struct stencil_fused_call<stencil,stencils...>
+    {
+        template<typename SparseGridT, typename DataBlockWrapperT, typename PointCoordT, typename... Args>
+        static inline __device__ void call(SparseGridT & sparseGrid,
+                                           const unsigned int dataBlockId,
+                                           const openfpm::sparse_index<unsigned int> dataBlockIdPos,
+                                           const unsigned int offset,
+                                           const PointCoordT & pointCoord,
+                                           DataBlockWrapperT & dataBlock,
+                                           unsigned char curMask,
+                                           Args... args)
+        {
+            stencil::stencil(
+                    sparseGrid, dataBlockId, dataBlockIdPos , offset, pointCoord, dataBlock, dataBlock,
+                    curMask, args...);
+
+            __syncthreads();
+
+            stencil_fused_call<stencils...>::call(sparseGrid, dataBlockId, dataBlockIdPos, offset, pointCoord, dataBlock, curMask, args...);
+        }
+    };
+
+    /*! \brief Apply a sequence of stencils in place with one launch, every block run all the stencils
+     *
+     * \see SparseGridGpu::applyStencilsFused
+     *
+     */
+    template <unsigned int dim,
+            unsigned int pMask,
+            typename stencilSeq,
+            typename IndexBufT,
+            typename DataBufT,
+            typename SparseGridT,
+            typename... Args>
+    __global__ void
+    applyStencilsFusedInPlace(
+    		Box<dim,int> bx,
+            IndexBufT indexBuffer,
+            DataBufT dataBuffer,
+            SparseGridT sparseGrid,
+            Args... args)
+    {
+        constexpr unsigned int pIndex = 0;
+
+        typedef typename DataBufT::value_type AggregateT;
+        typedef BlockTypeOf<AggregateT, pMask> MaskBlockT;
+        constexpr unsigned int blockSize = MaskBlockT::size;
+
+        const unsigned int dataBlockPos = blockIdx.x;
+        const unsigned int offset = threadIdx.x;
+
+        if (dataBlockPos >= indexBuffer.size())
+        {
+            return;
+        }
+
+        auto dataBlock = dataBuffer.get(dataBlockPos);
+
+        const auto dataBlockId = indexBuffer.template get<pIndex>(dataBlockPos);
+        grid_key_dx<dim, int> pointCoord = sparseGrid.getCoord(dataBlockId * blockSize + offset);
+
+        unsigned char curMask;
+
+        if (offset < blockSize)
+        {
+            curMask = dataBlock.template get<pMask>()[offset];
+			for (int i = 0 ; i < dim ; i++)
+			{curMask &= (pointCoord.get(i) < bx.getLow(i) || pointCoord.get(i) > bx.getHigh(i))?0:0xFF;}
+        }
+
+        openfpm::sparse_index<unsigned int> sdataBlockPos;
+        sdataBlockPos.id = dataBlockPos;
+
+        stencilSeq::call(sparseGrid, dataBlockId, sdataBlockPos, offset, pointCoord, dataBlock, curMask, args...);
+    }
+
+    /*! \brief Sum of the support radius of a sequence of stages
+     *
+     */
+    template<typename ... stages>
+    struct stages_radius
+    {
+        static const unsigned int value = 0;
+    };
+
+    template<typename stage, typename ... stages>
+    struct stages_radius<stage,stages...>
+    {
+        static const unsigned int value = stage::supportRadius + stages_radius<stages...>::value;
+    };
+
+    /*! \brief Run a sequence of dependent stages on the scratch of one data block
+     *
+     * The scratch is made of three regions of edge^dim points: s_0 contain the loaded property and it is never
+     * written, the stages ping-pong between s_1 and s_2. A stage is computed only on the points that are at
+     * least margin + stage::supportRadius away from the border of the scratch, because only there its input
+     * (computed by the previous stage on the points at least margin away) is valid
+     *
+     * \tparam margin border of the scratch where the input of the stage is not valid
+     * \tparam s_in region containing the input of the stage
+     * \tparam s_out region where the stage write
+     *
+     */
+    template<unsigned int dim, unsigned int edge, unsigned int margin, unsigned int s_in, unsigned int s_out, typename ... stages>
+    struct stages_fused_call
+    {
+        template<typename ScalarT, typename... Args>
+        static inline __device__ ScalarT * call(ScalarT * scratch, const unsigned char * active, Args... args)
+        {
+            return scratch + s_in*IntPow<edge,dim>::value;
+        }
+    };
+
+    template<unsigned int dim, unsigned int edge, unsigned int margin, unsigned int s_in, unsigned int s_out, typename stage, typename ... stages>
+    struct stages_fused_call<dim,edge,margin,s_in,s_out,stage,stages...>
+    {
+        template<typename ScalarT, typename... Args>
+        static inline __device__ ScalarT * call(ScalarT * scratch, const unsigned char * active, Args... args)
+        {
+            constexpr unsigned int scratchSize = IntPow<edge,dim>::value;
+            constexpr unsigned int m = margin + stage::supportRadius;
+
+            const ScalarT * u0 = scratch;
+            const ScalarT * in = scratch + s_in*scratchSize;
+            ScalarT * out = scratch + s_out*scratchSize;
+
+            for (unsigned int e = threadIdx.x ; e < scratchSize ; e += blockDim.x)
+            {
+                unsigned int ctr = e;
+                bool valid = true;
+                for (int i = 0 ; i < dim ; i++)
+                {
+                    unsigned int c = ctr % edge;
+                    ctr /= edge;
+                    valid &= (c >= m && c < edge - m);
+                }
+
+                if (valid == true)
+                {out[e] = (active[e])?stage::template stage<edge>(u0,in,e,args...):in[e];}
+            }
+
+            __syncthreads();
+
+            return stages_fused_call<dim,edge,m,s_out,(s_out == 1)?2:1,stages...>::call(scratch,active,args...);
+        }
+    };
+
+    /*! \brief Apply a sequence of dependent stages to the blocks, using a block-local scratch in shared memory
+     *
+     * \see SparseGridGpu::applyStagesFused
+     *
+     */
+    template<typename ... stages>
+    struct stages_fused
+    {
+        //! halo of the scratch, every stage consume its support radius
+        static const unsigned int halo = stages_radius<stages...>::value;
+
+        template<unsigned int dim,
+                 unsigned int pMask,
+                 unsigned int p_src,
+                 unsigned int p_dst,
+                 typename NN_type,
+                 typename IndexBufT,
+                 typename DataBufT,
+                 typename SparseGridT,
+                 typename... Args>
+        static inline __device__ void apply(const Box<dim,int> & bx,
+                                            IndexBufT & indexBuffer,
+                                            DataBufT & dataBuffer,
+                                            SparseGridT & sparseGrid,
+                                            Args... args)
+        {
+            constexpr unsigned int pIndex = 0;
+
+            typedef typename DataBufT::value_type AggregateT;
+            typedef BlockTypeOf<AggregateT, pMask> MaskBlockT;
+            typedef ScalarTypeOf<AggregateT, p_src> ScalarT;
+            constexpr unsigned int blockSize = MaskBlockT::size;
+            constexpr unsigned int blockEdgeSize = SparseGridT::getBlockEdgeSize();
+            constexpr unsigned int edge = blockEdgeSize + 2*halo;
+            constexpr unsigned int scratchSize = IntPow<edge,dim>::value;
+
+            const unsigned int dataBlockPos = blockIdx.x;
+
+            if (dataBlockPos >= indexBuffer.size())
+            {
+                return;
+            }
+
+            __shared__ ScalarT scratch[3*scratchSize];
+            __shared__ unsigned char active[scratchSize];
+
+            openfpm::sparse_index<unsigned int> sdataBlockPos;
+            sdataBlockPos.id = dataBlockPos;
+
+            sparseGrid.template loadBlockWithHalo<p_src,halo,NN_type>(sdataBlockPos, scratch, active);
+
+            // A point of the scratch is updated by the stages only if it exist, it is not padding and it is
+            // inside the box. Every thread convert the masks it loaded
+            const unsigned int dataBlockId = indexBuffer.template get<pIndex>(dataBlockPos);
+            grid_key_dx<dim, int> origin = sparseGrid.getCoord(dataBlockId * blockSize);
+
+            for (unsigned int e = threadIdx.x ; e < scratchSize ; e += blockDim.x)
+            {
+                unsigned char mask = active[e];
+
+                bool in_box = true;
+                unsigned int ctr = e;
+                for (int i = 0 ; i < dim ; i++)
+                {
+                    int c = origin.get(i) + (int)(ctr % edge) - (int)halo;
+                    ctr /= edge;
+                    in_box &= (c >= bx.getLow(i) && c <= bx.getHigh(i));
+                }
+
+                active[e] = ((mask & mask_sparse::EXIST) && !(mask & mask_sparse::PADDING) && in_box);
+            }
+
+            __syncthreads();
+
+            ScalarT * res = stages_fused_call<dim,edge,0,0,1,stages...>::call(scratch,active,args...);
+
+            const unsigned int offset = threadIdx.x;
+
+            if (offset < blockSize)
+            {
+                unsigned int coord[dim];
+                linToCoordWithOffset<blockEdgeSize>(offset, halo, coord);
+                const unsigned int linId = coordToLin<blockEdgeSize>(coord, halo);
+
+                auto dataBlock = dataBuffer.get(dataBlockPos);
+                dataBlock.template get<p_dst>()[offset] = res[linId];
+            }
+        }
+    };
+
+    /*! \brief Apply a sequence of dependent stages with one launch, every block run all the stages in shared memory
+     *
+     * \see SparseGridGpu::applyStagesFused
+     *
+     */
+    template <unsigned int dim,
+            unsigned int pMask,
+            unsigned int p_src,
+            unsigned int p_dst,
+            typename NN_type,
+            typename stageSeq,
+            typename IndexBufT,
+            typename DataBufT,
+            typename SparseGridT,
+            typename... Args>
+    __global__ void
+    applyStagesFusedKernel(
+    		Box<dim,int> bx,
+            IndexBufT indexBuffer,
+            DataBufT dataBuffer,
+            SparseGridT sparseGrid,
+            Args... args)
+    {
+        stageSeq::template apply<dim,pMask,p_src,p_dst,NN_type>(bx,indexBuffer,dataBuffer,sparseGrid,args...);
+    }
+
     template <unsigned int dim,
             unsigned int pMask,
             typename stencil,
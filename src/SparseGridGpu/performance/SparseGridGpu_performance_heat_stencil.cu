@@ -142,6 +142,110 @@ void launch_testStencilHeat_perf(std::string testURI, unsigned int i)
     cudaDeviceSynchronize();
 }
 
+/*! \brief Two independent heat equations (0,1) and (2,3): one launch per stencil against one fused launch
+ *
+ */
+template<unsigned int blockEdgeSize, unsigned int gridEdgeSize, typename SparseGridZ>
+void testStencilHeatFused_perf(unsigned int i, std::string base)
+{
+    typedef HeatStencil<SparseGridZ::dims,0,1> Stencil01T;
+    typedef HeatStencil<SparseGridZ::dims,1,0> Stencil10T;
+    typedef HeatStencil<SparseGridZ::dims,2,3> Stencil23T;
+    typedef HeatStencil<SparseGridZ::dims,3,2> Stencil32T;
+
+    report_sparsegrid_funcs.graphs.put(base + ".dim",2);
+    report_sparsegrid_funcs.graphs.put(base + ".blockSize",blockEdgeSize);
+    report_sparsegrid_funcs.graphs.put(base + ".gridSize.x",gridEdgeSize*SparseGridZ::blockEdgeSize_);
+    report_sparsegrid_funcs.graphs.put(base + ".gridSize.y",gridEdgeSize*SparseGridZ::blockEdgeSize_);
+
+    unsigned int iterations = 50;
+
+    openfpm::vector<double> measures_sep;
+    openfpm::vector<double> measures_fus;
+
+	dim3 gridSize(gridEdgeSize, gridEdgeSize);
+	dim3 blockSize(SparseGridZ::blockEdgeSize_,SparseGridZ::blockEdgeSize_);
+	typename SparseGridZ::grid_info blockGeometry(gridSize);
+	SparseGridZ sparseGrid(blockGeometry);
+	gpu::ofp_context_t gpuContext;
+	sparseGrid.template setBackgroundValue<0>(0);
+
+    unsigned long long numElements = gridEdgeSize*SparseGridZ::blockEdgeSize_*gridEdgeSize*SparseGridZ::blockEdgeSize_;
+
+	// Initialize the grid
+	sparseGrid.setGPUInsertBuffer(gridSize, dim3(1));
+	CUDA_LAUNCH_DIM3((insertConstantValue<0>),gridSize, blockSize,sparseGrid.toKernel(), 0);
+	CUDA_LAUNCH_DIM3((insertConstantValue<2>),gridSize, blockSize,sparseGrid.toKernel(), 0);
+	sparseGrid.template flush < smax_ < 0 >, smax_ < 2 >> (gpuContext, flush_type::FLUSH_ON_DEVICE);
+
+	sparseGrid.findNeighbours(); // Pre-compute the neighbours pos for each block!
+
+	for (unsigned int iter=0; iter<iterations; ++iter)
+	{
+		cudaDeviceSynchronize();
+        timer ts;
+        ts.start();
+
+        sparseGrid.template applyStencils<Stencil01T,Stencil23T>(sparseGrid.getBox(),STENCIL_MODE_INPLACE, 0.1);
+        sparseGrid.template applyStencils<Stencil10T,Stencil32T>(sparseGrid.getBox(),STENCIL_MODE_INPLACE, 0.1);
+        cudaDeviceSynchronize();
+
+        ts.stop();
+
+        measures_sep.add(ts.getwct());
+
+        timer tf;
+        tf.start();
+
+        sparseGrid.template applyStencilsFused<Stencil01T,Stencil23T>(sparseGrid.getBox(),STENCIL_MODE_INPLACE, 0.1);
+        sparseGrid.template applyStencilsFused<Stencil10T,Stencil32T>(sparseGrid.getBox(),STENCIL_MODE_INPLACE, 0.1);
+        cudaDeviceSynchronize();
+
+        tf.stop();
+
+        measures_fus.add(tf.getwct());
+	}
+
+	double mean_sep = 0;
+	double deviation_sep = 0;
+	standard_deviation(measures_sep,mean_sep,deviation_sep);
+
+	double mean_fus = 0;
+	double deviation_fus = 0;
+	standard_deviation(measures_fus,mean_fus,deviation_fus);
+
+    // 4 stencils on every element for each iteration
+    float gElemS_sep = 4 * numElements / (1e9 * mean_sep);
+    float gElemS_fus = 4 * numElements / (1e9 * mean_fus);
+
+    std::cout << "Test: In-place stencil fused" << std::endl;
+    std::cout << "Block: " << SparseGridZ::blockEdgeSize_ << "x" << SparseGridZ::blockEdgeSize_ << std::endl;
+    std::cout << "Grid: " << gridEdgeSize*SparseGridZ::blockEdgeSize_ << "x" << gridEdgeSize*SparseGridZ::blockEdgeSize_ << std::endl;
+    std::cout << "Iterations: " << iterations << std::endl;
+    std::cout << "\tSeparate: " << mean_sep << " dev:" << deviation_sep << " s  " << gElemS_sep << " GElem/s" << std::endl;
+    std::cout << "\tFused: " << mean_fus << " dev:" << deviation_fus << " s  " << gElemS_fus << " GElem/s" << std::endl;
+
+    report_sparsegrid_funcs.graphs.put(base + ".separate.time.mean",mean_sep);
+    report_sparsegrid_funcs.graphs.put(base + ".separate.time.dev",deviation_sep);
+    report_sparsegrid_funcs.graphs.put(base + ".fused.time.mean",mean_fus);
+    report_sparsegrid_funcs.graphs.put(base + ".fused.time.dev",deviation_fus);
+}
+
+template<unsigned int blockEdgeSize, unsigned int gridEdgeSize>
+void launch_testStencilHeatFused_perf(std::string testURI, unsigned int i)
+{
+    constexpr unsigned int dim = 2;
+    typedef aggregate<float,float,float,float> AggregateT;
+    constexpr unsigned int chunkSize = IntPow<blockEdgeSize,dim>::value;
+
+    std::string base(testURI + "(" + std::to_string(i) + ")");
+    report_sparsegrid_funcs.graphs.put(base + ".test.name","StencilFused");
+
+    testStencilHeatFused_perf<blockEdgeSize, gridEdgeSize,
+            SparseGridGpu<dim, AggregateT, blockEdgeSize, chunkSize>>(i, base);
+    cudaDeviceSynchronize();
+}
+
 
 BOOST_AUTO_TEST_SUITE(performance)
 
@@ -234,6 +338,19 @@ BOOST_AUTO_TEST_CASE(testStencilHeat_blockScaling)
 }
 
 
+BOOST_AUTO_TEST_CASE(testStencilHeatFused_gridScaling)
+{
+    std::string testURI = suiteURI + ".device.stencil.dense.N.2D.fused.gridScaling";
+    unsigned int counter = 0;
+    constexpr unsigned int blockEdgeSize = 8;
+    launch_testStencilHeatFused_perf<blockEdgeSize, 128>(testURI, counter++);
+    launch_testStencilHeatFused_perf<blockEdgeSize, 256>(testURI, counter++);
+    launch_testStencilHeatFused_perf<blockEdgeSize, 512>(testURI, counter++);
+
+    testSet.insert(testURI);
+}
+
+
 BOOST_AUTO_TEST_CASE(testStencilHeatZ_gridScaling)
 {
     std::string testURI = suiteURI + ".device.stencil.dense.Z.2D.gridScaling";
@@ -740,6 +740,112 @@ BOOST_AUTO_TEST_CASE(testStencil_lap_no_cross_simplified2)
 	BOOST_REQUIRE_EQUAL(match, true);
 }
 
+BOOST_AUTO_TEST_CASE(testStencilHeatFused)
+{
+	constexpr unsigned int dim = 2;
+	constexpr unsigned int blockEdgeSize = 8;
+	typedef aggregate<float,float,float,float> AggregateT;
+
+	dim3 gridSize(2, 2);
+	dim3 blockSizeInsert(blockEdgeSize, blockEdgeSize);
+
+	grid_smb<dim, blockEdgeSize> blockGeometry(gridSize);
+	SparseGridGpu<dim, AggregateT, blockEdgeSize, 64> sparseGrid(blockGeometry);
+	gpu::ofp_context_t gpuContext;
+	sparseGrid.template setBackgroundValue<0>(0);
+
+	// Insert values on the grid
+	sparseGrid.setGPUInsertBuffer(gridSize, blockSizeInsert);
+	CUDA_LAUNCH_DIM3((insertConstantValue<0>), gridSize, blockSizeInsert,sparseGrid.toKernel(), 0);
+	CUDA_LAUNCH_DIM3((insertConstantValue<2>), gridSize, blockSizeInsert,sparseGrid.toKernel(), 0);
+	sparseGrid.flush < smax_< 0 >, smax_< 2 >> (gpuContext, flush_type::FLUSH_ON_DEVICE);
+
+	sparseGrid.findNeighbours(); // Pre-compute the neighbours pos for each block!
+	sparseGrid.tagBoundaries(gpuContext);
+
+	// Point-wise stencils can always be fused
+	sparseGrid.template applyStencilsFused<BoundaryStencilSetXRescaled<dim,0,0>,
+	                                       BoundaryStencilSetXRescaled<dim,2,2>>(sparseGrid.getBox(),STENCIL_MODE_INPLACE,0.0 ,gridSize.x * blockEdgeSize, 0.0, 10.0);
+
+	// The two heat equations (0,1) and (2,3) are independent, one fused sweep advance both
+	const unsigned int maxIter = 1000;
+	for (unsigned int iter=0; iter<maxIter; ++iter)
+	{
+		sparseGrid.template applyStencilsFused<HeatStencil<dim, 0, 1>, HeatStencil<dim, 2, 3>>(sparseGrid.getBox(),STENCIL_MODE_INPLACE, 0.1);
+		sparseGrid.template applyStencilsFused<HeatStencil<dim, 1, 0>, HeatStencil<dim, 3, 2>>(sparseGrid.getBox(),STENCIL_MODE_INPLACE, 0.1);
+	}
+
+	sparseGrid.template deviceToHost<0,2>();
+
+	// Compare
+	bool match = true;
+	for (size_t i = 0; i < 64*4; i++)
+	{
+		auto coord = sparseGrid.getCoord(i);
+		float expectedValue = 10.0 * coord.get(0) / (gridSize.x * blockEdgeSize - 1);
+
+		match &= fabs(sparseGrid.template get<0>(coord) - expectedValue) < 1e-2;
+		match &= sparseGrid.template get<0>(coord) == sparseGrid.template get<2>(coord);
+	}
+
+	BOOST_REQUIRE_EQUAL(match, true);
+}
+
+BOOST_AUTO_TEST_CASE(testStencilHeatStagesFused)
+{
+	constexpr unsigned int dim = 2;
+	constexpr unsigned int blockEdgeSize = 8;
+	typedef aggregate<float,float,float,float> AggregateT;
+
+	dim3 gridSize(2, 2);
+	dim3 blockSizeInsert(blockEdgeSize, blockEdgeSize);
+
+	grid_smb<dim, blockEdgeSize> blockGeometry(gridSize);
+	SparseGridGpu<dim, AggregateT, blockEdgeSize, 64> sparseGrid(blockGeometry);
+	gpu::ofp_context_t gpuContext;
+	sparseGrid.template setBackgroundValue<0>(0);
+
+	// Insert values on the grid
+	sparseGrid.setGPUInsertBuffer(gridSize, blockSizeInsert);
+	CUDA_LAUNCH_DIM3((insertConstantValue<0>), gridSize, blockSizeInsert,sparseGrid.toKernel(), 0);
+	CUDA_LAUNCH_DIM3((insertConstantValue<2>), gridSize, blockSizeInsert,sparseGrid.toKernel(), 0);
+	sparseGrid.flush < smax_< 0 >, smax_< 2 >> (gpuContext, flush_type::FLUSH_ON_DEVICE);
+
+	sparseGrid.findNeighbours(); // Pre-compute the neighbours pos for each block!
+	sparseGrid.tagBoundaries(gpuContext);
+
+	sparseGrid.template applyStencilsFused<BoundaryStencilSetXRescaled<dim,0,0>,
+	                                       BoundaryStencilSetXRescaled<dim,2,2>>(sparseGrid.getBox(),STENCIL_MODE_INPLACE,0.0 ,gridSize.x * blockEdgeSize, 0.0, 10.0);
+
+	// (0,1) advance two steps per launch in shared memory, (2,3) one step per launch
+	const unsigned int maxIter = 500;
+	for (unsigned int iter=0; iter<maxIter; ++iter)
+	{
+		sparseGrid.template applyStagesFused<0,1,HeatStage<dim>,HeatStage<dim>>(sparseGrid.getBox(), 0.1f);
+		sparseGrid.template applyStagesFused<1,0,HeatStage<dim>,HeatStage<dim>>(sparseGrid.getBox(), 0.1f);
+
+		sparseGrid.template applyStencils<HeatStencil<dim, 2, 3>>(sparseGrid.getBox(),STENCIL_MODE_INPLACE, 0.1);
+		sparseGrid.template applyStencils<HeatStencil<dim, 3, 2>>(sparseGrid.getBox(),STENCIL_MODE_INPLACE, 0.1);
+		sparseGrid.template applyStencils<HeatStencil<dim, 2, 3>>(sparseGrid.getBox(),STENCIL_MODE_INPLACE, 0.1);
+		sparseGrid.template applyStencils<HeatStencil<dim, 3, 2>>(sparseGrid.getBox(),STENCIL_MODE_INPLACE, 0.1);
+	}
+
+	sparseGrid.template deviceToHost<0,2>();
+
+	// Compare
+	bool match = true;
+	for (size_t i = 0; i < 64*4; i++)
+	{
+		auto coord = sparseGrid.getCoord(i);
+		float expectedValue = 10.0 * coord.get(0) / (gridSize.x * blockEdgeSize - 1);
+
+		match &= fabs(sparseGrid.template get<0>(coord) - expectedValue) < 1e-2;
+		match &= fabs(sparseGrid.template get<0>(coord) - sparseGrid.template get<2>(coord)) < 1e-4;
+	}
+
+	BOOST_REQUIRE_EQUAL(match, true);
+}
+
 BOOST_AUTO_TEST_CASE(testStencil_lap_no_cross_simplified_subset)
 {
 	constexpr unsigned int dim = 2;
@@ -350,6 +350,41 @@ struct HeatStencil
     }
 };
 
+/*! \brief Explicit Euler step of the heat equation, as a stage of SparseGridGpu::applyStagesFused
+ *
+ * It compute the same of HeatStencil on the block-local scratch
+ *
+ */
+template<unsigned int dim>
+struct HeatStage
+{
+    static constexpr unsigned int supportRadius = 1;
+
+    /*! \brief Stage function
+     *
+     * \param u0 value at the beginning of the sequence of stages
+     * \param u output of the previous stage
+     * \param linId point in the scratch
+     * \param dt delta t
+     *
+     */
+    template<unsigned int edge, typename ScalarT>
+    static inline __device__ ScalarT stage(const ScalarT * u0, const ScalarT * u, const unsigned int linId, float dt)
+    {
+        ScalarT cur = u[linId];
+        ScalarT laplacian = -2.0 * dim * cur; // The central part of the stencil
+
+        unsigned int stride = 1;
+        for (int d = 0; d < dim; ++d)
+        {
+            laplacian += u[linId - stride] + u[linId + stride];
+            stride *= edge;
+        }
+
+        return cur + dt * laplacian;
+    }
+};
+
 struct conv_coeff
 {
 	float coeff[3][3][3];
@@ -39,6 +39,9 @@
 #include "util/cuda_util.hpp"
 #include "cuda/map_vector_cuda_ker.cuh"
 #include "map_vector_printers.hpp"
+#include "util/radix_sort_cpu.hpp"
+#include "util/mem_usage.hpp"
+#include "Grid/grid_layout_convert.hpp"
 
 namespace openfpm
 {
@@ -87,6 +90,31 @@ namespace openfpm
 		}
 	};
 
+	/*! \brief Copy an element between two 1D grids, used by vector reorder
+	 *
+	 * \tparam all_prp true if all the properties must be copied
+	 *
+	 */
+	template<bool all_prp>
+	struct vector_reorder_set_impl
+	{
+		template<unsigned int ... prp, typename grid_type>
+		static inline void set(grid_type & dst, size_t i, const grid_type & src, size_t j)
+		{
+			dst.template set<prp...>(grid_key_dx<1>(i),src,grid_key_dx<1>(j));
+		}
+	};
+
+	template<>
+	struct vector_reorder_set_impl<true>
+	{
+		template<unsigned int ... prp, typename grid_type>
+		static inline void set(grid_type & dst, size_t i, const grid_type & src, size_t j)
+		{
+			dst.set(grid_key_dx<1>(i),src,grid_key_dx<1>(j));
+		}
+	};
+
 	template<bool is_ok_cuda,typename T, typename Memory,
 			 template<typename> class layout_base,
 			 typename grow_p>
@@ -183,6 +211,34 @@ namespace openfpm
 	};
 
 
+	/*! \brief Copy (or merge) the elements of a vector into another by blocks of properties (layout_convert_prp)
+	 *
+	 * It is used by add_prp, merge_prp_v and the assignment between layouts when all the properties can be
+	 * converted by blocks, otherwise run return false and the element by element copy is used
+	 *
+	 */
+	template<bool is_block>
+	struct vector_layout_convert_impl
+	{
+		template<template<typename,typename> class op, unsigned int ... args, typename base_dst, typename base_src>
+		static bool run(base_dst & dst, size_t start, const base_src & src, size_t n)
+		{
+			return false;
+		}
+	};
+
+	template<>
+	struct vector_layout_convert_impl<true>
+	{
+		template<template<typename,typename> class op, unsigned int ... args, typename base_dst, typename base_src>
+		static bool run(base_dst & dst, size_t start, const base_src & src, size_t n)
+		{
+			layout_convert_prp<op,args...>(dst,start,src,0,n);
+
+			return true;
+		}
+	};
+
 	/*! \brief Implementation of 1-D std::vector like structure
 	 *
 	 * Stub object look at the various implementations
@@ -282,6 +338,122 @@ namespace openfpm
 
 #endif
 
+		/*! \brief Keep at the beginning the elements not selected by sel, and the selected ones at the end (if keep_sel)
+		 *         or remove them
+		 *
+		 * Each thread evaluate sel on its chunk and count the not selected (and selected) elements, an exclusive
+		 * prefix sum over the thread counts give the destination of every chunk and every thread scatter its
+		 * elements in a new buffer. Every element is moved once, the new buffer is then swapped with the vector
+		 *
+		 * \tparam keep_sel keep the selected elements at the end of the vector
+		 *
+		 * \param sel selector bool(size_t i)
+		 *
+		 * \return the number of elements not selected
+		 *
+		 */
+		template<bool keep_sel, typename sel_type>
+		size_t compact_impl(sel_type & sel)
+		{
+			const size_t n = size();
+
+			if (n == 0)	{return 0;}
+
+			const int nth = openfpm::ofp_n_threads(n,RADIX_SORT_CPU_GRAIN);
+
+			std::vector<unsigned char> mask(n);
+			std::vector<size_t> cnt(nth+1);
+
+			// count the not selected elements in every thread chunk
+
+			#pragma omp parallel for num_threads(nth) schedule(static,1)
+			for (int t = 0 ; t < nth ; t++)
+			{
+				size_t start;
+				size_t stop;
+				openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+				size_t c = 0;
+				for (size_t i = start ; i < stop ; i++)
+				{
+					mask[i] = (sel(i) == true);
+					c += (mask[i] == 0);
+				}
+
+				cnt[t+1] = c;
+			}
+
+			// exclusive prefix sum, cnt[t] is the destination of the first not selected element of the chunk t
+
+			cnt[0] = 0;
+			for (int t = 0 ; t < nth ; t++)
+			{cnt[t+1] += cnt[t];}
+
+			const size_t n_keep = cnt[nth];
+
+			if (n_keep == n)	{return n;}
+
+			self_type tmp;
+			tmp.resize((keep_sel == true)?n:n_keep);
+
+			#pragma omp parallel for num_threads(nth) schedule(static,1)
+			for (int t = 0 ; t < nth ; t++)
+			{
+				size_t start;
+				size_t stop;
+				openfpm::ofp_thread_range(n,t,nth,start,stop);
+
+				size_t d_k = cnt[t];
+
+				// the selected elements before the chunk t are start - cnt[t]
+				size_t d_s = n_keep + start - cnt[t];
+
+				for (size_t i = start ; i < stop ; i++)
+				{
+					if (mask[i] == 0)
+					{vector_reorder_set_impl<true>::set(tmp.base,d_k++,base,i);}
+					else if (keep_sel == true)
+					{vector_reorder_set_impl<true>::set(tmp.base,d_s++,base,i);}
+				}
+			}
+
+			swap(tmp);
+
+			return n_keep;
+		}
+
+		/*! \brief Remove the elements with the given ids
+		 *
+		 * \param n_keys number of keys
+		 * \param start first key to use
+		 * \param key function that return the key i
+		 *
+		 */
+		template<typename key_get_type>
+		void remove_keys_impl(size_t n_keys, size_t start, key_get_type key)
+		{
+			// Nothing to remove return
+			if (n_keys <= start )
+				return;
+
+			const size_t n = size();
+
+			std::vector<unsigned char> rm(n);
+
+			for (size_t i = start ; i < n_keys ; i++)
+			{
+				size_t k = key(i);
+				if (k < n)	{rm[k] = 1;}
+			}
+
+			auto sel = [&rm](size_t i) {return rm[i] == 1;};
+			compact_impl<false>(sel);
+
+			// re-calculate the vector size (keys outside the vector count as removed elements)
+
+			v_size = n - (n_keys - start);
+		}
+
 	public:
 
 		//! it define that it is a vector
@@ -352,6 +524,16 @@ namespace openfpm
 			return base.size();
 		}
 
+		/*! \brief Return the memory allocated and used by the vector
+		 *
+		 * \return the memory usage (allocated is the capacity, used the size)
+		 *
+		 */
+		mem_usage getMemoryUsage() const
+		{
+			return mem_usage(base.size()*sizeof(T),v_size*sizeof(T));
+		}
+
 		/*! \brief Reserve slots in the vector to avoid reallocation
 		 *
 		 * Reserve slots in the vector to avoid reallocation
@@ -1036,6 +1218,19 @@ namespace openfpm
 		void merge_prp_v(const vector<S,M,layout_base2,gp,OPENFPM_NATIVE> & v,
 				         size_t start)
 		{
+#ifdef SE_CLASS1
+
+			if (start + v.size() > v_size)
+				std::cerr << "Error: " << __FILE__ << ":" << __LINE__ << " try to access element " << start+v.size()-1 << " but the vector has size " << size() << std::endl;
+
+#endif
+
+			// arithmetic properties are merged by blocks
+			const bool is_block = sizeof...(args) != 0 && layout_convert_ok<T,S,args...>::value;
+
+			if (vector_layout_convert_impl<is_block>::template run<op,args...>(base,start,v.getInternal_base(),v.size()) == true)
+			{return;}
+
 			//! Add the element of v
 			for (size_t i = 0 ; i < v.size() ; i++)
 			{
@@ -1072,6 +1267,18 @@ namespace openfpm
 				  unsigned int ...args>
 		void add_prp(const vector<S,M,layout_base2,gp,impl> & v)
 		{
+			// arithmetic properties are copied by blocks, whatever are the layouts
+			const bool is_block = impl == OPENFPM_NATIVE && sizeof...(args) != 0 && layout_convert_ok<T,S,args...>::value;
+
+			if (is_block == true)
+			{
+				size_t old_sz = size();
+				resize(old_sz + v.size());
+
+				vector_layout_convert_impl<is_block>::template run<replace_,args...>(base,old_sz,v.getInternal_base(),v.size());
+				return;
+			}
+
 			//! Add the element of v
 			for (size_t i = 0 ; i < v.size() ; i++)
 			{
@@ -1156,7 +1363,8 @@ namespace openfpm
 
 		/*! \brief Remove several entries from the vector
 		 *
-		 * \warning the keys in the vector MUST be sorted
+		 * The keys must be unique, they do not need to be sorted. The remaining elements are compacted in
+		 * one pass (see remove_if)
 		 *
 		 * \param keys objects id to remove
 		 * \param start key starting point
@@ -1164,78 +1372,147 @@ namespace openfpm
 		 */
 		void remove(openfpm::vector<size_t> & keys, size_t start = 0)
 		{
-			// Nothing to remove return
-			if (keys.size() <= start )
-				return;
+			remove_keys_impl(keys.size(),start,[&keys](size_t i) {return (size_t)keys.get(i);});
+		}
 
-			size_t a_key = start;
-			size_t d_k = keys.get(a_key);
-			size_t s_k = keys.get(a_key) + 1;
+		/*! \brief Remove several entries from the vector
+		 *
+		 * The keys must be unique, they do not need to be sorted. The remaining elements are compacted in
+		 * one pass (see remove_if)
+		 *
+		 * \param keys objects id to remove
+		 * \param start key starting point
+		 *
+		 */
+		void remove(openfpm::vector<aggregate<int>> & keys, size_t start = 0)
+		{
+			remove_keys_impl(keys.size(),start,[&keys](size_t i) {return (size_t)keys.template get<0>(i);});
+		}
 
-			// keys
-			while (s_k < size())
-			{
-				// s_k should always point to a key that is not going to be deleted
-				while (a_key+1 < keys.size() && s_k == keys.get(a_key+1))
-				{
-					a_key++;
-					s_k = keys.get(a_key) + 1;
-				}
+		/*! \brief Remove all the elements for which pred(i) is true, the order of the remaining elements is preserved
+		 *
+		 * The predicate is evaluated once for every element in parallel (it must be thread safe), the remaining
+		 * elements are placed with a prefix sum over the per-thread counts and scattered in parallel in a new
+		 * buffer, so every property is moved once
+		 *
+		 * ### Remove the particles outside the domain
+		 * \snippet vector_unit_tests.hpp Remove and partition
+		 *
+		 * \param pred predicate with signature bool(size_t i)
+		 *
+		 * \return the number of removed elements
+		 *
+		 */
+		template<typename pred_type>
+		size_t remove_if(pred_type pred)
+		{
+			size_t n = size();
 
-				// In case of overflow
-				if (s_k >= size())
-					break;
+			return n - compact_impl<false>(pred);
+		}
 
-				set(d_k,get(s_k));
-				d_k++;
-				s_k++;
+		/*! \brief Move the elements for which pred(i) is true at the end of the vector, the order is preserved
+		 *         in both parts (stable partition)
+		 *
+		 * It can be used to split the particles in real and ghost
+		 *
+		 * \param pred predicate with signature bool(size_t i), evaluated in parallel
+		 *
+		 * \return the number of elements for which pred is false (the first selected element)
+		 *
+		 */
+		template<typename pred_type>
+		size_t partition(pred_type pred)
+		{
+			return compact_impl<true>(pred);
+		}
+
+		/*! \brief Reorder the vector with a permutation
+		 *
+		 * After the call the element i is the element perm[i] before the call. The
+		 * reordering is done on multiple threads
+		 *
+		 * \tparam prp properties to reorder, if empty all the properties are reordered
+		 *
+		 * \param perm permutation (must have the same size of the vector)
+		 *
+		 */
+		template<unsigned int ... prp, typename perm_type>
+		void reorder(const perm_type & perm)
+		{
+			self_type tmp;
+			tmp.resize(size());
+
+			int nth = openfpm::ofp_n_threads(size(),RADIX_SORT_CPU_GRAIN);
+
+			#pragma omp parallel for num_threads(nth) schedule(static)
+			for (size_t i = 0 ; i < size() ; i++)
+			{
+				vector_reorder_set_impl<sizeof...(prp) == 0>::template set<prp...>(tmp.base,i,base,perm.template get<0>(i));
 			}
 
-			// re-calculate the vector size
+			if (sizeof...(prp) == 0)
+			{
+				swap(tmp);
+				return;
+			}
 
-			v_size -= keys.size() - start;
+			#pragma omp parallel for num_threads(nth) schedule(static)
+			for (size_t i = 0 ; i < size() ; i++)
+			{
+				vector_reorder_set_impl<false>::template set<prp...>(base,i,tmp.base,i);
+			}
 		}
 
-		/*! \brief Remove several entries from the vector
+		/*! \brief Sort the vector using the property key_prp as key
 		 *
-		 * \warning the keys in the vector MUST be sorted
+		 * It use a multi-threaded LSD radix sort, the sort is stable. The property key_prp
+		 * must be an integer or a floating point scalar
 		 *
-		 * \param keys objects id to remove
-		 * \param start key starting point
+		 * \tparam key_prp property used as key
+		 * \tparam prp properties to reorder, if empty all the properties are reordered
+		 *
+		 * \param perm output permutation, the element i is the element perm[i] before sorting
 		 *
 		 */
-		void remove(openfpm::vector<aggregate<int>> & keys, size_t start = 0)
+		template<unsigned int key_prp, unsigned int ... prp>
+		void sort_by_prop(openfpm::vector<aggregate<size_t>> & perm)
 		{
-			// Nothing to remove return
-			if (keys.size() <= start )
-				return;
+			typedef typename std::remove_const<typename std::remove_reference<decltype(this->template get<key_prp>(0))>::type>::type key_type;
 
-			size_t a_key = start;
-			size_t d_k = keys.template get<0>(a_key);
-			size_t s_k = keys.template get<0>(a_key) + 1;
+			perm.resize(size());
 
-			// keys
-			while (s_k < size())
-			{
-				// s_k should always point to a key that is not going to be deleted
-				while (a_key+1 < keys.size() && s_k == keys.template get<0>(a_key+1))
-				{
-					a_key++;
-					s_k = keys.template get<0>(a_key) + 1;
-				}
+			openfpm::vector<aggregate<key_type>> keys;
+			keys.resize(size());
 
-				// In case of overflow
-				if (s_k >= size())
-					break;
+			int nth = openfpm::ofp_n_threads(size(),RADIX_SORT_CPU_GRAIN);
 
-				set(d_k,get(s_k));
-				d_k++;
-				s_k++;
+			#pragma omp parallel for num_threads(nth) schedule(static)
+			for (size_t i = 0 ; i < size() ; i++)
+			{
+				keys.template get<0>(i) = this->template get<key_prp>(i);
+				perm.template get<0>(i) = i;
 			}
 
-			// re-calculate the vector size
+			openfpm::radix_sort_cpu((key_type *)keys.template getPointer<0>(),(size_t *)perm.template getPointer<0>(),size());
 
-			v_size -= keys.size() - start;
+			reorder<prp...>(perm);
+		}
+
+		/*! \brief Sort the vector using the property key_prp as key
+		 *
+		 * \see sort_by_prop
+		 *
+		 * \tparam key_prp property used as key
+		 * \tparam prp properties to reorder, if empty all the properties are reordered
+		 *
+		 */
+		template<unsigned int key_prp, unsigned int ... prp>
+		void sort_by_prop()
+		{
+			openfpm::vector<aggregate<size_t>> perm;
+
+			sort_by_prop<key_prp,prp...>(perm);
 		}
 
 		/*! \brief Get an element of the vector
@@ -1778,14 +2055,22 @@ namespace openfpm
 		operator=(const vector<T, Mem, layout_base2 ,grow_p,OPENFPM_NATIVE> & mv)
 		{
 			v_size = mv.getInternal_v_size();
-			size_t rsz[1] = {v_size};
-			base.resize(rsz);
 
-			// copy the object
-			for (size_t i = 0 ; i < v_size ; i++ )
+			// the memory already allocated is reused, the old content is overwritten
+			if (base.size() < v_size || layout_convert_ok<T,T>::value == false)
 			{
-				grid_key_dx<1> key(i);
-				base.set_general(key,mv.getInternal_base(),key);
+				size_t rsz[1] = {v_size};
+				base.resize(rsz);
+			}
+
+			// copy the properties by blocks, or object by object
+			if (vector_layout_convert_impl<layout_convert_ok<T,T>::value>::template run<replace_>(base,0,mv.getInternal_base(),v_size) == false)
+			{
+				for (size_t i = 0 ; i < v_size ; i++ )
+				{
+					grid_key_dx<1> key(i);
+					base.set_general(key,mv.getInternal_base(),key);
+				}
 			}
 
 #if defined(CUDIFY_USE_SEQUENTIAL) || defined(CUDIFY_USE_OPENMP)
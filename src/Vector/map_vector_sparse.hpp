@@ -23,6 +23,9 @@
 #include "util/cuda/sort_ofp.cuh"
 #include "util/cuda/segreduce_ofp.cuh"
 #include "util/cuda/merge_ofp.cuh"
+#include "util/radix_sort_cpu.hpp"
+#include "util/multi_thread_util.hpp"
+#include "util/scratch_arena.hpp"
 
 enum flush_type
 {
@@ -61,6 +64,12 @@ namespace openfpm
     constexpr int VECTOR_SPARSE_STANDARD = 1;
     constexpr int VECTOR_SPARSE_BLOCK = 2;
 
+    //! Minimum number of elements processed by a thread in the host flush
+    constexpr int VECTOR_SPARSE_CPU_GRAIN = 4096;
+
+    //! Number of binary searches interleaved by the batched get
+    constexpr int VECTOR_SPARSE_BATCH_INTERLEAVE = 8;
+
     template<typename reduction_type, unsigned int impl>
     struct cpu_block_process
     {
@@ -324,93 +333,106 @@ namespace openfpm
 		}
 	};
 
-	template<typename reduction_type, typename vector_reduction, typename T,unsigned int impl, typename red_type>
-	struct sparse_vector_reduction_cpu_impl
+	/*! \brief Access the indexes (property 0) of an index vector with operator[]
+	 *
+	 * \tparam vector_index_type type of the index vector
+	 *
+	 */
+	template<typename vector_index_type>
+	struct sparse_index_accessor
 	{
-		template<typename vector_data_type, typename vector_index_type,typename vector_index_type_reo>
-		static inline void red(size_t & i, vector_data_type & vector_data_red,
-				   vector_data_type & vector_data,
-				   vector_index_type & vector_index,
-				   vector_index_type_reo & reorder_add_index_cpu)
+		//! index vector
+		const vector_index_type & v;
+
+		sparse_index_accessor(const vector_index_type & v)
+		:v(v)
+		{}
+
+		inline auto operator[](size_t i) const -> decltype(v.template get<0>(i))
 		{
-			size_t start = reorder_add_index_cpu.get(i).id;
-			red_type red = vector_data.template get<reduction_type::prop::value>(i);
+			return v.template get<0>(i);
+		}
+	};
 
-			size_t j = 1;
-			for ( ; i+j < reorder_add_index_cpu.size() && reorder_add_index_cpu.get(i+j).id == start ; j++)
-			{
-				cpu_block_process<reduction_type,impl>::process(vector_data.template get<reduction_type::prop::value>(i+j),red);
-				//reduction_type::red(red,vector_data.template get<reduction_type::prop::value>(i+j));
-			}
-			vector_data_red.add();
-			vector_data_red.template get<reduction_type::prop::value>(vector_data_red.size()-1) = red;
+	template<typename reduction_type, unsigned int impl, typename red_type>
+	struct sparse_vector_reduction_cpu_impl
+	{
+		/*! \brief Reduce the segment [start,stop) of vector_data into the element seg of vector_data_red
+		 *
+		 * \param seg segment id
+		 * \param start first element of the segment
+		 * \param stop one past the last element of the segment
+		 * \param vector_data_red reduced data
+		 * \param vector_data data to reduce
+		 *
+		 */
+		template<typename vector_data_type>
+		static inline void red(size_t seg, size_t start, size_t stop,
+				   vector_data_type & vector_data_red,
+				   vector_data_type & vector_data)
+		{
+			red_type red = vector_data.template get<reduction_type::prop::value>(start);
 
-			if (T::value == 0)
+			for (size_t j = start + 1 ; j < stop ; j++)
 			{
-				vector_index.add();
-				vector_index.template get<0>(vector_index.size() - 1) = reorder_add_index_cpu.get(i).id;
+				cpu_block_process<reduction_type,impl>::process(vector_data.template get<reduction_type::prop::value>(j),red);
 			}
 
-			i += j;
+			vector_data_red.template get<reduction_type::prop::value>(seg) = red;
 		}
 	};
 
 
-	template<typename reduction_type, typename vector_reduction, typename T,unsigned int impl, typename red_type, unsigned int N1>
-	struct sparse_vector_reduction_cpu_impl<reduction_type,vector_reduction,T,impl,red_type[N1]>
+	template<typename reduction_type, unsigned int impl, typename red_type, unsigned int N1>
+	struct sparse_vector_reduction_cpu_impl<reduction_type,impl,red_type[N1]>
 	{
-		template<typename vector_data_type, typename vector_index_type,typename vector_index_type_reo>
-		static inline void red(size_t & i, vector_data_type & vector_data_red,
-				   vector_data_type & vector_data,
-				   vector_index_type & vector_index,
-				   vector_index_type_reo & reorder_add_index_cpu)
+		/*! \brief Reduce the segment [start,stop) of vector_data into the element seg of vector_data_red
+		 *
+		 * \param seg segment id
+		 * \param start first element of the segment
+		 * \param stop one past the last element of the segment
+		 * \param vector_data_red reduced data
+		 * \param vector_data data to reduce
+		 *
+		 */
+		template<typename vector_data_type>
+		static inline void red(size_t seg, size_t start, size_t stop,
+				   vector_data_type & vector_data_red,
+				   vector_data_type & vector_data)
 		{
-			size_t start = reorder_add_index_cpu.get(i).id;
 			red_type red[N1];
 
 			for (size_t k = 0 ; k < N1 ; k++)
 			{
-				red[k] = vector_data.template get<reduction_type::prop::value>(i)[k];
+				red[k] = vector_data.template get<reduction_type::prop::value>(start)[k];
 			}
 
-			size_t j = 1;
-			for ( ; i+j < reorder_add_index_cpu.size() && reorder_add_index_cpu.get(i+j).id == start ; j++)
+			for (size_t j = start + 1 ; j < stop ; j++)
 			{
-				auto ev = vector_data.template get<reduction_type::prop::value>(i+j);
+				auto ev = vector_data.template get<reduction_type::prop::value>(j);
 				cpu_block_process<reduction_type,impl+1>::process(ev,red);
-				//reduction_type::red(red,vector_data.template get<reduction_type::prop::value>(i+j));
 			}
 
-			vector_data_red.add();
-
 			for (size_t k = 0 ; k < N1 ; k++)
 			{
-				vector_data_red.template get<reduction_type::prop::value>(vector_data_red.size()-1)[k] = red[k];
+				vector_data_red.template get<reduction_type::prop::value>(seg)[k] = red[k];
 			}
-
-			if (T::value == 0)
-			{
-				vector_index.add();
-				vector_index.template get<0>(vector_index.size() - 1) = reorder_add_index_cpu.get(i).id;
-			}
-
-			i += j;
 		}
 	};
 
 	/*! \brief this class is a functor for "for_each" algorithm
 	 *
-	 * This class is a functor for "for_each" algorithm. For each
-	 * element of the boost::vector the operator() is called.
-	 * Is mainly used to copy one encap into another encap object
+	 * For each reduction it reduce the segments of the sorted inserted data. Every segment
+	 * contain the inserted elements with the same index, segments are processed in parallel
 	 *
-	 * \tparam encap source
-	 * \tparam encap dst
+	 * \tparam vector_data_type type of the data vector
+	 * \tparam vector_index_type type of the segment vector (index,segment start)
+	 * \tparam vector_reduction vector of the reductions
+	 * \tparam impl VECTOR_SPARSE_STANDARD or VECTOR_SPARSE_BLOCK
 	 *
 	 */
 	template<typename vector_data_type,
 			typename vector_index_type,
-	        typename vector_index_type_reo,
 	        typename vector_reduction,
 	        unsigned int impl>
 	struct sparse_vector_reduction_cpu
@@ -418,26 +440,23 @@ namespace openfpm
 		//! Vector in which to the reduction
 		vector_data_type & vector_data_red;
 
-		//! Vector in which to the reduction
+		//! Vector to reduce
 		vector_data_type & vector_data;
 
-		//! reorder vector index
-		vector_index_type_reo & reorder_add_index_cpu;
-
-		//! Index type vector
-		vector_index_type & vector_index;
+		//! segments (index, segment start)
+		vector_index_type & segments;
 
 		/*! \brief constructor
 		 *
-		 * \param src source encapsulated object
-		 * \param dst source encapsulated object
+		 * \param vector_data_red reduced data (one element for each segment)
+		 * \param vector_data sorted data to reduce
+		 * \param segments for each segment the index and the segment start
 		 *
 		 */
 		inline sparse_vector_reduction_cpu(vector_data_type & vector_data_red,
 									   vector_data_type & vector_data,
-									   vector_index_type & vector_index,
-									   vector_index_type_reo & reorder_add_index_cpu)
-		:vector_data_red(vector_data_red),vector_data(vector_data),vector_index(vector_index),reorder_add_index_cpu(reorder_add_index_cpu)
+									   vector_index_type & segments)
+		:vector_data_red(vector_data_red),vector_data(vector_data),segments(segments)
 		{};
 
 		//! It call the copy function for each property
@@ -449,29 +468,17 @@ namespace openfpm
 
             if (reduction_type::is_special() == false)
 			{
-    			for (size_t i = 0 ; i < reorder_add_index_cpu.size() ; )
+            	size_t n_seg = segments.size();
+            	size_t n = vector_data.size();
+            	int nth = ofp_n_threads(n,VECTOR_SPARSE_CPU_GRAIN);
+
+				#pragma omp parallel for num_threads(nth) schedule(static)
+    			for (size_t s = 0 ; s < n_seg ; s++)
     			{
-    				sparse_vector_reduction_cpu_impl<reduction_type,vector_reduction,T,impl,red_type>::red(i,vector_data_red,vector_data,vector_index,reorder_add_index_cpu);
-
-/*    				size_t start = reorder_add_index_cpu.get(i).id;
-    				red_type red = vector_data.template get<reduction_type::prop::value>(i);
-
-    				size_t j = 1;
-    				for ( ; i+j < reorder_add_index_cpu.size() && reorder_add_index_cpu.get(i+j).id == start ; j++)
-    				{
-    					cpu_block_process<reduction_type,impl>::process(vector_data.template get<reduction_type::prop::value>(i+j),red);
-    					//reduction_type::red(red,vector_data.template get<reduction_type::prop::value>(i+j));
-    				}
-    				vector_data_red.add();
-    				vector_data_red.template get<reduction_type::prop::value>(vector_data_red.size()-1) = red;
-
-    				if (T::value == 0)
-    				{
-    					vector_index.add();
-    					vector_index.template get<0>(vector_index.size() - 1) = reorder_add_index_cpu.get(i).id;
-    				}
-
-    				i += j;*/
+    				size_t start = segments.template get<1>(s);
+    				size_t stop = (s + 1 < n_seg)?segments.template get<1>(s+1):n;
+
+    				sparse_vector_reduction_cpu_impl<reduction_type,impl,red_type>::red(s,start,stop,vector_data_red,vector_data);
     			}
 			}
 		}
@@ -816,13 +823,135 @@ namespace openfpm
 
 		CudaMemory mem;
 
-		openfpm::vector<reorder<Ti>> reorder_add_index_cpu;
-
 		size_t max_ele;
 
 		int n_gpu_add_block_slot = 0;
 		int n_gpu_rem_block_slot = 0;
 
+		//! arena where the flush temporaries are borrowed (NULL the temporaries are kept between flushes)
+		scratch_arena * arena = NULL;
+
+		//! insert pool of a host thread
+		struct cpu_insert_pool
+		{
+			//! inserted indexes
+			vector<aggregate<Ti>,Memory,layout_base,grow_p> index;
+
+			//! inserted data
+			vector<T,Memory,layout_base,grow_p> data;
+
+			//! the pools of two threads are not on the same cache line (std::vector does not honour alignas before C++17)
+			char pad[64];
+		};
+
+		//! insert pools of the host threads (setCPUInsertBuffer)
+		std::vector<cpu_insert_pool> cpu_pools;
+
+		/*! \brief Append the insert pools of the host threads to the insert buffer
+		 *
+		 * Every pool is copied in its segment of vct_add_index and vct_add_data by a different thread
+		 *
+		 */
+		void merge_cpu_insert_pools()
+		{
+			size_t n_pool = cpu_pools.size();
+
+			if (n_pool == 0)	{return;}
+
+			std::vector<size_t> offsets(n_pool+1);
+			offsets[0] = vct_add_index.size();
+
+			for (size_t i = 0 ; i < n_pool ; i++)
+			{offsets[i+1] = offsets[i] + cpu_pools[i].index.size();}
+
+			size_t n = offsets[n_pool] - offsets[0];
+
+			if (n == 0)	{return;}
+
+			vct_add_index.resize(offsets[n_pool]);
+			vct_add_data.resize(offsets[n_pool]);
+
+			int nth = ofp_n_threads(n,VECTOR_SPARSE_CPU_GRAIN);
+
+			#pragma omp parallel for num_threads(nth) schedule(dynamic,1)
+			for (size_t i = 0 ; i < n_pool ; i++)
+			{
+				cpu_insert_pool & pool = cpu_pools[i];
+
+				for (size_t j = 0 ; j < pool.index.size() ; j++)
+				{
+					vct_add_index.template get<0>(offsets[i] + j) = pool.index.template get<0>(j);
+					vct_add_data.set(offsets[i] + j,pool.data,j);
+				}
+
+				pool.index.clear();
+				pool.data.clear();
+			}
+		}
+
+		/*! \brief Check that the insert pools of the host threads are empty
+		 *
+		 * The pools are merged only by a flush on host, a flush on device with pools not empty is an error
+		 *
+		 * \param func flush function that check
+		 *
+		 * \return true if all the pools are empty
+		 *
+		 */
+		bool check_cpu_insert_pools_empty(const char * func)
+		{
+			for (size_t i = 0 ; i < cpu_pools.size() ; i++)
+			{
+				if (cpu_pools[i].index.size() != 0)
+				{
+					std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " " << func << " with FLUSH_ON_DEVICE, the insert pools of the host threads (insert(ele,tid)) are not empty, they can be flushed only with FLUSH_ON_HOST" << std::endl;
+					ACTION_ON_ERROR(VECTOR_ERROR_OBJECT);
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		/*! \brief Take the flush temporaries from the arena
+		 *
+		 */
+		void borrow_scratch()
+		{
+			if (arena == NULL)	{return;}
+
+			arena->borrow(vct_m_index);
+			arena->borrow(vct_add_index_cont_0);
+			arena->borrow(vct_add_data_reord);
+			arena->borrow(vct_add_data_cont);
+			arena->borrow(vct_add_data_unique);
+			arena->borrow(vct_index_tmp);
+			arena->borrow(vct_index_tmp3);
+			arena->borrow(vct_index_tmp4);
+			arena->borrow(vct_index_dtmp);
+		}
+
+		/*! \brief Give back the flush temporaries to the arena
+		 *
+		 * The temporaries that are readable after the flush (getMappingVector, getMergeIndexMapVector,
+		 * getSegmentToMergeIndexMap) are kept
+		 *
+		 */
+		void release_scratch()
+		{
+			if (arena == NULL)	{return;}
+
+			arena->release(vct_m_index);
+			arena->release(vct_add_index_cont_0);
+			arena->release(vct_add_data_reord);
+			arena->release(vct_add_data_cont);
+			arena->release(vct_add_data_unique);
+			arena->release(vct_index_tmp);
+			arena->release(vct_index_tmp3);
+			arena->release(vct_index_tmp4);
+			arena->release(vct_index_dtmp);
+		}
+
 		/*! \brief get the element i
 		 *
 		 * search the element x
@@ -866,6 +995,56 @@ namespace openfpm
 			id = (x == v)?id:vct_data.size()-1;
 		}
 
+		/*! \brief search n_int elements at the same time
+		 *
+		 * The binary searches run in lock-step, at every step the loads of all the searches
+		 * (and the prefetch of the next step) are issued together so the memory latencies overlap
+		 *
+		 * \param x elements to search
+		 * \param id for each element the position in the data buffer (background if not found)
+		 *
+		 */
+		template<unsigned int n_int>
+		inline void _branchfree_search_interleaved(const Ti (& x)[n_int], Ti (& id)[n_int]) const
+		{
+			Ti bck_id = vct_data.size()-1;
+			Ti n_ele = vct_index.size();
+
+			if (n_ele == 0)
+			{
+				for (unsigned int k = 0 ; k < n_int ; k++)	{id[k] = bck_id;}
+				return;
+			}
+
+			const Ti * start = &vct_index.template get<0>(0);
+			const Ti * base[n_int];
+
+			for (unsigned int k = 0 ; k < n_int ; k++)	{base[k] = start;}
+
+			Ti n = n_ele;
+			while (n > 1)
+			{
+				Ti half = n / 2;
+
+				for (unsigned int k = 0 ; k < n_int ; k++)
+				{
+					__builtin_prefetch(base[k] + half/2, 0, 0);
+					__builtin_prefetch(base[k] + half + half/2, 0, 0);
+				}
+
+				for (unsigned int k = 0 ; k < n_int ; k++)
+				{base[k] = (base[k][half] < x[k]) ? base[k]+half : base[k];}
+
+				n -= half;
+			}
+
+			for (unsigned int k = 0 ; k < n_int ; k++)
+			{
+				Ti pos = base[k] - start + (*base[k] < x[k]);
+				id[k] = (pos < n_ele && start[pos] == x[k])?pos:bck_id;
+			}
+		}
+
 
 		/* \brief take the indexes for the insertion pools and create a continuos array
 		 *
@@ -1371,111 +1550,265 @@ namespace openfpm
 			flush_on_gpu_insert<v_reduce ... >(vct_add_index_cont_0,vct_add_index_cont_1,vct_add_data_reord,gpuContext);
 		}
 
-		template<typename ... v_reduce>
-		void flush_on_cpu()
+		/*! \brief Sort the inserted indexes and reorder the inserted data accordingly
+		 *
+		 * At the end vct_add_index_cont_0 contain the sorted indexes and vct_add_data_cont the inserted
+		 * data in the same order
+		 *
+		 */
+		void sort_add_cpu()
 		{
-			if (vct_add_index.size() == 0)
-			{return;}
+			size_t n = vct_add_index.size();
+			int nth = ofp_n_threads(n,VECTOR_SPARSE_CPU_GRAIN);
 
-			// First copy the added index to reorder
-			reorder_add_index_cpu.resize(vct_add_index.size());
-			vct_add_data_cont.resize(vct_add_index.size());
+			vct_add_index_cont_0.resize(n);
+			vct_add_index_cont_1.resize(n);
+			vct_index_tmp.resize(n);
+			vct_index_tmp2.resize(n);
 
-			for (size_t i = 0 ; i < reorder_add_index_cpu.size() ; i++)
+			#pragma omp parallel for num_threads(nth) schedule(static)
+			for (size_t i = 0 ; i < n ; i++)
 			{
-				reorder_add_index_cpu.get(i).id = vct_add_index.template get<0>(i);
-				reorder_add_index_cpu.get(i).id2 = i;
+				vct_add_index_cont_0.template get<0>(i) = vct_add_index.template get<0>(i);
+				vct_add_index_cont_1.template get<0>(i) = i;
 			}
 
-			reorder_add_index_cpu.sort();
+			openfpm::radix_sort_cpu((Ti *)vct_add_index_cont_0.template getPointer<0>(),
+									(Ti *)vct_add_index_cont_1.template getPointer<0>(),
+									n,
+									(Ti *)vct_index_tmp.template getPointer<0>(),
+									(Ti *)vct_index_tmp2.template getPointer<0>());
 
 			// Copy the data
-			for (size_t i = 0 ; i < reorder_add_index_cpu.size() ; i++)
+
+			vct_add_data_cont.resize(n);
+
+			#pragma omp parallel for num_threads(nth) schedule(static)
+			for (size_t i = 0 ; i < n ; i++)
 			{
-				vct_add_data_cont.get(i) = vct_add_data.get(reorder_add_index_cpu.get(i).id2);
+				vct_add_data_cont.set(i,vct_add_data,vct_add_index_cont_1.template get<0>(i));
 			}
+		}
 
+		/*! \brief Find the segments of equal indexes in the sorted inserted indexes
+		 *
+		 * At the end vct_add_index_unique contain for each segment the index and the segment start
+		 *
+		 */
+		void find_segments_cpu()
+		{
+			size_t n = vct_add_index_cont_0.size();
+			int nth = ofp_n_threads(n,VECTOR_SPARSE_CPU_GRAIN);
+
+			const Ti * keys = (const Ti *)vct_add_index_cont_0.template getPointer<0>();
+
+			std::vector<size_t> offsets(nth+1,0);
+
+			// count the segments starting in every thread chunk
+
+			#pragma omp parallel for num_threads(nth) schedule(static,1)
+			for (int t = 0 ; t < nth ; t++)
+			{
+				size_t start;
+				size_t stop;
+				ofp_thread_range(n,t,nth,start,stop);
+
+				size_t cnt = 0;
+				for (size_t i = start ; i < stop ; i++)
+				{cnt += (i == 0 || keys[i] != keys[i-1]);}
+
+				offsets[t+1] = cnt;
+			}
+
+			for (int t = 0 ; t < nth ; t++)
+			{offsets[t+1] += offsets[t];}
+
+			vct_add_index_unique.resize(offsets[nth]);
+
+			// write the segments
+
+			#pragma omp parallel for num_threads(nth) schedule(static,1)
+			for (int t = 0 ; t < nth ; t++)
+			{
+				size_t start;
+				size_t stop;
+				ofp_thread_range(n,t,nth,start,stop);
+
+				size_t o = offsets[t];
+				for (size_t i = start ; i < stop ; i++)
+				{
+					if (i == 0 || keys[i] != keys[i-1])
+					{
+						vct_add_index_unique.template get<0>(o) = keys[i];
+						vct_add_index_unique.template get<1>(o) = i;
+						o++;
+					}
+				}
+			}
+		}
+
+		/*! \brief Merge the reduced inserted data into vct_index and vct_data
+		 *
+		 * The two sorted sequences are split across threads with a merge path search
+		 *
+		 */
+		template<typename ... v_reduce>
+		void merge_cpu()
+		{
 			typedef boost::mpl::vector<v_reduce...> vv_reduce;
 
-			sparse_vector_reduction_cpu<decltype(vct_add_data),
-										decltype(vct_add_index_unique),
-										decltype(reorder_add_index_cpu),
-										vv_reduce,
-										impl2>
-			        svr(vct_add_data_unique,
-			        	vct_add_data_cont,
-			        	vct_add_index_unique,
-			        	reorder_add_index_cpu);
+			size_t na = vct_index.size();
+			size_t nb = vct_add_index_unique.size();
+			int nth = ofp_n_threads(na + nb,VECTOR_SPARSE_CPU_GRAIN);
 
-			boost::mpl::for_each_ref<boost::mpl::range_c<int,0,sizeof...(v_reduce)>>(svr);
+			sparse_index_accessor<decltype(vct_index)> a(vct_index);
+			sparse_index_accessor<decltype(vct_add_index_unique)> b(vct_add_index_unique);
 
-			// merge the the data
+			// partition of the merged sequence
 
-			vector<T,Memory,layout_base,grow_p,impl> vct_data_tmp;
-			vector<aggregate<Ti>,Memory,layout_base,grow_p> vct_index_tmp;
+			std::vector<size_t> ia(nth+1);
+			std::vector<size_t> ib(nth+1);
+			std::vector<size_t> offsets(nth+1,0);
 
-			vct_data_tmp.resize(vct_data.size() + vct_add_data_unique.size());
-			vct_index_tmp.resize(vct_index.size() + vct_add_index_unique.size());
+			#pragma omp parallel for num_threads(nth) schedule(static,1)
+			for (int t = 0 ; t <= nth ; t++)
+			{
+				size_t diag = (na + nb) * t / nth;
+				size_t i = merge_path_search(a,na,b,nb,diag,std::less<Ti>());
+				size_t j = diag - i;
+
+				// an index present in both sequences must be processed by one thread
+				if (i > 0 && j < nb && a[i-1] == b[j])	{j++;}
+
+				ia[t] = i;
+				ib[t] = j;
+			}
 
-			Ti di = 0;
-			Ti ai = 0;
-			size_t i = 0;
+			// count the merged elements of each partition
 
-			for ( ; i < vct_data_tmp.size() ; i++)
+			#pragma omp parallel for num_threads(nth) schedule(static,1)
+			for (int t = 0 ; t < nth ; t++)
 			{
-				Ti id_a = (ai < vct_add_index_unique.size())?vct_add_index_unique.template get<0>(ai):std::numeric_limits<Ti>::max();
-				Ti id_d = (di < vct_index.size())?vct_index.template get<0>(di):std::numeric_limits<Ti>::max();
+				size_t i = ia[t];
+				size_t j = ib[t];
+				size_t cnt = 0;
 
-				if (  id_a <= id_d )
+				while (i < ia[t+1] || j < ib[t+1])
 				{
-					vct_index_tmp.template get<0>(i) = id_a;
+					if (j >= ib[t+1] || (i < ia[t+1] && a[i] < b[j]))	{i++;}
+					else if (i >= ia[t+1] || b[j] < a[i])	{j++;}
+					else	{i++;j++;}
 
-					if (id_a == id_d)
+					cnt++;
+				}
+
+				offsets[t+1] = cnt;
+			}
+
+			for (int t = 0 ; t < nth ; t++)
+			{offsets[t+1] += offsets[t];}
+
+			vector<T,Memory,layout_base,grow_p,impl> vct_data_tmp;
+
+			if (arena != NULL)	{arena->borrow(vct_data_tmp);}
+
+			vct_data_tmp.resize(offsets[nth]);
+			vct_index_tmp.resize(offsets[nth]);
+
+			// merge
+
+			#pragma omp parallel for num_threads(nth) schedule(static,1)
+			for (int t = 0 ; t < nth ; t++)
+			{
+				size_t di = ia[t];
+				size_t ai = ib[t];
+				size_t o = offsets[t];
+
+				while (di < ia[t+1] || ai < ib[t+1])
+				{
+					if (ai >= ib[t+1] || (di < ia[t+1] && a[di] < b[ai]))
+					{
+						vct_index_tmp.template get<0>(o) = a[di];
+						vct_data_tmp.get(o) = vct_data.get(di);
+						di++;
+					}
+					else if (di >= ia[t+1] || b[ai] < a[di])
 					{
-						auto dst = vct_data_tmp.get(i);
+						vct_index_tmp.template get<0>(o) = b[ai];
+						vct_data_tmp.get(o) = vct_add_data_unique.get(ai);
+						ai++;
+					}
+					else
+					{
+						vct_index_tmp.template get<0>(o) = b[ai];
+
+						auto dst = vct_data_tmp.get(o);
 						auto src = vct_add_data_unique.get(ai);
 
-						sparse_vector_reduction_solve_conflict_assign_cpu<decltype(vct_data_tmp.get(i)),
-																		  decltype(vct_add_data.get(ai)),
+						sparse_vector_reduction_solve_conflict_assign_cpu<decltype(vct_data_tmp.get(o)),
+																		  decltype(vct_add_data_unique.get(ai)),
 																		  vv_reduce>
 						sva(src,dst);
 
 						boost::mpl::for_each_ref<boost::mpl::range_c<int,0,sizeof...(v_reduce)>>(sva);
-						ai++;
 
-						dst = vct_data_tmp.get(i);
-						src = vct_data.get(di);
+						auto src2 = vct_data.get(di);
 
-						sparse_vector_reduction_solve_conflict_reduce_cpu<decltype(vct_data_tmp.get(i)),
+						sparse_vector_reduction_solve_conflict_reduce_cpu<decltype(vct_data_tmp.get(o)),
 								  	  	  	  	  	  	  	  	  	  	  decltype(vct_data.get(di)),
 								  	  	  	  	  	  	  	  	  	  	  vv_reduce,
 								  	  	  	  	  	  	  	  	  	  	  impl2>
-						svr(src,dst);
+						svr(src2,dst);
 						boost::mpl::for_each_ref<boost::mpl::range_c<int,0,sizeof...(v_reduce)>>(svr);
 
 						di++;
-
-						vct_data_tmp.resize(vct_data_tmp.size()-1);
-						vct_index_tmp.resize(vct_index_tmp.size()-1);
-					}
-					else
-					{
-						vct_index_tmp.template get<0>(i) = vct_add_index_unique.template get<0>(ai);
-						vct_data_tmp.get(i) = vct_add_data_unique.get(ai);
 						ai++;
 					}
-				}
-				else
-				{
-					vct_index_tmp.template get<0>(i) = vct_index.template get<0>(di);
-					vct_data_tmp.get(i) = vct_data.get(di);
-					di++;
+
+					o++;
 				}
 			}
 
 			vct_index.swap(vct_index_tmp);
 			vct_data.swap(vct_data_tmp);
 
+			if (arena != NULL)	{arena->release(vct_data_tmp);}
+		}
+
+		/*! \brief Flush on host
+		 *
+		 * The inserted elements are sorted with a parallel radix sort, the elements with the same
+		 * index are reduced with a segmented reduction and the result is merged into the data
+		 * with a merge path merge. All the phases run on multiple threads
+		 *
+		 */
+		template<typename ... v_reduce>
+		void flush_on_cpu()
+		{
+			merge_cpu_insert_pools();
+
+			if (vct_add_index.size() == 0)
+			{return;}
+
+			sort_add_cpu();
+			find_segments_cpu();
+
+			typedef boost::mpl::vector<v_reduce...> vv_reduce;
+
+			vct_add_data_unique.resize(vct_add_index_unique.size());
+
+			sparse_vector_reduction_cpu<decltype(vct_add_data),
+										decltype(vct_add_index_unique),
+										vv_reduce,
+										impl2>
+			        svr(vct_add_data_unique,
+			        	vct_add_data_cont,
+			        	vct_add_index_unique);
+
+			boost::mpl::for_each_ref<boost::mpl::range_c<int,0,sizeof...(v_reduce)>>(svr);
+
+			merge_cpu<v_reduce ...>();
+
 			vct_add_data.clear();
 			vct_add_index.clear();
 			vct_add_index_unique.clear();
@@ -1582,6 +1915,78 @@ namespace openfpm
 			return vct_data.get(di);
 		}
 
+		/*! \brief Get the sparse indexes of a batch of elements
+		 *
+		 * The keys are processed in groups of VECTOR_SPARSE_BATCH_INTERLEAVE interleaved binary
+		 * searches and the groups are distributed across threads
+		 *
+		 * \param keys vector of the elements to search (property 0)
+		 * \param ids for each key the position in the data buffer (the background if the element does not exist)
+		 *
+		 */
+		template<typename vector_keys_type, typename vector_ids_type>
+		void get_sparse_batch(const vector_keys_type & keys, vector_ids_type & ids) const
+		{
+			size_t n = keys.size();
+			size_t n_grp = n / VECTOR_SPARSE_BATCH_INTERLEAVE;
+
+			ids.resize(n);
+
+			int nth = ofp_n_threads(n,VECTOR_SPARSE_CPU_GRAIN);
+
+			#pragma omp parallel for num_threads(nth) schedule(static)
+			for (size_t g = 0 ; g < n_grp ; g++)
+			{
+				Ti x[VECTOR_SPARSE_BATCH_INTERLEAVE];
+				Ti id[VECTOR_SPARSE_BATCH_INTERLEAVE];
+
+				for (size_t k = 0 ; k < VECTOR_SPARSE_BATCH_INTERLEAVE ; k++)
+				{x[k] = keys.template get<0>(g*VECTOR_SPARSE_BATCH_INTERLEAVE + k);}
+
+				_branchfree_search_interleaved(x,id);
+
+				for (size_t k = 0 ; k < VECTOR_SPARSE_BATCH_INTERLEAVE ; k++)
+				{ids.template get<0>(g*VECTOR_SPARSE_BATCH_INTERLEAVE + k) = id[k];}
+			}
+
+			for (size_t i = n_grp*VECTOR_SPARSE_BATCH_INTERLEAVE ; i < n ; i++)
+			{
+				Ti di;
+				this->_branchfree_search<true>(keys.template get<0>(i),di);
+				ids.template get<0>(i) = di;
+			}
+		}
+
+		/*! \brief Get the property p of a batch of elements
+		 *
+		 * \see get_sparse_batch
+		 *
+		 * \tparam p property to get
+		 *
+		 * \param keys vector of the elements to search (property 0)
+		 * \param out for each key the value of the property p (the background if the element does not exist)
+		 *
+		 */
+		template<unsigned int p, typename vector_keys_type, typename vector_out_type>
+		void get_batch(const vector_keys_type & keys, vector_out_type & out) const
+		{
+			openfpm::vector<aggregate<Ti>> ids;
+			get_sparse_batch(keys,ids);
+
+			out.resize(keys.size());
+
+			typedef typename std::remove_const<typename std::remove_reference<decltype(vct_data.template get<p>(0))>::type>::type src_type;
+			typedef typename std::remove_reference<decltype(out.template get<0>(0))>::type dst_type;
+
+			int nth = ofp_n_threads(keys.size(),VECTOR_SPARSE_CPU_GRAIN);
+
+			#pragma omp parallel for num_threads(nth) schedule(static)
+			for (size_t i = 0 ; i < keys.size() ; i++)
+			{
+				meta_copy_d<src_type,dst_type>::meta_copy_d_(vct_data.template get<p>(ids.template get<0>(i)),out.template get<0>(i));
+			}
+		}
+
 		/*! \brief resize to n elements
 		 *
 		 * \param n elements
@@ -1727,6 +2132,64 @@ namespace openfpm
 			return vct_add_data.get(vct_add_data.size()-1);
 		}
 
+		/*! \brief It insert an element in the insert pool of the host thread tid
+		 *
+		 * Different threads can insert at the same time without locks (setCPUInsertBuffer must be called
+		 * before), the pools are merged in flush
+		 *
+		 * \tparam p property id
+		 *
+		 * \param ele element id
+		 * \param tid thread id (usually ofp_thread_id())
+		 *
+		 */
+		template <unsigned int p>
+		auto insert(Ti ele, int tid) -> decltype(vct_data.template get<p>(0))
+		{
+#ifdef SE_CLASS1
+
+			if (tid < 0 || (size_t)tid >= cpu_pools.size())
+			{
+				std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " insert with thread id " << tid << " but there are " << cpu_pools.size() << " insert pools (setCPUInsertBuffer)" << std::endl;
+				ACTION_ON_ERROR(VECTOR_ERROR_OBJECT);
+			}
+
+#endif
+
+			cpu_insert_pool & pool = cpu_pools[tid];
+
+			pool.index.add();
+			pool.index.template get<0>(pool.index.size()-1) = ele;
+			pool.data.add();
+			return pool.data.template get<p>(pool.data.size()-1);
+		}
+
+		/*! \brief It insert an element in the insert pool of the host thread tid
+		 *
+		 * \param ele element id
+		 * \param tid thread id (usually ofp_thread_id())
+		 *
+		 */
+		auto insert(Ti ele, int tid) -> decltype(vct_data.get(0))
+		{
+#ifdef SE_CLASS1
+
+			if (tid < 0 || (size_t)tid >= cpu_pools.size())
+			{
+				std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " insert with thread id " << tid << " but there are " << cpu_pools.size() << " insert pools (setCPUInsertBuffer)" << std::endl;
+				ACTION_ON_ERROR(VECTOR_ERROR_OBJECT);
+			}
+
+#endif
+
+			cpu_insert_pool & pool = cpu_pools[tid];
+
+			pool.index.add();
+			pool.index.template get<0>(pool.index.size()-1) = ele;
+			pool.data.add();
+			return pool.data.get(pool.data.size()-1);
+		}
+
 		/*! \brief merge the added element to the main data array but save the insert buffer in v
 		 *
 		 * \param v insert buffer
@@ -1740,15 +2203,22 @@ namespace openfpm
 				     flush_type opt = FLUSH_ON_HOST,
 				     int i = 0)
 		{
+			if ((opt & flush_type::FLUSH_ON_DEVICE) && check_cpu_insert_pools_empty("flush_v") == false)
+			{return;}
+
 			// Eliminate background
 			vct_data.resize(vct_index.size());
 
+			borrow_scratch();
+
 			if (opt & flush_type::FLUSH_ON_DEVICE)
 			{this->flush_on_gpu<v_reduce ... >(vct_add_index_cont_0,vct_add_index_cont_1,vct_add_data_reord,gpuContext,i);}
 			else
 			{this->flush_on_cpu<v_reduce ... >();}
 
 			resetBck();
+
+			release_scratch();
 		}
 
 		/*! \brief merge the added element to the main data array but save the insert buffer in vct_add_data_reord
@@ -1763,15 +2233,22 @@ namespace openfpm
 				     gpu::ofp_context_t& gpuContext,
 				     flush_type opt = FLUSH_ON_HOST)
 		{
+			if ((opt & flush_type::FLUSH_ON_DEVICE) && check_cpu_insert_pools_empty("flush_vd") == false)
+			{return;}
+
 			// Eliminate background
 			vct_data.resize(vct_index.size());
 
+			borrow_scratch();
+
 			if (opt & flush_type::FLUSH_ON_DEVICE)
 			{this->flush_on_gpu<v_reduce ... >(vct_add_index_cont_0,vct_add_index_cont_1,vct_add_data_reord,gpuContext);}
 			else
 			{this->flush_on_cpu<v_reduce ... >();}
 
 			resetBck();
+
+			release_scratch();
 		}
 
 		/*! \brief merge the added element to the main data array
@@ -1782,15 +2259,22 @@ namespace openfpm
 		template<typename ... v_reduce>
 		void flush(gpu::ofp_context_t& gpuContext, flush_type opt = FLUSH_ON_HOST)
 		{
+			if ((opt & flush_type::FLUSH_ON_DEVICE) && check_cpu_insert_pools_empty("flush") == false)
+			{return;}
+
 			// Eliminate background
 			vct_data.resize(vct_index.size());
 
+			borrow_scratch();
+
 			if (opt & flush_type::FLUSH_ON_DEVICE)
 			{this->flush_on_gpu<v_reduce ... >(vct_add_index_cont_0,vct_add_index_cont_1,vct_add_data_reord,gpuContext);}
 			else
 			{this->flush_on_cpu<v_reduce ... >();}
 
 			resetBck();
+
+			release_scratch();
 		}
 
 		/*! \brief merge the added element to the main data array
@@ -1800,8 +2284,13 @@ namespace openfpm
 		 */
 		void flush_remove(gpu::ofp_context_t& gpuContext, flush_type opt = FLUSH_ON_HOST)
 		{
+			if ((opt & flush_type::FLUSH_ON_DEVICE) && check_cpu_insert_pools_empty("flush_remove") == false)
+			{return;}
+
 			vct_data.resize(vct_data.size()-1);
 
+			borrow_scratch();
+
 			if (opt & flush_type::FLUSH_ON_DEVICE)
 			{this->flush_on_gpu_remove(gpuContext);}
 			else
@@ -1810,6 +2299,8 @@ namespace openfpm
 			}
 
 			resetBck();
+
+			release_scratch();
 		}
 
 		/*! \brief Return how many element you have in this map
@@ -1821,6 +2312,34 @@ namespace openfpm
 			return vct_index.size();
 		}
 
+		/*! \brief Return the memory allocated and used by the sparse vector
+		 *
+		 * Indexes, data and the pending insertions/removals are used memory, the buffers
+		 * of the flush are only allocated (they are kept to avoid reallocation on the next flush)
+		 *
+		 * \return the memory usage
+		 *
+		 */
+		mem_usage getMemoryUsage() const
+		{
+			mem_usage m = vct_index.getMemoryUsage() + vct_data.getMemoryUsage();
+			m += vct_add_index.getMemoryUsage() + vct_add_data.getMemoryUsage();
+			m += vct_rem_index.getMemoryUsage();
+
+			for (size_t i = 0 ; i < cpu_pools.size() ; i++)
+			{m += cpu_pools[i].index.getMemoryUsage() + cpu_pools[i].data.getMemoryUsage();}
+
+			mem_usage tmp = vct_m_index.getMemoryUsage() + vct_nadd_index.getMemoryUsage() + vct_nrem_index.getMemoryUsage();
+			tmp += vct_add_data_reord.getMemoryUsage() + vct_add_index_cont_0.getMemoryUsage() + vct_add_index_cont_1.getMemoryUsage();
+			tmp += vct_add_data_cont.getMemoryUsage() + vct_add_index_unique.getMemoryUsage() + vct_add_data_unique.getMemoryUsage();
+			tmp += vct_index_tmp4.getMemoryUsage() + vct_index_tmp.getMemoryUsage() + vct_index_tmp2.getMemoryUsage();
+			tmp += vct_index_tmp3.getMemoryUsage() + vct_index_dtmp.getMemoryUsage();
+
+			m.allocated += tmp.allocated + mem.size();
+
+			return m;
+		}
+
 		/*! \brief Return the sorted vector of the indexes
 		 *
 		 * \return return the sorted vector of the indexes
@@ -1888,6 +2407,19 @@ namespace openfpm
 			vct_nadd_index.template fill<0>(0);
 		}
 
+		/*! \brief set the insert pools of the host threads
+		 *
+		 * Every thread insert with insert(ele,tid) in its own pool, the pools grow independently and are
+		 * merged by flush (on host). The memory of the pools is kept between flushes
+		 *
+		 * \param nthr number of threads that insert
+		 *
+		 */
+		void setCPUInsertBuffer(int nthr = ofp_max_threads())
+		{
+			cpu_pools.resize(nthr);
+		}
+
 		/*! \brief In case we manually set the added index buffer and the add data buffer we have to call this
 		 *         function before flush
 		 *
@@ -1956,6 +2488,12 @@ namespace openfpm
 			vct_add_data.clear();
 			vct_add_index_cont_0.clear();
 
+			for (size_t i = 0 ; i < cpu_pools.size() ; i++)
+			{
+				cpu_pools[i].index.clear();
+				cpu_pools[i].data.clear();
+			}
+
 			// re-add background
 			vct_data.resize(vct_data.size()+1);
 			vct_data.get(vct_data.size()-1) = bck;
@@ -2015,6 +2553,31 @@ namespace openfpm
 			return blf.get_outputMap();
 		}
 
+		/*! \brief Borrow the flush temporaries from an arena instead of keeping them between flushes
+		 *
+		 * The same arena can be shared by many sparse vectors and sparse grids, the memory retained between flushes
+		 * is the one of the biggest flush. The temporaries currently held are given to the arena
+		 *
+		 * \param arena arena (NULL to keep the temporaries in the vector), it must live longer than the vector
+		 *
+		 */
+		void setScratchArena(scratch_arena * arena)
+		{
+			this->arena = arena;
+
+			release_scratch();
+		}
+
+		/*! \brief Return the arena used for the flush temporaries
+		 *
+		 * \return the arena (NULL if the temporaries are kept in the vector)
+		 *
+		 */
+		scratch_arena * getScratchArena() const
+		{
+			return arena;
+		}
+
 		/*! \brief Eliminate many internal temporary buffer you can use this between flushes if you get some out of memory
 		 *
 		 *
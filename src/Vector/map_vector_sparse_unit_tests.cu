@@ -2,6 +2,7 @@
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 #include "map_vector_sparse.hpp"
+#include <map>
 
 BOOST_AUTO_TEST_SUITE( sparse_vector_test )
 
@@ -89,4 +90,263 @@ BOOST_AUTO_TEST_CASE ( test_sparse_vector_use )
 	BOOST_REQUIRE_EQUAL(vs.get<0>(1),2050);
 }
 
+BOOST_AUTO_TEST_CASE ( test_sparse_vector_flush_cpu_large )
+{
+	openfpm::vector_sparse<aggregate<size_t,float>> vs;
+
+	vs.template setBackground<0>(0);
+	vs.template setBackground<1>(0.0);
+
+	std::map<long int,size_t> ref_sum;
+	std::map<long int,float> ref_max;
+
+	gpu::ofp_context_t gpuContext;
+
+	// Several flushes with many duplicated indexes, to run the multi-threaded sort, reduction and merge
+
+	for (size_t k = 0 ; k < 4 ; k++)
+	{
+		for (size_t i = 0 ; i < 200000 ; i++)
+		{
+			long int id = rand() % 300000;
+			size_t val = rand() % 100;
+			float val2 = (float)(rand() % 1000);
+
+			vs.template insert<0>(id) = val;
+			vs.template insert<1>(id) = val2;
+
+			auto it = ref_sum.find(id);
+			if (it == ref_sum.end())
+			{
+				ref_sum[id] = val;
+				ref_max[id] = val2;
+			}
+			else
+			{
+				it->second += val;
+				ref_max[id] = std::max(ref_max[id],val2);
+			}
+		}
+
+		vs.template flush<sadd_<0>,smax_<1>>(gpuContext);
+
+		BOOST_REQUIRE_EQUAL(vs.size(),ref_sum.size());
+
+		auto & idx = vs.getIndexBuffer();
+
+		for (size_t i = 1 ; i < idx.size() ; i++)
+		{BOOST_REQUIRE(idx.template get<0>(i-1) < idx.template get<0>(i));}
+
+		for (auto it = ref_sum.begin() ; it != ref_sum.end() ; ++it)
+		{
+			BOOST_REQUIRE_EQUAL(vs.template get<0>(it->first),it->second);
+			BOOST_REQUIRE_EQUAL(vs.template get<1>(it->first),ref_max[it->first]);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE ( test_sparse_vector_get_batch )
+{
+	openfpm::vector_sparse<aggregate<size_t,size_t[3]>> vs;
+
+	vs.template setBackground<0>(17);
+
+	size_t bck[3] = {17,17,17};
+	vs.template setBackground<1>(bck);
+
+	for (size_t i = 0 ; i < 100000 ; i++)
+	{
+		long int id = 3*i + (rand() % 3);
+
+		vs.template insert<0>(id) = id;
+		vs.template insert<1>(id)[0] = id;
+		vs.template insert<1>(id)[1] = id+1;
+		vs.template insert<1>(id)[2] = id+2;
+	}
+
+	gpu::ofp_context_t gpuContext;
+	vs.template flush<sadd_<0>>(gpuContext);
+
+	// query existing and not existing elements, the number of keys is not a multiple of the interleave
+
+	openfpm::vector<aggregate<long int>> keys;
+
+	for (size_t i = 0 ; i < 54321 ; i++)
+	{
+		keys.add();
+		keys.template get<0>(keys.size()-1) = rand() % 310000;
+	}
+
+	openfpm::vector<aggregate<long int>> ids;
+	openfpm::vector<aggregate<size_t>> out;
+	openfpm::vector<aggregate<size_t[3]>> out2;
+
+	vs.get_sparse_batch(keys,ids);
+	vs.template get_batch<0>(keys,out);
+	vs.template get_batch<1>(keys,out2);
+
+	BOOST_REQUIRE_EQUAL(ids.size(),keys.size());
+	BOOST_REQUIRE_EQUAL(out.size(),keys.size());
+
+	for (size_t i = 0 ; i < keys.size() ; i++)
+	{
+		long int k = keys.template get<0>(i);
+
+		BOOST_REQUIRE_EQUAL(ids.template get<0>(i),vs.get_sparse(k).id);
+		BOOST_REQUIRE_EQUAL(out.template get<0>(i),vs.template get<0>(k));
+		BOOST_REQUIRE_EQUAL(out2.template get<0>(i)[0],vs.template get<1>(k)[0]);
+		BOOST_REQUIRE_EQUAL(out2.template get<0>(i)[2],vs.template get<1>(k)[2]);
+	}
+}
+
+BOOST_AUTO_TEST_CASE ( test_sparse_vector_scratch_arena )
+{
+	gpu::ofp_context_t gpuContext;
+
+	//! [Share the flush buffers]
+
+	scratch_arena arena;
+
+	openfpm::vector<openfpm::vector_sparse<aggregate<size_t>>> vss;
+	vss.resize(8);
+
+	openfpm::vector<std::map<long int,size_t>> refs;
+	refs.resize(vss.size());
+
+	for (size_t k = 0 ; k < vss.size() ; k++)
+	{
+		// the temporaries of the flush are borrowed from the arena and given back at the end
+		vss.get(k).setScratchArena(&arena);
+		vss.get(k).template setBackground<0>(0);
+	}
+
+	for (size_t f = 0 ; f < 3 ; f++)
+	{
+		for (size_t k = 0 ; k < vss.size() ; k++)
+		{
+			for (size_t i = 0 ; i < 20000 ; i++)
+			{
+				long int id = rand() % 30000;
+
+				vss.get(k).template insert<0>(id) = i;
+				refs.get(k)[id] += i;
+			}
+
+			vss.get(k).template flush<sadd_<0>>(gpuContext);
+		}
+	}
+
+	//! [Share the flush buffers]
+
+	for (size_t k = 0 ; k < vss.size() ; k++)
+	{
+		BOOST_REQUIRE_EQUAL(vss.get(k).size(),refs.get(k).size());
+		BOOST_REQUIRE(vss.get(k).getScratchArena() == &arena);
+
+		for (auto it = refs.get(k).begin() ; it != refs.get(k).end() ; ++it)
+		{BOOST_REQUIRE_EQUAL(vss.get(k).template get<0>(it->first),it->second);}
+	}
+
+	// all the flushes after the first one reuse the buffers, the arena hold the buffers of one flush
+	size_t n_flush = 3*vss.size();
+	BOOST_REQUIRE(arena.getNReuse() >= 3*(n_flush - 1));
+	BOOST_REQUIRE(arena.size() <= 10ul);
+
+	// the arena retain the temporaries of one flush, not of all the vectors
+
+	openfpm::vector_sparse<aggregate<size_t>> vs_own;
+	vs_own.template setBackground<0>(0);
+	for (size_t i = 0 ; i < 20000 ; i++)
+	{vs_own.template insert<0>(rand() % 30000) = i;}
+	vs_own.template flush<sadd_<0>>(gpuContext);
+
+	size_t own_tmp = vs_own.getMemoryUsage().wasted() - vs_own.private_get_vct_add_data().getMemoryUsage().allocated
+					 - vs_own.private_get_vct_add_index().getMemoryUsage().allocated;
+
+	size_t shared_tmp = 0;
+	for (size_t k = 0 ; k < vss.size() ; k++)
+	{
+		shared_tmp += vss.get(k).getMemoryUsage().wasted() - vss.get(k).private_get_vct_add_data().getMemoryUsage().allocated
+				      - vss.get(k).private_get_vct_add_index().getMemoryUsage().allocated;
+	}
+
+	shared_tmp += arena.getMemoryUsage().allocated;
+
+	BOOST_REQUIRE(shared_tmp < vss.size() * own_tmp);
+
+	// going back to private temporaries
+	vss.get(0).setScratchArena(NULL);
+	vss.get(0).template insert<0>(5) = 1;
+	vss.get(0).template flush<sadd_<0>>(gpuContext);
+	BOOST_REQUIRE_EQUAL(vss.get(0).template get<0>(5),refs.get(0)[5] + 1);
+
+	arena.trim();
+	BOOST_REQUIRE_EQUAL(arena.size(),0ul);
+	BOOST_REQUIRE_EQUAL(arena.getMemoryUsage().allocated,0ul);
+}
+
+BOOST_AUTO_TEST_CASE ( test_sparse_vector_cpu_insert_pools )
+{
+	gpu::ofp_context_t gpuContext;
+
+	openfpm::vector_sparse<aggregate<size_t,float>> vs;
+
+	vs.template setBackground<0>(0);
+	vs.template setBackground<1>(0.0);
+
+	//! [Insert from many threads]
+
+	int nthr = openfpm::ofp_max_threads();
+	vs.setCPUInsertBuffer(nthr);
+
+	const size_t n = 300000;
+
+	for (size_t k = 0 ; k < 2 ; k++)
+	{
+		// every thread insert in its own pool without locks
+		#pragma omp parallel for num_threads(nthr)
+		for (size_t i = 0 ; i < n ; i++)
+		{
+			int tid = openfpm::ofp_thread_id();
+
+			long int id = (i * 7919) % 100000;
+			vs.template insert<0>(id,tid) = 1;
+			vs.template insert<1>(id,tid) = (float)(i % 1000);
+		}
+
+		// the single thread insert buffer can be used together with the pools
+		vs.template insert<0>(100001) = 5;
+		vs.template insert<1>(100001) = 5.0;
+
+		// the pools are merged in flush
+		vs.template flush<sadd_<0>,smax_<1>>(gpuContext);
+	}
+
+	//! [Insert from many threads]
+
+	BOOST_REQUIRE_EQUAL(vs.size(),100001ul);
+
+	auto & idx = vs.getIndexBuffer();
+	for (size_t i = 1 ; i < idx.size() ; i++)
+	{BOOST_REQUIRE(idx.template get<0>(i-1) < idx.template get<0>(i));}
+
+	// every id is inserted 3 times in every flush, max of i % 1000 over i = id + 100000*j (7919 is coprime with 100000)
+
+	std::vector<float> ref_max(100000,0.0);
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		long int id = (i * 7919) % 100000;
+		ref_max[id] = std::max(ref_max[id],(float)(i % 1000));
+	}
+
+	for (long int id = 0 ; id < 100000 ; id++)
+	{
+		BOOST_REQUIRE_EQUAL(vs.template get<0>(id),6ul);
+		BOOST_REQUIRE_EQUAL(vs.template get<1>(id),ref_max[id]);
+	}
+
+	BOOST_REQUIRE_EQUAL(vs.template get<0>(100001),10ul);
+	BOOST_REQUIRE_EQUAL(vs.template get<1>(100001),5.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
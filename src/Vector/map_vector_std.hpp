@@ -135,6 +135,16 @@ public:
 		return base.size();
 	}
 
+	/*! \brief Return the memory allocated and used by the vector (and by its elements)
+	 *
+	 * \return the memory usage
+	 *
+	 */
+	mem_usage getMemoryUsage() const
+	{
+		return ::getMemoryUsage(base);
+	}
+
 
 	/*! \ brief Resize the vector to contain n elements
 	 *
@@ -325,12 +325,11 @@ template<int ... prp> inline void pack(ExtPreAlloc<HeapMemory> & mem, Pack_stat
 	{
 		//Pack the size of a vector
 		Packer<size_t, HeapMemory>::pack(mem,this->size(),sts);
-		
-		for (size_t i = 0 ; i < this->size() ; i++)
-		{
-			//Call a packer in nested way
-			call_aggregatePack<decltype(this->get(i)),HeapMemory,prp ... >::call_pack(this->get(i),mem,sts);
-		}
+
+		//Call a packer in nested way (ranges of elements are packed in parallel)
+		pack_nested_mt(mem,this->size(),sts,
+		               [this](size_t i, size_t & req) {call_aggregatePackRequest<decltype(this->get(i)),HeapMemory,prp ... >::call_packRequest(this->get(i),req);},
+		               [this](size_t i, ExtPreAlloc<HeapMemory> & mem_t, Pack_stat & sts_t) {call_aggregatePack<decltype(this->get(i)),HeapMemory,prp ... >::call_pack(this->get(i),mem_t,sts_t);});
 	}
 }
 
@@ -366,3 +365,248 @@ template<int ... prp, typename MemType> inline void unpack(ExtPreAlloc<MemType>
 	}
 }
 
+
+//! Select how a simple object (no "pack()" inside) is split into segments
+// 0 = memory_traits_lin all properties, 1 = memory_traits_lin subset of properties, 2 = memory_traits_inte
+template<int ... prp>
+struct pack_segments_sel
+{
+	//! selector
+	enum
+	{
+		value = (is_layout_inte<layout_base<T>>::value == true)?2:((sizeof...(prp) == 0)?0:1)
+	};
+};
+
+//! It add one segment for each component of the properties of a memory_traits_inte vector
+template<typename vector_type>
+struct pack_segments_inte_prp
+{
+	//! vector to pack
+	vector_type & obj;
+
+	//! list of segments
+	Pack_iovec & iov;
+
+	//! constructor
+	pack_segments_inte_prp(vector_type & obj, Pack_iovec & iov)
+	:obj(obj),iov(iov)
+	{}
+
+	//! It add the segments of the property
+	template<typename prp_id>
+	inline void operator()(prp_id & t) const
+	{
+		typedef typename boost::mpl::at<typename T::type,boost::mpl::int_<prp_id::value>>::type prp_type;
+		typedef typename std::remove_all_extents<prp_type>::type base_type;
+
+		// array properties are stored component by component, each component is long capacity()
+		const size_t n_comp = sizeof(prp_type) / sizeof(base_type);
+		const unsigned char * ptr = (const unsigned char *)obj.template getPointer<prp_id::value>();
+
+		for (size_t c = 0 ; c < n_comp ; c++)
+		{iov.add(ptr + c*obj.capacity()*sizeof(base_type),obj.size()*sizeof(base_type));}
+	}
+};
+
+//! It read from the segments each component of the properties of a memory_traits_inte vector
+template<typename vector_type>
+struct unpack_segments_inte_prp
+{
+	//! vector where to unpack
+	vector_type & obj;
+
+	//! list of segments
+	const Pack_iovec & iov;
+
+	//! unpack-stat info
+	Unpack_stat & ps;
+
+	//! constructor
+	unpack_segments_inte_prp(vector_type & obj, const Pack_iovec & iov, Unpack_stat & ps)
+	:obj(obj),iov(iov),ps(ps)
+	{}
+
+	//! It read the segments of the property
+	template<typename prp_id>
+	inline void operator()(prp_id & t) const
+	{
+		typedef typename boost::mpl::at<typename T::type,boost::mpl::int_<prp_id::value>>::type prp_type;
+		typedef typename std::remove_all_extents<prp_type>::type base_type;
+
+		const size_t n_comp = sizeof(prp_type) / sizeof(base_type);
+		unsigned char * ptr = (unsigned char *)obj.template getPointer<prp_id::value>();
+
+		for (size_t c = 0 ; c < n_comp ; c++)
+		{
+			iov.read(ps.getOffset(),ptr + c*obj.capacity()*sizeof(base_type),obj.size()*sizeof(base_type));
+			ps.addOffset(obj.size()*sizeof(base_type));
+		}
+	}
+};
+
+//! These structures produce the segments of a simple (no "pack()" inside) object
+// memory_traits_lin with specified properties, the selected properties are not contiguous
+// in memory, so they are copied into a staged segment with the same format of pack()
+template<unsigned int sel, int ... prp>
+struct pack_segments_cond
+{
+	//! produce the segments of the vector
+	static inline void packSegments(const openfpm::vector<T,Memory,layout_base,grow_p,OPENFPM_NATIVE> & obj, Pack_iovec & iov)
+	{
+		typedef openfpm::vector<T,Memory,layout_base,grow_p> vctr;
+		typedef object<typename object_creator<typename vctr::value_type::type,prp...>::type> prp_object;
+		typedef openfpm::vector<prp_object,PtrMemory,memory_traits_lin,openfpm::grow_policy_identity> dtype;
+
+		size_t size = obj.template packMem<prp...>(obj.size(),0);
+
+		// Create a vector over the staged memory (No allocation is produced)
+		PtrMemory & ptr = *(new PtrMemory(iov.stage(size),size));
+
+		dtype dest;
+		dest.setMemory(ptr);
+		dest.resize(obj.size());
+
+		for (size_t i = 0 ; i < obj.size() ; i++)
+		{
+			typedef encapc<1,typename vctr::value_type,typename vctr::layout_type > encap_src;
+			typedef encapc<1,prp_object,typename dtype::layout_type > encap_dst;
+
+			// Copy only the selected properties
+			object_si_d<encap_src,encap_dst,OBJ_ENCAP,prp...>(obj.get(i),dest.get(i));
+		}
+	}
+
+	//! read the vector from the segments
+	static inline void unpackSegments(openfpm::vector<T,Memory,layout_base,grow_p,OPENFPM_NATIVE> & obj, const Pack_iovec & iov, Unpack_stat & ps)
+	{
+		typedef openfpm::vector<T,Memory,layout_base,grow_p> vctr;
+		typedef object<typename object_creator<typename vctr::value_type::type,prp...>::type> prp_object;
+		typedef openfpm::vector<prp_object,PtrMemory,memory_traits_lin,openfpm::grow_policy_identity> stype;
+
+		size_t size = obj.template packMem<prp...>(obj.size(),0);
+
+		// read in place if the data are in one segment, otherwise gather them
+		std::vector<unsigned char> tmp;
+		void * src_ptr = const_cast<void *>(iov.contiguous(ps.getOffset(),size));
+
+		if (src_ptr == nullptr && size != 0)
+		{
+			tmp.resize(size);
+			iov.read(ps.getOffset(),tmp.data(),size);
+			src_ptr = tmp.data();
+		}
+
+		PtrMemory & ptr = *(new PtrMemory(src_ptr,size));
+
+		stype src;
+		src.setMemory(ptr);
+		src.resize(obj.size());
+
+		for (size_t i = 0 ; i < obj.size() ; i++)
+		{
+			typedef encapc<1,typename vctr::value_type,typename vctr::layout_type > encap_dst;
+			typedef encapc<1,prp_object,typename stype::layout_type > encap_src;
+
+			// Copy only the selected properties
+			object_s_di<encap_src,encap_dst,OBJ_ENCAP,prp...>(src.get(i),obj.get(i));
+		}
+
+		ps.addOffset(size);
+	}
+};
+
+//! These structures produce the segments of a simple (no "pack()" inside) object
+// memory_traits_lin without specified properties, the full vector is one segment
+template<int ... prp>
+struct pack_segments_cond<0,prp...>
+{
+	//! produce the segments of the vector
+	static inline void packSegments(const openfpm::vector<T,Memory,layout_base,grow_p,OPENFPM_NATIVE> & obj, Pack_iovec & iov)
+	{
+		iov.add(obj.getPointer(),obj.size()*sizeof(typename T::type));
+	}
+
+	//! read the vector from the segments
+	static inline void unpackSegments(openfpm::vector<T,Memory,layout_base,grow_p,OPENFPM_NATIVE> & obj, const Pack_iovec & iov, Unpack_stat & ps)
+	{
+		iov.read(ps.getOffset(),obj.getPointer(),obj.size()*sizeof(typename T::type));
+		ps.addOffset(obj.size()*sizeof(typename T::type));
+	}
+};
+
+//! These structures produce the segments of a simple (no "pack()" inside) object
+// memory_traits_inte, every component of every property is one segment
+template<int ... prp>
+struct pack_segments_cond<2,prp...>
+{
+	//! list of the properties to pack
+	typedef typename boost::mpl::if_c<sizeof...(prp) == 0,
+	                                  boost::mpl::range_c<int,0,T::max_prop>,
+	                                  boost::mpl::vector_c<int,prp...>>::type prp_list;
+
+	//! produce the segments of the vector
+	static inline void packSegments(const openfpm::vector<T,Memory,layout_base,grow_p,OPENFPM_NATIVE> & obj, Pack_iovec & iov)
+	{
+		typedef openfpm::vector<T,Memory,layout_base,grow_p,OPENFPM_NATIVE> vctr;
+
+		pack_segments_inte_prp<vctr> ps_prp(const_cast<vctr &>(obj),iov);
+		boost::mpl::for_each_ref<prp_list>(ps_prp);
+	}
+
+	//! read the vector from the segments
+	static inline void unpackSegments(openfpm::vector<T,Memory,layout_base,grow_p,OPENFPM_NATIVE> & obj, const Pack_iovec & iov, Unpack_stat & ps)
+	{
+		typedef openfpm::vector<T,Memory,layout_base,grow_p,OPENFPM_NATIVE> vctr;
+
+		unpack_segments_inte_prp<vctr> us_prp(obj,iov,ps);
+		boost::mpl::for_each_ref<prp_list>(us_prp);
+	}
+};
+
+/*! \brief pack a vector as a list of segments (zero-copy)
+ *
+ * Contiguous data are not copied, the segments refer directly to the memory of the vector. With
+ * memory_traits_lin and all the properties the format is the same of pack(), with memory_traits_inte
+ * the selected properties are packed one after the other. With memory_traits_lin and a subset of the
+ * properties the data are copied into a segment owned by iov.
+ * The vector must not be modified until the segments are consumed
+ *
+ * \param iov list of segments
+ * \param sts pack-stat info
+ *
+ */
+template<int ... prp> inline void packSegments(Pack_iovec & iov, Pack_stat & sts) const
+{
+	static_assert(has_pack_agg<T,prp...>::result::value == false,"packSegments is supported only for objects without a pack() member");
+
+	//Pack the size of a vector
+	Packer<size_t, HeapMemory>::packSegments(iov,this->size(),sts);
+
+	pack_segments_cond<pack_segments_sel<prp...>::value,prp...>::packSegments(*this,iov);
+
+	// Update statistic
+	sts.incReq();
+}
+
+/*! \brief unpack a vector from a list of segments
+ *
+ * The data are copied directly from the segments into the vector
+ *
+ * \param iov list of segments
+ * \param ps unpack-stat info
+ *
+ */
+template<unsigned int ... prp> inline void unpackSegments(const Pack_iovec & iov, Unpack_stat & ps)
+{
+	static_assert(has_pack_agg<T,prp...>::result::value == false,"unpackSegments is supported only for objects without a pack() member");
+
+	//Unpack a size of a source vector
+	size_t u2 = 0;
+	Unpacker<size_t, HeapMemory>::unpackSegments(iov,u2,ps);
+
+	//Resize a destination vector
+	this->resize(u2);
+
+	pack_segments_cond<pack_segments_sel<prp...>::value,prp...>::unpackSegments(*this,iov,ps);
+}
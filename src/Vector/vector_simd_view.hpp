@@ -0,0 +1,308 @@
+/*
+ * vector_simd_view.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef VECTOR_SIMD_VIEW_HPP_
+#define VECTOR_SIMD_VIEW_HPP_
+
+#include <Vc/Vc>
+#include <type_traits>
+#include "Vector/map_vector.hpp"
+
+/*! \brief SIMD access to an array of n scalars (a property, or a component of a property, of a vector with
+ *         interleaved layout)
+ *
+ * load and store work on Vc::Vector<T>::Size consecutive elements starting from i. The loads are aligned when
+ * the array and i are aligned, the tail (i + Size > n) is read with the missing lanes set to a fill value and
+ * written only on the existing lanes
+ *
+ * \tparam T scalar type
+ *
+ */
+template<typename T>
+class vector_simd_lane
+{
+	//! array
+	T * ptr;
+
+	//! number of elements
+	size_t n;
+
+	//! the array is aligned for Vc::Vector<T>
+	bool aligned;
+
+public:
+
+	//! SIMD type
+	typedef Vc::Vector<T> simd_type;
+
+	//! number of lanes of the SIMD type
+	static const size_t vsize = Vc::Vector<T>::Size;
+
+	//! Empty lane array
+	vector_simd_lane()
+	:ptr(NULL),n(0),aligned(true)
+	{}
+
+	/*! \brief Constructor
+	 *
+	 * \param ptr array
+	 * \param n number of elements
+	 *
+	 */
+	vector_simd_lane(T * ptr, size_t n)
+	:ptr(ptr),n(n),aligned(((size_t)ptr % alignof(Vc::Vector<T>)) == 0)
+	{}
+
+	/*! \brief Number of elements
+	 *
+	 * \return the number of elements
+	 *
+	 */
+	inline size_t size() const
+	{
+		return n;
+	}
+
+	/*! \brief Mask of the lanes [i,i+vsize) that are inside the array
+	 *
+	 * \param i first element (all the lanes are off if i >= size())
+	 *
+	 * \return the mask
+	 *
+	 */
+	inline typename Vc::Vector<T>::MaskType mask(size_t i) const
+	{
+		return Vc::Vector<T>::IndexesFromZero() < Vc::Vector<T>((T)((i >= n)?0:n - i));
+	}
+
+	/*! \brief Load the elements [i,i+vsize)
+	 *
+	 * \param i first element
+	 * \param fill value of the lanes outside the array
+	 *
+	 * \return the SIMD vector
+	 *
+	 */
+	inline Vc::Vector<T> load(size_t i, T fill = 0) const
+	{
+		if (i + vsize <= n)
+		{
+			if (aligned == true && i % vsize == 0)
+			{return Vc::Vector<T>(ptr + i,Vc::Aligned);}
+
+			return Vc::Vector<T>(ptr + i,Vc::Unaligned);
+		}
+
+		T tmp[vsize];
+		for (size_t l = 0 ; l < vsize ; l++)
+		{tmp[l] = (i + l < n)?ptr[i + l]:fill;}
+
+		return Vc::Vector<T>(tmp,Vc::Unaligned);
+	}
+
+	/*! \brief Store the elements [i,i+vsize) (only the ones inside the array)
+	 *
+	 * \param i first element
+	 * \param x values
+	 *
+	 */
+	inline void store(size_t i, const Vc::Vector<T> & x)
+	{
+		if (i + vsize <= n)
+		{
+			if (aligned == true && i % vsize == 0)
+			{x.store(ptr + i,Vc::Aligned);}
+			else
+			{x.store(ptr + i,Vc::Unaligned);}
+
+			return;
+		}
+
+		for (size_t l = 0 ; i + l < n ; l++)
+		{ptr[i + l] = x[l];}
+	}
+
+	/*! \brief Load the elements ids[0] ... ids[k-1] (for example the neighborhood of a particle)
+	 *
+	 * \param ids ids of the elements
+	 * \param k number of elements (at most vsize)
+	 * \param fill value of the lanes [k,vsize)
+	 *
+	 * \return the SIMD vector
+	 *
+	 */
+	template<typename id_type>
+	inline Vc::Vector<T> gather(const id_type * ids, size_t k, T fill = 0) const
+	{
+		T tmp[vsize];
+		for (size_t l = 0 ; l < vsize ; l++)
+		{tmp[l] = (l < k)?ptr[ids[l]]:fill;}
+
+		return Vc::Vector<T>(tmp,Vc::Unaligned);
+	}
+
+	/*! \brief Return the array
+	 *
+	 * \return the pointer to the first element
+	 *
+	 */
+	inline T * getPointer()
+	{
+		return ptr;
+	}
+};
+
+/*! \brief Pointer to the component c of the property of the first element (scalar property)
+ *
+ */
+template<unsigned int rank>
+struct vector_simd_component
+{
+	template<unsigned int p, typename vector_type>
+	static inline auto get(vector_type & v, size_t c) -> decltype(&v.template get<p>(0))
+	{
+		return &v.template get<p>(0);
+	}
+};
+
+/*! \brief Pointer to the component c of the property of the first element (array property, or Point)
+ *
+ */
+template<>
+struct vector_simd_component<1>
+{
+	template<unsigned int p, typename vector_type>
+	static inline auto get(vector_type & v, size_t c) -> decltype(&v.template get<p>(0)[c])
+	{
+		return &v.template get<p>(0)[c];
+	}
+};
+
+/*! \brief SIMD view of an openfpm::vector with interleaved layout (one array for each property)
+ *
+ * A scalar property is one lane array, a property T[n] (or a Point<dim,T> stored in the vector) are n lane
+ * arrays, one for each component. Loops over the elements, or over the neighborhood of an element with gather,
+ * can be written with Vc vectors without pointer arithmetic
+ *
+ * ### SIMD loop over a vector
+ * \snippet vector_unit_tests.hpp SIMD view
+ *
+ * \tparam vector_type openfpm::vector<T,Memory,memory_traits_inte,...>
+ *
+ */
+template<typename vector_type>
+class vector_simd_view
+{
+	//! type of the element
+	typedef typename vector_type::value_type T_ele;
+
+	//! vector
+	vector_type & v;
+
+public:
+
+	/*! \brief Scalar type of the property p
+	 *
+	 */
+	template<unsigned int p>
+	using prop_scalar = typename std::remove_all_extents<typename boost::mpl::at<typename T_ele::type,boost::mpl::int_<p>>::type>::type;
+
+	/*! \brief SIMD type of the property p
+	 *
+	 */
+	template<unsigned int p>
+	using simd_type = Vc::Vector<prop_scalar<p>>;
+
+	/*! \brief Constructor
+	 *
+	 * \param v vector (its size must not change while the view is used)
+	 *
+	 */
+	vector_simd_view(vector_type & v)
+	:v(v)
+	{}
+
+	/*! \brief Number of elements
+	 *
+	 * \return the number of elements
+	 *
+	 */
+	inline size_t size() const
+	{
+		return v.size();
+	}
+
+	/*! \brief Return the lane array of the component c of the property p
+	 *
+	 * Get the lanes outside the loops, they cache the pointer to the data
+	 *
+	 * \tparam p property
+	 *
+	 * \param c component (0 for scalar properties)
+	 *
+	 * \return the lane array
+	 *
+	 */
+	template<unsigned int p>
+	inline vector_simd_lane<prop_scalar<p>> lane(size_t c = 0)
+	{
+		typedef typename boost::mpl::at<typename T_ele::type,boost::mpl::int_<p>>::type prop;
+
+		static_assert(std::rank<prop>::value <= 1,"SIMD view supports scalar and one dimensional array properties");
+
+		if (v.size() == 0)
+		{return vector_simd_lane<prop_scalar<p>>(NULL,0);}
+
+		return vector_simd_lane<prop_scalar<p>>(vector_simd_component<std::rank<prop>::value>::template get<p>(v,c),v.size());
+	}
+
+	/*! \brief Load the component c of the property p of the elements [i,i+Size)
+	 *
+	 * \tparam p property
+	 *
+	 * \param i first element
+	 * \param c component
+	 *
+	 * \return the SIMD vector (0 on the lanes outside the vector)
+	 *
+	 */
+	template<unsigned int p>
+	inline simd_type<p> load(size_t i, size_t c = 0)
+	{
+		return lane<p>(c).load(i);
+	}
+
+	/*! \brief Store the component c of the property p of the elements [i,i+Size)
+	 *
+	 * \tparam p property
+	 *
+	 * \param i first element
+	 * \param x values
+	 * \param c component
+	 *
+	 */
+	template<unsigned int p>
+	inline void store(size_t i, const simd_type<p> & x, size_t c = 0)
+	{
+		lane<p>(c).store(i,x);
+	}
+};
+
+/*! \brief Create a SIMD view of a vector with interleaved layout
+ *
+ * \param v vector
+ *
+ * \return the SIMD view
+ *
+ */
+template<typename T, typename Memory, typename grow_p, unsigned int impl>
+vector_simd_view<openfpm::vector<T,Memory,memory_traits_inte,grow_p,impl>> simd_view(openfpm::vector<T,Memory,memory_traits_inte,grow_p,impl> & v)
+{
+	return vector_simd_view<openfpm::vector<T,Memory,memory_traits_inte,grow_p,impl>>(v);
+}
+
+#endif /* VECTOR_SIMD_VIEW_HPP_ */
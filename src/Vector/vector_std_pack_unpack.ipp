@@ -29,10 +29,10 @@
 			//Pack the size of a vector
 			Packer<size_t, Memory1>::pack(mem,obj.size(),sts);
 
-			//Call a packer in nested way
-			for (size_t i = 0; i < obj.size(); i++) {
-				obj.get(i).template pack<prp...>(mem,sts);
-			}
+			//Call a packer in nested way (ranges of objects are packed in parallel)
+			pack_nested_mt(mem,obj.size(),sts,
+			               [&obj](size_t i, size_t & req) {obj.get(i).template packRequest<prp...>(req);},
+			               [&obj](size_t i, ExtPreAlloc<Memory1> & mem_t, Pack_stat & sts_t) {obj.get(i).template pack<prp...>(mem_t,sts_t);});
 		}
 	};
 
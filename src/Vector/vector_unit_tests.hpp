@@ -9,6 +9,7 @@
 #include "Space/Shape/Point.hpp"
 #include "util/object_util.hpp"
 #include "vector_test_util.hpp"
+#include "vector_simd_view.hpp"
 
 BOOST_AUTO_TEST_SUITE( vector_test )
 
@@ -745,6 +746,88 @@ BOOST_AUTO_TEST_CASE( vector_std_utility )
 
 }
 
+template<typename vector_type>
+void test_vector_sort_by_prop()
+{
+	vector_type v;
+	vector_type v_old;
+
+	for (size_t i = 0 ; i < 100000 ; i++)
+	{
+		v.add();
+		v.template get<0>(i) = (rand() % 20000) - 10000;
+		v.template get<1>(i) = 100.0f * (float)rand() / (float)RAND_MAX - 50.0f;
+		v.template get<2>(i) = i;
+	}
+
+	v_old = v;
+
+	openfpm::vector<aggregate<size_t>> perm;
+	v.template sort_by_prop<0>(perm);
+
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{
+		size_t j = perm.template get<0>(i);
+
+		BOOST_REQUIRE_EQUAL(v.template get<0>(i),v_old.template get<0>(j));
+		BOOST_REQUIRE_EQUAL(v.template get<1>(i),v_old.template get<1>(j));
+		BOOST_REQUIRE_EQUAL(v.template get<2>(i),v_old.template get<2>(j));
+
+		if (i != 0)
+		{
+			BOOST_REQUIRE(v.template get<0>(i-1) <= v.template get<0>(i));
+
+			// the sort must be stable
+			if (v.template get<0>(i-1) == v.template get<0>(i))
+			{BOOST_REQUIRE(v.template get<2>(i-1) < v.template get<2>(i));}
+		}
+	}
+
+	// Sort by the float key reordering only the properties 1 and 2
+
+	v_old = v;
+	v.template sort_by_prop<1,1,2>(perm);
+
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{
+		size_t j = perm.template get<0>(i);
+
+		BOOST_REQUIRE_EQUAL(v.template get<0>(i),v_old.template get<0>(i));
+		BOOST_REQUIRE_EQUAL(v.template get<1>(i),v_old.template get<1>(j));
+		BOOST_REQUIRE_EQUAL(v.template get<2>(i),v_old.template get<2>(j));
+
+		if (i != 0)
+		{BOOST_REQUIRE(v.template get<1>(i-1) <= v.template get<1>(i));}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( vector_sort_by_prop )
+{
+	test_vector_sort_by_prop<openfpm::vector<aggregate<int,float,size_t>>>();
+	test_vector_sort_by_prop<openfpm::vector_soa<aggregate<int,float,size_t>>>();
+
+	// bool keys
+
+	openfpm::vector<aggregate<bool,size_t>> vb;
+	vb.resize(100000);
+
+	for (size_t i = 0 ; i < vb.size() ; i++)
+	{
+		vb.template get<0>(i) = (i*7919 % 3) == 0;
+		vb.template get<1>(i) = i;
+	}
+
+	vb.template sort_by_prop<0>();
+
+	for (size_t i = 1 ; i < vb.size() ; i++)
+	{
+		BOOST_REQUIRE(vb.template get<0>(i-1) <= vb.template get<0>(i));
+
+		if (vb.template get<0>(i-1) == vb.template get<0>(i))
+		{BOOST_REQUIRE(vb.template get<1>(i-1) < vb.template get<1>(i));}
+	}
+}
+
 BOOST_AUTO_TEST_CASE ( vector_prealloc_ext )
 {
 	// Memory for the ghost sending buffer
@@ -912,6 +995,379 @@ BOOST_AUTO_TEST_CASE( vector_cuda_to_kernel_recursive )
 	BOOST_REQUIRE_EQUAL(test,true);
 }
 
+BOOST_AUTO_TEST_CASE( vector_simd_view_test )
+{
+	//! [SIMD view]
+
+	// 103 is not a multiple of the SIMD size, the last load/store are masked
+	openfpm::vector_soa<aggregate<float,float[3]>> v;
+	v.resize(103);
+
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{
+		v.template get<0>(i) = 0.0;
+		v.template get<1>(i)[0] = i;
+		v.template get<1>(i)[1] = 2.0*i;
+		v.template get<1>(i)[2] = 3.0*i;
+	}
+
+	auto vw = simd_view(v);
+
+	// every component of the array property is a lane array
+	auto x = vw.template lane<1>(0);
+	auto y = vw.template lane<1>(1);
+	auto z = vw.template lane<1>(2);
+	auto r2 = vw.template lane<0>();
+
+	typedef Vc::Vector<float> vf;
+
+	for (size_t i = 0 ; i < vw.size() ; i += vf::Size)
+	{
+		vf xv = x.load(i);
+		vf yv = y.load(i);
+		vf zv = z.load(i);
+
+		r2.store(i,xv*xv + yv*yv + zv*zv);
+	}
+
+	//! [SIMD view]
+
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{BOOST_REQUIRE_CLOSE(v.template get<0>(i),14.0f*i*i,0.001);}
+
+	// the tail is filled with zero, and the mask select the existing elements
+	size_t last = (v.size() / vf::Size) * vf::Size;
+	vf t = vw.template load<1>(last,2);
+	auto m = x.mask(last);
+
+	BOOST_REQUIRE_EQUAL((size_t)m.count(),v.size() - last);
+
+	// past the end all the lanes are off
+	BOOST_REQUIRE_EQUAL((size_t)x.mask(v.size() + 1).count(),0ul);
+	for (size_t l = 0 ; l < vf::Size ; l++)
+	{
+		if (last + l < v.size())
+		{BOOST_REQUIRE_EQUAL(t[l],3.0f*(last + l));}
+		else
+		{BOOST_REQUIRE_EQUAL(t[l],0.0f);}
+	}
+
+	// store on the view is the same as get
+	vw.template store<1>(4,vf(-1.0f),1);
+	for (size_t l = 0 ; l < vf::Size ; l++)
+	{BOOST_REQUIRE_EQUAL(v.template get<1>(4+l)[1],-1.0f);}
+	BOOST_REQUIRE_EQUAL(v.template get<1>(4+vf::Size)[1],2.0f*(4+vf::Size));
+
+	// gather the neighborhood
+	size_t ids[3] = {7,50,100};
+	vf g = x.gather(ids,3,-5.0f);
+	BOOST_REQUIRE_EQUAL(g[0],7.0f);
+	BOOST_REQUIRE_EQUAL(g[1],50.0f);
+	BOOST_REQUIRE_EQUAL(g[2],100.0f);
+	for (size_t l = 3 ; l < vf::Size ; l++)
+	{BOOST_REQUIRE_EQUAL(g[l],-5.0f);}
+
+	// positions as a vector of points, the coordinates are the lanes
+	openfpm::vector<Point<3,double>,HeapMemory,memory_traits_inte> pos;
+	pos.resize(10);
+	for (size_t i = 0 ; i < pos.size() ; i++)
+	{
+		pos.template get<0>(i)[0] = i;
+		pos.template get<0>(i)[1] = -(double)i;
+		pos.template get<0>(i)[2] = 0.5;
+	}
+
+	auto pw = simd_view(pos);
+	typedef Vc::Vector<double> vd;
+
+	for (size_t i = 0 ; i < pw.size() ; i += vd::Size)
+	{pw.template store<0>(i,pw.template load<0>(i,0) + pw.template load<0>(i,1),2);}
+
+	for (size_t i = 0 ; i < pos.size() ; i++)
+	{BOOST_REQUIRE_EQUAL(pos.template get<0>(i)[2],0.0);}
+
+	// empty vector
+	openfpm::vector_soa<aggregate<float>> ve;
+	BOOST_REQUIRE_EQUAL(simd_view(ve).template lane<0>().size(),0ul);
+}
+
+BOOST_AUTO_TEST_CASE( vector_layout_convert_test )
+{
+	//! [Layout conversion]
+
+	typedef aggregate<float,double[3],int[2][2]> part;
+
+	// more than one block of conversion
+	openfpm::vector<part> v_aos;
+	v_aos.resize(3000);
+
+	for (size_t i = 0 ; i < v_aos.size() ; i++)
+	{
+		v_aos.template get<0>(i) = i;
+		for (size_t j = 0 ; j < 3 ; j++)
+		{v_aos.template get<1>(i)[j] = 10.0*i + j;}
+		for (size_t j = 0 ; j < 4 ; j++)
+		{v_aos.template get<2>(i)[j/2][j%2] = 100*i + j;}
+	}
+
+	// AoS -> SoA, the properties are copied by blocks
+	openfpm::vector_soa<part> v_soa;
+	v_soa = v_aos;
+
+	// and back
+	openfpm::vector<part> v_aos2;
+	v_aos2 = v_soa;
+
+	// grids
+	size_t sz[3] = {16,8,5};
+	grid_cpu<3,part> g_aos(sz);
+	g_aos.setMemory();
+	grid_base<3,part,HeapMemory,memory_traits_inte<part>::type> g_soa(sz);
+	g_soa.setMemory();
+
+	auto it = g_aos.getIterator();
+	while (it.isNext())
+	{
+		auto key = it.get();
+		g_aos.template get<0>(key) = g_aos.getGrid().LinId(key);
+		++it;
+	}
+
+	layout_convert(g_soa,g_aos);
+
+	//! [Layout conversion]
+
+	bool is_block = layout_convert_ok<part,part>::value;
+	BOOST_REQUIRE_EQUAL(is_block,true);
+	is_block = layout_convert_ok<aggregate<float,openfpm::vector<float>>,aggregate<float,openfpm::vector<float>>>::value;
+	BOOST_REQUIRE_EQUAL(is_block,false);
+
+	for (size_t i = 0 ; i < v_aos.size() ; i++)
+	{
+		BOOST_REQUIRE_EQUAL(v_soa.template get<0>(i),v_aos.template get<0>(i));
+		BOOST_REQUIRE_EQUAL(v_aos2.template get<0>(i),v_aos.template get<0>(i));
+		for (size_t j = 0 ; j < 3 ; j++)
+		{
+			BOOST_REQUIRE_EQUAL(v_soa.template get<1>(i)[j],v_aos.template get<1>(i)[j]);
+			BOOST_REQUIRE_EQUAL(v_aos2.template get<1>(i)[j],v_aos.template get<1>(i)[j]);
+		}
+		for (size_t j = 0 ; j < 4 ; j++)
+		{
+			BOOST_REQUIRE_EQUAL(v_soa.template get<2>(i)[j/2][j%2],v_aos.template get<2>(i)[j/2][j%2]);
+			BOOST_REQUIRE_EQUAL(v_aos2.template get<2>(i)[j/2][j%2],v_aos.template get<2>(i)[j/2][j%2]);
+		}
+	}
+
+	auto it2 = g_soa.getIterator();
+	while (it2.isNext())
+	{
+		auto key = it2.get();
+		BOOST_REQUIRE_EQUAL(g_soa.template get<0>(key),g_soa.getGrid().LinId(key));
+		++it2;
+	}
+
+	// add_prp from a different layout with a property map, and merge
+
+	openfpm::vector_soa<aggregate<double[3],float>> v_src;
+	v_src.resize(2000);
+	for (size_t i = 0 ; i < v_src.size() ; i++)
+	{
+		v_src.template get<0>(i)[0] = i;
+		v_src.template get<0>(i)[1] = 2.0*i;
+		v_src.template get<0>(i)[2] = 3.0*i;
+		v_src.template get<1>(i) = -(float)i;
+	}
+
+	v_aos.template add_prp<aggregate<double[3],float>,HeapMemory,openfpm::grow_policy_double,OPENFPM_NATIVE,memory_traits_inte,1,0>(v_src);
+
+	BOOST_REQUIRE_EQUAL(v_aos.size(),5000ul);
+	for (size_t i = 0 ; i < v_src.size() ; i++)
+	{
+		BOOST_REQUIRE_EQUAL(v_aos.template get<0>(3000+i),-(float)i);
+		BOOST_REQUIRE_EQUAL(v_aos.template get<1>(3000+i)[2],3.0*i);
+	}
+
+	v_aos.template merge_prp_v<add_,aggregate<double[3],float>,HeapMemory,openfpm::grow_policy_double,memory_traits_inte,1,0>(v_src,1000);
+
+	for (size_t i = 0 ; i < v_src.size() ; i++)
+	{
+		size_t k = 1000 + i;
+		float old = (k < 3000)?(float)k:-(float)(k - 3000);
+		BOOST_REQUIRE_EQUAL(v_aos.template get<0>(k),old - (float)i);
+	}
+
+	// add_prp called by every thread of a parallel region does not start nested teams, inside a parallel
+	// region ofp_n_threads return 1 and the conversion run on the calling thread
+
+	const size_t n_big = 2*LAYOUT_CONVERT_GRAIN;
+	v_src.resize(n_big);
+	for (size_t i = 0 ; i < v_src.size() ; i++)
+	{
+		for (size_t j = 0 ; j < 3 ; j++)
+		{v_src.template get<0>(i)[j] = (j+1.0)*i;}
+		v_src.template get<1>(i) = -(float)i;
+	}
+
+	const int nth = openfpm::ofp_max_threads();
+	std::vector<size_t> err(nth);
+
+	#pragma omp parallel num_threads(nth)
+	{
+		openfpm::vector<part> v_th;
+		v_th.template add_prp<aggregate<double[3],float>,HeapMemory,openfpm::grow_policy_double,OPENFPM_NATIVE,memory_traits_inte,1,0>(v_src);
+
+		size_t e = (v_th.size() != n_big);
+		if (nth > 1 && openfpm::ofp_n_threads(n_big,LAYOUT_CONVERT_GRAIN) != 1)	{e++;}
+
+		for (size_t i = 0 ; i < v_th.size() ; i++)
+		{e += (v_th.template get<0>(i) != -(float)i) + (v_th.template get<1>(i)[1] != 2.0*i);}
+
+		err[openfpm::ofp_thread_id()] = e;
+	}
+
+	for (int t = 0 ; t < nth ; t++)
+	{BOOST_REQUIRE_EQUAL(err[t],0ul);}
+}
+
+BOOST_AUTO_TEST_CASE( vector_layout_transpose_test )
+{
+	// float[3] + float are 4 consecutive words, AoS <-> SoA is a 4x4 transposition (the size is not a multiple of 4)
+	typedef aggregate<float[3],float> part4;
+
+	openfpm::vector<part4> v_aos;
+	v_aos.resize(1001);
+
+	for (size_t i = 0 ; i < v_aos.size() ; i++)
+	{
+		for (size_t j = 0 ; j < 3 ; j++)
+		{v_aos.template get<0>(i)[j] = 10.0*i + j;}
+		v_aos.template get<1>(i) = -(float)i;
+	}
+
+	openfpm::vector_soa<part4> v_soa;
+	v_soa = v_aos;
+
+	openfpm::vector<part4> v_aos2;
+	v_aos2 = v_soa;
+
+	for (size_t i = 0 ; i < v_aos.size() ; i++)
+	{
+		for (size_t j = 0 ; j < 3 ; j++)
+		{
+			BOOST_REQUIRE_EQUAL(v_soa.template get<0>(i)[j],10.0f*i + j);
+			BOOST_REQUIRE_EQUAL(v_aos2.template get<0>(i)[j],10.0f*i + j);
+		}
+		BOOST_REQUIRE_EQUAL(v_soa.template get<1>(i),-(float)i);
+		BOOST_REQUIRE_EQUAL(v_aos2.template get<1>(i),-(float)i);
+	}
+
+	// In place, the memory of the AoS vector become the SoA image and back
+
+	float * buf = &v_aos.template get<0>(0)[0];
+
+	BOOST_REQUIRE_EQUAL(layout_transpose_inplace(buf,v_aos.size(),4),false);
+
+	v_aos.resize(50*LAYOUT_CONVERT_TILE);
+	buf = &v_aos.template get<0>(0)[0];
+	const size_t n = v_aos.size();
+
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		for (size_t j = 0 ; j < 3 ; j++)
+		{v_aos.template get<0>(i)[j] = 10.0*i + j;}
+		v_aos.template get<1>(i) = -(float)i;
+	}
+
+	BOOST_REQUIRE_EQUAL(layout_transpose_inplace(buf,n,4),true);
+
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		for (size_t j = 0 ; j < 3 ; j++)
+		{BOOST_REQUIRE_EQUAL(buf[j*n + i],10.0f*i + j);}
+		BOOST_REQUIRE_EQUAL(buf[3*n + i],-(float)i);
+	}
+
+	BOOST_REQUIRE_EQUAL(layout_transpose_inplace(buf,n,4,false),true);
+
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		for (size_t j = 0 ; j < 3 ; j++)
+		{BOOST_REQUIRE_EQUAL(v_aos.template get<0>(i)[j],10.0f*i + j);}
+		BOOST_REQUIRE_EQUAL(v_aos.template get<1>(i),-(float)i);
+	}
+}
+
+template<typename vector_type>
+void test_vector_remove_if_partition()
+{
+	//! [Remove and partition]
+
+	vector_type v;
+	v.resize(100000);
+
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{
+		v.template get<0>(i)[0] = (float)(i % 1000) / 1000.0;
+		v.template get<0>(i)[1] = 0.5;
+		v.template get<1>(i) = i;
+	}
+
+	// remove the particles outside the domain
+	size_t n_rm = v.remove_if([&v](size_t i) {return v.template get<0>(i)[0] >= 0.9f;});
+
+	// real particles first, ghost particles at the end
+	size_t n_real = v.partition([&v](size_t i) {return v.template get<0>(i)[0] < 0.1f;});
+
+	//! [Remove and partition]
+
+	BOOST_REQUIRE_EQUAL(n_rm,10000ul);
+	BOOST_REQUIRE_EQUAL(v.size(),90000ul);
+	BOOST_REQUIRE_EQUAL(n_real,80000ul);
+
+	// both parts are in the original order
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{
+		float x = v.template get<0>(i)[0];
+		size_t id = v.template get<1>(i);
+
+		BOOST_REQUIRE_EQUAL(x < 0.1f,i >= n_real);
+		BOOST_REQUIRE(x < 0.9f);
+		BOOST_REQUIRE_EQUAL(v.template get<0>(i)[1],0.5);
+
+		if (i != 0 && i != n_real)
+		{BOOST_REQUIRE(v.template get<1>(i-1) < id);}
+	}
+
+	// nothing to remove, remove everything
+	BOOST_REQUIRE_EQUAL(v.remove_if([](size_t i) {return false;}),0ul);
+	BOOST_REQUIRE_EQUAL(v.size(),90000ul);
+	BOOST_REQUIRE_EQUAL(v.partition([](size_t i) {return true;}),0ul);
+	BOOST_REQUIRE_EQUAL(v.remove_if([](size_t i) {return true;}),90000ul);
+	BOOST_REQUIRE_EQUAL(v.size(),0ul);
+
+	// unsorted keys
+	v.resize(10);
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{v.template get<1>(i) = i;}
+
+	openfpm::vector<size_t> keys;
+	keys.add(7);
+	keys.add(2);
+	keys.add(3);
+	v.remove(keys);
+
+	BOOST_REQUIRE_EQUAL(v.size(),7ul);
+	size_t check[] = {0,1,4,5,6,8,9};
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{BOOST_REQUIRE_EQUAL(v.template get<1>(i),check[i]);}
+}
+
+BOOST_AUTO_TEST_CASE( vector_remove_if_partition )
+{
+	test_vector_remove_if_partition<openfpm::vector<aggregate<float[2],size_t>>>();
+	test_vector_remove_if_partition<openfpm::vector_soa<aggregate<float[2],size_t>>>();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 #endif
@@ -0,0 +1,929 @@
+/*
+ * flat_int_map.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef FLAT_INT_MAP_H_
+#define FLAT_INT_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//! Number of control bytes probed together
+#define FLAT_INT_MAP_GROUP 16
+
+#ifndef FLAT_INT_MAP_PREFETCH_DIST
+//! Distance (in number of keys) of the prefetch in find_many
+#define FLAT_INT_MAP_PREFETCH_DIST 8
+#endif
+
+namespace openfpm
+{
+	/*! \brief Hash for integer keys
+	 *
+	 * std::hash of an integer is the identity, flat_int_map use the low 7 bits of the hash as tag and the
+	 * high bits to select the group, so the key must be mixed (finalizer of MurmurHash3)
+	 *
+	 */
+	template<typename Key>
+	struct flat_int_hash
+	{
+		inline size_t operator()(Key k) const
+		{
+			uint64_t h = (uint64_t)k;
+
+			h ^= h >> 33;
+			h *= 0xff51afd7ed558ccdull;
+			h ^= h >> 33;
+			h *= 0xc4ceb9fe1a85ec53ull;
+			h ^= h >> 33;
+
+			return h;
+		}
+	};
+
+	namespace flat_int_map_impl
+	{
+		//! control byte
+		typedef signed char ctrl_t;
+
+		//! control byte of an empty slot
+		static const ctrl_t ctrl_empty = -128;
+
+		//! control byte of a deleted slot
+		static const ctrl_t ctrl_deleted = -2;
+
+		/*! \brief Return the position of the lowest bit set and clear it
+		 *
+		 * \param m bit mask (must not be zero)
+		 *
+		 * \return the position of the lowest bit set
+		 *
+		 */
+		inline unsigned int pop_lowest_bit(unsigned int & m)
+		{
+			unsigned int b = __builtin_ctz(m);
+			m &= m - 1;
+
+			return b;
+		}
+
+		/*! \brief Group of FLAT_INT_MAP_GROUP control bytes
+		 *
+		 * Every match function return a bit-mask with one bit for each control byte of the group.
+		 * With SSE2 the FLAT_INT_MAP_GROUP bytes are compared with one instruction
+		 *
+		 */
+		struct group
+		{
+#ifdef __SSE2__
+
+			//! control bytes
+			__m128i ctrl;
+
+			explicit group(const ctrl_t * p)
+			:ctrl(_mm_loadu_si128((const __m128i *)p))
+			{}
+
+			//! slots with tag h2
+			inline unsigned int match(ctrl_t h2) const
+			{
+				return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2),ctrl));
+			}
+
+			//! empty slots
+			inline unsigned int match_empty() const
+			{
+				return match(ctrl_empty);
+			}
+
+			//! empty or deleted slots
+			inline unsigned int match_free() const
+			{
+				return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1),ctrl));
+			}
+
+#else
+
+			//! control bytes
+			const ctrl_t * ctrl;
+
+			explicit group(const ctrl_t * p)
+			:ctrl(p)
+			{}
+
+			//! slots with tag h2
+			inline unsigned int match(ctrl_t h2) const
+			{
+				unsigned int m = 0;
+				for (unsigned int i = 0 ; i < FLAT_INT_MAP_GROUP ; i++)
+				{m |= (unsigned int)(ctrl[i] == h2) << i;}
+
+				return m;
+			}
+
+			//! empty slots
+			inline unsigned int match_empty() const
+			{
+				return match(ctrl_empty);
+			}
+
+			//! empty or deleted slots
+			inline unsigned int match_free() const
+			{
+				unsigned int m = 0;
+				for (unsigned int i = 0 ; i < FLAT_INT_MAP_GROUP ; i++)
+				{m |= (unsigned int)(ctrl[i] < -1) << i;}
+
+				return m;
+			}
+
+#endif
+		};
+	}
+
+	/*! \brief Open addressing hash map for integer keys (Swiss-table like)
+	 *
+	 * Every slot has a control byte that is empty, deleted or contain 7 bits of the hash of the key (tag).
+	 * The slots are divided in groups of FLAT_INT_MAP_GROUP elements, a lookup compare the tag with all the
+	 * control bytes of a group at once (SSE2), and touch the slots only for the matching tags. Groups are probed
+	 * quadratically, the maximum load factor is 7/8. The control bytes of a group are stored just before its
+	 * slots, so a lookup touch one page.
+	 *
+	 * The interface is a subset of tsl::hopscotch_map (find, operator[], insert, erase, iterators, swap ...) so
+	 * it can be used as the chunk map of sgrid_cpu. find_many look-up a batch of keys prefetching the control
+	 * bytes and the slots of the next keys, to hide the memory latency when the map does not fit in cache
+	 *
+	 * \tparam Key integer key type
+	 * \tparam T value type
+	 * \tparam Hash hash function (its low bits must be well mixed)
+	 *
+	 */
+	template<typename Key, typename T, typename Hash = flat_int_hash<Key>>
+	class flat_int_map
+	{
+		static_assert(std::is_integral<Key>::value,"flat_int_map support only integer keys");
+
+		typedef flat_int_map_impl::ctrl_t ctrl_t;
+
+	public:
+
+		//! key type
+		typedef Key key_type;
+
+		//! value type
+		typedef T mapped_type;
+
+		//! element type
+		typedef std::pair<Key,T> value_type;
+
+		//! size type
+		typedef size_t size_type;
+
+	private:
+
+		//! bytes used by the control bytes of a group (the slots that follow must be aligned)
+		static const size_t ctrl_bytes = (FLAT_INT_MAP_GROUP + alignof(value_type) - 1) / alignof(value_type) * alignof(value_type);
+
+		//! bytes of a group (control bytes + slots)
+		static const size_t group_bytes = ctrl_bytes + FLAT_INT_MAP_GROUP*sizeof(value_type);
+
+		//! groups
+		unsigned char * mem;
+
+		//! number of slots (0 or a power of 2 multiple of FLAT_INT_MAP_GROUP)
+		size_t cap;
+
+		//! number of elements
+		size_t n_ele;
+
+		//! number of elements that can be inserted in empty slots before a rehash
+		size_t growth_left;
+
+		//! hash function
+		Hash hash;
+
+		//! maximum number of elements for a capacity
+		static size_t max_load(size_t c)
+		{
+			return c - c/8;
+		}
+
+		//! tag of an hash
+		static ctrl_t h2(size_t h)
+		{
+			return h & 0x7F;
+		}
+
+		//! control bytes of the group g
+		inline ctrl_t * ctrl_g(size_t g) const
+		{
+			return (ctrl_t *)(mem + g*group_bytes);
+		}
+
+		//! control byte of the slot s
+		inline ctrl_t & ctrl_at(size_t s) const
+		{
+			return ctrl_g(s / FLAT_INT_MAP_GROUP)[s % FLAT_INT_MAP_GROUP];
+		}
+
+		//! slot s
+		inline value_type * slot_at(size_t s) const
+		{
+			return (value_type *)(mem + (s / FLAT_INT_MAP_GROUP)*group_bytes + ctrl_bytes) + s % FLAT_INT_MAP_GROUP;
+		}
+
+		//! first group of the probe sequence of an hash
+		size_t h1(size_t h) const
+		{
+			return (h >> 7) & (cap / FLAT_INT_MAP_GROUP - 1);
+		}
+
+		//! preferred (home) slot of an hash
+		size_t home(size_t h) const
+		{
+			return h1(h)*FLAT_INT_MAP_GROUP + (h >> 60) % FLAT_INT_MAP_GROUP;
+		}
+
+		/*! \brief Return the slot of a key
+		 *
+		 * \param key key
+		 * \param h hash of the key
+		 *
+		 * \return the slot, or cap if the key does not exist
+		 *
+		 */
+		inline size_t find_index(const Key & key, size_t h) const
+		{
+			if (cap == 0)	{return 0;}
+
+			const size_t gmask = cap / FLAT_INT_MAP_GROUP - 1;
+			const ctrl_t tag = h2(h);
+			size_t g = h1(h);
+
+			// most of the keys are in their home slot, the control byte and the slot are loaded in parallel
+			// so in the common case the lookup cost one memory latency
+
+			size_t hs = home(h);
+			ctrl_t hc = ctrl_at(hs);
+			Key hk = slot_at(hs)->first;
+			if (hc == tag && hk == key)	{return hs;}
+
+			for (size_t step = 1 ; ; step++)
+			{
+				flat_int_map_impl::group gr(ctrl_g(g));
+				unsigned int m = gr.match(tag);
+
+				while (m != 0)
+				{
+					size_t s = g*FLAT_INT_MAP_GROUP + flat_int_map_impl::pop_lowest_bit(m);
+					if (slot_at(s)->first == key)	{return s;}
+				}
+
+				if (gr.match_empty() != 0)	{return cap;}
+
+				g = (g + step) & gmask;
+			}
+		}
+
+		/*! \brief Return the first empty or deleted slot in the probe sequence of an hash
+		 *
+		 * \param h hash
+		 *
+		 * \return the slot
+		 *
+		 */
+		inline size_t find_free(size_t h) const
+		{
+			const size_t gmask = cap / FLAT_INT_MAP_GROUP - 1;
+			size_t g = h1(h);
+
+			size_t hs = home(h);
+			if (ctrl_at(hs) < -1)	{return hs;}
+
+			for (size_t step = 1 ; ; step++)
+			{
+				unsigned int m = flat_int_map_impl::group(ctrl_g(g)).match_free();
+
+				if (m != 0)	{return g*FLAT_INT_MAP_GROUP + flat_int_map_impl::pop_lowest_bit(m);}
+
+				g = (g + step) & gmask;
+			}
+		}
+
+		/*! \brief Allocate the groups
+		 *
+		 * \param c number of slots
+		 *
+		 */
+		void allocate(size_t c)
+		{
+			cap = c;
+			n_ele = 0;
+			growth_left = max_load(c);
+
+			if (c == 0)
+			{
+				mem = NULL;
+				return;
+			}
+
+			// the keys of the empty slots are read (and discarded) by the home slot check, so they are initialized
+
+			mem = (unsigned char *)::operator new(c / FLAT_INT_MAP_GROUP * group_bytes);
+			std::memset(mem,0,c / FLAT_INT_MAP_GROUP * group_bytes);
+
+			for (size_t g = 0 ; g < c / FLAT_INT_MAP_GROUP ; g++)
+			{std::memset(ctrl_g(g),flat_int_map_impl::ctrl_empty,FLAT_INT_MAP_GROUP);}
+		}
+
+		//! destroy all the elements and release the memory
+		void destroy()
+		{
+			for (size_t i = 0 ; i < cap ; i++)
+			{
+				if (ctrl_at(i) >= 0)	{slot_at(i)->~value_type();}
+			}
+
+			::operator delete(mem);
+		}
+
+		/*! \brief Move all the elements in a table with c slots
+		 *
+		 * \param c new number of slots
+		 *
+		 */
+		void rehash(size_t c)
+		{
+			flat_int_map old;
+			swap(old);
+
+			allocate(c);
+
+			for (size_t i = 0 ; i < old.cap ; i++)
+			{
+				if (old.ctrl_at(i) < 0)	{continue;}
+
+				value_type * v = old.slot_at(i);
+				size_t h = hash(v->first);
+				size_t s = find_free(h);
+
+				ctrl_at(s) = h2(h);
+				new (slot_at(s)) value_type(std::move(*v));
+			}
+
+			n_ele = old.n_ele;
+			growth_left -= n_ele;
+		}
+
+		/*! \brief Reserve a slot for a new key (the key must not exist)
+		 *
+		 * \param h hash of the key
+		 *
+		 * \return the slot, its control byte is set but the element is not constructed
+		 *
+		 */
+		size_t prepare_insert(size_t h)
+		{
+			size_t s = (cap == 0)?0:find_free(h);
+
+			if (cap == 0 || (growth_left == 0 && ctrl_at(s) != flat_int_map_impl::ctrl_deleted))
+			{
+				// if most of the slots are tombstones rehash with the same capacity
+
+				size_t c = (cap == 0)?FLAT_INT_MAP_GROUP:((n_ele + 1 > cap*7/16)?2*cap:cap);
+				rehash(c);
+				s = find_free(h);
+			}
+
+			if (ctrl_at(s) == flat_int_map_impl::ctrl_empty)	{growth_left--;}
+
+			ctrl_at(s) = h2(h);
+			n_ele++;
+
+			return s;
+		}
+
+		/*! \brief Prefetch the control bytes of the first group of an hash
+		 *
+		 * \param h hash
+		 *
+		 */
+		inline void prefetch_ctrl(size_t h) const
+		{
+			__builtin_prefetch(ctrl_g(h1(h)), 0, 0);
+		}
+
+		/*! \brief Prefetch the first slot of the first group that match the tag of an hash
+		 *
+		 * \param h hash
+		 *
+		 */
+		inline void prefetch_slot(size_t h) const
+		{
+			size_t g = h1(h);
+			unsigned int m = flat_int_map_impl::group(ctrl_g(g)).match(h2(h));
+
+			if (m != 0)
+			{__builtin_prefetch(slot_at(g*FLAT_INT_MAP_GROUP + flat_int_map_impl::pop_lowest_bit(m)), 0, 0);}
+		}
+
+		/*! \brief Iterator over the elements
+		 *
+		 * \tparam map_type flat_int_map or const flat_int_map
+		 * \tparam val_type value_type or const value_type
+		 *
+		 */
+		template<typename map_type, typename val_type>
+		class iterator_impl
+		{
+			//! map
+			map_type * m;
+
+			//! slot
+			size_t s;
+
+			//! Move to the next full slot
+			void skip()
+			{
+				while (s < m->cap && m->ctrl_at(s) < 0)
+				{s++;}
+			}
+
+			friend class flat_int_map;
+
+		public:
+
+			typedef std::forward_iterator_tag iterator_category;
+			typedef typename std::remove_const<val_type>::type value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef val_type & reference;
+			typedef val_type * pointer;
+
+			iterator_impl()
+			:m(NULL),s(0)
+			{}
+
+			iterator_impl(map_type * m, size_t s)
+			:m(m),s(s)
+			{
+				skip();
+			}
+
+			//! Conversion from iterator to const_iterator
+			template<typename map_type2, typename val_type2>
+			iterator_impl(const iterator_impl<map_type2,val_type2> & i)
+			:m(i.m),s(i.s)
+			{}
+
+			//! return the key
+			const Key & key() const
+			{
+				return m->slot_at(s)->first;
+			}
+
+			//! return the value
+			typename std::conditional<std::is_const<map_type>::value,const T &,T &>::type value() const
+			{
+				return m->slot_at(s)->second;
+			}
+
+			reference operator*() const
+			{
+				return *m->slot_at(s);
+			}
+
+			pointer operator->() const
+			{
+				return m->slot_at(s);
+			}
+
+			iterator_impl & operator++()
+			{
+				s++;
+				skip();
+
+				return *this;
+			}
+
+			iterator_impl operator++(int)
+			{
+				iterator_impl tmp(*this);
+				++(*this);
+
+				return tmp;
+			}
+
+			bool operator==(const iterator_impl & i) const
+			{
+				return s == i.s;
+			}
+
+			bool operator!=(const iterator_impl & i) const
+			{
+				return s != i.s;
+			}
+
+			template<typename map_type2, typename val_type2> friend class iterator_impl;
+		};
+
+	public:
+
+		//! iterator
+		typedef iterator_impl<flat_int_map,value_type> iterator;
+
+		//! const iterator
+		typedef iterator_impl<const flat_int_map,const value_type> const_iterator;
+
+		//! Constructor
+		flat_int_map()
+		{
+			allocate(0);
+		}
+
+		/*! \brief Constructor
+		 *
+		 * \param n expected number of elements
+		 *
+		 */
+		explicit flat_int_map(size_t n)
+		{
+			allocate(0);
+			reserve(n);
+		}
+
+		//! Copy constructor
+		flat_int_map(const flat_int_map & m)
+		:hash(m.hash)
+		{
+			allocate(m.cap);
+
+			if (cap == 0)	{return;}
+
+			for (size_t i = 0 ; i < cap ; i++)
+			{
+				ctrl_at(i) = m.ctrl_at(i);
+				if (ctrl_at(i) >= 0)	{new (slot_at(i)) value_type(*m.slot_at(i));}
+			}
+
+			n_ele = m.n_ele;
+			growth_left = m.growth_left;
+		}
+
+		//! Move constructor
+		flat_int_map(flat_int_map && m)
+		:hash(m.hash)
+		{
+			allocate(0);
+			swap(m);
+		}
+
+		~flat_int_map()
+		{
+			destroy();
+		}
+
+		//! Copy assignment
+		flat_int_map & operator=(const flat_int_map & m)
+		{
+			if (this != &m)
+			{
+				flat_int_map tmp(m);
+				swap(tmp);
+			}
+
+			return *this;
+		}
+
+		//! Move assignment
+		flat_int_map & operator=(flat_int_map && m)
+		{
+			swap(m);
+
+			return *this;
+		}
+
+		/*! \brief Reserve space for n elements
+		 *
+		 * Inserting up to n elements does not rehash
+		 *
+		 * \param n number of elements
+		 *
+		 */
+		void reserve(size_t n)
+		{
+			size_t c = FLAT_INT_MAP_GROUP;
+			while (max_load(c) < n)	{c *= 2;}
+
+			if (c > cap)	{rehash(c);}
+		}
+
+		/*! \brief Number of elements
+		 *
+		 * \return the number of elements
+		 *
+		 */
+		size_t size() const
+		{
+			return n_ele;
+		}
+
+		/*! \brief Return true if the map is empty
+		 *
+		 * \return true if empty
+		 *
+		 */
+		bool empty() const
+		{
+			return n_ele == 0;
+		}
+
+		/*! \brief Number of slots
+		 *
+		 * \return the number of slots
+		 *
+		 */
+		size_t bucket_count() const
+		{
+			return cap;
+		}
+
+		/*! \brief Load factor
+		 *
+		 * \return number of elements / number of slots
+		 *
+		 */
+		float load_factor() const
+		{
+			return (cap == 0)?0.0f:(float)n_ele / cap;
+		}
+
+		//! Remove all the elements (the memory is not released)
+		void clear()
+		{
+			for (size_t i = 0 ; i < cap ; i++)
+			{
+				if (ctrl_at(i) >= 0)	{slot_at(i)->~value_type();}
+				ctrl_at(i) = flat_int_map_impl::ctrl_empty;
+			}
+
+			n_ele = 0;
+			growth_left = max_load(cap);
+		}
+
+		/*! \brief swap two maps
+		 *
+		 * \param m map to swap with
+		 *
+		 */
+		void swap(flat_int_map & m)
+		{
+			std::swap(mem,m.mem);
+			std::swap(cap,m.cap);
+			std::swap(n_ele,m.n_ele);
+			std::swap(growth_left,m.growth_left);
+			std::swap(hash,m.hash);
+		}
+
+		/*! \brief Find an element
+		 *
+		 * \param key key to search
+		 *
+		 * \return the iterator to the element or end()
+		 *
+		 */
+		iterator find(const Key & key)
+		{
+			size_t s = find_index(key,hash(key));
+
+			return (s == cap)?end():iterator(this,s);
+		}
+
+		/*! \brief Find an element
+		 *
+		 * \param key key to search
+		 *
+		 * \return the iterator to the element or end()
+		 *
+		 */
+		const_iterator find(const Key & key) const
+		{
+			size_t s = find_index(key,hash(key));
+
+			return (s == cap)?end():const_iterator(this,s);
+		}
+
+		/*! \brief Count the elements with the key
+		 *
+		 * \param key key to search
+		 *
+		 * \return 1 if the key exist 0 otherwise
+		 *
+		 */
+		size_t count(const Key & key) const
+		{
+			return find_index(key,hash(key)) != cap;
+		}
+
+		/*! \brief Find a batch of keys
+		 *
+		 * While a key is searched the control bytes of the key that come FLAT_INT_MAP_PREFETCH_DIST*2 positions
+		 * later and the matching slot of the key FLAT_INT_MAP_PREFETCH_DIST positions later are prefetched, so
+		 * several cache misses are in flight at the same time
+		 *
+		 * \param keys keys to search (random access iterator or pointer)
+		 * \param n number of keys
+		 * \param vals for each key its value, or def if the key does not exist (random access iterator or pointer)
+		 * \param def value for the keys that does not exist
+		 *
+		 * \return the number of keys found
+		 *
+		 */
+		template<typename key_it, typename val_it>
+		size_t find_many(key_it keys, size_t n, val_it vals, const T & def) const
+		{
+			const size_t D = FLAT_INT_MAP_PREFETCH_DIST;
+			const size_t R = 2*FLAT_INT_MAP_PREFETCH_DIST;
+
+			if (cap == 0)
+			{
+				for (size_t i = 0 ; i < n ; i++)	{vals[i] = def;}
+				return 0;
+			}
+
+			// ring buffer with the hashes of the keys [i,i+2D)
+
+			size_t hs[R];
+
+			for (size_t j = 0 ; j < R && j < n ; j++)
+			{
+				hs[j] = hash(keys[j]);
+				prefetch_ctrl(hs[j]);
+			}
+
+			for (size_t j = 0 ; j < D && j < n ; j++)
+			{prefetch_slot(hs[j]);}
+
+			size_t n_found = 0;
+
+			for (size_t i = 0 ; i < n ; i++)
+			{
+				size_t h = hs[i % R];
+
+				if (i + R < n)
+				{
+					hs[i % R] = hash(keys[i+R]);
+					prefetch_ctrl(hs[i % R]);
+				}
+
+				if (i + D < n)	{prefetch_slot(hs[(i + D) % R]);}
+
+				size_t s = find_index(keys[i],h);
+
+				if (s == cap)
+				{vals[i] = def;}
+				else
+				{
+					vals[i] = slot_at(s)->second;
+					n_found++;
+				}
+			}
+
+			return n_found;
+		}
+
+		/*! \brief Access an element, it is created if it does not exist
+		 *
+		 * \param key key
+		 *
+		 * \return a reference to the value
+		 *
+		 */
+		T & operator[](const Key & key)
+		{
+			size_t h = hash(key);
+			size_t s = find_index(key,h);
+
+			if (s == cap)
+			{
+				s = prepare_insert(h);
+				new (slot_at(s)) value_type(key,T());
+			}
+
+			return slot_at(s)->second;
+		}
+
+		/*! \brief Insert an element if the key does not exist
+		 *
+		 * \param v element
+		 *
+		 * \return the iterator to the element with the key, and true if the element has been inserted
+		 *
+		 */
+		std::pair<iterator,bool> insert(const value_type & v)
+		{
+			size_t h = hash(v.first);
+			size_t s = find_index(v.first,h);
+
+			if (s != cap)	{return std::make_pair(iterator(this,s),false);}
+
+			s = prepare_insert(h);
+			new (slot_at(s)) value_type(v);
+
+			return std::make_pair(iterator(this,s),true);
+		}
+
+		/*! \brief Insert an element or overwrite its value if the key exist
+		 *
+		 * \param key key
+		 * \param val value
+		 *
+		 * \return the iterator to the element, and true if the element has been inserted
+		 *
+		 */
+		std::pair<iterator,bool> insert_or_assign(const Key & key, const T & val)
+		{
+			size_t h = hash(key);
+			size_t s = find_index(key,h);
+
+			if (s != cap)
+			{
+				slot_at(s)->second = val;
+				return std::make_pair(iterator(this,s),false);
+			}
+
+			s = prepare_insert(h);
+			new (slot_at(s)) value_type(key,val);
+
+			return std::make_pair(iterator(this,s),true);
+		}
+
+		/*! \brief Remove an element
+		 *
+		 * \param key key of the element to remove
+		 *
+		 * \return the number of removed elements
+		 *
+		 */
+		size_t erase(const Key & key)
+		{
+			size_t s = find_index(key,hash(key));
+
+			if (s == cap)	{return 0;}
+
+			slot_at(s)->~value_type();
+			n_ele--;
+
+			// if the group has an empty slot no probe sequence continue after this group, so the slot
+			// can be marked empty, otherwise it become a tombstone
+
+			size_t g = s / FLAT_INT_MAP_GROUP;
+			if (flat_int_map_impl::group(ctrl_g(g)).match_empty() != 0)
+			{
+				ctrl_at(s) = flat_int_map_impl::ctrl_empty;
+				growth_left++;
+			}
+			else
+			{ctrl_at(s) = flat_int_map_impl::ctrl_deleted;}
+
+			return 1;
+		}
+
+		//! Iterator to the first element
+		iterator begin()
+		{
+			return iterator(this,0);
+		}
+
+		//! Iterator to the end
+		iterator end()
+		{
+			return iterator(this,cap);
+		}
+
+		//! Iterator to the first element
+		const_iterator begin() const
+		{
+			return const_iterator(this,0);
+		}
+
+		//! Iterator to the end
+		const_iterator end() const
+		{
+			return const_iterator(this,cap);
+		}
+	};
+}
+
+#endif /* FLAT_INT_MAP_H_ */
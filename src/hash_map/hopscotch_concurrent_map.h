@@ -0,0 +1,558 @@
+/*
+ * hopscotch_concurrent_map.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef HOPSCOTCH_CONCURRENT_MAP_H_
+#define HOPSCOTCH_CONCURRENT_MAP_H_
+
+#include <atomic>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <thread>
+#include "hopscotch_map.h"
+
+namespace openfpm
+{
+	/*! \brief Spin-lock that protect one segment of hopscotch_concurrent_map
+	 *
+	 * A copy of a lock is always unlocked
+	 *
+	 */
+	class hopscotch_spinlock
+	{
+		//! lock flag
+		std::atomic_flag flag;
+
+	public:
+
+		hopscotch_spinlock()
+		{
+			flag.clear();
+		}
+
+		hopscotch_spinlock(const hopscotch_spinlock & l)
+		{
+			flag.clear();
+		}
+
+		hopscotch_spinlock & operator=(const hopscotch_spinlock & l)
+		{
+			return *this;
+		}
+
+		//! Acquire the lock (after some failed attempts the thread yield, in case the owner is not running)
+		inline void lock()
+		{
+			int spin = 0;
+
+			while (flag.test_and_set(std::memory_order_acquire))
+			{
+				if (++spin >= 64)
+				{
+					std::this_thread::yield();
+					spin = 0;
+				}
+			}
+		}
+
+		//! Release the lock
+		inline void unlock()
+		{
+			flag.clear(std::memory_order_release);
+		}
+	};
+
+	/*! \brief Concurrent variant of tsl::hopscotch_map
+	 *
+	 * The keys are distributed over 2^n_seg_log2 segments by the high bits of their (mixed) hash, every
+	 * segment is a tsl::hopscotch_map protected by its own lock (lock striping). Threads that work on different
+	 * segments never wait for each other.
+	 *
+	 * The thread-safe interface is composed by find_value, insert, insert_or_assign, get_or_insert_with,
+	 * erase and count. All the other functions (find, operator[], iterators, reserve, clear, swap ...) are
+	 * the same of tsl::hopscotch_map, so the map can be used as a drop-in replacement, but they must not run
+	 * concurrently with a writer
+	 *
+	 * \tparam Key key type
+	 * \tparam T value type
+	 * \tparam Hash hash function
+	 * \tparam KeyEqual key comparison
+	 * \tparam n_seg_log2 logarithm in base 2 of the number of segments
+	 *
+	 */
+	template<typename Key,
+	         typename T,
+	         typename Hash = std::hash<Key>,
+	         typename KeyEqual = std::equal_to<Key>,
+	         unsigned int n_seg_log2 = 6>
+	class hopscotch_concurrent_map
+	{
+		static_assert(n_seg_log2 >= 1 && n_seg_log2 <= 16,"the number of segments must be between 2^1 and 2^16");
+
+	public:
+
+		//! Map of one segment
+		typedef tsl::hopscotch_map<Key,T,Hash,KeyEqual> segment_map;
+
+		//! key type
+		typedef Key key_type;
+
+		//! value type
+		typedef T mapped_type;
+
+		//! size type
+		typedef size_t size_type;
+
+		//! number of segments
+		static const size_t n_seg = 1ul << n_seg_log2;
+
+	private:
+
+		//! One segment of the map
+		struct segment
+		{
+			//! map of the segment
+			segment_map map;
+
+			//! lock of the segment
+			mutable hopscotch_spinlock lock;
+
+			//! padding to avoid that the locks of two segments share a cache line
+			unsigned char pad[64];
+		};
+
+		//! segments
+		std::vector<segment> seg;
+
+		//! hash function
+		Hash hash;
+
+		/*! \brief Return the segment of a key
+		 *
+		 * \param key key
+		 *
+		 * \return the segment id
+		 *
+		 */
+		inline size_t seg_id(const Key & key) const
+		{
+			// std::hash of integers is the identity, so we mix it before taking the high bits
+			uint64_t h = (uint64_t)hash(key) * 0x9E3779B97F4A7C15ull;
+
+			return h >> (64 - n_seg_log2);
+		}
+
+		/*! \brief Iterator over all the segments
+		 *
+		 * \tparam map_type hopscotch_concurrent_map or const hopscotch_concurrent_map
+		 * \tparam it_type iterator of the segment map
+		 *
+		 */
+		template<typename map_type, typename it_type>
+		class iterator_impl
+		{
+			//! map
+			map_type * m;
+
+			//! actual segment
+			size_t s;
+
+			//! iterator inside the segment
+			it_type it;
+
+			//! Move to the first element of the next not-empty segment if the actual segment is finished
+			void skip()
+			{
+				while (s < n_seg && it == m->seg[s].map.end())
+				{
+					s++;
+					if (s < n_seg)	{it = m->seg[s].map.begin();}
+				}
+			}
+
+			friend class hopscotch_concurrent_map;
+
+		public:
+
+			typedef std::forward_iterator_tag iterator_category;
+			typedef typename std::iterator_traits<it_type>::value_type value_type;
+			typedef typename std::iterator_traits<it_type>::difference_type difference_type;
+			typedef typename std::iterator_traits<it_type>::reference reference;
+			typedef typename std::iterator_traits<it_type>::pointer pointer;
+
+			iterator_impl()
+			:m(NULL),s(n_seg)
+			{}
+
+			iterator_impl(map_type * m, size_t s, it_type it)
+			:m(m),s(s),it(it)
+			{
+				skip();
+			}
+
+			//! Conversion from iterator to const_iterator
+			template<typename map_type2, typename it_type2>
+			iterator_impl(const iterator_impl<map_type2,it_type2> & i)
+			:m(i.m),s(i.s),it(i.it)
+			{}
+
+			//! return the key
+			const Key & key() const
+			{
+				return it.key();
+			}
+
+			//! return the value
+			decltype(std::declval<it_type>().value()) value() const
+			{
+				return it.value();
+			}
+
+			reference operator*() const
+			{
+				return *it;
+			}
+
+			pointer operator->() const
+			{
+				return it.operator->();
+			}
+
+			iterator_impl & operator++()
+			{
+				++it;
+				skip();
+
+				return *this;
+			}
+
+			iterator_impl operator++(int)
+			{
+				iterator_impl tmp(*this);
+				++(*this);
+
+				return tmp;
+			}
+
+			bool operator==(const iterator_impl & i) const
+			{
+				return s == i.s && (s == n_seg || it == i.it);
+			}
+
+			bool operator!=(const iterator_impl & i) const
+			{
+				return !(*this == i);
+			}
+
+			template<typename map_type2, typename it_type2> friend class iterator_impl;
+		};
+
+	public:
+
+		//! iterator
+		typedef iterator_impl<hopscotch_concurrent_map,typename segment_map::iterator> iterator;
+
+		//! const iterator
+		typedef iterator_impl<const hopscotch_concurrent_map,typename segment_map::const_iterator> const_iterator;
+
+		//! Constructor
+		hopscotch_concurrent_map()
+		:seg(n_seg)
+		{}
+
+		/*! \brief Constructor
+		 *
+		 * \param n expected number of elements
+		 *
+		 */
+		explicit hopscotch_concurrent_map(size_t n)
+		:seg(n_seg)
+		{
+			reserve(n);
+		}
+
+		/*! \brief Reserve space for n elements
+		 *
+		 * Every segment reserve space for its expected number of elements plus a margin for the
+		 * fluctuation of the distribution of the keys, inserting up to n elements does not rehash
+		 * in the common case
+		 *
+		 * \param n expected number of elements (for example the expected number of chunks)
+		 *
+		 */
+		void reserve(size_t n)
+		{
+			size_t per_seg = n / n_seg;
+			per_seg += 3*(size_t)std::sqrt((double)per_seg) + 16;
+
+			for (size_t i = 0 ; i < n_seg ; i++)
+			{seg[i].map.reserve(per_seg);}
+		}
+
+		/*! \brief Number of elements (not thread-safe with writers)
+		 *
+		 * \return the number of elements
+		 *
+		 */
+		size_t size() const
+		{
+			size_t tot = 0;
+
+			for (size_t i = 0 ; i < n_seg ; i++)
+			{tot += seg[i].map.size();}
+
+			return tot;
+		}
+
+		/*! \brief Number of slots of all the segments (not thread-safe with writers)
+		 *
+		 * \return the number of slots
+		 *
+		 */
+		size_t bucket_count() const
+		{
+			size_t tot = 0;
+
+			for (size_t i = 0 ; i < n_seg ; i++)
+			{tot += seg[i].map.bucket_count();}
+
+			return tot;
+		}
+
+		/*! \brief Return true if the map is empty (not thread-safe with writers)
+		 *
+		 * \return true if empty
+		 *
+		 */
+		bool empty() const
+		{
+			return size() == 0;
+		}
+
+		//! Remove all the elements (not thread-safe)
+		void clear()
+		{
+			for (size_t i = 0 ; i < n_seg ; i++)
+			{seg[i].map.clear();}
+		}
+
+		/*! \brief swap two maps (not thread-safe)
+		 *
+		 * \param m map to swap with
+		 *
+		 */
+		void swap(hopscotch_concurrent_map & m)
+		{
+			seg.swap(m.seg);
+			std::swap(hash,m.hash);
+		}
+
+		/*! \brief Find an element (not thread-safe with writers)
+		 *
+		 * \param key key to search
+		 *
+		 * \return the iterator to the element or end()
+		 *
+		 */
+		iterator find(const Key & key)
+		{
+			size_t s = seg_id(key);
+			auto it = seg[s].map.find(key);
+
+			if (it == seg[s].map.end())	{return end();}
+
+			return iterator(this,s,it);
+		}
+
+		/*! \brief Find an element (not thread-safe with writers)
+		 *
+		 * \param key key to search
+		 *
+		 * \return the iterator to the element or end()
+		 *
+		 */
+		const_iterator find(const Key & key) const
+		{
+			size_t s = seg_id(key);
+			auto it = seg[s].map.find(key);
+
+			if (it == seg[s].map.end())	{return end();}
+
+			return const_iterator(this,s,it);
+		}
+
+		/*! \brief Access an element, it is created if it does not exist (not thread-safe)
+		 *
+		 * \param key key
+		 *
+		 * \return a reference to the value
+		 *
+		 */
+		T & operator[](const Key & key)
+		{
+			return seg[seg_id(key)].map[key];
+		}
+
+		//! Iterator to the first element
+		iterator begin()
+		{
+			return iterator(this,0,seg[0].map.begin());
+		}
+
+		//! Iterator to the end
+		iterator end()
+		{
+			return iterator();
+		}
+
+		//! Iterator to the first element
+		const_iterator begin() const
+		{
+			return const_iterator(this,0,seg[0].map.begin());
+		}
+
+		//! Iterator to the end
+		const_iterator end() const
+		{
+			return const_iterator();
+		}
+
+		/*! \brief Find an element (thread-safe)
+		 *
+		 * \param key key to search
+		 * \param val value of the element (if found)
+		 *
+		 * \return true if the element exist
+		 *
+		 */
+		bool find_value(const Key & key, T & val) const
+		{
+			const segment & sg = seg[seg_id(key)];
+
+			sg.lock.lock();
+
+			auto it = sg.map.find(key);
+			bool found = (it != sg.map.end());
+			if (found == true)	{val = it->second;}
+
+			sg.lock.unlock();
+
+			return found;
+		}
+
+		/*! \brief Count the elements with the key (thread-safe)
+		 *
+		 * \param key key to search
+		 *
+		 * \return 1 if the key exist 0 otherwise
+		 *
+		 */
+		size_t count(const Key & key) const
+		{
+			const segment & sg = seg[seg_id(key)];
+
+			sg.lock.lock();
+			size_t c = sg.map.count(key);
+			sg.lock.unlock();
+
+			return c;
+		}
+
+		/*! \brief Insert an element if the key does not exist (thread-safe)
+		 *
+		 * \param key key
+		 * \param val value
+		 *
+		 * \return true if the element has been inserted
+		 *
+		 */
+		bool insert(const Key & key, const T & val)
+		{
+			segment & sg = seg[seg_id(key)];
+
+			sg.lock.lock();
+			bool ins = sg.map.insert(std::make_pair(key,val)).second;
+			sg.lock.unlock();
+
+			return ins;
+		}
+
+		/*! \brief Insert an element or overwrite its value if the key exist (thread-safe)
+		 *
+		 * \param key key
+		 * \param val value
+		 *
+		 * \return true if the element has been inserted, false if it has been assigned
+		 *
+		 */
+		bool insert_or_assign(const Key & key, const T & val)
+		{
+			segment & sg = seg[seg_id(key)];
+
+			sg.lock.lock();
+			bool ins = sg.map.insert_or_assign(key,val).second;
+			sg.lock.unlock();
+
+			return ins;
+		}
+
+		/*! \brief Return the value of an element, if the key does not exist it is inserted with the value f() (thread-safe)
+		 *
+		 * f is called with the lock of the segment acquired and only if the key does not exist, it can be used
+		 * for example to allocate an id with an atomic counter only for new keys
+		 *
+		 * \param key key
+		 * \param f functor that produce the value of a new element
+		 *
+		 * \return the value of the element
+		 *
+		 */
+		template<typename functor>
+		T get_or_insert_with(const Key & key, functor f)
+		{
+			segment & sg = seg[seg_id(key)];
+
+			sg.lock.lock();
+
+			auto it = sg.map.find(key);
+			T val;
+
+			if (it == sg.map.end())
+			{
+				val = f();
+				sg.map.insert(std::make_pair(key,val));
+			}
+			else
+			{val = it->second;}
+
+			sg.lock.unlock();
+
+			return val;
+		}
+
+		/*! \brief Remove an element (thread-safe)
+		 *
+		 * \param key key of the element to remove
+		 *
+		 * \return the number of removed elements
+		 *
+		 */
+		size_t erase(const Key & key)
+		{
+			segment & sg = seg[seg_id(key)];
+
+			sg.lock.lock();
+			size_t c = sg.map.erase(key);
+			sg.lock.unlock();
+
+			return c;
+		}
+	};
+}
+
+#endif /* HOPSCOTCH_CONCURRENT_MAP_H_ */
@@ -41,6 +41,8 @@
 #include "NN/VerletList/VerletList_test.hpp"
 #include "Grid/iterators/grid_iterators_unit_tests.cpp"
 #include "util/test/compute_optimal_device_grid_unit_tests.hpp"
+#include "util/test/benchmark_store_unit_test.hpp"
+#include "util/test/mem_usage_unit_test.hpp"
 
 #ifdef PERFORMANCE_TEST
 #include "performance.hpp"
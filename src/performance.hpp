@@ -13,6 +13,10 @@
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 #include "util/performance/performance_util.hpp"
+#include "hash_map/hopscotch_concurrent_map.h"
+#include "hash_map/flat_int_map.h"
+#include "util/SimpleRNG.hpp"
+#include "Space/BoxBVH.hpp"
 
 constexpr int N_STAT = 32;
 constexpr int N_STAT_SMALL = 32;
@@ -34,6 +38,10 @@ BOOST_AUTO_TEST_SUITE( performance )
 //// Include tests ////////
 
 #include "Grid/performance/grid_performance_tests.hpp"
+#include "NN/performance/nn_performance_tests.hpp"
+#include "SparseGrid/performance/SparseGrid_map_performance_tests.hpp"
+#include "Graph/performance/graph_performance_tests.hpp"
+#include "Space/performance/space_performance_tests.hpp"
 //#include "Vector/performance/vector_performance_test.hpp"
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,248 @@
+/*
+ * Pack_iovec.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef SRC_PACK_IOVEC_HPP_
+#define SRC_PACK_IOVEC_HPP_
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+#include "util/multi_thread_util.hpp"
+
+//! Segments bigger than this are copied with multiple threads by gather
+#define PACK_IOVEC_GATHER_GRAIN 65536
+
+/*! \brief One segment of a scatter/gather packing
+ *
+ * It refer to len bytes starting at ptr
+ *
+ */
+struct pack_segment
+{
+	//! pointer to the data
+	const void * ptr;
+
+	//! number of bytes
+	size_t len;
+};
+
+/*! \brief Scatter/gather (iovec like) packing buffer
+ *
+ * Instead of copying the objects into a preallocated buffer, like ExtPreAlloc does, the segment
+ * packing produce a list of (pointer,length) segments that refer directly to the memory of the
+ * packed objects. Only small headers (like the size of a vector) and data that are not contiguous in
+ * memory are copied into buffers owned by this object (staged).
+ *
+ * The stream represented is the concatenation of all the segments, offsets used by Unpack_stat are
+ * offsets in this stream. The segments refer to the memory of the packed objects, so such objects
+ * must not be modified or resized until the Pack_iovec is consumed
+ *
+ * \see Packer::packSegments Unpacker::unpackSegments
+ *
+ */
+class Pack_iovec
+{
+	//! list of segments
+	std::vector<pack_segment> seg;
+
+	//! offset of each segment in the stream (it has seg.size() + 1 elements)
+	std::vector<size_t> seg_off;
+
+	//! memory owned by this object
+	std::vector<std::unique_ptr<unsigned char[]>> stage_mem;
+
+	//! number of bytes owned by this object
+	size_t staged_bytes;
+
+	/*! \brief Find the segment that contain the byte off of the stream
+	 *
+	 * \param off offset in the stream
+	 *
+	 * \return the segment id
+	 *
+	 */
+	size_t find_segment(size_t off) const
+	{
+		return std::upper_bound(seg_off.begin(),seg_off.end(),off) - seg_off.begin() - 1;
+	}
+
+public:
+
+	//! Constructor
+	Pack_iovec()
+	:staged_bytes(0)
+	{
+		seg_off.push_back(0);
+	}
+
+	/*! \brief Add a segment that refer to external memory
+	 *
+	 * \param ptr pointer to the data
+	 * \param len number of bytes
+	 *
+	 */
+	void add(const void * ptr, size_t len)
+	{
+		if (len == 0)	{return;}
+
+		pack_segment s;
+		s.ptr = ptr;
+		s.len = len;
+
+		seg.push_back(s);
+		seg_off.push_back(seg_off.back() + len);
+	}
+
+	/*! \brief Add a segment of len bytes owned by this object
+	 *
+	 * \param len number of bytes
+	 *
+	 * \return the pointer where to write the data of the segment
+	 *
+	 */
+	void * stage(size_t len)
+	{
+		stage_mem.emplace_back(new unsigned char[len]);
+		staged_bytes += len;
+		add(stage_mem.back().get(),len);
+
+		return stage_mem.back().get();
+	}
+
+	/*! \brief Return the number of segments
+	 *
+	 * \return the number of segments
+	 *
+	 */
+	size_t size() const
+	{
+		return seg.size();
+	}
+
+	/*! \brief Return the segment i
+	 *
+	 * \param i segment id
+	 *
+	 * \return the segment
+	 *
+	 */
+	const pack_segment & get(size_t i) const
+	{
+		return seg[i];
+	}
+
+	/*! \brief Return the number of bytes in the stream
+	 *
+	 * \return the sum of the size of all the segments
+	 *
+	 */
+	size_t totalSize() const
+	{
+		return seg_off.back();
+	}
+
+	/*! \brief Return the number of bytes owned by this object
+	 *
+	 * \return the number of staged bytes
+	 *
+	 */
+	size_t stagedSize() const
+	{
+		return staged_bytes;
+	}
+
+	/*! \brief Remove all the segments and release the staged memory
+	 *
+	 */
+	void clear()
+	{
+		seg.clear();
+		seg_off.clear();
+		seg_off.push_back(0);
+		stage_mem.clear();
+		staged_bytes = 0;
+	}
+
+	/*! \brief Return a pointer to the bytes [off,off+len) of the stream if they are contiguous
+	 *
+	 * \param off offset in the stream
+	 * \param len number of bytes
+	 *
+	 * \return the pointer, or nullptr if the range cross the boundary of a segment
+	 *
+	 */
+	const void * contiguous(size_t off, size_t len) const
+	{
+		if (off >= totalSize())	{return nullptr;}
+
+		size_t s = find_segment(off);
+
+		if (off + len > seg_off[s+1])	{return nullptr;}
+
+		return (const unsigned char *)seg[s].ptr + (off - seg_off[s]);
+	}
+
+	/*! \brief Copy len bytes of the stream starting from off into dst
+	 *
+	 * \param off offset in the stream
+	 * \param dst destination
+	 * \param len number of bytes
+	 *
+	 */
+	void read(size_t off, void * dst, size_t len) const
+	{
+		unsigned char * d = (unsigned char *)dst;
+
+		while (len != 0)
+		{
+			size_t s = find_segment(off);
+			size_t in_s = off - seg_off[s];
+			size_t n = std::min(len,seg[s].len - in_s);
+
+			std::memcpy(d,(const unsigned char *)seg[s].ptr + in_s,n);
+
+			d += n;
+			off += n;
+			len -= n;
+		}
+	}
+
+	/*! \brief Copy the full stream into a contiguous buffer
+	 *
+	 * It is used when the stream must be sent as one message. Big segments are copied
+	 * with multiple threads
+	 *
+	 * \param dst destination (at least totalSize() bytes)
+	 *
+	 */
+	void gather(void * dst) const
+	{
+		unsigned char * d = (unsigned char *)dst;
+
+		for (size_t i = 0 ; i < seg.size() ; i++)
+		{
+			const unsigned char * src = (const unsigned char *)seg[i].ptr;
+			unsigned char * ds = d + seg_off[i];
+			size_t len = seg[i].len;
+
+			const int nth = openfpm::ofp_n_threads(len,PACK_IOVEC_GATHER_GRAIN);
+
+			#pragma omp parallel for num_threads(nth) schedule(static,1)
+			for (int t = 0 ; t < nth ; t++)
+			{
+				size_t start;
+				size_t stop;
+				openfpm::ofp_thread_range(len,t,nth,start,stop);
+
+				std::memcpy(ds + start,src + start,stop - start);
+			}
+		}
+	}
+};
+
+#endif /* SRC_PACK_IOVEC_HPP_ */
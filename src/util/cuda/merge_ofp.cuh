@@ -27,29 +27,37 @@
         #include <thrust/execution_policy.h>
      #endif
  #endif
+
+ #ifdef CUDA_ON_CPU
+     #include "util/multi_thread_util.hpp"
+
+     //! Under this number of elements the merge run on a single thread
+     #define MERGE_CPU_GRAIN 16384
+ #endif
  
 
  namespace openfpm
  {
+ #ifdef CUDA_ON_CPU
+
+    /*! \brief Sequential merge of a[a_it,a_stop) and b[b_it,b_stop) into c starting from c_it
+     *
+     * In case of equal keys the elements of a come first
+     *
+     */
     template<typename a_keys_it, typename a_vals_it,
              typename b_keys_it, typename b_vals_it,
              typename c_keys_it, typename c_vals_it,
-             typename comp_t, typename context_t>
-    void merge(a_keys_it a_keys, a_vals_it a_vals, int a_count,
-               b_keys_it b_keys, b_vals_it b_vals, int b_count,
-            c_keys_it c_keys, c_vals_it c_vals, comp_t comp, context_t& gpuContext)
+             typename comp_t>
+    void merge_cpu_range(a_keys_it a_keys, a_vals_it a_vals, int a_it, int a_stop,
+                         b_keys_it b_keys, b_vals_it b_vals, int b_it, int b_stop,
+                         c_keys_it c_keys, c_vals_it c_vals, int c_it, comp_t comp)
     {
- #ifdef CUDA_ON_CPU
- 
-        int a_it = 0;
-        int b_it = 0;
-        int c_it = 0;
-
-        while (a_it < a_count || b_it < b_count)
+        while (a_it < a_stop || b_it < b_stop)
         {
-            if (a_it < a_count)
+            if (a_it < a_stop)
             {
-                if (b_it < b_count)
+                if (b_it < b_stop)
                 {
                     if (comp(b_keys[b_it],a_keys[a_it]))
                     {
@@ -82,6 +90,55 @@
                 b_it++;
             }
         }
+    }
+
+    /*! \brief Merge on the host
+     *
+     * The output is split in equal parts across threads, the merge path search find for every part
+     * where it start in a and b and every thread merge its part sequentially. The result is
+     * identical to the sequential merge
+     *
+     */
+    template<typename a_keys_it, typename a_vals_it,
+             typename b_keys_it, typename b_vals_it,
+             typename c_keys_it, typename c_vals_it,
+             typename comp_t>
+    void merge_cpu(a_keys_it a_keys, a_vals_it a_vals, int a_count,
+                   b_keys_it b_keys, b_vals_it b_vals, int b_count,
+                   c_keys_it c_keys, c_vals_it c_vals, comp_t comp)
+    {
+        const size_t n = (size_t)a_count + b_count;
+        const int nth = ofp_n_threads(n,MERGE_CPU_GRAIN);
+
+        #pragma omp parallel for num_threads(nth) schedule(static,1)
+        for (int t = 0 ; t < nth ; t++)
+        {
+            size_t start;
+            size_t stop;
+            ofp_thread_range(n,t,nth,start,stop);
+
+            int a_start = merge_path_search(a_keys,a_count,b_keys,b_count,start,comp);
+            int a_stop = merge_path_search(a_keys,a_count,b_keys,b_count,stop,comp);
+
+            merge_cpu_range(a_keys,a_vals,a_start,a_stop,
+                            b_keys,b_vals,start - a_start,stop - a_stop,
+                            c_keys,c_vals,start,comp);
+        }
+    }
+
+ #endif
+
+    template<typename a_keys_it, typename a_vals_it,
+             typename b_keys_it, typename b_vals_it,
+             typename c_keys_it, typename c_vals_it,
+             typename comp_t, typename context_t>
+    void merge(a_keys_it a_keys, a_vals_it a_vals, int a_count,
+               b_keys_it b_keys, b_vals_it b_vals, int b_count,
+            c_keys_it c_keys, c_vals_it c_vals, comp_t comp, context_t& gpuContext)
+    {
+ #ifdef CUDA_ON_CPU
+
+        merge_cpu(a_keys,a_vals,a_count,b_keys,b_vals,b_count,c_keys,c_vals,comp);
  
  #else
 
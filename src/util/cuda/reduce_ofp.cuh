@@ -26,19 +26,81 @@
 	#include "cub_old/cub.cuh"
 #endif
 
+#ifdef CUDA_ON_CPU
+	#include <vector>
+	#include <type_traits>
+	#include "util/multi_thread_util.hpp"
+
+	//! Under this number of elements the reduction run on a single thread
+	#define REDUCE_CPU_GRAIN 16384
+#endif
+
 
 namespace openfpm
 {
+#ifdef CUDA_ON_CPU
+
+	/*! \brief Reduction on the host
+	 *
+	 * Integer reductions are split across threads, every thread reduce a contiguous block and the
+	 * partial results are combined in order (op must be associative). Floating point reductions stay
+	 * sequential to give the same rounding of the sequential version
+	 *
+	 * \param input input
+	 * \param count number of elements
+	 * \param output output (one element)
+	 * \param op reduction operation
+	 *
+	 */
+	template<typename input_it, typename output_it, typename reduce_op>
+	void reduce_cpu(input_it input, int count, output_it output, reduce_op op)
+	{
+		typedef typename std::decay<decltype(output[0])>::type out_type;
+
+		const int nth = (std::is_integral<out_type>::value == true)?ofp_n_threads(count,REDUCE_CPU_GRAIN):1;
+
+		if (nth == 1)
+		{
+			output[0] = 0;
+			for (int i = 0 ; i < count ; i++)
+			{
+				output[0] = op(output[0],input[i]);
+			}
+
+			return;
+		}
+
+		std::vector<out_type> part(nth);
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			ofp_thread_range(count,t,nth,start,stop);
+
+			out_type p = input[start];
+			for (size_t i = start + 1 ; i < stop ; i++)
+			{p = op(p,input[i]);}
+
+			part[t] = p;
+		}
+
+		out_type red = 0;
+		for (int t = 0 ; t < nth ; t++)
+		{red = op(red,part[t]);}
+
+		output[0] = red;
+	}
+
+#endif
+
 	template<typename input_it, typename output_it, typename reduce_op>
 			void reduce(input_it input, int count, output_it output, reduce_op op, gpu::ofp_context_t& gpuContext)
 	{
 #ifdef CUDA_ON_CPU
 
-	output[0] = 0;
-	for (int i = 0 ; i < count ; i++)
-	{
-		output[0] = op(output[0],input[i]);
-	}
+	reduce_cpu(input,count,output,op);
 
 #else
 
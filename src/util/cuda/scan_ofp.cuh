@@ -26,24 +26,100 @@
 	#include "cub_old/cub.cuh"
 #endif
 
+#ifdef CUDA_ON_CPU
+	#include <vector>
+	#include <type_traits>
+	#include "util/multi_thread_util.hpp"
+
+	//! Under this number of elements the scan run on a single thread
+	#define SCAN_CPU_GRAIN 16384
+#endif
+
 
 namespace openfpm
 {
+#ifdef CUDA_ON_CPU
+
+	/*! \brief Exclusive scan on the host
+	 *
+	 * Integer scans are done in two passes, first the sum of each thread block, then every thread
+	 * scan its block starting from the prefix of the block sums. Floating point scans stay
+	 * sequential to give the same rounding of the sequential version. Input and output can be
+	 * the same array
+	 *
+	 * \param input input
+	 * \param count number of elements
+	 * \param output output
+	 *
+	 */
 	template<typename input_it, typename output_it>
-			 void scan(input_it input, int count, output_it output, gpu::ofp_context_t& gpuContext)
+	void scan_cpu(input_it input, int count, output_it output)
 	{
-#ifdef CUDA_ON_CPU
+		typedef typename std::decay<decltype(output[0])>::type out_type;
+
+		if (count == 0)	{return;}
+
+		const int nth = (std::is_integral<out_type>::value == true)?ofp_n_threads(count,SCAN_CPU_GRAIN):1;
+
+		if (nth == 1)
+		{
+			auto prec = input[0];
+			output[0] = 0;
+			for (int i = 1 ; i < count ; i++)
+			{
+				auto next = prec + output[i-1];
+				prec = input[i];
+				output[i] = next;
+			}
+
+			return;
+		}
+
+		std::vector<out_type> blk(nth+1);
+		blk[0] = 0;
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			ofp_thread_range(count,t,nth,start,stop);
+
+			out_type sum = 0;
+			for (size_t i = start ; i < stop ; i++)
+			{sum += input[i];}
+
+			blk[t+1] = sum;
+		}
+
+		for (int t = 0 ; t < nth ; t++)
+		{blk[t+1] += blk[t];}
+
+		#pragma omp parallel for num_threads(nth) schedule(static,1)
+		for (int t = 0 ; t < nth ; t++)
+		{
+			size_t start;
+			size_t stop;
+			ofp_thread_range(count,t,nth,start,stop);
+
+			out_type acc = blk[t];
+			for (size_t i = start ; i < stop ; i++)
+			{
+				out_type v = input[i];
+				output[i] = acc;
+				acc += v;
+			}
+		}
+	}
 
-	if (count == 0)	{return;}
+#endif
 
-	auto prec = input[0];
-	output[0] = 0;
-	for (int i = 1 ; i < count ; i++)
+	template<typename input_it, typename output_it>
+			 void scan(input_it input, int count, output_it output, gpu::ofp_context_t& gpuContext)
 	{
-		auto next = prec + output[i-1];
-		prec = input[i];
-		output[i] = next;
-	}
+#ifdef CUDA_ON_CPU
+
+	scan_cpu(input,count,output);
 
 #else
 	if (count == 0)	return;
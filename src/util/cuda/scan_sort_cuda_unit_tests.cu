@@ -7,6 +7,11 @@
 #include "sort_ofp.cuh"
 #include "scan_ofp.cuh"
 #include "segreduce_ofp.cuh"
+#include "merge_ofp.cuh"
+#include "reduce_ofp.cuh"
+#include "timer.hpp"
+#include <algorithm>
+#include <random>
 
 BOOST_AUTO_TEST_SUITE( scan_tests )
 
@@ -182,4 +187,241 @@ BOOST_AUTO_TEST_CASE( test_seg_reduce_wrapper )
 	// Test the cell list
 }
 
+/*! \brief Run scan, sort, merge, segreduce and reduce on n elements and check the results against sequential versions
+ *
+ * \param n number of elements
+ * \param gen random generator
+ *
+ * \return true if all the results match
+ *
+ */
+bool scan_sort_large_check(size_t n, std::mt19937 & gen)
+{
+	std::uniform_int_distribution<int> ud(0,1000);
+	std::uniform_int_distribution<int> us(0,40);
+
+	openfpm::vector_gpu<aggregate<int>> in;
+	openfpm::vector_gpu<aggregate<int>> out;
+	openfpm::vector_gpu<aggregate<int>> id;
+	openfpm::vector_gpu<aggregate<int>> seg;
+
+	in.resize(n);
+	out.resize(n);
+	id.resize(n);
+
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		in.template get<0>(i) = ud(gen);
+		id.template get<0>(i) = i;
+	}
+
+	seg.add();
+	seg.template get<0>(0) = 0;
+	while (seg.template get<0>(seg.size()-1) < (int)n)
+	{
+		int s = std::min(seg.template get<0>(seg.size()-1) + us(gen),(int)n);
+		seg.add();
+		seg.template get<0>(seg.size()-1) = s;
+	}
+	seg.remove(seg.size()-1);
+
+	in.template hostToDevice<0>();
+	id.template hostToDevice<0>();
+	seg.template hostToDevice<0>();
+
+	gpu::ofp_context_t gpuContext;
+	bool match = true;
+
+	// scan
+
+	openfpm::scan((int *)in.template getDeviceBuffer<0>(),n,(int *)out.template getDeviceBuffer<0>(),gpuContext);
+	out.template deviceToHost<0>();
+
+	int acc = 0;
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		match &= (out.template get<0>(i) == acc);
+		acc += in.template get<0>(i);
+	}
+
+	// reduce
+
+	openfpm::vector_gpu<aggregate<int>> red;
+	red.resize(1);
+	openfpm::reduce((int *)in.template getDeviceBuffer<0>(),n,(int *)red.template getDeviceBuffer<0>(),gpu::plus_t<int>(),gpuContext);
+	red.template deviceToHost<0>();
+
+	match &= (red.template get<0>(0) == acc);
+
+	// segmented reduction
+
+	openfpm::vector_gpu<aggregate<int>> sred;
+	sred.resize(seg.size());
+	openfpm::segreduce((int *)in.template getDeviceBuffer<0>(),n,(int *)seg.template getDeviceBuffer<0>(),seg.size(),
+			           (int *)sred.template getDeviceBuffer<0>(),gpu::maximum_t<int>(),-1,gpuContext);
+	sred.template deviceToHost<0>();
+
+	for (size_t i = 0 ; i < seg.size() ; i++)
+	{
+		int stop = (i == seg.size() - 1)?n:seg.template get<0>(i+1);
+		int m = -1;
+		for (int j = seg.template get<0>(i) ; j < stop ; j++)
+		{m = std::max(m,in.template get<0>(j));}
+
+		match &= (sred.template get<0>(i) == m);
+	}
+
+	// sort (stable like the radix sort)
+
+	std::vector<std::pair<int,int>> ref(n);
+	for (size_t i = 0 ; i < n ; i++)
+	{ref[i] = std::make_pair(in.template get<0>(i),(int)i);}
+
+	std::stable_sort(ref.begin(),ref.end(),[](const std::pair<int,int> & a, const std::pair<int,int> & b){return a.first < b.first;});
+
+	openfpm::sort((int *)in.template getDeviceBuffer<0>(),(int *)id.template getDeviceBuffer<0>(),n,gpu::template less_t<int>(),gpuContext);
+	in.template deviceToHost<0>();
+	id.template deviceToHost<0>();
+
+	for (size_t i = 0 ; i < n ; i++)
+	{match &= (in.template get<0>(i) == ref[i].first && id.template get<0>(i) == ref[i].second);}
+
+	// merge the sorted sequence with itself
+
+	openfpm::vector_gpu<aggregate<int>> mk;
+	openfpm::vector_gpu<aggregate<int>> mv;
+	mk.resize(2*n);
+	mv.resize(2*n);
+
+	openfpm::merge((int *)in.template getDeviceBuffer<0>(),(int *)id.template getDeviceBuffer<0>(),n,
+			       (int *)in.template getDeviceBuffer<0>(),(int *)id.template getDeviceBuffer<0>(),n,
+			       (int *)mk.template getDeviceBuffer<0>(),(int *)mv.template getDeviceBuffer<0>(),gpu::template less_t<int>(),gpuContext);
+	mk.template deviceToHost<0>();
+	mv.template deviceToHost<0>();
+
+	size_t k = 0;
+	size_t i = 0;
+	while (i < n)
+	{
+		// run of equal keys, first the ones of a then the ones of b
+		size_t j = i;
+		while (j < n && in.template get<0>(j) == in.template get<0>(i))	{j++;}
+
+		for (size_t r = 0 ; r < 2 ; r++)
+		{
+			for (size_t l = i ; l < j ; l++)
+			{
+				match &= (mk.template get<0>(k) == in.template get<0>(l) && mv.template get<0>(k) == id.template get<0>(l));
+				k++;
+			}
+		}
+
+		i = j;
+	}
+
+	// sort descending
+
+	openfpm::sort((int *)in.template getDeviceBuffer<0>(),(int *)id.template getDeviceBuffer<0>(),n,gpu::template greater_t<int>(),gpuContext);
+	in.template deviceToHost<0>();
+
+	for (size_t i = 0 ; i < n - 1 ; i++)
+	{match &= (in.template get<0>(i) >= in.template get<0>(i+1));}
+
+	return match;
+}
+
+BOOST_AUTO_TEST_CASE( test_scan_sort_large )
+{
+	std::mt19937 gen(11);
+
+	BOOST_REQUIRE_EQUAL(scan_sort_large_check(1000,gen),true);
+	BOOST_REQUIRE_EQUAL(scan_sort_large_check(1000003,gen),true);
+}
+
+#ifdef CUDA_ON_CPU
+
+BOOST_AUTO_TEST_CASE( test_scan_sort_cpu_scaling )
+{
+	const size_t n = 1 << 24;
+
+	std::mt19937 gen(13);
+	std::uniform_int_distribution<unsigned int> ud(0,1 << 30);
+
+	openfpm::vector<aggregate<unsigned int>> in;
+	openfpm::vector<aggregate<unsigned int>> out;
+	openfpm::vector<aggregate<unsigned int>> key;
+	openfpm::vector<aggregate<unsigned int>> val;
+	openfpm::vector<aggregate<unsigned int>> mk;
+	openfpm::vector<aggregate<unsigned int>> mv;
+	openfpm::vector<aggregate<unsigned int>> seg;
+	openfpm::vector<aggregate<unsigned int>> sred;
+
+	in.resize(n);
+	out.resize(n);
+	key.resize(n);
+	val.resize(n);
+	mk.resize(2*n);
+	mv.resize(2*n);
+	seg.resize(n / 16);
+	sred.resize(n / 16);
+
+	for (size_t i = 0 ; i < n ; i++)	{in.template get<0>(i) = ud(gen);}
+	for (size_t i = 0 ; i < seg.size() ; i++)	{seg.template get<0>(i) = 16*i;}
+
+	gpu::ofp_context_t gpuContext;
+
+	int max_th = openfpm::ofp_max_threads();
+
+	for (int nth = 1 ; nth <= max_th ; nth = (nth == max_th)?max_th + 1:std::min(2*nth,max_th))
+	{
+#ifdef HAVE_OPENMP
+		omp_set_num_threads(nth);
+#endif
+
+		timer t_scan;
+		t_scan.start();
+		openfpm::scan(&in.template get<0>(0),n,&out.template get<0>(0),gpuContext);
+		t_scan.stop();
+
+		timer t_red;
+		t_red.start();
+		openfpm::reduce(&in.template get<0>(0),n,&out.template get<0>(0),gpu::plus_t<unsigned int>(),gpuContext);
+		t_red.stop();
+
+		timer t_sred;
+		t_sred.start();
+		openfpm::segreduce(&in.template get<0>(0),n,&seg.template get<0>(0),seg.size(),&sred.template get<0>(0),
+				           gpu::plus_t<unsigned int>(),0u,gpuContext);
+		t_sred.stop();
+
+		for (size_t i = 0 ; i < n ; i++)
+		{
+			key.template get<0>(i) = in.template get<0>(i);
+			val.template get<0>(i) = i;
+		}
+
+		timer t_sort;
+		t_sort.start();
+		openfpm::sort(&key.template get<0>(0),&val.template get<0>(0),n,gpu::template less_t<unsigned int>(),gpuContext);
+		t_sort.stop();
+
+		timer t_merge;
+		t_merge.start();
+		openfpm::merge(&key.template get<0>(0),&val.template get<0>(0),n,
+				       &key.template get<0>(0),&val.template get<0>(0),n,
+				       &mk.template get<0>(0),&mv.template get<0>(0),gpu::template less_t<unsigned int>(),gpuContext);
+		t_merge.stop();
+
+		std::cout << "CPU primitives " << n << " elements " << nth << " threads  scan: " << t_scan.getwct() << " s  reduce: " << t_red.getwct()
+				  << " s  segreduce: " << t_sred.getwct() << " s  sort: " << t_sort.getwct() << " s  merge: " << t_merge.getwct() << " s" << std::endl;
+	}
+
+#ifdef HAVE_OPENMP
+	omp_set_num_threads(max_th);
+#endif
+}
+
+#endif
+
 BOOST_AUTO_TEST_SUITE_END()
+
@@ -25,43 +25,110 @@
 #else
     #include "cub_old/cub.cuh"
 #endif
+
+#ifdef CUDA_ON_CPU
+    #include "util/multi_thread_util.hpp"
+
+    //! Under this number of elements the segmented reduction run on a single thread
+    #define SEGREDUCE_CPU_GRAIN 16384
+#endif
  
 
  namespace openfpm
  {
+ #ifdef CUDA_ON_CPU
+
+    /*! \brief Segmented reduction of the segments [seg_start,seg_stop) on the host
+     *
+     * Every segment is reduced in order starting from its first element, empty segments are set
+     * to init (except the last one that is left untouched)
+     *
+     */
     template<typename input_it,
              typename segments_it, typename output_it, typename op_t, typename type_t>
-    void segreduce(input_it input, int count, segments_it segments,
-                    int num_segments, output_it output, op_t op, type_t init,
-                    gpu::ofp_context_t& gpuContext)
-     {
- #ifdef CUDA_ON_CPU
- 
-        int i = 0;
-        for ( ; i < num_segments - 1; i++)
+    void segreduce_cpu_range(input_it input, int count, segments_it segments,
+                    int num_segments, output_it output, op_t op, type_t init, int seg_start, int seg_stop)
+    {
+        for (int i = seg_start ; i < seg_stop ; i++)
         {
             int j = segments[i];
-            output[i] = init;
-            if (j == segments[i+1]) {continue;}
+            int stop = (i == num_segments - 1)?count:segments[i+1];
+
+            if (j == stop)
+            {
+                if (i != num_segments - 1)  {output[i] = init;}
+                continue;
+            }
+
             output[i] = input[j];
             ++j;
-            for ( ; j < segments[i+1] ; j++)
+            for ( ; j < stop ; j++)
             {
                 output[i] = op(output[i],input[j]);
             }
         }
+    }
 
-        // Last segment
-        int j = segments[i];
-        if (j != count)
+    /*! \brief Segmented reduction on the host
+     *
+     * The segments are distributed across threads so that every thread get a contiguous range of
+     * segments covering about the same number of elements (the segment boundaries are found with a
+     * binary search on the offsets). Every segment is reduced by one thread in the same order of the
+     * sequential version, so the result is identical
+     *
+     */
+    template<typename input_it,
+             typename segments_it, typename output_it, typename op_t, typename type_t>
+    void segreduce_cpu(input_it input, int count, segments_it segments,
+                    int num_segments, output_it output, op_t op, type_t init)
+    {
+        const int nth = ofp_n_threads(count,SEGREDUCE_CPU_GRAIN);
+
+        if (nth == 1 || num_segments <= 1)
         {
-            output[i] = input[j];
-            ++j;
-            for ( ; j < count ; j++)
+            segreduce_cpu_range(input,count,segments,num_segments,output,op,init,0,num_segments);
+            return;
+        }
+
+        #pragma omp parallel for num_threads(nth) schedule(static,1)
+        for (int t = 0 ; t < nth ; t++)
+        {
+            // first segment starting at or after the element e (segments are sorted)
+            auto first_seg = [&](size_t e) -> int
             {
-                output[i] = op(output[i],input[j]);
-            }
+                int lo = 0;
+                int hi = num_segments;
+                while (lo < hi)
+                {
+                    int mid = (lo + hi) / 2;
+                    if ((size_t)segments[mid] < e)  {lo = mid + 1;}
+                    else                            {hi = mid;}
+                }
+                return lo;
+            };
+
+            size_t start;
+            size_t stop;
+            ofp_thread_range(count,t,nth,start,stop);
+
+            int seg_start = (t == 0)?0:first_seg(start);
+            int seg_stop = (t == nth - 1)?num_segments:first_seg(stop);
+
+            segreduce_cpu_range(input,count,segments,num_segments,output,op,init,seg_start,seg_stop);
         }
+    }
+
+ #endif
+
+    template<typename input_it,
+             typename segments_it, typename output_it, typename op_t, typename type_t>
+    void segreduce(input_it input, int count, segments_it segments,
+                    int num_segments, output_it output, op_t op, type_t init,
+                    gpu::ofp_context_t& gpuContext)
+     {
+ #ifdef CUDA_ON_CPU
+
+        segreduce_cpu(input,count,segments,num_segments,output,op,init);
  
  #else
         #ifdef __HIP__
@@ -28,6 +28,11 @@
 	#include "cub_old/cub.cuh"
 #endif
 
+#ifdef CUDA_ON_CPU
+	#include <type_traits>
+	#include "util/radix_sort_cpu.hpp"
+#endif
+
 
 template<typename key_t, typename val_t>
 struct key_val_ref;
@@ -256,6 +261,48 @@ namespace std
 }
 
 
+#ifdef CUDA_ON_CPU
+
+/*! \brief Sort on the host with a generic comparator
+ *
+ */
+template<typename key_t, typename val_t, typename comp_t, bool is_arithmetic = std::is_arithmetic<key_t>::value>
+struct sort_cpu_ofp
+{
+	static void sort(key_t* keys_input, val_t* vals_input, int count, comp_t comp)
+	{
+		key_val_it<key_t,val_t> kv(keys_input,vals_input);
+
+		std::sort(kv,kv+count,comp);
+	}
+};
+
+/*! \brief Sort on the host of numeric keys in ascending order (multi-threaded radix sort)
+ *
+ */
+template<typename key_t, typename val_t>
+struct sort_cpu_ofp<key_t,val_t,gpu::less_t<key_t>,true>
+{
+	static void sort(key_t* keys_input, val_t* vals_input, int count, gpu::less_t<key_t> comp)
+	{
+		openfpm::radix_sort_cpu<false>(keys_input,vals_input,count);
+	}
+};
+
+/*! \brief Sort on the host of numeric keys in descending order (multi-threaded radix sort)
+ *
+ */
+template<typename key_t, typename val_t>
+struct sort_cpu_ofp<key_t,val_t,gpu::greater_t<key_t>,true>
+{
+	static void sort(key_t* keys_input, val_t* vals_input, int count, gpu::greater_t<key_t> comp)
+	{
+		openfpm::radix_sort_cpu<true>(keys_input,vals_input,count);
+	}
+};
+
+#endif
+
 namespace openfpm
 {
 	template<typename key_t, typename val_t,
@@ -265,9 +312,7 @@ namespace openfpm
 	{
 #ifdef CUDA_ON_CPU
 
-	key_val_it<key_t,val_t> kv(keys_input,vals_input);
-
-	std::sort(kv,kv+count,comp);
+	sort_cpu_ofp<key_t,val_t,comp_t>::sort(keys_input,vals_input,count,comp);
 
 #else
 	#ifdef __HIP__
@@ -0,0 +1,323 @@
+/*
+ * mem_usage.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef MEM_USAGE_HPP_
+#define MEM_USAGE_HPP_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include "util/common.hpp"
+
+/*! \brief Memory used by a data-structure
+ *
+ * Every data-structure (openfpm::vector, vector_sparse, grid_base_impl, sgrid_cpu, SparseGridGpu,
+ * CellList, VerletList, Graph_CSR) return it with getMemoryUsage(). allocated is the host memory in byte
+ * owned by the structure, used the part of it that contain valid data. The difference (wasted) is
+ * reserved capacity, empty slots of cell-lists, empty points of the chunks, temporary buffers ...
+ *
+ * Objects can be registered in mem_registry to get a snapshot of all the live structures
+ *
+ * ### Memory usage and registry
+ * \snippet mem_usage_unit_test.hpp Memory usage
+ *
+ */
+struct mem_usage
+{
+	//! allocated bytes
+	size_t allocated = 0;
+
+	//! bytes containing valid data
+	size_t used = 0;
+
+	//! Default constructor
+	mem_usage() {}
+
+	/*! \brief Constructor
+	 *
+	 * \param allocated allocated bytes
+	 * \param used used bytes
+	 *
+	 */
+	mem_usage(size_t allocated, size_t used)
+	:allocated(allocated),used(used)
+	{}
+
+	/*! \brief Bytes allocated but not used
+	 *
+	 * \return the wasted bytes
+	 *
+	 */
+	size_t wasted() const
+	{
+		return (allocated > used)?allocated - used:0;
+	}
+
+	/*! \brief Sum the memory usage of another object
+	 *
+	 * \param m memory usage to add
+	 *
+	 * \return itself
+	 *
+	 */
+	mem_usage & operator+=(const mem_usage & m)
+	{
+		allocated += m.allocated;
+		used += m.used;
+
+		return *this;
+	}
+
+	/*! \brief Sum of two memory usages
+	 *
+	 * \param m memory usage to add
+	 *
+	 * \return the sum
+	 *
+	 */
+	mem_usage operator+(const mem_usage & m) const
+	{
+		mem_usage r = *this;
+		r += m;
+
+		return r;
+	}
+};
+
+/*! \brief Memory usage of the objects pointed by an element (nothing for types without getMemoryUsage)
+ *
+ * \tparam T type of the element
+ *
+ */
+template<typename T, typename Sfinae = void>
+struct mem_usage_nested
+{
+	/*! \brief memory owned by the element outside its sizeof
+	 *
+	 * \param obj element
+	 *
+	 * \return zero
+	 *
+	 */
+	static mem_usage get(const T & obj)
+	{
+		return mem_usage();
+	}
+};
+
+/*! \brief Memory usage of the objects pointed by an element (for types with getMemoryUsage)
+ *
+ * \tparam T type of the element
+ *
+ */
+template<typename T>
+struct mem_usage_nested<T,typename Void<decltype(std::declval<const T &>().getMemoryUsage())>::type>
+{
+	/*! \brief memory owned by the element outside its sizeof
+	 *
+	 * \param obj element
+	 *
+	 * \return the memory usage of the element
+	 *
+	 */
+	static mem_usage get(const T & obj)
+	{
+		return obj.getMemoryUsage();
+	}
+};
+
+/*! \brief Memory usage of an std::vector (nested structures included)
+ *
+ * \param v vector
+ *
+ * \return the memory usage
+ *
+ */
+template<typename T, typename Alloc>
+mem_usage getMemoryUsage(const std::vector<T,Alloc> & v)
+{
+	mem_usage m(v.capacity()*sizeof(T),v.size()*sizeof(T));
+
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{m += mem_usage_nested<T>::get(v[i]);}
+
+	return m;
+}
+
+/*! \brief Registry of live data-structures, to get a snapshot of the memory used
+ *
+ * The registered objects must be alive until they are removed, use mem_registered to remove them
+ * automatically
+ *
+ */
+class mem_registry
+{
+	//! registered object
+	struct entry
+	{
+		//! name
+		std::string name;
+
+		//! return the memory usage of the object
+		std::function<mem_usage()> usage;
+	};
+
+	//! registered objects
+	std::map<size_t,entry> entries;
+
+	//! next id
+	size_t next_id = 0;
+
+	//! protect entries
+	std::mutex mtx;
+
+	/*! \brief The registry
+	 *
+	 * \return the unique registry
+	 *
+	 */
+	static mem_registry & instance()
+	{
+		static mem_registry reg;
+
+		return reg;
+	}
+
+public:
+
+	/*! \brief Register an object
+	 *
+	 * \param name name of the object
+	 * \param obj object (it must have getMemoryUsage())
+	 *
+	 * \return the id to use in remove
+	 *
+	 */
+	template<typename T>
+	static size_t add(const std::string & name, const T & obj)
+	{
+		mem_registry & reg = instance();
+		std::lock_guard<std::mutex> lock(reg.mtx);
+
+		entry & e = reg.entries[reg.next_id];
+		e.name = name;
+		e.usage = [&obj](){return obj.getMemoryUsage();};
+
+		return reg.next_id++;
+	}
+
+	/*! \brief Remove an object
+	 *
+	 * \param id returned by add
+	 *
+	 */
+	static void remove(size_t id)
+	{
+		mem_registry & reg = instance();
+		std::lock_guard<std::mutex> lock(reg.mtx);
+
+		reg.entries.erase(id);
+	}
+
+	/*! \brief Memory usage of all the registered objects (in order of registration)
+	 *
+	 * \return name and memory usage of every object
+	 *
+	 */
+	static std::vector<std::pair<std::string,mem_usage>> snapshot()
+	{
+		mem_registry & reg = instance();
+		std::lock_guard<std::mutex> lock(reg.mtx);
+
+		std::vector<std::pair<std::string,mem_usage>> out;
+
+		for (auto & e : reg.entries)
+		{out.push_back(std::make_pair(e.second.name,e.second.usage()));}
+
+		return out;
+	}
+
+	/*! \brief Total memory of the registered objects
+	 *
+	 * \return the sum of the memory usage
+	 *
+	 */
+	static mem_usage total()
+	{
+		mem_usage tot;
+
+		for (auto & s : snapshot())
+		{tot += s.second;}
+
+		return tot;
+	}
+
+	/*! \brief Print the snapshot, biggest waste first
+	 *
+	 * \param os output stream
+	 *
+	 */
+	static void print(std::ostream & os = std::cout)
+	{
+		auto snap = snapshot();
+
+		std::stable_sort(snap.begin(),snap.end(),[](const std::pair<std::string,mem_usage> & a, const std::pair<std::string,mem_usage> & b)
+		{return a.second.wasted() > b.second.wasted();});
+
+		os << std::left << std::setw(32) << "object" << std::right << std::setw(16) << "allocated(B)"
+		   << std::setw(16) << "used(B)" << std::setw(16) << "wasted(B)" << std::endl;
+
+		mem_usage tot;
+		for (auto & s : snap)
+		{
+			os << std::left << std::setw(32) << s.first << std::right << std::setw(16) << s.second.allocated
+			   << std::setw(16) << s.second.used << std::setw(16) << s.second.wasted() << std::endl;
+			tot += s.second;
+		}
+
+		os << std::left << std::setw(32) << "total" << std::right << std::setw(16) << tot.allocated
+		   << std::setw(16) << tot.used << std::setw(16) << tot.wasted() << std::endl;
+	}
+};
+
+/*! \brief Register an object in mem_registry for the lifetime of this object
+ *
+ */
+class mem_registered
+{
+	//! id in the registry
+	size_t id;
+
+public:
+
+	/*! \brief Register the object
+	 *
+	 * \param name name of the object
+	 * \param obj object (it must have getMemoryUsage() and live longer than this object)
+	 *
+	 */
+	template<typename T>
+	mem_registered(const std::string & name, const T & obj)
+	:id(mem_registry::add(name,obj))
+	{}
+
+	mem_registered(const mem_registered &) = delete;
+	mem_registered & operator=(const mem_registered &) = delete;
+
+	//! Remove the object from the registry
+	~mem_registered()
+	{
+		mem_registry::remove(id);
+	}
+};
+
+#endif /* MEM_USAGE_HPP_ */
@@ -0,0 +1,136 @@
+/*
+ * multi_thread_util.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef MULTI_THREAD_UTIL_HPP_
+#define MULTI_THREAD_UTIL_HPP_
+
+#include "config.h"
+#include <cstddef>
+
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+namespace openfpm
+{
+	/*! \brief Return the maximum number of threads usable by the host multi-threaded algorithms
+	 *
+	 * \return the number of threads (1 if compiled without OpenMP)
+	 *
+	 */
+	static inline int ofp_max_threads()
+	{
+#ifdef HAVE_OPENMP
+		return omp_get_max_threads();
+#else
+		return 1;
+#endif
+	}
+
+	/*! \brief Return the id of the calling thread inside a parallel region
+	 *
+	 * \return the thread id (0 if compiled without OpenMP)
+	 *
+	 */
+	static inline int ofp_thread_id()
+	{
+#ifdef HAVE_OPENMP
+		return omp_get_thread_num();
+#else
+		return 0;
+#endif
+	}
+
+	/*! \brief Return true if the calling thread is inside an active parallel region
+	 *
+	 * \return true inside a parallel region with more than one thread (false if compiled without OpenMP)
+	 *
+	 */
+	static inline bool ofp_in_parallel()
+	{
+#ifdef HAVE_OPENMP
+		return omp_in_parallel();
+#else
+		return false;
+#endif
+	}
+
+	/*! \brief Return the number of threads to use to process n elements
+	 *
+	 * It avoid to spawn threads that would have less than grain elements to process, inside a
+	 * parallel region it return 1 (the algorithms run serially on the calling thread)
+	 *
+	 * \param n number of elements to process
+	 * \param grain minimum number of elements per thread
+	 *
+	 * \return the number of threads to use
+	 *
+	 */
+	static inline int ofp_n_threads(size_t n, size_t grain)
+	{
+		if (ofp_in_parallel() == true)	{return 1;}
+
+		size_t nth = n / grain;
+		size_t max_th = ofp_max_threads();
+
+		if (nth > max_th)	{nth = max_th;}
+		if (nth == 0)	{nth = 1;}
+
+		return nth;
+	}
+
+	/*! \brief Calculate the range of elements [start,stop) processed by the thread t
+	 *
+	 * \param n total number of elements
+	 * \param t thread id
+	 * \param nth number of threads
+	 * \param start first element
+	 * \param stop one past the last element
+	 *
+	 */
+	static inline void ofp_thread_range(size_t n, int t, int nth, size_t & start, size_t & stop)
+	{
+		start = n * t / nth;
+		stop = n * (t+1) / nth;
+	}
+
+	/*! \brief Merge path search
+	 *
+	 * Given two sorted sequences a and b it find how many elements of a are contained in the first
+	 * diag elements of the merged sequence. In case of equal elements the elements of a come first
+	 *
+	 * \param a first sorted sequence
+	 * \param na number of elements in a
+	 * \param b second sorted sequence
+	 * \param nb number of elements in b
+	 * \param diag diagonal (number of elements of the merged sequence)
+	 * \param comp less comparator
+	 *
+	 * \return the number of elements of a in the first diag elements of the merged sequence
+	 *
+	 */
+	template<typename a_it, typename b_it, typename comp_t>
+	size_t merge_path_search(a_it a, size_t na, b_it b, size_t nb, size_t diag, comp_t comp)
+	{
+		size_t lo = (diag > nb)?diag - nb:0;
+		size_t hi = (diag < na)?diag:na;
+
+		while (lo < hi)
+		{
+			size_t mid = (lo + hi) / 2;
+
+			if (comp(b[diag - 1 - mid],a[mid]))
+			{hi = mid;}
+			else
+			{lo = mid + 1;}
+		}
+
+		return lo;
+	}
+}
+
+#endif /* MULTI_THREAD_UTIL_HPP_ */
@@ -0,0 +1,807 @@
+/*
+ * benchmark_store.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef BENCHMARK_STORE_HPP_
+#define BENCHMARK_STORE_HPP_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <sstream>
+#include <fstream>
+#include <limits>
+#include <algorithm>
+#include <ctime>
+#include <cmath>
+#include <cstdlib>
+#include <unistd.h>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/math/distributions/students_t.hpp>
+#include "Vector/map_vector.hpp"
+#include "util/stat/common_statistics.hpp"
+
+/*! \brief Machine readable store of benchmark results
+ *
+ * Every measure is recorded together with the commit, the host, the compiler and the parameters of
+ * the benchmark, as one JSON object per line (JSON-lines). The store can be appended run after run and
+ * exported to CSV, the plots are left to an external post-processing of these files. Nothing is executed
+ * and no network is required: the commit is read from the .git directory (or from the environment
+ * variable OPENFPM_BENCH_COMMIT)
+ *
+ * A new set of measures is compared against a reference with a Welch t-test, see benchmark_check
+ *
+ * ### Record, store and check benchmarks
+ * \snippet benchmark_store_unit_test.hpp Record and check benchmarks
+ *
+ */
+
+/*! \brief Environment where a benchmark run
+ *
+ */
+struct benchmark_env
+{
+	//! commit hash
+	std::string commit;
+
+	//! host name
+	std::string host;
+
+	//! compiler and version
+	std::string compiler;
+
+	//! relevant build options
+	std::string build;
+
+	//! time of the measure (seconds from epoch)
+	long int time = 0;
+
+	/*! \brief Check if the measures taken in the environment e can be compared with the ones taken in this
+	 *         environment (same host, compiler and build options, the commit can differ)
+	 *
+	 * \param e environment
+	 *
+	 * \return true if the measures are comparable
+	 *
+	 */
+	bool comparable(const benchmark_env & e) const
+	{
+		return host == e.host && compiler == e.compiler && build == e.build;
+	}
+};
+
+/*! \brief Read the commit hash of the repository that contain the directory dir, without calling git
+ *
+ * \param dir directory from where to start searching the .git directory
+ *
+ * \return the commit hash, "unknown" if not found
+ *
+ */
+static inline std::string benchmark_git_commit(std::string dir = ".")
+{
+	const char * env_commit = getenv("OPENFPM_BENCH_COMMIT");
+	if (env_commit != NULL)
+	{return std::string(env_commit);}
+
+	boost::filesystem::path p;
+
+	try
+	{p = boost::filesystem::absolute(dir);}
+	catch (boost::filesystem::filesystem_error & e)
+	{return "unknown";}
+
+	// search .git going up
+	boost::filesystem::path git;
+	while (p.empty() == false)
+	{
+		if (boost::filesystem::exists(p / ".git"))
+		{
+			git = p / ".git";
+			break;
+		}
+		p = p.parent_path();
+	}
+
+	if (git.empty() == true)
+	{return "unknown";}
+
+	// worktrees and submodules have a file .git containing "gitdir: path"
+	if (boost::filesystem::is_regular_file(git))
+	{
+		std::string tag;
+		std::string path;
+		std::ifstream f(git.string());
+		f >> tag >> path;
+
+		boost::filesystem::path gp(path);
+		git = (gp.is_absolute())?gp:(git.parent_path() / gp);
+	}
+
+	std::string head;
+	std::ifstream fh((git / "HEAD").string());
+	std::getline(fh,head);
+
+	if (head.compare(0,5,"ref: ") != 0)
+	{return (head.size() == 0)?"unknown":head;}
+
+	std::string ref = head.substr(5);
+	std::string commit;
+
+	std::ifstream fr((git / ref).string());
+	if (fr.is_open() && (fr >> commit))
+	{return commit;}
+
+	// the reference can be only in packed-refs
+	std::ifstream fp((git / "packed-refs").string());
+	std::string line;
+	while (std::getline(fp,line))
+	{
+		std::stringstream ss(line);
+		std::string hash;
+		std::string name;
+		ss >> hash >> name;
+
+		if (name == ref)
+		{return hash;}
+	}
+
+	return "unknown";
+}
+
+/*! \brief Return the environment of the benchmark
+ *
+ * \return the environment
+ *
+ */
+static inline benchmark_env benchmark_get_env()
+{
+	benchmark_env env;
+
+	env.commit = benchmark_git_commit();
+
+	char host[256];
+	if (gethostname(host,sizeof(host)) == 0)
+	{
+		host[sizeof(host)-1] = 0;
+		env.host = host;
+	}
+	else
+	{env.host = "unknown";}
+
+#if defined(__clang__)
+	env.compiler = std::string("clang ") + __clang_version__;
+#elif defined(__INTEL_COMPILER)
+	env.compiler = std::string("icc ") + std::to_string(__INTEL_COMPILER);
+#elif defined(__GNUC__)
+	env.compiler = std::string("gcc ") + __VERSION__;
+#else
+	env.compiler = "unknown";
+#endif
+
+#ifdef __OPTIMIZE__
+	env.build += "optimized ";
+#endif
+#ifdef NDEBUG
+	env.build += "NDEBUG ";
+#endif
+#ifdef _OPENMP
+	env.build += "openmp ";
+#endif
+#ifdef CUDA_ON_CPU
+	env.build += "CUDA_ON_CPU ";
+#endif
+#ifdef CUDA_GPU
+	env.build += "CUDA_GPU ";
+#endif
+#ifdef SE_CLASS1
+	env.build += "SE_CLASS1 ";
+#endif
+
+	if (env.build.size() != 0)
+	{env.build.pop_back();}
+
+	env.time = std::time(0);
+
+	return env;
+}
+
+/*! \brief One benchmark: the samples with all the information to reproduce it
+ *
+ */
+struct benchmark_record
+{
+	//! name of the benchmark
+	std::string name;
+
+	//! parameters (for example size, dimensionality ...)
+	std::map<std::string,std::string> params;
+
+	//! measures
+	std::vector<double> samples;
+
+	//! unit of the measures
+	std::string unit = "s";
+
+	//! true if a bigger value is better (throughput), false for times
+	bool higher_is_better = false;
+
+	//! environment
+	benchmark_env env;
+
+	//! mean of the samples
+	double mean = 0.0;
+
+	//! standard deviation of the samples
+	double dev = 0.0;
+
+	/*! \brief Calculate mean and standard deviation of the samples
+	 *
+	 */
+	void calculate_stat()
+	{
+		if (samples.size() == 0)
+		{
+			mean = 0.0;
+			dev = 0.0;
+		}
+		else if (samples.size() == 1)
+		{
+			mean = samples[0];
+			dev = 0.0;
+		}
+		else
+		{standard_deviation(samples,mean,dev);}
+	}
+
+	/*! \brief Key that identify the benchmark: the name with the parameters in order
+	 *
+	 * \return the key
+	 *
+	 */
+	std::string key() const
+	{
+		std::string k = name;
+
+		for (auto & p : params)
+		{k += ";" + p.first + "=" + p.second;}
+
+		return k;
+	}
+};
+
+/*! \brief Escape a string for JSON
+ *
+ * \param s string
+ *
+ * \return the quoted escaped string
+ *
+ */
+static inline std::string benchmark_json_str(const std::string & s)
+{
+	std::string out = "\"";
+
+	for (char c : s)
+	{
+		switch (c)
+		{
+		case '"': out += "\\\""; break;
+		case '\\': out += "\\\\"; break;
+		case '\n': out += "\\n"; break;
+		case '\t': out += "\\t"; break;
+		case '\r': out += "\\r"; break;
+		default:
+			if ((unsigned char)c < 0x20)
+			{
+				char buf[8];
+				snprintf(buf,sizeof(buf),"\\u%04x",c);
+				out += buf;
+			}
+			else
+			{out += c;}
+		}
+	}
+
+	return out + "\"";
+}
+
+/*! \brief Quote a field for CSV
+ *
+ * \param s field
+ *
+ * \return the quoted field
+ *
+ */
+static inline std::string benchmark_csv_str(const std::string & s)
+{
+	std::string out = "\"";
+
+	for (char c : s)
+	{
+		if (c == '"')	{out += "\"\"";}
+		else {out += c;}
+	}
+
+	return out + "\"";
+}
+
+/*! \brief Set of benchmark records, that can be saved and loaded as JSON-lines and exported as CSV
+ *
+ */
+class benchmark_store
+{
+	//! records
+	std::vector<benchmark_record> records;
+
+	//! environment of the new records
+	benchmark_env env;
+
+public:
+
+	//! Constructor, it fix the environment of the records added with add
+	benchmark_store()
+	:env(benchmark_get_env())
+	{}
+
+	/*! \brief Add a benchmark
+	 *
+	 * \param name name of the benchmark
+	 * \param params parameters
+	 * \param samples measures
+	 * \param unit unit of the measures
+	 * \param higher_is_better true for throughput like measures
+	 *
+	 * \return the record added
+	 *
+	 */
+	benchmark_record & add(const std::string & name,
+			               const std::map<std::string,std::string> & params,
+			               const std::vector<double> & samples,
+			               const std::string & unit = "s",
+			               bool higher_is_better = false)
+	{
+		records.emplace_back();
+		benchmark_record & r = records.back();
+
+		r.name = name;
+		r.params = params;
+		r.samples = samples;
+		r.unit = unit;
+		r.higher_is_better = higher_is_better;
+		r.env = env;
+
+		r.calculate_stat();
+
+		return r;
+	}
+
+	/*! \brief Add a benchmark
+	 *
+	 * \param name name of the benchmark
+	 * \param params parameters
+	 * \param samples measures
+	 * \param unit unit of the measures
+	 * \param higher_is_better true for throughput like measures
+	 *
+	 * \return the record added
+	 *
+	 */
+	benchmark_record & add(const std::string & name,
+			               const std::map<std::string,std::string> & params,
+			               const openfpm::vector<double> & samples,
+			               const std::string & unit = "s",
+			               bool higher_is_better = false)
+	{
+		std::vector<double> s(samples.size());
+
+		for (size_t i = 0 ; i < samples.size() ; i++)
+		{s[i] = samples.get(i);}
+
+		return add(name,params,s,unit,higher_is_better);
+	}
+
+	/*! \brief Add a record as it is (environment included)
+	 *
+	 * \param r record
+	 *
+	 */
+	void add(const benchmark_record & r)
+	{
+		records.push_back(r);
+	}
+
+	/*! \brief Number of records
+	 *
+	 * \return the number of records
+	 *
+	 */
+	size_t size() const
+	{
+		return records.size();
+	}
+
+	/*! \brief Get a record
+	 *
+	 * \param i record id
+	 *
+	 * \return the record
+	 *
+	 */
+	const benchmark_record & get(size_t i) const
+	{
+		return records[i];
+	}
+
+	/*! \brief Environment of the new records
+	 *
+	 * \return the environment
+	 *
+	 */
+	benchmark_env & getEnv()
+	{
+		return env;
+	}
+
+	//! Remove all the records
+	void clear()
+	{
+		records.clear();
+	}
+
+	/*! \brief Find the last record with a given key
+	 *
+	 * \param key the key (see benchmark_record::key)
+	 * \param env if not NULL only the records taken in a comparable environment are considered
+	 *
+	 * \return the record, NULL if not found
+	 *
+	 */
+	const benchmark_record * find(const std::string & key, const benchmark_env * env = NULL) const
+	{
+		for (long int i = records.size() - 1 ; i >= 0 ; i--)
+		{
+			if (records[i].key() == key && (env == NULL || env->comparable(records[i].env) == true))
+			{return &records[i];}
+		}
+
+		return NULL;
+	}
+
+	/*! \brief Write the records as JSON-lines, one record per line
+	 *
+	 * \param file output file
+	 * \param append append to the file instead of overwrite it
+	 *
+	 * \return true if the file has been written
+	 *
+	 */
+	bool write_jsonl(const std::string & file, bool append = true) const
+	{
+		std::ofstream f(file,(append == true)?std::ios::app:std::ios::trunc);
+
+		if (f.is_open() == false)
+		{return false;}
+
+		f.precision(std::numeric_limits<double>::max_digits10);
+
+		for (auto & r : records)
+		{
+			f << "{\"name\":" << benchmark_json_str(r.name) << ",\"params\":{";
+
+			bool first = true;
+			for (auto & p : r.params)
+			{
+				f << ((first == true)?"":",") << benchmark_json_str(p.first) << ":" << benchmark_json_str(p.second);
+				first = false;
+			}
+
+			f << "},\"unit\":" << benchmark_json_str(r.unit)
+			  << ",\"higher_is_better\":" << ((r.higher_is_better == true)?"true":"false")
+			  << ",\"samples\":[";
+
+			for (size_t i = 0 ; i < r.samples.size() ; i++)
+			{f << ((i == 0)?"":",") << r.samples[i];}
+
+			f << "],\"mean\":" << r.mean << ",\"dev\":" << r.dev
+			  << ",\"commit\":" << benchmark_json_str(r.env.commit)
+			  << ",\"host\":" << benchmark_json_str(r.env.host)
+			  << ",\"compiler\":" << benchmark_json_str(r.env.compiler)
+			  << ",\"build\":" << benchmark_json_str(r.env.build)
+			  << ",\"time\":" << r.env.time << "}\n";
+		}
+
+		return f.good();
+	}
+
+	/*! \brief Load records from a JSON-lines file, the records are added to the one already present
+	 *
+	 * Malformed lines are skipped
+	 *
+	 * \param file input file
+	 *
+	 * \return false if the file does not exist
+	 *
+	 */
+	bool load_jsonl(const std::string & file)
+	{
+		std::ifstream f(file);
+
+		if (f.is_open() == false)
+		{return false;}
+
+		std::string line;
+		while (std::getline(f,line))
+		{
+			if (line.find_first_not_of(" \t\r") == std::string::npos)
+			{continue;}
+
+			boost::property_tree::ptree t;
+
+			try
+			{
+				std::stringstream ss(line);
+				boost::property_tree::read_json(ss,t);
+
+				benchmark_record r;
+
+				r.name = t.get<std::string>("name");
+				r.unit = t.get<std::string>("unit","s");
+				r.higher_is_better = t.get<bool>("higher_is_better",false);
+
+				for (auto & p : t.get_child("params"))
+				{r.params[p.first] = p.second.data();}
+
+				for (auto & s : t.get_child("samples"))
+				{r.samples.push_back(s.second.get_value<double>());}
+
+				r.env.commit = t.get<std::string>("commit","unknown");
+				r.env.host = t.get<std::string>("host","unknown");
+				r.env.compiler = t.get<std::string>("compiler","unknown");
+				r.env.build = t.get<std::string>("build","");
+				r.env.time = t.get<long int>("time",0);
+
+				r.calculate_stat();
+
+				records.push_back(r);
+			}
+			catch (std::exception & e)
+			{
+				std::cerr << __FILE__ << ":" << __LINE__ << " skipping malformed benchmark record in " << file << std::endl;
+			}
+		}
+
+		return true;
+	}
+
+	/*! \brief Write the records as CSV (one row per record, parameters as key=value;...)
+	 *
+	 * \param file output file
+	 *
+	 * \return true if the file has been written
+	 *
+	 */
+	bool write_csv(const std::string & file) const
+	{
+		std::ofstream f(file);
+
+		if (f.is_open() == false)
+		{return false;}
+
+		f.precision(std::numeric_limits<double>::max_digits10);
+
+		f << "name,params,unit,n,mean,dev,min,max,commit,host,compiler,build,time\n";
+
+		for (auto & r : records)
+		{
+			std::string pr;
+			for (auto & p : r.params)
+			{pr += ((pr.size() == 0)?"":";") + p.first + "=" + p.second;}
+
+			double mn = 0.0;
+			double mx = 0.0;
+			if (r.samples.size() != 0)
+			{
+				mn = *std::min_element(r.samples.begin(),r.samples.end());
+				mx = *std::max_element(r.samples.begin(),r.samples.end());
+			}
+
+			f << benchmark_csv_str(r.name) << "," << benchmark_csv_str(pr) << "," << benchmark_csv_str(r.unit) << ","
+			  << r.samples.size() << "," << r.mean << "," << r.dev << "," << mn << "," << mx << ","
+			  << benchmark_csv_str(r.env.commit) << "," << benchmark_csv_str(r.env.host) << ","
+			  << benchmark_csv_str(r.env.compiler) << "," << benchmark_csv_str(r.env.build) << "," << r.env.time << "\n";
+		}
+
+		return f.good();
+	}
+};
+
+/*! \brief Two sided Welch t-test: probability that two sets of samples with these statistics have the same mean
+ *
+ * \param m1 mean of the first set
+ * \param s1 standard deviation of the first set
+ * \param n1 number of samples of the first set
+ * \param m2 mean of the second set
+ * \param s2 standard deviation of the second set
+ * \param n2 number of samples of the second set
+ *
+ * \return the p-value (1.0 if the test cannot be done, less than two samples in one set)
+ *
+ */
+static inline double welch_t_test(double m1, double s1, size_t n1, double m2, double s2, size_t n2)
+{
+	if (n1 < 2 || n2 < 2)
+	{return 1.0;}
+
+	double v1 = s1*s1 / n1;
+	double v2 = s2*s2 / n2;
+
+	// No variance, the means are equal or not
+	if (v1 + v2 == 0.0)
+	{return (m1 == m2)?1.0:0.0;}
+
+	double t = (m1 - m2) / sqrt(v1 + v2);
+
+	// Welch–Satterthwaite degrees of freedom
+	double df = (v1 + v2)*(v1 + v2) / (v1*v1 / (n1 - 1) + v2*v2 / (n2 - 1));
+
+	boost::math::students_t dist(df);
+
+	return 2.0 * boost::math::cdf(boost::math::complement(dist,fabs(t)));
+}
+
+/*! \brief Result of the comparison of a benchmark against its reference
+ *
+ */
+struct benchmark_regression
+{
+	//! key of the benchmark
+	std::string key;
+
+	//! mean of the reference
+	double mean_ref;
+
+	//! mean of the new measure
+	double mean;
+
+	//! relative change of the mean (mean - mean_ref) / mean_ref
+	double rel_change;
+
+	//! p-value of the Welch t-test
+	double p_value;
+
+	//! -1 improvement, 0 no significant change, 1 regression
+	int level;
+};
+
+/*! \brief Compare every record of a store with the last record with the same key of a reference store,
+ *         taken on the same host with the same compiler and build options
+ *
+ * A change is significant when the Welch t-test reject equal means with significance alpha and the
+ * relative change of the mean is at least min_rel (a small but statistically significant change is not
+ * reported). Records without reference are skipped
+ *
+ * \param ref reference store
+ * \param cur new measures
+ * \param out one entry for every record of cur that has a reference
+ * \param alpha significance of the test
+ * \param min_rel minimum relative change
+ *
+ * \return the number of regressions
+ *
+ */
+static inline size_t benchmark_check(const benchmark_store & ref,
+		                             const benchmark_store & cur,
+		                             std::vector<benchmark_regression> & out,
+		                             double alpha = 0.01,
+		                             double min_rel = 0.05)
+{
+	size_t n_reg = 0;
+	out.clear();
+
+	for (size_t i = 0 ; i < cur.size() ; i++)
+	{
+		const benchmark_record & r = cur.get(i);
+		const benchmark_record * rr = ref.find(r.key(),&r.env);
+
+		if (rr == NULL)
+		{continue;}
+
+		benchmark_regression reg;
+		reg.key = r.key();
+		reg.mean_ref = rr->mean;
+		reg.mean = r.mean;
+		reg.rel_change = (rr->mean != 0.0)?(r.mean - rr->mean) / fabs(rr->mean):0.0;
+		reg.p_value = welch_t_test(r.mean,r.dev,r.samples.size(),rr->mean,rr->dev,rr->samples.size());
+		reg.level = 0;
+
+		if (reg.p_value < alpha && fabs(reg.rel_change) >= min_rel)
+		{
+			bool worse = (r.higher_is_better == true)?(reg.rel_change < 0.0):(reg.rel_change > 0.0);
+			reg.level = (worse == true)?1:-1;
+		}
+
+		n_reg += (reg.level == 1);
+		out.push_back(reg);
+	}
+
+	return n_reg;
+}
+
+/*! \brief Print the significant changes found by benchmark_check
+ *
+ * \param out result of benchmark_check
+ * \param os output stream
+ *
+ */
+static inline void benchmark_print_changes(const std::vector<benchmark_regression> & out, std::ostream & os = std::cout)
+{
+	for (auto & r : out)
+	{
+		if (r.level == 0)	{continue;}
+
+		os << ((r.level == 1)?"REGRESSION ":"IMPROVEMENT ") << r.key << ": " << r.mean_ref << " -> " << r.mean
+		   << " (" << r.rel_change * 100.0 << "%, p=" << r.p_value << ")" << std::endl;
+	}
+}
+
+/*! \brief Append the measures of a performance test to its reference
+ *
+ * This is the only function that write ref_dir/name_ref.jsonl. It is called by benchmark_write_and_check only
+ * when the environment variable OPENFPM_BENCH_UPDATE_REF is set
+ *
+ * \param cur new measures
+ * \param name name of the performance test
+ * \param ref_dir directory of the reference
+ *
+ */
+static inline void benchmark_update_reference(const benchmark_store & cur,
+		                                      const std::string & name,
+		                                      const std::string & ref_dir)
+{
+	cur.write_jsonl(ref_dir + "/" + name + "_ref.jsonl");
+}
+
+/*! \brief Write the measures of a performance test and check them against the reference
+ *
+ * The records are appended to name.jsonl and exported to name.csv in the working directory, then compared
+ * with ref_dir/name_ref.jsonl. The reference is only read: to accept the new measures as reference run with
+ * OPENFPM_BENCH_UPDATE_REF set (or call benchmark_update_reference)
+ *
+ * \param cur new measures
+ * \param name name of the performance test
+ * \param ref_dir directory of the reference
+ * \param os where to print the significant changes
+ *
+ * \return the number of regressions
+ *
+ */
+static inline size_t benchmark_write_and_check(const benchmark_store & cur,
+		                                       const std::string & name,
+		                                       const std::string & ref_dir,
+		                                       std::ostream & os = std::cout)
+{
+	cur.write_jsonl(name + ".jsonl");
+	cur.write_csv(name + ".csv");
+
+	std::string file_ref = ref_dir + "/" + name + "_ref.jsonl";
+
+	size_t n_reg = 0;
+	benchmark_store ref;
+	if (ref.load_jsonl(file_ref) == true)
+	{
+		std::vector<benchmark_regression> res;
+		n_reg = benchmark_check(ref,cur,res);
+		benchmark_print_changes(res,os);
+	}
+
+	if (getenv("OPENFPM_BENCH_UPDATE_REF") != NULL)
+	{benchmark_update_reference(cur,name,ref_dir);}
+
+	return n_reg;
+}
+
+#endif /* BENCHMARK_STORE_HPP_ */
@@ -0,0 +1,609 @@
+/*
+ * perf_counters.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef PERF_COUNTERS_HPP_
+#define PERF_COUNTERS_HPP_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <algorithm>
+#include "util/multi_thread_util.hpp"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+/*! \brief Hardware performance counters on code regions
+ *
+ * A region is instrumented with OFP_PERF_REGION("name") at the beginning of a scope. When the library is
+ * compiled with OPENFPM_PERF_COUNTERS the region measure time, cycles, instructions and last level cache
+ * misses (perf_event_open on Linux) and accumulate them in perf_registry under its name. Without
+ * OPENFPM_PERF_COUNTERS the macro is empty and has no overhead. When the counters cannot be opened (not Linux,
+ * or perf_event_paranoid) only the time and the number of calls are recorded
+ *
+ * A region that start outside a parallel region sum the counters of all the threads of the OpenMP team, so the
+ * work of the parallel sections inside the region (Packer, Unpacker ...) is counted. The counters of the team
+ * are opened before the first measure. A region that start inside a parallel region count only the calling
+ * thread. Threads not created by OpenMP are not counted
+ *
+ * The bytes moved are estimated as LLC misses times the cache line size. Nested calls of the same region
+ * (for example the Packer of a vector of vectors) are counted once
+ *
+ * ### Instrument a region and report
+ * \snippet benchmark_store_unit_test.hpp Instrument a region
+ *
+ */
+
+//! Size of a cache line used to estimate the memory traffic
+#define PERF_CACHE_LINE_SIZE 64
+
+//! Maximum number of samples (calls) stored for each region
+#define PERF_MAX_SAMPLES 4096
+
+//! Maximum depth of nested regions
+#define PERF_MAX_NESTING 32
+
+//! Counters measured
+enum perf_counter_id
+{
+	PERF_CYCLES = 0,
+	PERF_INSTRUCTIONS = 1,
+	PERF_LLC_MISSES = 2,
+	PERF_N_COUNTERS = 3
+};
+
+/*! \brief Hardware counters of the calling thread
+ *
+ */
+class perf_counter_group
+{
+	//! file descriptor of the counters (-1 if not available)
+	int fd[PERF_N_COUNTERS];
+
+	//! Groups of the threads of the OpenMP team
+	struct group_list
+	{
+		//! protect team
+		std::mutex mtx;
+
+		//! groups of the threads opened by open_team
+		std::vector<perf_counter_group *> team;
+
+		//! number of threads of the team when it was opened (0 to open it again)
+		std::atomic<int> n_team;
+
+		group_list()
+		:n_team(0)
+		{}
+	};
+
+	/*! \brief Groups of the OpenMP team
+	 *
+	 * \return the list of the groups
+	 *
+	 */
+	static group_list & groups()
+	{
+		static group_list gl;
+
+		return gl;
+	}
+
+public:
+
+	//! Open the counters
+	perf_counter_group()
+	{
+		for (size_t i = 0 ; i < PERF_N_COUNTERS ; i++)
+		{fd[i] = -1;}
+
+#ifdef __linux__
+		const uint32_t type[PERF_N_COUNTERS] = {PERF_TYPE_HARDWARE,PERF_TYPE_HARDWARE,PERF_TYPE_HARDWARE};
+		const uint64_t config[PERF_N_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES,PERF_COUNT_HW_INSTRUCTIONS,PERF_COUNT_HW_CACHE_MISSES};
+
+		for (size_t i = 0 ; i < PERF_N_COUNTERS ; i++)
+		{
+			struct perf_event_attr attr;
+			memset(&attr,0,sizeof(attr));
+
+			attr.size = sizeof(attr);
+			attr.type = type[i];
+			attr.config = config[i];
+			attr.disabled = 0;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+
+			// this thread on any cpu
+			fd[i] = syscall(__NR_perf_event_open,&attr,0,-1,-1,0);
+		}
+#endif
+	}
+
+	//! Close the counters
+	~perf_counter_group()
+	{
+		group_list & gl = groups();
+		std::unique_lock<std::mutex> lock(gl.mtx);
+
+		for (size_t i = 0 ; i < gl.team.size() ; i++)
+		{
+			if (gl.team[i] == this)
+			{
+				// a thread of the team is gone, the team is opened again at the next region
+				gl.team[i] = gl.team.back();
+				gl.team.pop_back();
+				gl.n_team = 0;
+				break;
+			}
+		}
+
+		lock.unlock();
+
+#ifdef __linux__
+		for (size_t i = 0 ; i < PERF_N_COUNTERS ; i++)
+		{
+			if (fd[i] >= 0)	{close(fd[i]);}
+		}
+#endif
+	}
+
+	/*! \brief Check if a counter is available
+	 *
+	 * \param i counter
+	 *
+	 * \return true if available
+	 *
+	 */
+	bool available(size_t i) const
+	{
+		return fd[i] >= 0;
+	}
+
+	/*! \brief Read the counters (0 for the counters not available)
+	 *
+	 * \param v values
+	 *
+	 */
+	void read(uint64_t (& v)[PERF_N_COUNTERS]) const
+	{
+		for (size_t i = 0 ; i < PERF_N_COUNTERS ; i++)
+		{
+			v[i] = 0;
+#ifdef __linux__
+			if (fd[i] >= 0 && ::read(fd[i],&v[i],sizeof(uint64_t)) != sizeof(uint64_t))
+			{v[i] = 0;}
+#endif
+		}
+	}
+
+	/*! \brief Counters of the calling thread
+	 *
+	 * \return the counters, opened at the first call in every thread
+	 *
+	 */
+	static perf_counter_group & thread_counters()
+	{
+		static thread_local perf_counter_group grp;
+
+		return grp;
+	}
+
+	/*! \brief Open the counters on all the threads of the OpenMP team and remember them as the team
+	 *
+	 * The threads of the team are persistent, the team is spawned again only when the number of threads
+	 * change (or a thread of the team is gone)
+	 *
+	 */
+	static void open_team()
+	{
+		group_list & gl = groups();
+
+		int nth = openfpm::ofp_max_threads();
+		if (nth == gl.n_team)	{return;}
+
+		{
+			std::lock_guard<std::mutex> lock(gl.mtx);
+			gl.team.clear();
+		}
+
+		#pragma omp parallel num_threads(nth)
+		{
+			perf_counter_group * g = &thread_counters();
+
+			std::lock_guard<std::mutex> lock(gl.mtx);
+			if (std::find(gl.team.begin(),gl.team.end(),g) == gl.team.end())
+			{gl.team.push_back(g);}
+		}
+
+		gl.n_team = nth;
+	}
+
+	/*! \brief Number of threads of the team opened by open_team
+	 *
+	 * \return the number of groups summed by read_all
+	 *
+	 */
+	static size_t team_size()
+	{
+		group_list & gl = groups();
+		std::lock_guard<std::mutex> lock(gl.mtx);
+
+		return gl.team.size();
+	}
+
+	/*! \brief Read the sum of the counters of the threads of the team opened by open_team
+	 *         (0 for the counters not available)
+	 *
+	 * \param v values
+	 *
+	 */
+	static void read_all(uint64_t (& v)[PERF_N_COUNTERS])
+	{
+		group_list & gl = groups();
+		std::lock_guard<std::mutex> lock(gl.mtx);
+
+		for (size_t i = 0 ; i < PERF_N_COUNTERS ; i++)
+		{v[i] = 0;}
+
+		for (size_t j = 0 ; j < gl.team.size() ; j++)
+		{
+			uint64_t vt[PERF_N_COUNTERS];
+			gl.team[j]->read(vt);
+
+			for (size_t i = 0 ; i < PERF_N_COUNTERS ; i++)
+			{v[i] += vt[i];}
+		}
+	}
+};
+
+/*! \brief Measures accumulated for a region
+ *
+ */
+struct perf_region_stat
+{
+	//! name of the region
+	std::string name;
+
+	//! number of calls
+	size_t calls = 0;
+
+	//! total time in seconds
+	double time = 0.0;
+
+	//! total of every counter
+	uint64_t cnt[PERF_N_COUNTERS] = {0,0,0};
+
+	//! true if the counter has been measured at least one time
+	bool has_cnt[PERF_N_COUNTERS] = {false,false,false};
+
+	//! time of each call (the first PERF_MAX_SAMPLES)
+	std::vector<double> s_time;
+
+	//! counters of each call (the first PERF_MAX_SAMPLES)
+	std::vector<double> s_cnt[PERF_N_COUNTERS];
+
+	/*! \brief Estimated bytes moved from/to the memory
+	 *
+	 * \return LLC misses times the cache line size
+	 *
+	 */
+	uint64_t bytes() const
+	{
+		return cnt[PERF_LLC_MISSES] * PERF_CACHE_LINE_SIZE;
+	}
+};
+
+/*! \brief Registry of all the instrumented regions
+ *
+ */
+class perf_registry
+{
+	//! regions
+	std::map<std::string,perf_region_stat> regions;
+
+	//! protect regions
+	std::mutex mtx;
+
+	/*! \brief The registry
+	 *
+	 * \return the unique registry
+	 *
+	 */
+	static perf_registry & instance()
+	{
+		static perf_registry reg;
+
+		return reg;
+	}
+
+public:
+
+	/*! \brief Get (create) the region with a given name
+	 *
+	 * \param name region name
+	 *
+	 * \return the region
+	 *
+	 */
+	static perf_region_stat & get(const std::string & name)
+	{
+		perf_registry & reg = instance();
+		std::lock_guard<std::mutex> lock(reg.mtx);
+
+		perf_region_stat & st = reg.regions[name];
+		st.name = name;
+
+		return st;
+	}
+
+	/*! \brief Add a measure to a region
+	 *
+	 * \param st region
+	 * \param time time of the call
+	 * \param cnt counters of the call
+	 * \param av availability of the counters
+	 *
+	 */
+	static void add(perf_region_stat & st, double time, const uint64_t (& cnt)[PERF_N_COUNTERS], const perf_counter_group & av)
+	{
+		std::lock_guard<std::mutex> lock(instance().mtx);
+
+		st.calls++;
+		st.time += time;
+
+		bool smp = st.s_time.size() < PERF_MAX_SAMPLES;
+		if (smp == true)	{st.s_time.push_back(time);}
+
+		for (size_t i = 0 ; i < PERF_N_COUNTERS ; i++)
+		{
+			if (av.available(i) == false)	{continue;}
+
+			st.has_cnt[i] = true;
+			st.cnt[i] += cnt[i];
+			if (smp == true)	{st.s_cnt[i].push_back(cnt[i]);}
+		}
+	}
+
+	//! Reset all the measures
+	static void reset()
+	{
+		perf_registry & reg = instance();
+		std::lock_guard<std::mutex> lock(reg.mtx);
+
+		for (auto & r : reg.regions)
+		{
+			std::string name = r.second.name;
+			r.second = perf_region_stat();
+			r.second.name = name;
+		}
+	}
+
+	/*! \brief Copy of all the regions with at least one call
+	 *
+	 * \return the regions
+	 *
+	 */
+	static std::vector<perf_region_stat> regions_list()
+	{
+		perf_registry & reg = instance();
+		std::lock_guard<std::mutex> lock(reg.mtx);
+
+		std::vector<perf_region_stat> out;
+		for (auto & r : reg.regions)
+		{
+			if (r.second.calls != 0)	{out.push_back(r.second);}
+		}
+
+		return out;
+	}
+
+	/*! \brief Print a table with the measures of every region
+	 *
+	 * \param os output stream
+	 *
+	 */
+	static void print(std::ostream & os = std::cout)
+	{
+		os << std::left << std::setw(32) << "region" << std::right << std::setw(10) << "calls" << std::setw(14) << "time(s)"
+		   << std::setw(16) << "cycles" << std::setw(16) << "instructions" << std::setw(8) << "IPC"
+		   << std::setw(14) << "LLC misses" << std::setw(12) << "MB moved" << std::endl;
+
+		for (auto & r : regions_list())
+		{
+			os << std::left << std::setw(32) << r.name << std::right << std::setw(10) << r.calls << std::setw(14) << r.time;
+
+			for (size_t i = 0 ; i < PERF_N_COUNTERS ; i++)
+			{
+				os << std::setw((i == PERF_LLC_MISSES)?14:16);
+				if (r.has_cnt[i] == true)	{os << r.cnt[i];}
+				else {os << "n/a";}
+
+				if (i == PERF_INSTRUCTIONS)
+				{
+					os << std::setw(8);
+					if (r.has_cnt[PERF_CYCLES] && r.has_cnt[PERF_INSTRUCTIONS] && r.cnt[PERF_CYCLES] != 0)
+					{os << std::setprecision(3) << (double)r.cnt[PERF_INSTRUCTIONS] / r.cnt[PERF_CYCLES] << std::setprecision(6);}
+					else {os << "n/a";}
+				}
+			}
+
+			os << std::setw(12);
+			if (r.has_cnt[PERF_LLC_MISSES] == true)	{os << r.bytes() / 1e6;}
+			else {os << "n/a";}
+			os << std::endl;
+		}
+	}
+
+	/*! \brief Add the measures of every region to a benchmark store (see benchmark_store.hpp)
+	 *
+	 * For every region one record for the time and one for each available counter, the samples are the
+	 * calls of the region
+	 *
+	 * \param store benchmark store
+	 * \param params parameters added to every record
+	 *
+	 */
+	template<typename store_type>
+	static void to_store(store_type & store, const std::map<std::string,std::string> & params = std::map<std::string,std::string>())
+	{
+		const char * cnt_name[PERF_N_COUNTERS] = {"cycles","instructions","llc_misses"};
+
+		for (auto & r : regions_list())
+		{
+			std::map<std::string,std::string> p = params;
+			p["region"] = r.name;
+
+			store.add("perf_time",p,r.s_time,"s");
+
+			for (size_t i = 0 ; i < PERF_N_COUNTERS ; i++)
+			{
+				if (r.has_cnt[i] == false)	{continue;}
+
+				store.add(std::string("perf_") + cnt_name[i],p,r.s_cnt[i],cnt_name[i]);
+
+				if (i == PERF_LLC_MISSES)
+				{
+					std::vector<double> b(r.s_cnt[i]);
+					for (auto & v : b)	{v *= PERF_CACHE_LINE_SIZE;}
+
+					store.add("perf_bytes",p,b,"bytes");
+				}
+			}
+		}
+	}
+};
+
+/*! \brief Measure the scope where it is created and add the measure to a region of perf_registry
+ *
+ */
+class perf_region
+{
+	//! region, NULL if the region is already active in this thread
+	perf_region_stat * st;
+
+	//! true if the counters of all the threads are measured (the region start outside a parallel region)
+	bool team;
+
+	//! counters at the beginning
+	uint64_t start[PERF_N_COUNTERS];
+
+	//! time at the beginning
+	std::chrono::steady_clock::time_point t0;
+
+	//! Active regions of a thread
+	struct active_stack
+	{
+		//! number of active regions
+		size_t depth = 0;
+
+		//! active regions
+		perf_region_stat * st[PERF_MAX_NESTING];
+	};
+
+	/*! \brief Stack of the active regions of this thread
+	 *
+	 * \return the stack
+	 *
+	 */
+	static active_stack & active()
+	{
+		static thread_local active_stack stack;
+
+		return stack;
+	}
+
+public:
+
+	/*! \brief Start the measure
+	 *
+	 * \param st region
+	 *
+	 */
+	perf_region(perf_region_stat & st)
+	:st(&st),team(openfpm::ofp_in_parallel() == false)
+	{
+		active_stack & stack = active();
+
+		for (size_t i = 0 ; i < stack.depth ; i++)
+		{
+			if (stack.st[i] == &st)
+			{
+				this->st = NULL;
+				return;
+			}
+		}
+
+		if (stack.depth == PERF_MAX_NESTING)
+		{
+			this->st = NULL;
+			return;
+		}
+
+		stack.st[stack.depth++] = &st;
+
+		if (team == true)
+		{
+			perf_counter_group::open_team();
+			perf_counter_group::read_all(start);
+		}
+		else
+		{perf_counter_group::thread_counters().read(start);}
+
+		t0 = std::chrono::steady_clock::now();
+	}
+
+	//! Stop the measure
+	~perf_region()
+	{
+		if (st == NULL)	{return;}
+
+		auto t1 = std::chrono::steady_clock::now();
+
+		perf_counter_group & grp = perf_counter_group::thread_counters();
+		uint64_t stop[PERF_N_COUNTERS];
+
+		if (team == true)	{perf_counter_group::read_all(stop);}
+		else	{grp.read(stop);}
+
+		// a thread can exit during the region (its counters are not summed anymore)
+		for (size_t i = 0 ; i < PERF_N_COUNTERS ; i++)
+		{stop[i] = (stop[i] >= start[i])?stop[i] - start[i]:0;}
+
+		perf_registry::add(*st,std::chrono::duration<double>(t1 - t0).count(),stop,grp);
+
+		active().depth--;
+	}
+};
+
+#define OFP_PERF_CAT_(a,b) a##b
+#define OFP_PERF_CAT(a,b) OFP_PERF_CAT_(a,b)
+
+#ifdef OPENFPM_PERF_COUNTERS
+
+//! Measure the rest of the scope as the region name
+#define OFP_PERF_REGION(name) static perf_region_stat & OFP_PERF_CAT(ofp_perf_st_,__LINE__) = perf_registry::get(name);\
+                              perf_region OFP_PERF_CAT(ofp_perf_reg_,__LINE__)(OFP_PERF_CAT(ofp_perf_st_,__LINE__))
+
+#else
+
+//! Compiled out
+#define OFP_PERF_REGION(name)
+
+#endif
+
+#endif /* PERF_COUNTERS_HPP_ */
@@ -0,0 +1,259 @@
+/*
+ * radix_sort_cpu.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef RADIX_SORT_CPU_HPP_
+#define RADIX_SORT_CPU_HPP_
+
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include "util/multi_thread_util.hpp"
+
+//! Number of bits processed by each pass of the radix sort
+#define RADIX_SORT_CPU_BITS 8
+//! Number of buckets for each pass of the radix sort
+#define RADIX_SORT_CPU_BUCKETS (1 << RADIX_SORT_CPU_BITS)
+//! Under this number of elements the radix sort run on a single thread
+#define RADIX_SORT_CPU_GRAIN 16384
+
+/*! \brief Map a key into an unsigned integer with the same ordering
+ *
+ * Unsigned integer are used as they are
+ *
+ * \tparam key_t type of the key
+ *
+ */
+template<typename key_t, bool is_float = std::is_floating_point<key_t>::value, bool is_signed = std::is_signed<key_t>::value>
+struct radix_key
+{
+	//! unsigned type with the same size of key_t
+	typedef typename std::make_unsigned<key_t>::type ukey_type;
+
+	static inline ukey_type to_ukey(const key_t & k)
+	{
+		return k;
+	}
+};
+
+/*! \brief bool keys are sorted as unsigned char (std::make_unsigned<bool> is ill-formed)
+ *
+ */
+template<>
+struct radix_key<bool,false,false>
+{
+	//! unsigned type with the same size of bool
+	typedef unsigned char ukey_type;
+
+	static inline ukey_type to_ukey(const bool & k)
+	{
+		return k;
+	}
+};
+
+/*! \brief Map a signed integer into an unsigned integer with the same ordering
+ *
+ * The sign bit is flipped
+ *
+ */
+template<typename key_t>
+struct radix_key<key_t,false,true>
+{
+	//! unsigned type with the same size of key_t
+	typedef typename std::make_unsigned<key_t>::type ukey_type;
+
+	static inline ukey_type to_ukey(const key_t & k)
+	{
+		return (ukey_type)k ^ ((ukey_type)1 << (sizeof(key_t)*8 - 1));
+	}
+};
+
+/*! \brief Map a floating point number into an unsigned integer with the same ordering
+ *
+ * For positive numbers the sign bit is flipped, for negative numbers all the bits are flipped
+ *
+ */
+template<typename key_t>
+struct radix_key<key_t,true,true>
+{
+	//! unsigned type with the same size of key_t
+	typedef typename std::conditional<sizeof(key_t) == 4,uint32_t,uint64_t>::type ukey_type;
+
+	static inline ukey_type to_ukey(const key_t & k)
+	{
+		ukey_type u;
+		std::memcpy(&u,&k,sizeof(key_t));
+
+		ukey_type sign = (ukey_type)1 << (sizeof(key_t)*8 - 1);
+
+		return (u & sign)?~u:(u | sign);
+	}
+};
+
+namespace openfpm
+{
+	/*! \brief Map a key into the unsigned integer sorted by the radix sort
+	 *
+	 * \tparam desc invert the ordering (descending sort)
+	 *
+	 * \param k key
+	 *
+	 * \return the unsigned key
+	 *
+	 */
+	template<bool desc, typename key_t>
+	inline typename radix_key<key_t>::ukey_type radix_ukey(const key_t & k)
+	{
+		typedef typename radix_key<key_t>::ukey_type ukey_type;
+
+		ukey_type u = radix_key<key_t>::to_ukey(k);
+		return (desc == true)?(ukey_type)~u:u;
+	}
+
+	/*! \brief Sort keys and values with a multi-threaded LSD radix sort
+	 *
+	 * The sort is stable. Keys can be any integer (bool included) or floating point type. Every pass process
+	 * RADIX_SORT_CPU_BITS bits, passes where all the keys have the same digit are skipped.
+	 * At the end the sorted keys and values are in keys and vals
+	 *
+	 * \tparam desc sort in descending order
+	 *
+	 * \param keys keys to sort
+	 * \param vals values to reorder with the keys
+	 * \param n number of elements
+	 * \param keys_tmp temporary buffer for the keys (at least n elements)
+	 * \param vals_tmp temporary buffer for the values (at least n elements)
+	 *
+	 */
+	template<bool desc = false, typename key_t, typename val_t>
+	void radix_sort_cpu(key_t * keys, val_t * vals, size_t n, key_t * keys_tmp, val_t * vals_tmp)
+	{
+		static_assert(std::is_integral<key_t>::value || std::is_floating_point<key_t>::value,"radix_sort_cpu support only integer or floating point keys");
+
+		typedef typename radix_key<key_t>::ukey_type ukey_type;
+
+		if (n <= 1)	{return;}
+
+		const int nth = ofp_n_threads(n,RADIX_SORT_CPU_GRAIN);
+		const int n_pass = (sizeof(key_t)*8 + RADIX_SORT_CPU_BITS - 1) / RADIX_SORT_CPU_BITS;
+
+		std::vector<size_t> cnt(nth*RADIX_SORT_CPU_BUCKETS);
+
+		key_t * src_k = keys;
+		val_t * src_v = vals;
+		key_t * dst_k = keys_tmp;
+		val_t * dst_v = vals_tmp;
+
+		for (int pass = 0 ; pass < n_pass ; pass++)
+		{
+			const int shift = pass*RADIX_SORT_CPU_BITS;
+
+			std::fill(cnt.begin(),cnt.end(),0);
+
+			// histogram of the digits for each thread chunk
+
+			#pragma omp parallel for num_threads(nth) schedule(static,1)
+			for (int t = 0 ; t < nth ; t++)
+			{
+				size_t start;
+				size_t stop;
+				ofp_thread_range(n,t,nth,start,stop);
+
+				size_t * c = &cnt[t*RADIX_SORT_CPU_BUCKETS];
+
+				for (size_t i = start ; i < stop ; i++)
+				{c[(radix_ukey<desc>(src_k[i]) >> shift) & (RADIX_SORT_CPU_BUCKETS-1)]++;}
+			}
+
+			// if all the keys have the same digit this pass does nothing
+
+			size_t d0 = (radix_ukey<desc>(src_k[0]) >> shift) & (RADIX_SORT_CPU_BUCKETS-1);
+			size_t n_d0 = 0;
+			for (int t = 0 ; t < nth ; t++)
+			{n_d0 += cnt[t*RADIX_SORT_CPU_BUCKETS + d0];}
+
+			if (n_d0 == n)	{continue;}
+
+			// offsets, digit major, thread minor to keep the sort stable
+
+			size_t off = 0;
+			for (size_t d = 0 ; d < RADIX_SORT_CPU_BUCKETS ; d++)
+			{
+				for (int t = 0 ; t < nth ; t++)
+				{
+					size_t c = cnt[t*RADIX_SORT_CPU_BUCKETS + d];
+					cnt[t*RADIX_SORT_CPU_BUCKETS + d] = off;
+					off += c;
+				}
+			}
+
+			// scatter
+
+			#pragma omp parallel for num_threads(nth) schedule(static,1)
+			for (int t = 0 ; t < nth ; t++)
+			{
+				size_t start;
+				size_t stop;
+				ofp_thread_range(n,t,nth,start,stop);
+
+				size_t * c = &cnt[t*RADIX_SORT_CPU_BUCKETS];
+
+				for (size_t i = start ; i < stop ; i++)
+				{
+					ukey_type d = (radix_ukey<desc>(src_k[i]) >> shift) & (RADIX_SORT_CPU_BUCKETS-1);
+					size_t pos = c[d]++;
+					dst_k[pos] = src_k[i];
+					dst_v[pos] = src_v[i];
+				}
+			}
+
+			std::swap(src_k,dst_k);
+			std::swap(src_v,dst_v);
+		}
+
+		// the result must be in keys, vals
+
+		if (src_k != keys)
+		{
+			#pragma omp parallel for num_threads(nth) schedule(static,1)
+			for (int t = 0 ; t < nth ; t++)
+			{
+				size_t start;
+				size_t stop;
+				ofp_thread_range(n,t,nth,start,stop);
+
+				std::copy(src_k + start,src_k + stop,keys + start);
+				std::copy(src_v + start,src_v + stop,vals + start);
+			}
+		}
+	}
+
+	/*! \brief Sort keys and values with a multi-threaded LSD radix sort
+	 *
+	 * Same as radix_sort_cpu but the temporary buffers are allocated internally
+	 *
+	 * \tparam desc sort in descending order
+	 *
+	 * \param keys keys to sort
+	 * \param vals values to reorder with the keys
+	 * \param n number of elements
+	 *
+	 */
+	template<bool desc = false, typename key_t, typename val_t>
+	void radix_sort_cpu(key_t * keys, val_t * vals, size_t n)
+	{
+		// not std::vector, std::vector<bool> is not contiguous
+		std::unique_ptr<key_t[]> keys_tmp(new key_t[n]);
+		std::unique_ptr<val_t[]> vals_tmp(new val_t[n]);
+
+		radix_sort_cpu<desc>(keys,vals,n,keys_tmp.get(),vals_tmp.get());
+	}
+}
+
+#endif /* RADIX_SORT_CPU_HPP_ */
@@ -0,0 +1,200 @@
+/*
+ * scratch_arena.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef SCRATCH_ARENA_HPP_
+#define SCRATCH_ARENA_HPP_
+
+#include <mutex>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+#include "util/mem_usage.hpp"
+
+/*! \brief Pool of temporary vectors shared across data-structures
+ *
+ * The flush phases of vector_sparse (and the block map of SparseGridGpu) need several temporary buffers as big as
+ * the data. Without an arena every structure keep its own buffers alive between two flushes. With an arena
+ * the buffers are borrowed at the beginning of the phase and given back at the end, so many structures
+ * flushed one after the other share the same buffers: the memory retained is the one of the biggest flush
+ * and not the sum over all the structures, and the buffers are not reallocated at every flush
+ *
+ * Buffers are pooled by type, a vector is given back with its capacity (the content is lost). The arena
+ * is thread-safe
+ *
+ * ### Share the flush buffers across sparse vectors
+ * \snippet map_vector_sparse_unit_tests.cu Share the flush buffers
+ *
+ */
+class scratch_arena
+{
+	//! pooled buffer
+	struct buffer_base
+	{
+		//! memory retained by the buffer
+		virtual mem_usage getMemoryUsage() const = 0;
+
+		virtual ~buffer_base() {}
+	};
+
+	//! pooled buffer of a given vector type
+	template<typename vector_type>
+	struct buffer : public buffer_base
+	{
+		//! pooled vector
+		vector_type v;
+
+		mem_usage getMemoryUsage() const
+		{
+			return v.getMemoryUsage();
+		}
+	};
+
+	//! free buffers for each vector type
+	std::unordered_map<std::type_index,std::vector<std::unique_ptr<buffer_base>>> pool;
+
+	//! number of borrow
+	size_t n_borrow = 0;
+
+	//! number of borrow served with a pooled buffer
+	size_t n_reuse = 0;
+
+	//! protect the pool
+	mutable std::mutex mtx;
+
+public:
+
+	/*! \brief Give to v a pooled buffer of the same type (if any)
+	 *
+	 * The content of v is discarded, and the content of the pooled buffer is undefined: the
+	 * caller must resize it
+	 *
+	 * \param v vector that receive the buffer
+	 *
+	 */
+	template<typename vector_type>
+	void borrow(vector_type & v)
+	{
+		std::unique_ptr<buffer_base> b;
+
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+
+			n_borrow++;
+
+			auto it = pool.find(std::type_index(typeid(vector_type)));
+			if (it == pool.end() || it->second.size() == 0)
+			{return;}
+
+			b = std::move(it->second.back());
+			it->second.pop_back();
+			n_reuse++;
+		}
+
+		v.swap(static_cast<buffer<vector_type> *>(b.get())->v);
+	}
+
+	/*! \brief Give back the buffer of v to the pool, v become an empty vector without memory
+	 *
+	 * \param v vector to give back
+	 *
+	 */
+	template<typename vector_type>
+	void release(vector_type & v)
+	{
+		if (v.getMemoryUsage().allocated == 0)
+		{return;}
+
+		std::unique_ptr<buffer<vector_type>> b(new buffer<vector_type>());
+
+		v.clear();
+		v.swap(b->v);
+
+		std::lock_guard<std::mutex> lock(mtx);
+		pool[std::type_index(typeid(vector_type))].push_back(std::move(b));
+	}
+
+	/*! \brief Free all the pooled buffers
+	 *
+	 */
+	void trim()
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		pool.clear();
+	}
+
+	/*! \brief Number of buffers in the pool
+	 *
+	 * \return the number of pooled buffers
+	 *
+	 */
+	size_t size() const
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+
+		size_t n = 0;
+		for (auto & p : pool)
+		{n += p.second.size();}
+
+		return n;
+	}
+
+	/*! \brief Number of borrow
+	 *
+	 * \return the number of borrow
+	 *
+	 */
+	size_t getNBorrow() const
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		return n_borrow;
+	}
+
+	/*! \brief Number of borrow served with a pooled buffer (allocations avoided)
+	 *
+	 * \return the number of borrow served from the pool
+	 *
+	 */
+	size_t getNReuse() const
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		return n_reuse;
+	}
+
+	/*! \brief Memory retained by the pool (all allocated, nothing used)
+	 *
+	 * \return the memory usage
+	 *
+	 */
+	mem_usage getMemoryUsage() const
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+
+		mem_usage m;
+		for (auto & p : pool)
+		{
+			for (auto & b : p.second)
+			{m.allocated += b->getMemoryUsage().allocated;}
+		}
+
+		return m;
+	}
+
+	/*! \brief Arena shared by the whole process
+	 *
+	 * \return the global arena
+	 *
+	 */
+	static scratch_arena & global()
+	{
+		static scratch_arena arena;
+
+		return arena;
+	}
+};
+
+#endif /* SCRATCH_ARENA_HPP_ */
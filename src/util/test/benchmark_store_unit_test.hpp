@@ -0,0 +1,295 @@
+/*
+ * benchmark_store_unit_test.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef OPENFPM_DATA_SRC_UTIL_BENCHMARK_STORE_UNIT_TEST_HPP_
+#define OPENFPM_DATA_SRC_UTIL_BENCHMARK_STORE_UNIT_TEST_HPP_
+
+#include "util/performance/benchmark_store.hpp"
+#include "util/performance/perf_counters.hpp"
+#include <thread>
+
+/*! \brief Function instrumented with a region
+ *
+ * \param n size of the work
+ *
+ * \return a result to avoid that the work is optimized out
+ *
+ */
+static double perf_test_work(size_t n)
+{
+	OFP_PERF_REGION("perf_test_work");
+
+	std::vector<double> v(n);
+	for (size_t i = 0 ; i < n ; i++)
+	{v[i] = i * 0.5;}
+
+	double sum = 0.0;
+	for (size_t i = 0 ; i < n ; i += 7)
+	{sum += v[(i * 4099) % n];}
+
+	return sum;
+}
+
+/*! \brief Same work of perf_test_work distributed across the OpenMP threads
+ *
+ * \param n size of the work
+ *
+ * \return a result to avoid that the work is optimized out
+ *
+ */
+static double perf_test_work_mt(size_t n)
+{
+	std::vector<double> v(n);
+	double sum = 0.0;
+
+	#pragma omp parallel num_threads(openfpm::ofp_max_threads())
+	{
+		#pragma omp for schedule(static)
+		for (size_t i = 0 ; i < n ; i++)
+		{v[i] = i * 0.5;}
+
+		#pragma omp for schedule(static) reduction(+:sum)
+		for (size_t i = 0 ; i < n ; i += 7)
+		{sum += v[(i * 4099) % n];}
+	}
+
+	return sum;
+}
+
+BOOST_AUTO_TEST_SUITE( benchmark_store_test )
+
+BOOST_AUTO_TEST_CASE( benchmark_store_write_load )
+{
+	boost::filesystem::remove("bench_test.jsonl");
+
+	//! [Record and check benchmarks]
+
+	benchmark_store ref;
+
+	// 5 measures of a time (lower is better), and one of a throughput (higher is better)
+	std::vector<double> t = {1.0, 1.1, 0.9, 1.05, 0.95};
+	openfpm::vector<double> thr;
+	thr.add(100.0); thr.add(102.0); thr.add(98.0);
+
+	ref.add("sort",{{"n","1000"},{"type","float"}},t);
+	ref.add("sort_thr",{{"n","1000"}},thr,"elem/s",true);
+
+	// append to the store of the previous runs
+	ref.write_jsonl("bench_test.jsonl");
+	ref.write_csv("bench_test.csv");
+
+	// next run
+	benchmark_store cur;
+	std::vector<double> t2 = {1.2, 1.3, 1.1, 1.25, 1.15, 1.22};
+	cur.add("sort",{{"type","float"},{"n","1000"}},t2);
+	cur.add("sort_thr",{{"n","1000"}},thr,"elem/s",true);
+
+	// compare against the stored measures
+	benchmark_store hist;
+	hist.load_jsonl("bench_test.jsonl");
+
+	std::vector<benchmark_regression> res;
+	size_t n_reg = benchmark_check(hist,cur,res);
+	benchmark_print_changes(res);
+
+	//! [Record and check benchmarks]
+
+	BOOST_REQUIRE_EQUAL(hist.size(),2ul);
+	BOOST_REQUIRE_EQUAL(hist.get(0).key(),ref.get(0).key());
+	BOOST_REQUIRE_EQUAL(hist.get(0).key(),"sort;n=1000;type=float");
+	BOOST_REQUIRE_EQUAL(hist.get(0).samples.size(),5ul);
+	for (size_t i = 0 ; i < t.size() ; i++)
+	{BOOST_REQUIRE_EQUAL(hist.get(0).samples[i],t[i]);}
+	BOOST_REQUIRE_CLOSE(hist.get(0).mean,1.0,1e-10);
+	BOOST_REQUIRE_EQUAL(hist.get(1).higher_is_better,true);
+	BOOST_REQUIRE_EQUAL(hist.get(1).unit,"elem/s");
+	BOOST_REQUIRE_EQUAL(hist.get(1).env.commit,ref.getEnv().commit);
+	BOOST_REQUIRE_EQUAL(hist.get(1).env.host,ref.getEnv().host);
+
+	BOOST_REQUIRE_EQUAL(n_reg,1ul);
+	BOOST_REQUIRE_EQUAL(res.size(),2ul);
+	BOOST_REQUIRE_EQUAL(res[0].level,1);
+	BOOST_REQUIRE_EQUAL(res[1].level,0);
+
+	// faster is an improvement, the last record with the same key is the reference
+
+	hist.add(cur.get(0));
+	benchmark_check(hist,ref,res);
+	BOOST_REQUIRE_EQUAL(res[0].level,-1);
+
+	// the store is appended
+
+	cur.write_jsonl("bench_test.jsonl");
+	hist.clear();
+	hist.load_jsonl("bench_test.jsonl");
+	BOOST_REQUIRE_EQUAL(hist.size(),4ul);
+
+	std::ifstream f("bench_test.csv");
+	std::string line;
+	size_t n_lines = 0;
+	while (std::getline(f,line))	{n_lines++;}
+	BOOST_REQUIRE_EQUAL(n_lines,3ul);
+}
+
+BOOST_AUTO_TEST_CASE( benchmark_store_welch_test )
+{
+	// same statistics
+	BOOST_REQUIRE_CLOSE(welch_t_test(1.0,0.1,10,1.0,0.2,5),1.0,1e-10);
+
+	// symmetric
+	BOOST_REQUIRE_CLOSE(welch_t_test(1.0,0.1,10,1.2,0.2,5),welch_t_test(1.2,0.2,5,1.0,0.1,10),1e-10);
+
+	// many samples, t = 1.96 is the 5% two sided
+	size_t n = 1000000;
+	double s = 1.0;
+	double d = 1.959964 * sqrt(2.0*s*s / n);
+	BOOST_REQUIRE_CLOSE(welch_t_test(0.0,s,n,d,s,n),0.05,0.01);
+
+	// not enough samples
+	BOOST_REQUIRE_EQUAL(welch_t_test(0.0,1.0,1,10.0,1.0,100),1.0);
+
+	// big noise, no significant difference
+	BOOST_REQUIRE(welch_t_test(1.0,0.5,5,1.2,0.5,5) > 0.1);
+}
+
+BOOST_AUTO_TEST_CASE( benchmark_store_env_reference )
+{
+	boost::filesystem::remove("bench_test_env_ref.jsonl");
+
+	std::vector<double> t = {1.0, 1.1, 0.9, 1.05, 0.95};
+	std::vector<double> t_slow = {2.0, 2.1, 1.9, 2.05, 1.95};
+
+	// the last reference has been taken on another machine
+
+	benchmark_store ref;
+	ref.add("sort",{{"n","1000"}},t);
+	benchmark_record & r_other = ref.add("sort",{{"n","1000"}},t_slow);
+	r_other.env.host = ref.getEnv().host + "_other";
+
+	BOOST_REQUIRE(ref.find("sort;n=1000") == &ref.get(1));
+	BOOST_REQUIRE(ref.find("sort;n=1000",&ref.getEnv()) == &ref.get(0));
+
+	benchmark_store cur;
+	cur.add("sort",{{"n","1000"}},t_slow);
+
+	std::vector<benchmark_regression> res;
+	BOOST_REQUIRE_EQUAL(benchmark_check(ref,cur,res),1ul);
+
+	// the reference is only read by the check
+
+	unsetenv("OPENFPM_BENCH_UPDATE_REF");
+
+	ref.write_jsonl("bench_test_env_ref.jsonl");
+	BOOST_REQUIRE_EQUAL(benchmark_write_and_check(cur,"bench_test_env",".",std::cerr),1ul);
+	BOOST_REQUIRE_EQUAL(benchmark_write_and_check(ref,"bench_test_env",".",std::cerr),0ul);
+
+	benchmark_store hist;
+	hist.load_jsonl("bench_test_env_ref.jsonl");
+	BOOST_REQUIRE_EQUAL(hist.size(),2ul);
+
+	// and updated only on request
+
+	benchmark_update_reference(cur,"bench_test_env",".");
+
+	benchmark_store hist2;
+	hist2.load_jsonl("bench_test_env_ref.jsonl");
+	BOOST_REQUIRE_EQUAL(hist2.size(),3ul);
+
+	setenv("OPENFPM_BENCH_UPDATE_REF","1",1);
+	BOOST_REQUIRE_EQUAL(benchmark_write_and_check(cur,"bench_test_env",".",std::cerr),0ul);
+	unsetenv("OPENFPM_BENCH_UPDATE_REF");
+
+	benchmark_store hist3;
+	hist3.load_jsonl("bench_test_env_ref.jsonl");
+	BOOST_REQUIRE_EQUAL(hist3.size(),4ul);
+}
+
+BOOST_AUTO_TEST_CASE( perf_counters_region )
+{
+	perf_registry::reset();
+
+	//! [Instrument a region]
+
+	// regions are usually marked with OFP_PERF_REGION("name") (active with OPENFPM_PERF_COUNTERS)
+	double sum = 0.0;
+	for (size_t k = 0 ; k < 3 ; k++)
+	{sum += perf_test_work(1000000);}
+
+	// or explicitly
+	perf_region_stat & st = perf_registry::get("perf_test_explicit");
+	for (size_t k = 0 ; k < 3 ; k++)
+	{
+		perf_region r(st);
+
+		// a nested call of the same region is not counted twice
+		perf_region r2(st);
+
+		sum += perf_test_work(100000);
+	}
+
+	// print a table region, calls, time, cycles, instructions, IPC, LLC misses, MB moved
+	perf_registry::print();
+
+	// and save them with the benchmarks
+	benchmark_store store;
+	perf_registry::to_store(store,{{"test","perf_counters_region"}});
+
+	//! [Instrument a region]
+
+	BOOST_REQUIRE(sum > 0.0);
+	BOOST_REQUIRE_EQUAL(st.calls,3ul);
+	BOOST_REQUIRE(st.time > 0.0);
+
+	const benchmark_record * rt = store.find("perf_time;region=perf_test_explicit;test=perf_counters_region");
+	BOOST_REQUIRE(rt != NULL);
+	BOOST_REQUIRE_EQUAL(rt->samples.size(),3ul);
+
+	if (perf_counter_group::thread_counters().available(PERF_INSTRUCTIONS))
+	{
+		BOOST_REQUIRE(st.has_cnt[PERF_INSTRUCTIONS]);
+		BOOST_REQUIRE(st.cnt[PERF_INSTRUCTIONS] > 300000ul);
+		BOOST_REQUIRE(store.find("perf_instructions;region=perf_test_explicit;test=perf_counters_region") != NULL);
+	}
+	else
+	{std::cout << "Hardware counters not available (perf_event_paranoid?), only the time is measured" << std::endl;}
+
+	// a region with a parallel section count the instructions of all the threads
+
+	perf_region_stat & st_mt = perf_registry::get("perf_test_explicit_mt");
+	{
+		perf_region r(st_mt);
+
+		sum += perf_test_work_mt(1000000);
+	}
+
+	if (perf_counter_group::thread_counters().available(PERF_INSTRUCTIONS))
+	{
+		// perf_test_explicit measured 3 times the work with n = 100000 on one thread, with only the calling
+		// thread counted the region would see 1/threads of the instructions
+		BOOST_REQUIRE(st_mt.cnt[PERF_INSTRUCTIONS] > 0.8 * st.cnt[PERF_INSTRUCTIONS] / 3 * 10);
+	}
+
+	// only the threads of the team are summed, not the other threads that opened their counters
+
+	perf_counter_group::open_team();
+	BOOST_REQUIRE_EQUAL(perf_counter_group::team_size(),(size_t)openfpm::ofp_max_threads());
+
+	std::thread th([](){perf_counter_group::thread_counters();});
+	th.join();
+
+	BOOST_REQUIRE_EQUAL(perf_counter_group::team_size(),(size_t)openfpm::ofp_max_threads());
+
+#ifdef OPENFPM_PERF_COUNTERS
+	BOOST_REQUIRE_EQUAL(perf_registry::get("perf_test_work").calls,6ul);
+#else
+	BOOST_REQUIRE_EQUAL(perf_registry::get("perf_test_work").calls,0ul);
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif /* OPENFPM_DATA_SRC_UTIL_BENCHMARK_STORE_UNIT_TEST_HPP_ */
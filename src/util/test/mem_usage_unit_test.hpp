@@ -0,0 +1,197 @@
+/*
+ * mem_usage_unit_test.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: i-bird
+ */
+
+#ifndef OPENFPM_DATA_SRC_UTIL_MEM_USAGE_UNIT_TEST_HPP_
+#define OPENFPM_DATA_SRC_UTIL_MEM_USAGE_UNIT_TEST_HPP_
+
+#include "util/mem_usage.hpp"
+#include "Vector/map_vector.hpp"
+#include "Vector/map_vector_sparse.hpp"
+#include "SparseGrid/SparseGrid.hpp"
+#include "NN/CellList/CellList.hpp"
+#include "NN/VerletList/VerletList.hpp"
+#include "Graph/map_graph.hpp"
+
+BOOST_AUTO_TEST_SUITE( mem_usage_test )
+
+BOOST_AUTO_TEST_CASE( mem_usage_vector_grid )
+{
+	//! [Memory usage]
+
+	openfpm::vector<aggregate<float,float[3]>> v;
+	v.resize(100);
+	v.reserve(1000);
+
+	// every data-structure report the allocated and used memory
+	mem_usage m = v.getMemoryUsage();
+
+	// register the objects to get a report of all the live structures
+	mem_registered reg_v("particles",v);
+
+	size_t sz[3] = {16,16,16};
+	grid_cpu<3,aggregate<double>> g(sz);
+	g.setMemory();
+
+	mem_registered reg_g("grid",g);
+
+	// name, allocated, used and wasted for each object, biggest waste first
+	mem_registry::print();
+
+	//! [Memory usage]
+
+	BOOST_REQUIRE_EQUAL(m.allocated,1000*sizeof(aggregate<float,float[3]>));
+	BOOST_REQUIRE_EQUAL(m.used,100*sizeof(aggregate<float,float[3]>));
+	BOOST_REQUIRE_EQUAL(m.wasted(),900*sizeof(aggregate<float,float[3]>));
+
+	BOOST_REQUIRE_EQUAL(g.getMemoryUsage().allocated,16*16*16*sizeof(aggregate<double>));
+	BOOST_REQUIRE_EQUAL(g.getMemoryUsage().wasted(),0ul);
+
+	// the snapshot is taken live
+	v.resize(1000);
+
+	auto snap = mem_registry::snapshot();
+	BOOST_REQUIRE_EQUAL(snap.size(),2ul);
+	BOOST_REQUIRE_EQUAL(snap[0].first,"particles");
+	BOOST_REQUIRE_EQUAL(snap[0].second.wasted(),0ul);
+
+	mem_usage tot = mem_registry::total();
+	BOOST_REQUIRE_EQUAL(tot.allocated,m.allocated + g.getMemoryUsage().allocated);
+
+	// nested vectors
+	openfpm::vector<openfpm::vector<size_t>> vv;
+	vv.resize(10);
+	for (size_t i = 0 ; i < vv.size() ; i++)
+	{vv.get(i).resize(i);}
+
+	mem_usage mv = vv.getMemoryUsage();
+	BOOST_REQUIRE(mv.used >= 10*sizeof(openfpm::vector<size_t>) + 45*sizeof(size_t));
+	BOOST_REQUIRE(mv.allocated >= mv.used);
+}
+
+BOOST_AUTO_TEST_CASE( mem_usage_registry_remove )
+{
+	openfpm::vector<float> v;
+	v.resize(10);
+
+	size_t n_before = mem_registry::snapshot().size();
+
+	{
+		mem_registered reg("tmp",v);
+		BOOST_REQUIRE_EQUAL(mem_registry::snapshot().size(),n_before + 1);
+	}
+
+	BOOST_REQUIRE_EQUAL(mem_registry::snapshot().size(),n_before);
+
+	size_t id = mem_registry::add("tmp2",v);
+	BOOST_REQUIRE_EQUAL(mem_registry::snapshot().size(),n_before + 1);
+	mem_registry::remove(id);
+	BOOST_REQUIRE_EQUAL(mem_registry::snapshot().size(),n_before);
+}
+
+BOOST_AUTO_TEST_CASE( mem_usage_sparse_structures )
+{
+	// sparse vector
+
+	openfpm::vector_sparse<aggregate<size_t>> vs;
+	vs.template setBackground<0>(0);
+
+	for (size_t i = 0 ; i < 100 ; i++)
+	{vs.template insert<0>(3*i) = i;}
+
+	mem_usage m_vs = vs.getMemoryUsage();
+	BOOST_REQUIRE(m_vs.used >= 100*sizeof(aggregate<size_t>));
+	BOOST_REQUIRE(m_vs.allocated >= m_vs.used);
+
+	// sparse grid, one point per chunk waste most of the chunk
+
+	size_t sz[3] = {64,64,64};
+	sgrid_cpu<3,aggregate<double>,HeapMemory> sg(sz);
+
+	grid_key_dx<3> k1({0,0,0});
+	sg.template insert<0>(k1) = 1.0;
+
+	mem_usage m_sg1 = sg.getMemoryUsage();
+
+	for (long int i = 0 ; i < 8 ; i++)
+	{
+		for (long int j = 0 ; j < 8 ; j++)
+		{
+			for (long int k = 0 ; k < 8 ; k++)
+			{
+				grid_key_dx<3> key({i,j,k});
+				sg.template insert<0>(key) = 1.0;
+			}
+		}
+	}
+
+	mem_usage m_sg2 = sg.getMemoryUsage();
+
+	BOOST_REQUIRE(m_sg1.wasted() > m_sg1.used);
+	BOOST_REQUIRE(m_sg2.used >= 512*sizeof(double));
+	BOOST_REQUIRE(m_sg2.used > m_sg1.used);
+}
+
+BOOST_AUTO_TEST_CASE( mem_usage_nn_graph )
+{
+	Box<3,double> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+	size_t div[3] = {10,10,10};
+
+	openfpm::vector<Point<3,double>> pos;
+	for (size_t i = 0 ; i < 1000 ; i++)
+	{
+		Point<3,double> p({0.05 + 0.1*(i%10),0.05 + 0.1*((i/10)%10),0.05 + 0.1*(i/100)});
+		pos.add(p);
+	}
+
+	// cell-list with Mem_fast, the empty slots are waste
+
+	CellList<3,double,Mem_fast<>,shift<3,double>> cl;
+	cl.Initialize(box,div);
+
+	for (size_t i = 0 ; i < pos.size() ; i++)
+	{cl.add(pos.get(i),i);}
+
+	mem_usage m_cl = cl.getMemoryUsage();
+	BOOST_REQUIRE(m_cl.used >= 1000*sizeof(size_t));
+	BOOST_REQUIRE(m_cl.allocated > m_cl.used);
+
+	CellList<3,double,Mem_bal<>,shift<3,double>> cl_bal;
+	cl_bal.Initialize(box,div);
+
+	for (size_t i = 0 ; i < pos.size() ; i++)
+	{cl_bal.add(pos.get(i),i);}
+
+	mem_usage m_bal = cl_bal.getMemoryUsage();
+	BOOST_REQUIRE(m_bal.used >= 1000*sizeof(size_t));
+	BOOST_REQUIRE(m_bal.allocated >= m_bal.used);
+
+	// verlet list include its cell-list
+
+	VERLETLIST_FAST(3,double) vl;
+	vl.Initialize(box,box,0.15,pos,pos.size());
+
+	mem_usage m_vl = vl.getMemoryUsage();
+	BOOST_REQUIRE(m_vl.used >= 1000*7*sizeof(size_t));
+	BOOST_REQUIRE(m_vl.allocated >= m_vl.used);
+
+	// graph, in slotted form the empty slots are waste
+
+	Graph_CSR<aggregate<float>,aggregate<float>> gr;
+	for (size_t i = 0 ; i < 100 ; i++)
+	{gr.addVertex();}
+
+	for (size_t i = 0 ; i < 99 ; i++)
+	{gr.addEdge(i,i+1);}
+
+	mem_usage m_gr = gr.getMemoryUsage();
+	BOOST_REQUIRE(m_gr.used >= 99*sizeof(aggregate<float>) + 100*sizeof(aggregate<float>));
+	BOOST_REQUIRE(m_gr.wasted() > 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif /* OPENFPM_DATA_SRC_UTIL_MEM_USAGE_UNIT_TEST_HPP_ */